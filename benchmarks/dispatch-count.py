@@ -0,0 +1,116 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+
+"""
+    TPP-MLIR XSMM Dispatch Count Benchmark
+
+    Runs an MLIR kernel in parallel (OpenMP) with and without hoisting and
+    combining XSMM dispatches, and reports, for each thread count, the number
+    of dispatch calls per kernel invocation and the kernel time.
+
+    Arguments:
+     * filename: MLIR kernel to run (default: mlir/mlp-fp32-3layers-1024.mlir)
+     * -n N: Number of kernel invocations (default 100)
+     * -e ENTRY: Entry point name (default "entry")
+     * -threads: Comma separated list of OMP_NUM_THREADS (default 1,2,4,8)
+"""
+
+import os
+import sys
+import argparse
+import re
+
+sys.path.append(os.path.join(os.path.dirname(__file__), 'harness'))
+
+from Logger import Logger
+from Execute import Execute
+from TPPHelper import TPPHelper
+
+class DispatchCountBenchmark(object):
+    """ Counts XSMM dispatch calls per run with and without hoisting """
+
+    def __init__(self, args, loglevel):
+        self.args = args
+        self.logger = Logger("dispatch-count", loglevel)
+        self.runner = Execute(loglevel)
+        helper = TPPHelper(loglevel)
+        baseDir = helper.findGitRoot(os.path.dirname(__file__))
+        buildDir = args.build if args.build else baseDir
+        self.programs = helper.findTPPProgs(buildDir)
+        if self.programs:
+            libDir = os.path.join(os.path.dirname(self.programs['tpp-run']),
+                                  os.path.pardir, "lib")
+            for path in ["LD_LIBRARY_PATH", "DYLD_LIBRARY_PATH"]:
+                environ = [os.getenv(path)] if os.getenv(path) else []
+                environ.insert(0, os.path.realpath(libDir))
+                os.environ[path] = ":".join(environ)
+
+    def _runOnce(self, threads, hoist):
+        """ Returns the mean kernel time and the dispatch calls per call """
+
+        command = [ self.programs['tpp-run'], self.args.benchmark,
+                    '-n', str(self.args.n),
+                    '-e', self.args.entry,
+                    '--entry-point-result=void',
+                    '--print=0',
+                    '-def-parallel',
+                    f'-def-xsmm-combine-dispatch={int(hoist)}',
+                  ]
+        os.environ["OMP_NUM_THREADS"] = str(threads)
+        os.environ["TPP_XSMM_DISPATCH_STATS"] = "1"
+        res = self.runner.run(command)
+        if 0 != res.returncode:
+            self.logger.error(f"Error executing tpp-run: {res.stderr}")
+            return None
+
+        timing = re.search(r"([\d\.\-e]+), ([\d\.\-e]+)", res.stdout)
+        calls = re.search(r"XSMM dispatch: (\d+) calls", res.stderr)
+        if not timing or not calls:
+            self.logger.error(f"Cannot parse tpp-run output: {res.stdout}")
+            return None
+        # tpp-run calls the kernel once more to warm up
+        perCall = int(calls.group(1)) / (self.args.n + 1)
+        return (float(timing.group(1)) * 1000, perCall)
+
+    def run(self):
+        if not self.programs:
+            return False
+
+        print(f"{'threads':>8} {'hoist':>6} {'dispatch/call':>14} {'time (ms)':>10}")
+        for threads in self.args.threads.split(","):
+            for hoist in [False, True]:
+                result = self._runOnce(threads, hoist)
+                if not result:
+                    return False
+                print(f"{threads:>8} {str(hoist):>6} {result[1]:>14.1f} "
+                      f"{result[0]:>10.3f}")
+
+        return True
+
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser(description='XSMM dispatch count benchmark')
+    defaultBench = os.path.join(os.path.dirname(__file__), "mlir",
+                                "mlp-fp32-3layers-1024.mlir")
+    parser.add_argument('benchmark', nargs='?', type=str, default=defaultBench,
+                        help='MLIR file to run')
+    parser.add_argument('-n', type=int, default=100,
+                        help='Number of kernel invocations (default 100)')
+    parser.add_argument('-e', '--entry', type=str, default="entry",
+                        help='Name of the entry point (default "entry")')
+    parser.add_argument('-threads', type=str, default="1,2,4,8",
+                        help='Comma separated list of thread counts')
+    parser.add_argument('--build', type=str, default="",
+                        help='Path to the build dir')
+    parser.add_argument('-v', '--verbose', action='count', default=0,
+                        help='The verbosity of logging output')
+    parser.add_argument('-q', '--quiet', action='count', default=0,
+                        help='Suppress warnings')
+    args = parser.parse_args()
+
+    loglevel = args.verbose - (args.quiet > 0)
+    logger = Logger("dispatch-count", loglevel)
+
+    bench = DispatchCountBenchmark(args, loglevel)
+    if not bench.run():
+        logger.error("Error executing the benchmark")
+        sys.exit(1)
@@ -0,0 +1,147 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+
+"""
+    TPP-MLIR XSMM Kernel Cache Benchmark
+
+    Measures the start-up cost of JIT-compiling LIBXSMM kernels by running an
+    MLIR kernel end-to-end (a single iteration) with the persistent kernel
+    cache cold (empty directory on every run) and warm (directory populated
+    by a previous run).
+
+    Arguments:
+     * filename: MLIR kernel to run (default: mlir/mlp-fp32-3layers-1024.mlir)
+     * -n N: Number of cold and warm runs each (default 10)
+     * -e ENTRY: Entry point name (default "entry")
+     * -run-args: Extra tpp-run arguments
+"""
+
+import os
+import sys
+import shlex
+import argparse
+import tempfile
+import statistics
+import time
+import re
+
+sys.path.append(os.path.join(os.path.dirname(__file__), 'harness'))
+
+from Logger import Logger
+from Execute import Execute
+from TPPHelper import TPPHelper
+
+class KernelCacheBenchmark(object):
+    """ Runs a kernel with a cold and a warm XSMM kernel cache """
+
+    def __init__(self, args, loglevel):
+        self.args = args
+        self.logger = Logger("kernel-cache", loglevel)
+        self.runner = Execute(loglevel)
+        helper = TPPHelper(loglevel)
+        baseDir = helper.findGitRoot(os.path.dirname(__file__))
+        buildDir = args.build if args.build else baseDir
+        self.programs = helper.findTPPProgs(buildDir)
+        if self.programs:
+            libDir = os.path.join(os.path.dirname(self.programs['tpp-run']),
+                                  os.path.pardir, "lib")
+            for path in ["LD_LIBRARY_PATH", "DYLD_LIBRARY_PATH"]:
+                environ = [os.getenv(path)] if os.getenv(path) else []
+                environ.insert(0, os.path.realpath(libDir))
+                os.environ[path] = ":".join(environ)
+
+    def _runOnce(self, cacheDir):
+        """ Returns the wall-clock time of one run and the cache counters """
+
+        command = [ self.programs['tpp-run'], self.args.benchmark,
+                    '-n', '1',
+                    '-e', self.args.entry,
+                    '--entry-point-result=void',
+                    '--print=0',
+                  ]
+        if self.args.run_args:
+            command.extend(shlex.split(self.args.run_args))
+
+        os.environ["TPP_XSMM_CACHE_DIR"] = cacheDir
+        os.environ["TPP_XSMM_CACHE_VERBOSE"] = "1"
+        start = time.perf_counter()
+        res = self.runner.run(command)
+        elapsed = time.perf_counter() - start
+        if 0 != res.returncode:
+            self.logger.error(f"Error executing tpp-run: {res.stderr}")
+            return None
+
+        hits = misses = 0
+        match = re.search(r"XSMM kernel cache: (\d+) hits, (\d+) misses",
+                          res.stderr)
+        if match:
+            hits = int(match.group(1))
+            misses = int(match.group(2))
+        else:
+            self.logger.warning("Cannot find kernel cache counters in output")
+        self.logger.debug(f"{elapsed:.6f} s, {hits} hits, {misses} misses")
+        return (elapsed, hits, misses)
+
+    def _runMany(self, name, makeCacheDir):
+        times = list()
+        hits = misses = 0
+        for _ in range(self.args.n):
+            result = self._runOnce(makeCacheDir())
+            if not result:
+                return False
+            times.append(result[0])
+            hits += result[1]
+            misses += result[2]
+        mean = statistics.mean(times) * 1000
+        stdev = statistics.stdev(times) * 1000 if len(times) > 1 else 0.0
+        print(f"{name}: {mean:3.3f} +- {stdev:3.3f} ms "
+              f"({hits} hits, {misses} misses)")
+        return True
+
+    def run(self):
+        if not self.programs:
+            return False
+
+        with tempfile.TemporaryDirectory(prefix="tpp-xsmm-cache-") as root:
+            # Cold: every run starts with an empty cache directory
+            coldDirs = iter(tempfile.mkdtemp(dir=root)
+                            for _ in range(self.args.n))
+            if not self._runMany("cold", lambda: next(coldDirs)):
+                return False
+
+            # Warm: populate the cache once, then reuse it for all runs
+            warmDir = tempfile.mkdtemp(dir=root)
+            if not self._runOnce(warmDir):
+                return False
+            if not self._runMany("warm", lambda: warmDir):
+                return False
+
+        return True
+
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser(description='XSMM kernel cache start-up benchmark')
+    defaultBench = os.path.join(os.path.dirname(__file__), "mlir",
+                                "mlp-fp32-3layers-1024.mlir")
+    parser.add_argument('benchmark', nargs='?', type=str, default=defaultBench,
+                        help='MLIR file to run')
+    parser.add_argument('-n', type=int, default=10,
+                        help='Number of cold and warm runs (default 10)')
+    parser.add_argument('-e', '--entry', type=str, default="entry",
+                        help='Name of the entry point (default "entry")')
+    parser.add_argument('-run-args', type=str,
+                        help='Extra tpp-run arguments')
+    parser.add_argument('--build', type=str, default="",
+                        help='Path to the build dir')
+    parser.add_argument('-v', '--verbose', action='count', default=0,
+                        help='The verbosity of logging output')
+    parser.add_argument('-q', '--quiet', action='count', default=0,
+                        help='Suppress warnings')
+    args = parser.parse_args()
+
+    loglevel = args.verbose - (args.quiet > 0)
+    logger = Logger("kernel-cache", loglevel)
+
+    bench = KernelCacheBenchmark(args, loglevel)
+    if not bench.run():
+        logger.error("Error executing the benchmark")
+        sys.exit(1)
@@ -0,0 +1,18 @@
+// RUN: tpp-run %s -n 10 \
+// RUN:  -e entry -entry-point-result=void \
+// RUN:  -def-conv-brgemm
+
+// Dilated 3x3 filter with dilation 2 (NHWC/HWCF).
+
+// Total flops = conv O(2*N*P*Q*K*C*R*S)
+// 2*1x28x28x64x64x3x3 = 57,802,752
+// BENCH_TOTAL_FLOPS: 57802752
+
+func.func @entry(%img: tensor<1x32x32x64xf32>, %filter: tensor<3x3x64x64xf32>,
+                 %out: tensor<1x28x28x64xf32>) -> tensor<1x28x28x64xf32> {
+  %0 = linalg.conv_2d_nhwc_hwcf {dilations = dense<2> : tensor<2xi64>,
+                                 strides = dense<1> : tensor<2xi64>}
+    ins(%img, %filter : tensor<1x32x32x64xf32>, tensor<3x3x64x64xf32>)
+    outs(%out : tensor<1x28x28x64xf32>) -> tensor<1x28x28x64xf32>
+  return %0 : tensor<1x28x28x64xf32>
+}
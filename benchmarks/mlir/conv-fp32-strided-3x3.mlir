@@ -0,0 +1,19 @@
+// RUN: tpp-run %s -n 10 \
+// RUN:  -e entry -entry-point-result=void \
+// RUN:  -def-conv-brgemm
+
+// ResNet-style downsampling layer: 3x3 filter with stride 2 (NHWC/HWCF).
+// The image is already padded (56 + 2).
+
+// Total flops = conv O(2*N*P*Q*K*C*R*S)
+// 2*1x28x28x128x64x3x3 = 115,605,504
+// BENCH_TOTAL_FLOPS: 115605504
+
+func.func @entry(%img: tensor<1x58x58x64xf32>, %filter: tensor<3x3x64x128xf32>,
+                 %out: tensor<1x28x28x128xf32>) -> tensor<1x28x28x128xf32> {
+  %0 = linalg.conv_2d_nhwc_hwcf {dilations = dense<1> : tensor<2xi64>,
+                                 strides = dense<2> : tensor<2xi64>}
+    ins(%img, %filter : tensor<1x58x58x64xf32>, tensor<3x3x64x128xf32>)
+    outs(%out : tensor<1x28x28x128xf32>) -> tensor<1x28x28x128xf32>
+  return %0 : tensor<1x28x28x128xf32>
+}
@@ -0,0 +1,19 @@
+// RUN: tpp-run %s -n 10 \
+// RUN:  -e entry -entry-point-result=void
+
+// Zero-initialized matmul with a short reduction: writing the 1024x1024 output
+// is a significant part of the memory traffic. Folding the zero initialization
+// into the BRGEMM (BETA_0) saves a full write pass over the output.
+
+// Total flops = matmul O(2*n*m*k)
+// 2*1024x1024x64 = 134,217,728
+// BENCH_TOTAL_FLOPS: 134217728
+
+func.func @entry(%arg0: tensor<1024x64xf32>, %arg1: tensor<64x1024xf32>) -> tensor<1024x1024xf32> {
+  %cst = arith.constant 0.000000e+00 : f32
+  %0 = tensor.empty() : tensor<1024x1024xf32>
+  %1 = linalg.fill ins(%cst : f32) outs(%0 : tensor<1024x1024xf32>) -> tensor<1024x1024xf32>
+  %2 = linalg.matmul ins(%arg0, %arg1 : tensor<1024x64xf32>, tensor<64x1024xf32>)
+                     outs(%1 : tensor<1024x1024xf32>) -> tensor<1024x1024xf32>
+  return %2 : tensor<1024x1024xf32>
+}
@@ -0,0 +1,26 @@
+// RUN: tpp-run %s -n 100 \
+// RUN:  -e entry -entry-point-result=void \
+// RUN:  -def-parallel -def-xsmm-combine-dispatch=0
+
+// Dispatches the same 32x32 relu kernel on every iteration of a parallel
+// loop, from all the threads, to measure the cost of repeated dispatches.
+// The dispatch sits in a conditional so that LICM leaves it in the loop.
+
+func.func @entry(%arg0: memref<4096x32x32xf32>) {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c4096 = arith.constant 4096 : index
+  scf.parallel (%i) = (%c0) to (%c4096) step (%c1) {
+    %inBounds = arith.cmpi ult, %i, %c4096 : index
+    scf.if %inBounds {
+      %0 = xsmm.unary.dispatch relu [32, 32, 32, 32] flags = (none) data_type = f32
+      %tile = memref.subview %arg0[%i, 0, 0] [1, 32, 32] [1, 1, 1]
+        : memref<4096x32x32xf32> to memref<32x32xf32, strided<[32, 1], offset: ?>>
+      xsmm.unary relu(data_type = f32, %0, %tile, %tile)
+        : (i64, memref<32x32xf32, strided<[32, 1], offset: ?>>,
+           memref<32x32xf32, strided<[32, 1], offset: ?>>) -> ()
+    }
+    scf.yield
+  }
+  return
+}
@@ -0,0 +1,80 @@
+//===- BlockingFactors.h -----------------------------------------*- C++-*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef TPP_BLOCKINGFACTORS_H
+#define TPP_BLOCKINGFACTORS_H
+
+#include "mlir/IR/OpDefinition.h"
+
+namespace mlir {
+class Operation;
+
+namespace linalg {
+class LinalgOp;
+} // namespace linalg
+
+namespace linalgx {
+namespace utils {
+
+// Discardable attribute to override the blocking factors of a single op, for
+// example: `linalg.matmul {tpp.block_factors = array<i64: 64, 64, 32>}`.
+constexpr const static llvm::StringLiteral kBlockFactorsAttrName =
+    "tpp.block_factors";
+
+// Discardable attribute to override the tile sizes used by
+// TileConsumerAndFuseProducers for a fusion anchor. Packing forwards it to the
+// packed op.
+constexpr const static llvm::StringLiteral kTileSizesAttrName =
+    "tpp.tile_sizes";
+
+// Machine parameters used by the blocking cost model.
+struct BlockingOptions {
+  // L1 and L2 data cache size in bytes (per core).
+  int64_t l1CacheSize = 32 * 1024;
+  int64_t l2CacheSize = 1024 * 1024;
+  // Number of threads sharing the parallel loops. 0 means OMP_NUM_THREADS if
+  // set, all the hardware threads of the host otherwise.
+  int64_t numThreads = 0;
+};
+
+// Return the blocking factors attached to `op` via `kBlockFactorsAttrName`.
+std::optional<SmallVector<int64_t>> getBlockingFactorsOverride(Operation *op);
+
+// Return the tile sizes attached to `op` via `kTileSizesAttrName`.
+std::optional<SmallVector<int64_t>> getTileSizesOverride(Operation *op);
+
+// Return the number of threads described by `options`.
+int64_t getNumThreads(const BlockingOptions &options);
+
+// Fraction of the threads doing useful work when `tasks` independent tasks of
+// equal cost are distributed over `numThreads`, i.e. `tasks` over the slots of
+// ceil(tasks / numThreads) full waves.
+double getLoadBalance(int64_t tasks, int64_t numThreads);
+
+// Select the blocking factors {i, j, k} for a linalg.matmul or
+// linalg.batch_matmul with static shape. The model picks, among the block
+// sizes evenly dividing each dimension, the pair (i, j) maximizing the
+// arithmetic intensity of the micro-kernel weighted by the load balance across
+// threads, then the largest k whose A and B blocks fit in L1. The k block is a
+// multiple of the VNNI factor for bf16.
+FailureOr<SmallVector<int64_t>>
+getMatmulBlockingFactors(linalg::LinalgOp linalgOp,
+                         const BlockingOptions &options = {});
+
+// Select the blocking factors {k, c} for a linalg.conv_2d_nhwc_hwcf or
+// linalg.conv_2d_nchw_fchw with static shape. The input and output channels
+// are blocked with the same factor, the BRGEMM rows are the output width.
+FailureOr<SmallVector<int64_t>>
+getConvBlockingFactors(linalg::LinalgOp linalgOp,
+                       const BlockingOptions &options = {});
+
+} // namespace utils
+} // namespace linalgx
+} // namespace mlir
+
+#endif
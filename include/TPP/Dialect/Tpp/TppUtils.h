@@ -40,6 +40,22 @@ bool hasCopySemantics(linalg::LinalgOp linalgOp);
 bool isTppAdd(linalg::GenericOp linalgOp,
               SmallVectorImpl<Value> *capturedOperands = nullptr);
 
+// Returns true if the linalg operation can convert to a tpp.mul.
+bool isTppMul(linalg::GenericOp linalgOp,
+              SmallVectorImpl<Value> *capturedOperands = nullptr);
+
+// Returns true if the linalg operation can convert to a tpp.sub.
+bool isTppSub(linalg::GenericOp linalgOp,
+              SmallVectorImpl<Value> *capturedOperands = nullptr);
+
+// Returns true if the linalg operation can convert to a tpp.div.
+bool isTppDiv(linalg::GenericOp linalgOp,
+              SmallVectorImpl<Value> *capturedOperands = nullptr);
+
+// Returns true if the linalg operation can convert to a tpp.max.
+bool isTppMax(linalg::GenericOp linalgOp,
+              SmallVectorImpl<Value> *capturedOperands = nullptr);
+
 // Returns true if the linalg.generic can convert to a tpp.identity.
 bool isTppIdentity(linalg::GenericOp linalgOp,
                    SmallVectorImpl<Value> *capturedOperands = nullptr);
@@ -52,6 +68,53 @@ bool isTppZero(linalg::GenericOp linalgOp,
 bool isTppRelu(linalg::GenericOp linalgOp,
                SmallVectorImpl<Value> *capturedOperands = nullptr);
 
+// Returns true if the linalg.generic can convert to a tpp.gelu.
+bool isTppGelu(linalg::GenericOp linalgOp,
+               SmallVectorImpl<Value> *capturedOperands = nullptr);
+
+// Returns true if the linalg.generic can convert to a tpp.tanh.
+bool isTppTanh(linalg::GenericOp linalgOp,
+               SmallVectorImpl<Value> *capturedOperands = nullptr);
+
+// Returns true if the linalg.generic can convert to a tpp.sigmoid.
+bool isTppSigmoid(linalg::GenericOp linalgOp,
+                  SmallVectorImpl<Value> *capturedOperands = nullptr);
+
+// Returns true if the linalg.generic can convert to a tpp.exp.
+bool isTppExp(linalg::GenericOp linalgOp,
+              SmallVectorImpl<Value> *capturedOperands = nullptr);
+
+// Returns true if the linalg operation can convert to a tpp.reduce_add. The
+// captured operands are the input and the init of the reduction.
+bool isTppReduceAdd(linalg::LinalgOp linalgOp,
+                    SmallVectorImpl<Value> *capturedOperands = nullptr);
+
+// Returns true if the linalg operation can convert to a tpp.reduce_max. The
+// captured operands are the input and the init of the reduction.
+bool isTppReduceMax(linalg::LinalgOp linalgOp,
+                    SmallVectorImpl<Value> *capturedOperands = nullptr);
+
+// Returns true if the linalg.generic is the division of a row-wise softmax,
+// exp(x) / sum(exp(x)), optionally stabilized by subtracting the row maximum
+// from x. The captured operands are x and the init of the division.
+bool isTppSoftmax(linalg::GenericOp linalgOp,
+                  SmallVectorImpl<Value> *capturedOperands = nullptr);
+
+// Returns true if the linalg.generic is the final shift of a row-wise layer
+// normalization, (x - mean(x)) * rsqrt(var(x) + epsilon) * gamma + beta, with
+// the mean and the variance computed by row sums. The captured operands are x,
+// gamma, beta and the init of the shift.
+bool isTppLayerNorm(linalg::GenericOp linalgOp,
+                    SmallVectorImpl<Value> *capturedOperands = nullptr,
+                    FloatAttr *epsilon = nullptr);
+
+// Returns true if the linalg.generic dequantizes an i32 accumulator,
+// sitofp(acc) * scale + bias, optionally followed by a relu. The captured
+// operands are the accumulator, scale, bias and the init.
+bool isTppDequantize(linalg::GenericOp linalgOp,
+                     SmallVectorImpl<Value> *capturedOperands = nullptr,
+                     bool *relu = nullptr);
+
 // Returns true if the linalg.generic can convert to a tpp.add + tpp.relu.
 bool isTppBiasRelu(linalg::GenericOp linalgOp,
                    SmallVectorImpl<Value> *capturedOperands = nullptr);
@@ -82,6 +145,9 @@ bool isValConstZero(Value val);
 // Returns true if the op defining `val` represents a zero filled tensor.
 bool isZeroTensor(Value val);
 
+// Returns true if `op` is a tpp.gemm or tpp.brgemm reading B transposed.
+bool hasTransposedB(Operation *op);
+
 // Splits and replaces fused op with its individual components.
 // Temporary workaround for:
 // https://github.com/libxsmm/libxsmm/issues/766
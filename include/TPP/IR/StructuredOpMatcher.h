@@ -131,6 +131,21 @@ struct HasStaticShape {
   }
 };
 
+// Callable object to verify if `operand` has a static innermost dimension.
+// Outer dimensions may be dynamic.
+struct HasStaticInnerDim {
+  HasStaticInnerDim() = default;
+
+  bool operator()(OpOperand *operand, Operation *op) const {
+    auto operandType = operand->get().getType();
+    if (auto shapedType = operandType.dyn_cast_or_null<ShapedType>())
+      if (shapedType.getRank() != 0 &&
+          ShapedType::isDynamic(shapedType.getShape().back()))
+        return false;
+    return true;
+  }
+};
+
 // Callable object to verify `operand` to have a rank in `ranks`.
 struct HasRank {
   HasRank() = delete;
@@ -88,10 +88,15 @@ std::unique_ptr<OperationPass<func::FuncOp>>
 createConvertLinalgToTppPass(bool, bool, ArrayRef<int64_t> tiles = {});
 std::unique_ptr<OperationPass<func::FuncOp>>
 createConvertTppToLoopsPass(bool parallel = false);
-std::unique_ptr<OperationPass<ModuleOp>> createConvertXsmmToFuncPass();
+std::unique_ptr<OperationPass<func::FuncOp>>
+createConvertNormalizationToTppPass();
+std::unique_ptr<OperationPass<ModuleOp>>
+createConvertXsmmToFuncPass(bool globalDispatchHandles = false);
+std::unique_ptr<OperationPass<ModuleOp>> createCombineXsmmDispatchPass();
 std::unique_ptr<OperationPass<func::FuncOp>> createConvertCheckToLoopsPass();
 std::unique_ptr<OperationPass<func::FuncOp>> createConvertVNNIToTppPass();
-std::unique_ptr<OperationPass<func::FuncOp>> createConvertTppToXsmmPass();
+std::unique_ptr<OperationPass<func::FuncOp>>
+createConvertTppToXsmmPass(bool prefetch = false, bool foldZeroInit = true);
 std::unique_ptr<OperationPass<ModuleOp>>
 createTransformDialectInterpreterPass();
 std::unique_ptr<OperationPass<func::FuncOp>> createConvertPerfToLoopsPass();
@@ -100,17 +105,21 @@ std::unique_ptr<OperationPass<func::FuncOp>> createCombineTppPass();
 std::unique_ptr<OperationPass<ModuleOp>> createTransformDropSchedulePass();
 std::unique_ptr<OperationPass<func::FuncOp>> createPackVNNIPass();
 std::unique_ptr<OperationPass<func::FuncOp>>
-createPackMatmulPass(ArrayRef<int64_t> blockingFactors = {});
+createPackMatmulPass(ArrayRef<int64_t> blockingFactors = {},
+                     bool autoBlock = false);
 std::unique_ptr<OperationPass<func::FuncOp>>
-createPackConv2DNchwFchwPass(ArrayRef<int64_t> blockingFactors = {});
+createPackConv2DNchwFchwPass(ArrayRef<int64_t> blockingFactors = {},
+                             bool autoBlock = false);
 std::unique_ptr<OperationPass<func::FuncOp>>
-createPackConv2DNhwcHwcfPass(ArrayRef<int64_t> blockingFactors = {});
+createPackConv2DNhwcHwcfPass(ArrayRef<int64_t> blockingFactors = {},
+                             bool autoBlock = false);
 std::unique_ptr<OperationPass<func::FuncOp>>
 createRewriteToBatchReduceGemmPass();
 std::unique_ptr<OperationPass<func::FuncOp>>
-createTileConsumerAndFuseProducersPass();
+createTileConsumerAndFuseProducersPass(bool threadAware = false,
+                                       int64_t numThreads = 0);
 std::unique_ptr<OperationPass<func::FuncOp>>
-createRewriteConvToMatmulOrBrgemmPass();
+createRewriteConvToMatmulOrBrgemmPass(bool enableBrgemm = false);
 std::unique_ptr<OperationPass<ModuleOp>>
 createDefaultTppPass(bool tppLoops = false, bool linalgLoops = false);
 std::unique_ptr<OperationPass<func::FuncOp>>
@@ -119,6 +128,9 @@ std::unique_ptr<OperationPass<func::FuncOp>> createPropagatePackUnPackPass();
 std::unique_ptr<OperationPass<ModuleOp>> createConstantFoldPackPass();
 std::unique_ptr<OperationPass<func::FuncOp>> createElementWiseFusionPass();
 std::unique_ptr<OperationPass<func::FuncOp>> createConvInitSimplifyPass();
+std::unique_ptr<OperationPass<func::FuncOp>> createFoldBatchNormPass();
+std::unique_ptr<OperationPass<func::FuncOp>>
+createApplyTuningDatabasePass(StringRef path = "");
 std::unique_ptr<OperationPass<ModuleOp>> createBufferizePass();
 std::unique_ptr<OperationPass<func::FuncOp>> createCleanupPass();
 std::unique_ptr<OperationPass<ModuleOp>> createTransformPass();
@@ -24,6 +24,10 @@ namespace linalg {
 class LinalgOp;
 } // namespace linalg
 
+namespace tensor {
+class PadOp;
+} // namespace tensor
+
 namespace linalgx {
 namespace utils {
 
@@ -70,6 +74,10 @@ bool validateFullTilesOnDims(TilingInterface tileOp,
                              ArrayRef<OpFoldResult> tiles,
                              ArrayRef<size_t> dims = {});
 
+// Return true if `padOp` pads with a constant zero, has static low and high
+// padding and pads only along `dims`.
+bool isZeroPaddingOnDims(tensor::PadOp padOp, ArrayRef<int64_t> dims);
+
 // Returns true if the linalg operation has a MulAdd region.
 bool hasMulAddBody(linalg::LinalgOp linalgOp,
                    SmallVectorImpl<Value> *capturedOperands = nullptr);
@@ -45,6 +45,20 @@ FailureOr<SmallVector<Value>> rewriteToBRGemmOp(RewriterBase &rewriter,
 FailureOr<linalg::MatmulOp> rewriteConvToMatmul(RewriterBase &rewriter,
                                                 linalg::LinalgOp linalgOp);
 
+// Rewrite a blocked convolution to a BRGEMM operation. The four innermost
+// loops must be [r, p, p, r], the outermost reduction is the batch-reduce
+// dimension (i.e., C'). Outer reductions (R and S) are materialized as loops,
+// strides and dilations are folded into the image slice.
+FailureOr<linalg::BatchReduceMatmulOp>
+rewriteConvToBRGemmOp(RewriterBase &rewriter, linalg::LinalgOp linalgOp);
+
+// Rewrite a blocked convolution, interchanged as for `rewriteConvToBRGemmOp`,
+// whose image is zero-padded on H and W. The BRGEMMs read the unpadded image:
+// filter taps that see only padding are skipped and boundary columns use a
+// smaller GEMM. On success the returned values are the materialized loops.
+FailureOr<SmallVector<Value>>
+rewritePaddedConvToBRGemmOp(RewriterBase &rewriter, linalg::LinalgOp linalgOp);
+
 // Attempt to block a Conv2DNchwFchwOp.
 FailureOr<linalg::GenericOp>
 packConv2DNchwFchwOp(RewriterBase &rewriter, linalg::Conv2DNchwFchwOp linalgOp,
@@ -63,6 +77,13 @@ FailureOr<linalg::GenericOp> packMatmulOp(RewriterBase &rewriter,
                                           linalg::BatchMatmulOp linalgOp,
                                           ArrayRef<OpFoldResult> tiles);
 
+// Split a MatmulOp whose dimensions are not multiple of `tiles` into a main
+// MatmulOp with full tiles only, returned, and smaller MatmulOps computing the
+// remainders.
+FailureOr<linalg::MatmulOp> peelMatmulOp(RewriterBase &rewriter,
+                                         linalg::MatmulOp matmulOp,
+                                         ArrayRef<int64_t> tiles);
+
 // Attempt to block a MatmulOp to VNNI format.
 FailureOr<linalg::GenericOp> packVNNIMatmulOp(RewriterBase &rewriter,
                                               linalg::GenericOp linalgOp);
@@ -80,8 +101,12 @@ collapseIterators(RewriterBase &rewriter, linalg::GenericOp genericOp,
 
 namespace tpp {
 void populateConvertLinalgToTppPatterns(RewritePatternSet &patterns);
+void populateConvertNormalizationToTppPatterns(
+    RewritePatternSet &patterns);
 void populateMapLinalgToTppPatterns(RewritePatternSet &patterns);
-void populateTppToXsmmPatterns(RewritePatternSet &patterns);
+void populateTppToXsmmPatterns(RewritePatternSet &patterns,
+                               bool prefetch = false,
+                               bool foldZeroInit = true);
 void populateXsmmToFuncPatterns(RewritePatternSet &patterns);
 void populateCheckToFuncPatterns(RewritePatternSet &patterns);
 void populateSinkPackPatterns(RewritePatternSet &patterns);
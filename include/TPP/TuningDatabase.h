@@ -0,0 +1,86 @@
+//===- TuningDatabase.h ------------------------------------------*- C++-*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef TPP_TUNINGDATABASE_H
+#define TPP_TUNINGDATABASE_H
+
+#include "mlir/Support/LogicalResult.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/ADT/StringRef.h"
+
+#include <optional>
+#include <string>
+
+namespace mlir {
+class Operation;
+
+namespace linalg {
+class LinalgOp;
+} // namespace linalg
+
+namespace tpp {
+
+// Best known configuration for an op.
+struct TuningEntry {
+  // Blocking factors for the packing passes (`tpp.block_factors`).
+  llvm::SmallVector<int64_t> blockingFactors;
+  // Tile sizes for TileConsumerAndFuseProducers (`tpp.tile_sizes`).
+  llvm::SmallVector<int64_t> tileSizes;
+  // Mean kernel time in seconds measured with this configuration.
+  double time = 0.0;
+};
+
+// Persistent map from (CPU, op) to the best configuration measured by the
+// tpp-run autotuner. Stored as JSON:
+//
+// {
+//   "skylake-avx512": {
+//     "linalg.matmul f32 1024x2560x1024": {
+//       "block-factors": [64, 128, 32], "tile-sizes": [1, 1], "time": 1.2e-3
+//     }
+//   }
+// }
+class TuningDatabase {
+public:
+  // Load the database at `path`. A missing file is an empty database.
+  static FailureOr<TuningDatabase> load(llvm::StringRef path,
+                                        std::string *errorMessage = nullptr);
+
+  // Write the database to `path`.
+  LogicalResult save(llvm::StringRef path,
+                     std::string *errorMessage = nullptr) const;
+
+  std::optional<TuningEntry> lookup(llvm::StringRef cpu,
+                                    llvm::StringRef key) const;
+
+  // Record `entry` unless a faster one is already known.
+  void insert(llvm::StringRef cpu, llvm::StringRef key,
+              const TuningEntry &entry);
+
+  bool empty() const { return entries.empty(); }
+
+private:
+  llvm::StringMap<llvm::StringMap<TuningEntry>> entries;
+};
+
+// Return the key of `linalgOp`: op name, element type and static loop ranges,
+// e.g. "linalg.matmul f32 1024x2560x1024". Fail for ops that cannot be tuned.
+FailureOr<std::string> getTuningKey(linalg::LinalgOp linalgOp);
+
+// Return the CPU name used to key the database on the host.
+std::string getHostCpuName();
+
+// Attach the configuration of `entry` to `op` as `tpp.block_factors` and
+// `tpp.tile_sizes`.
+void applyTuningEntry(Operation *op, const TuningEntry &entry);
+
+} // namespace tpp
+} // namespace mlir
+
+#endif
@@ -19,7 +19,7 @@ class MemRefType;
 namespace vnni {
 namespace utils {
 
-// Returns the VNNI blocking factor: 2 for BF16 and 4 for BF8.
+// Returns the VNNI blocking factor: 2 for BF16 and 4 for I8.
 std::optional<int64_t> getVnniBlockingFactor(Type type);
 
 // Return true if the memref is in VNNI layout.
@@ -0,0 +1,63 @@
+//===- ApplyTuningDatabase.cpp -----------------------------------*- C++-*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "TPP/BlockingFactors.h"
+#include "TPP/Passes.h"
+#include "TPP/TuningDatabase.h"
+#include "mlir/Dialect/Func/IR/FuncOps.h"
+#include "mlir/Dialect/Linalg/IR/Linalg.h"
+
+using namespace mlir;
+
+#define GEN_PASS_CLASSES
+#include "TPP/Passes.h.inc"
+
+namespace {
+
+// Annotate the ops found in the tuning database with their best known
+// blocking factors and tile sizes. Ops already carrying an override are left
+// untouched.
+struct ApplyTuningDatabase
+    : public ApplyTuningDatabaseBase<ApplyTuningDatabase> {
+  ApplyTuningDatabase() = default;
+  ApplyTuningDatabase(StringRef path) { this->path = path.str(); }
+
+  void runOnOperation() override {
+    if (path.empty())
+      return;
+
+    std::string errorMessage;
+    FailureOr<tpp::TuningDatabase> db =
+        tpp::TuningDatabase::load(path, &errorMessage);
+    if (failed(db)) {
+      getOperation().emitError(errorMessage);
+      return signalPassFailure();
+    }
+    if (db->empty())
+      return;
+
+    std::string cpuName = cpu.empty() ? tpp::getHostCpuName() : cpu.getValue();
+    getOperation()->walk([&](linalg::LinalgOp linalgOp) {
+      if (linalgOp->hasAttr(linalgx::utils::kBlockFactorsAttrName) ||
+          linalgOp->hasAttr(linalgx::utils::kTileSizesAttrName))
+        return;
+      FailureOr<std::string> key = tpp::getTuningKey(linalgOp);
+      if (failed(key))
+        return;
+      if (std::optional<tpp::TuningEntry> entry = db->lookup(cpuName, *key))
+        tpp::applyTuningEntry(linalgOp, *entry);
+    });
+  }
+};
+
+} // namespace
+
+std::unique_ptr<OperationPass<func::FuncOp>>
+mlir::tpp::createApplyTuningDatabasePass(StringRef path) {
+  return std::make_unique<ApplyTuningDatabase>(path);
+}
@@ -0,0 +1,212 @@
+//===- BlockingFactors.cpp ---------------------------------------*- C++-*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "TPP/BlockingFactors.h"
+#include "TPP/VNNIUtils.h"
+#include "mlir/Dialect/Linalg/IR/Linalg.h"
+#include "mlir/IR/BuiltinAttributes.h"
+#include "mlir/IR/TypeUtilities.h"
+#include "mlir/Support/MathExtras.h"
+#include "llvm/Support/Threading.h"
+
+#include <cstdlib>
+
+namespace mlir {
+namespace linalgx {
+namespace utils {
+
+// Block sizes considered by the model, largest first.
+static constexpr int64_t kCandidateBlocks[] = {256, 128, 96, 64, 48, 32, 24,
+                                               16,  8};
+// Largest block on the parallel (i, j) dimensions: bigger blocks do not
+// improve the micro-kernel and only hurt the load balance.
+static constexpr int64_t kMaxParallelBlock = 128;
+
+// Return the candidate blocks evenly dividing `dim`, multiple of `granule` and
+// not larger than `maxBlock`. A dimension smaller than every candidate is not
+// blocked, i.e., the block is the full dimension.
+static SmallVector<int64_t> getCandidateBlocks(int64_t dim, int64_t granule,
+                                               int64_t maxBlock) {
+  SmallVector<int64_t> blocks;
+  for (int64_t block : kCandidateBlocks) {
+    if (block <= maxBlock && block <= dim && dim % block == 0 &&
+        block % granule == 0)
+      blocks.push_back(block);
+  }
+  if (blocks.empty() && dim <= maxBlock && dim % granule == 0)
+    blocks.push_back(dim);
+  return blocks;
+}
+
+// The compiler and the kernels run in the same process with tpp-run: honor
+// OMP_NUM_THREADS if set.
+int64_t getNumThreads(const BlockingOptions &options) {
+  if (options.numThreads > 0)
+    return options.numThreads;
+  if (const char *ompThreads = std::getenv("OMP_NUM_THREADS")) {
+    int64_t numThreads = std::atoll(ompThreads);
+    if (numThreads > 0)
+      return numThreads;
+  }
+  return std::max<int64_t>(
+      1, llvm::hardware_concurrency().compute_thread_count());
+}
+
+double getLoadBalance(int64_t tasks, int64_t numThreads) {
+  int64_t waves = ceilDiv(tasks, numThreads);
+  return static_cast<double>(tasks) / static_cast<double>(waves * numThreads);
+}
+
+// Elements loaded per multiply-add of a [m x n] output block: the higher the
+// better.
+static double getIntensity(int64_t m, int64_t n) {
+  return static_cast<double>(m * n) / static_cast<double>(m + n);
+}
+
+static int64_t getElementSize(Type type) {
+  Type elementType = getElementTypeOrSelf(type);
+  return std::max<int64_t>(1, elementType.getIntOrFloatBitWidth() / 8);
+}
+
+static int64_t getVnniGranule(Type type) {
+  return vnni::utils::getVnniBlockingFactor(type).value_or(1);
+}
+
+// Largest k block such that the A [m x k] and B [k x n] blocks stay in L1.
+// Fall back to the smallest candidate if none fits.
+static int64_t selectKBlock(ArrayRef<int64_t> kBlocks, int64_t m, int64_t n,
+                            int64_t elementSize, int64_t l1CacheSize) {
+  for (int64_t k : kBlocks) {
+    if ((m * k + k * n) * elementSize <= l1CacheSize)
+      return k;
+  }
+  return kBlocks.back();
+}
+
+std::optional<SmallVector<int64_t>> getBlockingFactorsOverride(Operation *op) {
+  auto factors = op->getAttrOfType<DenseI64ArrayAttr>(kBlockFactorsAttrName);
+  if (!factors)
+    return std::nullopt;
+  return llvm::to_vector(factors.asArrayRef());
+}
+
+std::optional<SmallVector<int64_t>> getTileSizesOverride(Operation *op) {
+  auto tiles = op->getAttrOfType<DenseI64ArrayAttr>(kTileSizesAttrName);
+  if (!tiles)
+    return std::nullopt;
+  return llvm::to_vector(tiles.asArrayRef());
+}
+
+FailureOr<SmallVector<int64_t>>
+getMatmulBlockingFactors(linalg::LinalgOp linalgOp,
+                         const BlockingOptions &options) {
+  if (!isa<linalg::MatmulOp, linalg::BatchMatmulOp>(linalgOp))
+    return failure();
+  if (linalgOp.hasDynamicShape())
+    return failure();
+
+  // Loops are (i, j, k) for matmul and (b, i, j, k) for batch matmul.
+  SmallVector<int64_t> loopRanges = linalgOp.getStaticLoopRanges();
+  int64_t batch = 1;
+  if (isa<linalg::BatchMatmulOp>(linalgOp)) {
+    batch = loopRanges.front();
+    loopRanges.erase(loopRanges.begin());
+  }
+  int64_t dimI = loopRanges[0], dimJ = loopRanges[1], dimK = loopRanges[2];
+
+  Type inputType = linalgOp.getDpsInputOperand(0)->get().getType();
+  Type outputType = linalgOp.getDpsInitOperand(0)->get().getType();
+  int64_t inputSize = getElementSize(inputType);
+  int64_t outputSize = getElementSize(outputType);
+  int64_t numThreads = getNumThreads(options);
+
+  SmallVector<int64_t> iBlocks =
+      getCandidateBlocks(dimI, /*granule=*/1, kMaxParallelBlock);
+  SmallVector<int64_t> jBlocks =
+      getCandidateBlocks(dimJ, /*granule=*/1, kMaxParallelBlock);
+  SmallVector<int64_t> kBlocks = getCandidateBlocks(
+      dimK, getVnniGranule(inputType), /*maxBlock=*/dimK);
+  if (iBlocks.empty() || jBlocks.empty() || kBlocks.empty())
+    return failure();
+
+  SmallVector<int64_t> best;
+  double bestScore = -1.0;
+  for (int64_t i : iBlocks) {
+    for (int64_t j : jBlocks) {
+      int64_t k = selectKBlock(kBlocks, i, j, inputSize, options.l1CacheSize);
+      int64_t tasks = batch * (dimI / i) * (dimJ / j);
+      double score = getIntensity(i, j) * getLoadBalance(tasks, numThreads);
+      // The BRGEMM streams a [i x K] panel of A and a [K x j] panel of B
+      // against a resident [i x j] block of C: penalize spilling out of L2.
+      int64_t panels = (i * dimK + dimK * j) * inputSize + i * j * outputSize;
+      if (panels > options.l2CacheSize)
+        score /= 2;
+      // Prefer larger j (the vectorized dimension) on ties.
+      if (score > bestScore || (score == bestScore && j > best[1])) {
+        bestScore = score;
+        best = {i, j, k};
+      }
+    }
+  }
+  return best;
+}
+
+FailureOr<SmallVector<int64_t>>
+getConvBlockingFactors(linalg::LinalgOp linalgOp,
+                       const BlockingOptions &options) {
+  if (linalgOp.hasDynamicShape())
+    return failure();
+
+  // Loops are (n, p, q, k, r, s, c) for NHWC and (n, k, p, q, c, r, s) for
+  // NCHW.
+  SmallVector<int64_t> loopRanges = linalgOp.getStaticLoopRanges();
+  int64_t dimN, dimP, dimQ, dimK, dimC;
+  if (isa<linalg::Conv2DNhwcHwcfOp>(linalgOp)) {
+    dimN = loopRanges[0], dimP = loopRanges[1], dimQ = loopRanges[2];
+    dimK = loopRanges[3], dimC = loopRanges[6];
+  } else if (isa<linalg::Conv2DNchwFchwOp>(linalgOp)) {
+    dimN = loopRanges[0], dimK = loopRanges[1], dimP = loopRanges[2];
+    dimQ = loopRanges[3], dimC = loopRanges[4];
+  } else {
+    return failure();
+  }
+
+  Type inputType = linalgOp.getDpsInputOperand(0)->get().getType();
+  int64_t inputSize = getElementSize(inputType);
+  int64_t numThreads = getNumThreads(options);
+  int64_t granule = getVnniGranule(inputType);
+
+  // The packed image is blocked on C with the same factor as the output on K:
+  // a single block must divide both channels.
+  SmallVector<int64_t> blocks;
+  for (int64_t block : getCandidateBlocks(dimK, granule, kMaxParallelBlock)) {
+    if (dimC % block == 0)
+      blocks.push_back(block);
+  }
+  if (blocks.empty())
+    return failure();
+
+  int64_t best = 0;
+  double bestScore = -1.0;
+  for (int64_t block : blocks) {
+    // One BRGEMM computes a [Q x k] output row reducing over [C' x c].
+    double score = getIntensity(dimQ, block) *
+                   getLoadBalance(dimN * dimP * (dimK / block), numThreads);
+    if ((dimQ * block + block * block) * inputSize > options.l1CacheSize)
+      score /= 2;
+    if (score > bestScore) {
+      bestScore = score;
+      best = block;
+    }
+  }
+  return SmallVector<int64_t>{best, best};
+}
+
+} // namespace utils
+} // namespace linalgx
+} // namespace mlir
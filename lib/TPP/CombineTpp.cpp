@@ -7,9 +7,12 @@
 //===----------------------------------------------------------------------===//
 
 #include "TPP/Dialect/Tpp/TppOps.h"
+#include "TPP/Dialect/Tpp/TppUtils.h"
 #include "TPP/Passes.h"
 #include "mlir/Dialect/Func/IR/FuncOps.h"
 #include "mlir/Dialect/MemRef/IR/MemRef.h"
+#include "mlir/Dialect/Tensor/IR/Tensor.h"
+#include "mlir/Interfaces/SideEffectInterfaces.h"
 #include "mlir/Transforms/GreedyPatternRewriteDriver.h"
 
 using namespace mlir;
@@ -17,46 +20,195 @@ using namespace mlir;
 #define GEN_PASS_CLASSES
 #include "TPP/Passes.h.inc"
 
+// Return the first op before `op` in its block that may touch memory.
+static Operation *getPrevMemoryOp(Operation *op) {
+  for (Operation *prev = op->getPrevNode(); prev; prev = prev->getPrevNode()) {
+    if (!isMemoryEffectFree(prev) || prev->getNumRegions() != 0)
+      return prev;
+  }
+  return nullptr;
+}
+
+// Return the gemm-like op producing `operand` of `epilogue` if the epilogue can
+// be fused into it, nullptr otherwise. At tensor level the producer result must
+// only feed the epilogue. At memref level the epilogue must update the producer
+// output in place and be the next op touching memory after the producer.
+static tpp::TppOp getFusableProducer(tpp::TppOp epilogue, Value operand) {
+  tpp::TppOp producer = nullptr;
+  if (epilogue.hasTensorSemantics()) {
+    producer = operand.getDefiningOp<tpp::TppOp>();
+    if (!producer || !operand.hasOneUse() ||
+        operand.getType() != epilogue->getResult(0).getType())
+      return nullptr;
+  } else {
+    if (operand != epilogue.getOutput())
+      return nullptr;
+    producer = dyn_cast_or_null<tpp::TppOp>(getPrevMemoryOp(epilogue));
+    if (!producer || !producer.hasBufferSemantics() ||
+        producer.getOutput() != operand)
+      return nullptr;
+  }
+  if (!isa<tpp::GemmOp, tpp::BrgemmOp, tpp::FusedBrgemmOp>(producer))
+    return nullptr;
+  // tpp.fused_brgemm has no transposed B.
+  if (tpp::utils::hasTransposedB(producer))
+    return nullptr;
+  return producer;
+}
+
+// Return the type of `type` with a unit outer dimension prepended, or a null
+// type if the expanded memref layout cannot be computed.
+static Type getUnitBatchType(Type type,
+                             ArrayRef<ReassociationIndices> reassociation) {
+  auto shapedType = type.cast<ShapedType>();
+  SmallVector<int64_t> shape{1};
+  llvm::append_range(shape, shapedType.getShape());
+  if (auto memrefType = type.dyn_cast<MemRefType>()) {
+    FailureOr<MemRefType> expandedType =
+        memref::ExpandShapeOp::computeExpandedType(memrefType, shape,
+                                                   reassociation);
+    if (failed(expandedType))
+      return nullptr;
+    return *expandedType;
+  }
+  return RankedTensorType::get(shape, shapedType.getElementType());
+}
+
+// Return the reassociation prepending a unit dimension to a `rank` operand.
+static SmallVector<ReassociationIndices>
+getUnitBatchReassociation(int64_t rank) {
+  SmallVector<ReassociationIndices> reassociation{{0, 1}};
+  for (int64_t dim = 2; dim <= rank; dim++)
+    reassociation.push_back({dim});
+  return reassociation;
+}
+
+static Value expandToType(RewriterBase &rewriter, Location loc, Value operand,
+                          Type type,
+                          ArrayRef<ReassociationIndices> reassociation) {
+  if (type.isa<MemRefType>())
+    return rewriter.create<memref::ExpandShapeOp>(loc, type, operand,
+                                                  reassociation);
+  return rewriter.create<tensor::ExpandShapeOp>(loc, type, operand,
+                                                reassociation);
+}
+
+// Replace `producer` and `epilogue` with a single tpp.fused_brgemm. A tpp.gemm
+// producer is promoted to a brgemm with a unit batch.
+static LogicalResult fuseEpilogue(RewriterBase &rewriter, tpp::TppOp producer,
+                                  tpp::TppOp epilogue, Value bias,
+                                  tpp::FusedUnaryOpKind unaryKind,
+                                  tpp::FusedBinaryOpKind binaryKind) {
+  // Inputs are A, B and C for all the gemm-like ops, at both abstractions.
+  auto inputs = llvm::to_vector(producer->getOperands().take_front(3));
+  SmallVector<ReassociationIndices> reassociationA, reassociationB;
+  Type typeA = nullptr;
+  Type typeB = nullptr;
+  if (isa<tpp::GemmOp>(producer)) {
+    reassociationA = getUnitBatchReassociation(
+        inputs[0].getType().cast<ShapedType>().getRank());
+    reassociationB = getUnitBatchReassociation(
+        inputs[1].getType().cast<ShapedType>().getRank());
+    typeA = getUnitBatchType(inputs[0].getType(), reassociationA);
+    typeB = getUnitBatchType(inputs[1].getType(), reassociationB);
+    if (!typeA || !typeB)
+      return failure();
+  }
+
+  OpBuilder::InsertionGuard guard(rewriter);
+  rewriter.setInsertionPoint(epilogue);
+  Location loc = producer.getLoc();
+  if (typeA) {
+    inputs[0] = expandToType(rewriter, loc, inputs[0], typeA, reassociationA);
+    inputs[1] = expandToType(rewriter, loc, inputs[1], typeB, reassociationB);
+  }
+
+  auto ctx = rewriter.getContext();
+  auto unaryType = tpp::FusedUnaryOpKindAttr::get(ctx, unaryKind);
+  auto binaryType = tpp::FusedBinaryOpKindAttr::get(ctx, binaryKind);
+  if (epilogue.hasTensorSemantics()) {
+    rewriter.replaceOpWithNewOp<tpp::FusedBrgemmOp>(
+        epilogue, inputs, epilogue.getResultType(), bias, unaryType,
+        binaryType);
+  } else {
+    rewriter.create<tpp::FusedBrgemmOp>(loc, inputs, epilogue.getOutput(), bias,
+                                        unaryType, binaryType);
+    rewriter.eraseOp(epilogue);
+  }
+  rewriter.eraseOp(producer);
+  return success();
+}
+
 namespace {
 
-struct CombineBrgemmAddAndRelu : public OpRewritePattern<tpp::ReluOp> {
-  using OpRewritePattern<tpp::ReluOp>::OpRewritePattern;
+// Fuse a bias addition on a gemm-like op:
+// add(gemm(A, B, C), bias) -> fused_brgemm[unary = none, binary = add].
+struct CombineBrgemmAndAdd : public OpRewritePattern<tpp::AddOp> {
+  using OpRewritePattern<tpp::AddOp>::OpRewritePattern;
 
-  LogicalResult matchAndRewrite(tpp::ReluOp reluOp,
+  LogicalResult matchAndRewrite(tpp::AddOp addOp,
                                 PatternRewriter &rewriter) const override {
-    if (!reluOp.hasTensorSemantics())
-      return failure();
-    Value operandRelu = reluOp.getInputs()[0];
-    auto maybeAdd = operandRelu.getDefiningOp<tpp::AddOp>();
-    if (!maybeAdd)
+    ValueRange inputs = addOp.getInputs();
+    if (inputs.size() != 2)
       return failure();
-    SmallVector<Value> brgemmOperands;
-    Value addOperand;
-    bool hasBrgemmProducer = false;
-    for (Value operand : maybeAdd.getInputs()) {
-      if (auto brgemmOp = operand.getDefiningOp<tpp::BrgemmOp>()) {
-        brgemmOperands = brgemmOp.getInputs();
-        hasBrgemmProducer = true;
+    for (auto [idx, operand] : llvm::enumerate(inputs)) {
+      tpp::TppOp producer = getFusableProducer(addOp, operand);
+      if (!producer)
+        continue;
+      // The binary op runs before the unary one, fuse only once.
+      auto fusedOp = dyn_cast<tpp::FusedBrgemmOp>(producer.getOperation());
+      if (fusedOp &&
+          (fusedOp.getUnaryKind() != tpp::FusedUnaryOpKind::NONE ||
+           fusedOp.getBinaryKind() != tpp::FusedBinaryOpKind::NONE))
+        continue;
+      Value bias = inputs[1 - idx];
+      if (!bias.getType().isa<ShapedType>() || bias == operand)
         continue;
-      }
-      addOperand = operand;
+      return fuseEpilogue(rewriter, producer, addOp, bias,
+                          tpp::FusedUnaryOpKind::NONE,
+                          tpp::FusedBinaryOpKind::ADD);
     }
-    if (!hasBrgemmProducer)
-      return failure();
-    auto ctx = rewriter.getContext();
-    auto unaryType =
-        tpp::FusedUnaryOpKindAttr::get(ctx, tpp::FusedUnaryOpKind::RELU);
-    auto binaryType =
-        tpp::FusedBinaryOpKindAttr::get(ctx, tpp::FusedBinaryOpKind::ADD);
-    rewriter.replaceOpWithNewOp<tpp::FusedBrgemmOp>(
-        reluOp, brgemmOperands, brgemmOperands.back().getType(), addOperand,
-        unaryType, binaryType);
-    return success();
+    return rewriter.notifyMatchFailure(addOp, "Expect a fusable gemm operand");
+  }
+};
+
+// Fuse an element-wise unary op on a gemm-like op, keeping its bias addition
+// if any: relu(gemm(A, B, C)) -> fused_brgemm[unary = relu, binary = none].
+// Without a binary op the bias is ignored, C is passed in its place.
+template <typename OpTy, tpp::FusedUnaryOpKind unaryKind>
+struct CombineBrgemmAndUnary : public OpRewritePattern<OpTy> {
+  using OpRewritePattern<OpTy>::OpRewritePattern;
+
+  LogicalResult matchAndRewrite(OpTy unaryOp,
+                                PatternRewriter &rewriter) const override {
+    tpp::TppOp producer = getFusableProducer(unaryOp, unaryOp.getInputs()[0]);
+    if (!producer)
+      return rewriter.notifyMatchFailure(unaryOp,
+                                         "Expect a fusable gemm input");
+    Value bias = producer->getOperand(2);
+    auto binaryKind = tpp::FusedBinaryOpKind::NONE;
+    if (auto fusedOp = dyn_cast<tpp::FusedBrgemmOp>(producer.getOperation())) {
+      if (fusedOp.getUnaryKind() != tpp::FusedUnaryOpKind::NONE)
+        return rewriter.notifyMatchFailure(unaryOp, "Unary op already fused");
+      bias = fusedOp.getBiasOperand();
+      binaryKind = fusedOp.getBinaryKind();
+    }
+    return fuseEpilogue(rewriter, producer, unaryOp, bias, unaryKind,
+                        binaryKind);
   }
 };
 
 void populatePatterns(RewritePatternSet &patterns) {
-  patterns.add<CombineBrgemmAddAndRelu>(patterns.getContext());
+  // clang-format off
+  patterns.add<CombineBrgemmAndAdd,
+               CombineBrgemmAndUnary<tpp::ReluOp, tpp::FusedUnaryOpKind::RELU>,
+               CombineBrgemmAndUnary<tpp::GeluOp, tpp::FusedUnaryOpKind::GELU>,
+               CombineBrgemmAndUnary<tpp::TanhOp, tpp::FusedUnaryOpKind::TANH>,
+               CombineBrgemmAndUnary<tpp::SigmoidOp,
+                                     tpp::FusedUnaryOpKind::SIGMOID>,
+               CombineBrgemmAndUnary<tpp::ExpOp, tpp::FusedUnaryOpKind::EXP>>(
+      patterns.getContext());
+  // clang-format on
 }
 
 struct CombineTppOps : public CombineTppOpsBase<CombineTppOps> {
@@ -0,0 +1,102 @@
+//===- CombineXsmmDispatch.cpp -----------------------------------*- C++-*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "TPP/Dialect/Xsmm/XsmmOps.h"
+#include "TPP/Passes.h"
+#include "mlir/Dialect/Func/IR/FuncOps.h"
+#include "mlir/Dialect/SCF/IR/SCF.h"
+#include "llvm/ADT/DenseSet.h"
+
+using namespace mlir;
+using namespace mlir::xsmm;
+
+#define GEN_PASS_CLASSES
+#include "TPP/Passes.h.inc"
+
+namespace {
+
+// A dispatch without operands is fully described by its name and attributes:
+// it has no side effects.
+using DispatchKey = std::pair<OperationName, DictionaryAttr>;
+
+// Return true if `op` is a dispatch with static sizes only. Dispatches taking
+// sizes known at runtime stay next to the values they depend on.
+static bool isDispatchOp(Operation *op) {
+  return isa<GemmDispatchOp, BrgemmDispatchOp, GemmPrefetchDispatchOp,
+             BrgemmPrefetchDispatchOp, BrgemmOffsDispatchOp,
+             BrgemmAddrDispatchOp, FusedBrgemmDispatchOp, UnaryDispatchOp,
+             BinaryDispatchOp, TernaryDispatchOp>(op) &&
+         op->getNumOperands() == 0;
+}
+
+// Return true if `op` is only nested in loops and parallel regions below
+// `entryBlock`. Hoisting it then does not dispatch a kernel the function may
+// never use; dispatches under a conditional region stay in place.
+static bool isHoistable(Operation *op, Block &entryBlock) {
+  Operation *ancestor = op;
+  while (ancestor->getBlock() != &entryBlock) {
+    ancestor = ancestor->getParentOp();
+    if (!isa<scf::ForOp, scf::ParallelOp, scf::ForallOp>(ancestor))
+      return false;
+  }
+  return true;
+}
+
+struct CombineXsmmDispatch
+    : public CombineXsmmDispatchBase<CombineXsmmDispatch> {
+  void runOnOperation() override {
+    DenseSet<DispatchKey> kernels;
+
+    for (auto funcOp : getOperation().getOps<func::FuncOp>()) {
+      if (funcOp.isDeclaration())
+        continue;
+
+      SmallVector<Operation *> dispatchOps;
+      funcOp->walk([&](Operation *op) {
+        if (isDispatchOp(op))
+          dispatchOps.push_back(op);
+      });
+
+      // The first hoistable dispatch of each kernel, in program order,
+      // dominates all the following ones once it lives in the entry block.
+      // Leave it in place if it already does, otherwise move it right before
+      // its top-level ancestor, out of any loop or parallel region. Forward
+      // the following ones to it. A dispatch under a conditional region that
+      // comes before it is left alone.
+      Block &entryBlock = funcOp.getBody().front();
+      DenseMap<DispatchKey, Operation *> leaders;
+      for (Operation *op : dispatchOps) {
+        DispatchKey key = {op->getName(), op->getAttrDictionary()};
+        kernels.insert(key);
+        auto it = leaders.find(key);
+        if (it != leaders.end()) {
+          op->replaceAllUsesWith(it->second);
+          op->erase();
+          numCombinedDispatches++;
+          continue;
+        }
+        if (!isHoistable(op, entryBlock))
+          continue;
+        if (op->getBlock() != &entryBlock) {
+          op->moveBefore(entryBlock.findAncestorOpInBlock(*op));
+          numHoistedDispatches++;
+        }
+        leaders[key] = op;
+      }
+    }
+
+    numDistinctKernels = kernels.size();
+  }
+};
+
+} // namespace
+
+std::unique_ptr<OperationPass<ModuleOp>>
+mlir::tpp::createCombineXsmmDispatchPass() {
+  return std::make_unique<CombineXsmmDispatch>();
+}
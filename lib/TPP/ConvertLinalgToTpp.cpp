@@ -16,6 +16,8 @@
 #include "mlir/Dialect/Linalg/IR/Linalg.h"
 #include "mlir/Dialect/Linalg/Transforms/Transforms.h"
 #include "mlir/Dialect/Linalg/Utils/Utils.h"
+#include "mlir/Dialect/Tensor/IR/Tensor.h"
+#include "mlir/IR/Matchers.h"
 #include "mlir/Interfaces/ViewLikeInterface.h"
 #include "mlir/Transforms/GreedyPatternRewriteDriver.h"
 
@@ -29,6 +31,113 @@ using namespace mlir;
 
 namespace {
 
+// Tpp operations allow dynamic outer dimensions, the innermost one fixes the
+// leading dimensions and must be static.
+static bool hasStaticInnerDims(linalg::LinalgOp linalgOp) {
+  return llvm::all_of(linalgOp->getOperandTypes(), [](Type type) {
+    auto shapedType = type.dyn_cast<ShapedType>();
+    return !shapedType || shapedType.getRank() == 0 ||
+           !ShapedType::isDynamic(shapedType.getShape().back());
+  });
+}
+
+// Gemm-like tpp operations take float operands, or i8 inputs accumulating in
+// i32.
+static bool hasGemmLikeElementTypes(linalg::LinalgOp linalgOp) {
+  Type elementTypeA =
+      getElementTypeOrSelf(linalgOp.getDpsInputOperand(0)->get());
+  Type elementTypeB =
+      getElementTypeOrSelf(linalgOp.getDpsInputOperand(1)->get());
+  Type elementTypeC =
+      getElementTypeOrSelf(linalgOp.getDpsInitOperand(0)->get());
+  if (elementTypeA.isa<FloatType>() && elementTypeB.isa<FloatType>() &&
+      elementTypeC.isa<FloatType>())
+    return true;
+  return elementTypeA.isInteger(8) && elementTypeB.isInteger(8) &&
+         elementTypeC.isInteger(32);
+}
+
+// Return true if `val` is filled with the identity of a max reduction: -inf or
+// the lowest finite value.
+static bool isMaxIdentity(Value val) {
+  auto fillOp = val.getDefiningOp<linalg::FillOp>();
+  if (!fillOp)
+    return false;
+  FloatAttr attr;
+  if (!matchPattern(fillOp.getInputs()[0], m_Constant<FloatAttr>(&attr)))
+    return false;
+  APFloat value = attr.getValue();
+  APFloat lowest =
+      APFloat::getLargest(value.getSemantics(), /*Negative=*/true);
+  return (value.isInfinity() && value.isNegative()) ||
+         value.bitwiseIsEqual(lowest);
+}
+
+// Replace the reduction `linalgOp` of `input` into `init` with the tpp
+// reduction `ReduceOpTy`. Tpp reductions overwrite their output, `init` is
+// combined with the result using `CombineOpTy` unless it holds the identity of
+// the reduction. 1d outputs are computed on a 2d unit-dimension tensor.
+template <typename ReduceOpTy, typename CombineOpTy>
+static void rewriteToTppReduce(PatternRewriter &rewriter,
+                               linalg::LinalgOp linalgOp, Value input,
+                               Value init, bool isIdentityInit) {
+  Location loc = linalgOp.getLoc();
+  auto initType = init.getType().cast<RankedTensorType>();
+  RankedTensorType resultType = initType;
+  SmallVector<ReassociationIndices> reassociation = {{0, 1}};
+  if (initType.getRank() == 1) {
+    auto iteratorTypes = linalgOp.getIteratorTypesArray();
+    int64_t reductionDim =
+        iteratorTypes[0] == mlir::utils::IteratorType::reduction ? 0 : 1;
+    SmallVector<int64_t, 2> shape(2, 1);
+    shape[1 - reductionDim] = initType.getShape()[0];
+    resultType = RankedTensorType::get(shape, initType.getElementType());
+  }
+
+  Value result =
+      rewriter.create<ReduceOpTy>(loc, input, resultType).getResult(0);
+  if (!isIdentityInit) {
+    Value acc = init;
+    if (initType.getRank() == 1) {
+      acc = rewriter.create<tensor::ExpandShapeOp>(loc, resultType, init,
+                                                   reassociation);
+    }
+    result = rewriter
+                 .create<CombineOpTy>(loc, ValueRange{result, acc}, resultType)
+                 .getResult(0);
+  }
+  if (initType.getRank() == 1) {
+    result = rewriter.create<tensor::CollapseShapeOp>(loc, initType, result,
+                                                      reassociation);
+  }
+  rewriter.replaceOp(linalgOp, result);
+}
+
+// Convert a row or column reduction, either a linalg.generic or a
+// linalg.reduce, to a tpp reduction.
+static LogicalResult rewriteReductionToTpp(linalg::LinalgOp linalgOp,
+                                           PatternRewriter &rewriter) {
+  SmallVector<Value> operands;
+  if (tpp::utils::isTppReduceAdd(linalgOp, &operands)) {
+    assert(operands.size() == 2 && "tpp.reduce_add expects two operands");
+    rewriteToTppReduce<tpp::ReduceAddOp, tpp::AddOp>(
+        rewriter, linalgOp, operands[0], operands[1],
+        tpp::utils::isZeroTensor(operands[1]));
+    return success();
+  }
+
+  if (tpp::utils::isTppReduceMax(linalgOp, &operands)) {
+    assert(operands.size() == 2 && "tpp.reduce_max expects two operands");
+    rewriteToTppReduce<tpp::ReduceMaxOp, tpp::MaxOp>(
+        rewriter, linalgOp, operands[0], operands[1],
+        isMaxIdentity(operands[1]));
+    return success();
+  }
+
+  return rewriter.notifyMatchFailure(linalgOp,
+                                     "failed to match to a tpp reduction");
+}
+
 // Convert a linalg.generic to a tpp operation.
 struct ConvertGenericOpToTpp : public OpRewritePattern<linalg::GenericOp> {
   using OpRewritePattern<linalg::GenericOp>::OpRewritePattern;
@@ -57,6 +166,34 @@ struct ConvertGenericOpToTpp : public OpRewritePattern<linalg::GenericOp> {
       return success();
     }
 
+    if (tpp::utils::isTppGelu(linalgOp, &operands)) {
+      assert(operands.size() == 2 && "tpp.gelu expects two operands");
+      rewriter.replaceOpWithNewOp<tpp::GeluOp>(linalgOp, operands[0],
+                                               operands[1].getType());
+      return success();
+    }
+
+    if (tpp::utils::isTppTanh(linalgOp, &operands)) {
+      assert(operands.size() == 2 && "tpp.tanh expects two operands");
+      rewriter.replaceOpWithNewOp<tpp::TanhOp>(linalgOp, operands[0],
+                                               operands[1].getType());
+      return success();
+    }
+
+    if (tpp::utils::isTppSigmoid(linalgOp, &operands)) {
+      assert(operands.size() == 2 && "tpp.sigmoid expects two operands");
+      rewriter.replaceOpWithNewOp<tpp::SigmoidOp>(linalgOp, operands[0],
+                                                  operands[1].getType());
+      return success();
+    }
+
+    if (tpp::utils::isTppExp(linalgOp, &operands)) {
+      assert(operands.size() == 2 && "tpp.exp expects two operands");
+      rewriter.replaceOpWithNewOp<tpp::ExpOp>(linalgOp, operands[0],
+                                              operands[1].getType());
+      return success();
+    }
+
     if (tpp::utils::isTppAdd(linalgOp, &operands)) {
       assert(operands.size() == 3 && "tpp.add expects three operands");
       rewriter.replaceOpWithNewOp<tpp::AddOp>(
@@ -65,6 +202,41 @@ struct ConvertGenericOpToTpp : public OpRewritePattern<linalg::GenericOp> {
       return success();
     }
 
+    if (tpp::utils::isTppMul(linalgOp, &operands)) {
+      assert(operands.size() == 3 && "tpp.mul expects three operands");
+      rewriter.replaceOpWithNewOp<tpp::MulOp>(
+          linalgOp, ValueRange{operands[0], operands[1]},
+          operands[2].getType());
+      return success();
+    }
+
+    if (tpp::utils::isTppSub(linalgOp, &operands)) {
+      assert(operands.size() == 3 && "tpp.sub expects three operands");
+      rewriter.replaceOpWithNewOp<tpp::SubOp>(
+          linalgOp, ValueRange{operands[0], operands[1]},
+          operands[2].getType());
+      return success();
+    }
+
+    if (tpp::utils::isTppDiv(linalgOp, &operands)) {
+      assert(operands.size() == 3 && "tpp.div expects three operands");
+      rewriter.replaceOpWithNewOp<tpp::DivOp>(
+          linalgOp, ValueRange{operands[0], operands[1]},
+          operands[2].getType());
+      return success();
+    }
+
+    if (tpp::utils::isTppMax(linalgOp, &operands)) {
+      assert(operands.size() == 3 && "tpp.max expects three operands");
+      rewriter.replaceOpWithNewOp<tpp::MaxOp>(
+          linalgOp, ValueRange{operands[0], operands[1]},
+          operands[2].getType());
+      return success();
+    }
+
+    if (succeeded(rewriteReductionToTpp(linalgOp, rewriter)))
+      return success();
+
     if (tpp::utils::isTppBiasRelu(linalgOp, &operands)) {
       assert(operands.size() == 3 && "tpp.add+tpp.relu expects three operands");
       OpBuilder::InsertionGuard g(rewriter);
@@ -86,13 +258,29 @@ struct ConvertGenericOpToTpp : public OpRewritePattern<linalg::GenericOp> {
     if (!linalgOp.hasTensorSemantics())
       return rewriter.notifyMatchFailure(
           linalgOp, "Expect tensor type when mapping to tpp");
-    if (linalgOp.hasDynamicShape())
+    if (!hasStaticInnerDims(linalgOp))
       return rewriter.notifyMatchFailure(
-          linalgOp, "Expect static shape when mapping to tpp");
+          linalgOp, "Expect static innermost dimensions when mapping to tpp");
     return rewriteToTppOp(linalgOp, rewriter);
   }
 };
 
+// Convert a linalg.reduce to a tpp reduction.
+struct ConvertReduceToTpp : public OpRewritePattern<linalg::ReduceOp> {
+  using OpRewritePattern<linalg::ReduceOp>::OpRewritePattern;
+
+  LogicalResult matchAndRewrite(linalg::ReduceOp reduceOp,
+                                PatternRewriter &rewriter) const override {
+    if (!reduceOp.hasTensorSemantics())
+      return rewriter.notifyMatchFailure(
+          reduceOp, "Expect tensor type when mapping to tpp");
+    if (!hasStaticInnerDims(reduceOp))
+      return rewriter.notifyMatchFailure(
+          reduceOp, "Expect static innermost dimensions when mapping to tpp");
+    return rewriteReductionToTpp(reduceOp, rewriter);
+  }
+};
+
 // Convert a linalg.batch_reduce_matmul to a tpp.brgemm.
 struct ConvertBrgemmToTpp
     : public OpRewritePattern<linalg::BatchReduceMatmulOp> {
@@ -103,9 +291,12 @@ struct ConvertBrgemmToTpp
     if (!brMatmulOp.hasTensorSemantics())
       return rewriter.notifyMatchFailure(
           brMatmulOp, "Expect tensor type when mapping to tpp");
-    if (brMatmulOp.hasDynamicShape())
+    if (!hasStaticInnerDims(brMatmulOp))
       return rewriter.notifyMatchFailure(
-          brMatmulOp, "Expect static shape when mapping to tpp");
+          brMatmulOp, "Expect static innermost dimensions when mapping to tpp");
+    if (!hasGemmLikeElementTypes(brMatmulOp))
+      return rewriter.notifyMatchFailure(brMatmulOp,
+                                         "Unsupported element types");
     SmallVector<Value> inputs = brMatmulOp.getDpsInputOperands();
     inputs.push_back(brMatmulOp.getDpsInitOperands()[0]->get());
     SmallVector<Value> outputs = brMatmulOp.getDpsInitOperands();
@@ -124,9 +315,11 @@ struct ConvertMatmulToTpp : public OpRewritePattern<linalg::MatmulOp> {
     if (!matmulOp.hasTensorSemantics())
       return rewriter.notifyMatchFailure(
           matmulOp, "Expect tensor type when mapping to tpp");
-    if (matmulOp.hasDynamicShape())
+    if (!hasStaticInnerDims(matmulOp))
       return rewriter.notifyMatchFailure(
-          matmulOp, "Expect static shape when mapping to tpp");
+          matmulOp, "Expect static innermost dimensions when mapping to tpp");
+    if (!hasGemmLikeElementTypes(matmulOp))
+      return rewriter.notifyMatchFailure(matmulOp, "Unsupported element types");
     SmallVector<Value> inputs = matmulOp.getDpsInputOperands();
     inputs.push_back(matmulOp.getDpsInitOperands()[0]->get());
     SmallVector<Value> outputs = matmulOp.getDpsInitOperands();
@@ -136,6 +329,52 @@ struct ConvertMatmulToTpp : public OpRewritePattern<linalg::MatmulOp> {
   }
 };
 
+// Convert a matmul reading B transposed, i.e., linalg.matmul_transpose_b or
+// the equivalent linalg.generic, to a tpp.gemm with `transpose_b`. B is read
+// in place: no transposed copy is materialized.
+struct ConvertMatmulTransposeBToTpp
+    : public OpInterfaceRewritePattern<linalg::LinalgOp> {
+  using OpInterfaceRewritePattern<linalg::LinalgOp>::OpInterfaceRewritePattern;
+
+  LogicalResult matchAndRewrite(linalg::LinalgOp linalgOp,
+                                PatternRewriter &rewriter) const override {
+    if (!linalgOp.hasTensorSemantics())
+      return rewriter.notifyMatchFailure(
+          linalgOp, "Expect tensor type when mapping to tpp");
+    if (linalgOp.getNumDpsInputs() != 2 || linalgOp.getNumDpsInits() != 1 ||
+        linalgOp.getNumLoops() != 3 ||
+        !linalgx::utils::hasMulAddBody(linalgOp))
+      return rewriter.notifyMatchFailure(linalgOp, "Expect a matmul-like op");
+
+    // [i, j] += [i, k] * [j, k].
+    using MapList = ArrayRef<ArrayRef<AffineExpr>>;
+    AffineExpr i, j, k;
+    bindDims(linalgOp.getContext(), i, j, k);
+    SmallVector<AffineMap> expectedMaps =
+        AffineMap::inferFromExprList(MapList{{i, k}, {j, k}, {i, j}});
+    SmallVector<utils::IteratorType> iteratorTypes =
+        linalgOp.getIteratorTypesArray();
+    if (linalgOp.getIndexingMapsArray() != expectedMaps ||
+        !linalg::isParallelIterator(iteratorTypes[0]) ||
+        !linalg::isParallelIterator(iteratorTypes[1]) ||
+        !linalg::isReductionIterator(iteratorTypes[2]))
+      return rewriter.notifyMatchFailure(linalgOp,
+                                         "Expect B to be read transposed");
+    if (!hasStaticInnerDims(linalgOp))
+      return rewriter.notifyMatchFailure(
+          linalgOp, "Expect static innermost dimensions when mapping to tpp");
+    if (!hasGemmLikeElementTypes(linalgOp))
+      return rewriter.notifyMatchFailure(linalgOp, "Unsupported element types");
+    SmallVector<Value> inputs = linalgOp.getDpsInputOperands();
+    inputs.push_back(linalgOp.getDpsInitOperands()[0]->get());
+    SmallVector<Value> outputs = linalgOp.getDpsInitOperands();
+    rewriter.replaceOpWithNewOp<tpp::GemmOp>(linalgOp, inputs,
+                                             outputs[0].getType(),
+                                             /*transposeB=*/true);
+    return success();
+  }
+};
+
 // Convert a linalg.fill to a tpp.zero.
 struct ConvertFillToTpp : public OpRewritePattern<linalg::FillOp> {
   using OpRewritePattern<linalg::FillOp>::OpRewritePattern;
@@ -145,15 +384,17 @@ struct ConvertFillToTpp : public OpRewritePattern<linalg::FillOp> {
     if (!fillOp.hasTensorSemantics())
       return rewriter.notifyMatchFailure(
           fillOp, "Expect tensor type when mapping to tpp");
-    if (fillOp.hasDynamicShape())
+    if (!hasStaticInnerDims(fillOp))
       return rewriter.notifyMatchFailure(
-          fillOp, "Expect static shape when mapping to tpp");
+          fillOp, "Expect static innermost dimensions when mapping to tpp");
 
     auto inputs = fillOp.getInputs();
     if (!tpp::utils::isZeroTensor(inputs[0]))
       return rewriter.notifyMatchFailure(fillOp, "Unsupported fill type");
 
     auto output = fillOp.getOutputs()[0];
+    if (!getElementTypeOrSelf(output.getType()).isa<FloatType>())
+      return rewriter.notifyMatchFailure(fillOp, "Expect float type");
     auto outputRank = output.getType().cast<ShapedType>().getRank();
     if (outputRank != 2)
       return rewriter.notifyMatchFailure(fillOp, "Expect output rank 2");
@@ -163,6 +404,81 @@ struct ConvertFillToTpp : public OpRewritePattern<linalg::FillOp> {
   }
 };
 
+// Convert the linalg.generic dividing exp(x) by its row sums, and the chain
+// producing it, to a tpp.softmax.
+struct ConvertSoftmaxToTpp : public OpRewritePattern<linalg::GenericOp> {
+  using OpRewritePattern<linalg::GenericOp>::OpRewritePattern;
+
+  LogicalResult matchAndRewrite(linalg::GenericOp linalgOp,
+                                PatternRewriter &rewriter) const override {
+    if (!linalgOp.hasTensorSemantics())
+      return rewriter.notifyMatchFailure(
+          linalgOp, "Expect tensor type when mapping to tpp");
+    SmallVector<Value> operands;
+    if (!tpp::utils::isTppSoftmax(linalgOp, &operands))
+      return rewriter.notifyMatchFailure(linalgOp, "Not a softmax");
+    assert(operands.size() == 2 && "tpp.softmax expects two operands");
+    rewriter.replaceOpWithNewOp<tpp::SoftmaxOp>(linalgOp, operands[0],
+                                                operands[1].getType());
+    return success();
+  }
+};
+
+// Convert the linalg.generic shifting the normalized, scaled rows by beta, and
+// the chain producing it, to a tpp.layernorm.
+struct ConvertLayerNormToTpp : public OpRewritePattern<linalg::GenericOp> {
+  using OpRewritePattern<linalg::GenericOp>::OpRewritePattern;
+
+  LogicalResult matchAndRewrite(linalg::GenericOp linalgOp,
+                                PatternRewriter &rewriter) const override {
+    if (!linalgOp.hasTensorSemantics())
+      return rewriter.notifyMatchFailure(
+          linalgOp, "Expect tensor type when mapping to tpp");
+    SmallVector<Value> operands;
+    FloatAttr epsilon;
+    if (!tpp::utils::isTppLayerNorm(linalgOp, &operands, &epsilon))
+      return rewriter.notifyMatchFailure(linalgOp, "Not a layer norm");
+    assert(operands.size() == 4 && "tpp.layernorm expects four operands");
+    rewriter.replaceOpWithNewOp<tpp::LayerNormOp>(
+        linalgOp, ValueRange{operands[0], operands[1], operands[2]},
+        operands[3].getType(),
+        rewriter.getF32FloatAttr(epsilon.getValueAsDouble()));
+    return success();
+  }
+};
+
+// Convert the linalg.generic dequantizing an i32 accumulator to a
+// tpp.dequantize.
+struct ConvertDequantizeToTpp : public OpRewritePattern<linalg::GenericOp> {
+  using OpRewritePattern<linalg::GenericOp>::OpRewritePattern;
+
+  LogicalResult matchAndRewrite(linalg::GenericOp linalgOp,
+                                PatternRewriter &rewriter) const override {
+    if (!linalgOp.hasTensorSemantics())
+      return rewriter.notifyMatchFailure(
+          linalgOp, "Expect tensor type when mapping to tpp");
+    SmallVector<Value> operands;
+    bool relu = false;
+    if (!tpp::utils::isTppDequantize(linalgOp, &operands, &relu))
+      return rewriter.notifyMatchFailure(linalgOp, "Not a dequantization");
+    assert(operands.size() == 4 && "tpp.dequantize expects four operands");
+    rewriter.replaceOpWithNewOp<tpp::DequantizeOp>(
+        linalgOp, ValueRange{operands[0], operands[1], operands[2]},
+        operands[3].getType(), relu);
+    return success();
+  }
+};
+
+struct ConvertNormalizationToTppPass
+    : public ConvertNormalizationToTppBase<ConvertNormalizationToTppPass> {
+  ConvertNormalizationToTppPass() = default;
+  void runOnOperation() override {
+    RewritePatternSet patterns(getOperation().getContext());
+    tpp::populateConvertNormalizationToTppPatterns(patterns);
+    (void)applyPatternsAndFoldGreedily(getOperation(), std::move(patterns));
+  }
+};
+
 struct ConvertLinalgToTpp : public ConvertLinalgToTppBase<ConvertLinalgToTpp> {
   ConvertLinalgToTpp() = default;
   void runOnOperation() override {
@@ -181,13 +497,27 @@ void mlir::tpp::populateConvertLinalgToTppPatterns(
     RewritePatternSet &patterns) {
   // clang-format off
   patterns.add<ConvertGenericOpToTpp,
+               ConvertReduceToTpp,
                ConvertBrgemmToTpp,
                ConvertMatmulToTpp,
-               ConvertFillToTpp>(patterns.getContext());
+               ConvertMatmulTransposeBToTpp,
+               ConvertFillToTpp,
+               ConvertDequantizeToTpp>(patterns.getContext());
   // clang-format on
 }
 
+void mlir::tpp::populateConvertNormalizationToTppPatterns(
+    RewritePatternSet &patterns) {
+  patterns.add<ConvertSoftmaxToTpp, ConvertLayerNormToTpp>(
+      patterns.getContext());
+}
+
 std::unique_ptr<OperationPass<func::FuncOp>>
 mlir::tpp::createConvertLinalgToTppPass() {
   return std::make_unique<ConvertLinalgToTpp>();
 }
+
+std::unique_ptr<OperationPass<func::FuncOp>>
+mlir::tpp::createConvertNormalizationToTppPass() {
+  return std::make_unique<ConvertNormalizationToTppPass>();
+}
@@ -11,9 +11,12 @@
 #include "TPP/Passes.h"
 #include "mlir/Dialect/Arith/IR/Arith.h"
 #include "mlir/Dialect/Func/IR/FuncOps.h"
+#include "mlir/Dialect/Math/IR/Math.h"
 #include "mlir/Dialect/MemRef/IR/MemRef.h"
 #include "mlir/Dialect/SCF/IR/SCF.h"
 #include "mlir/Transforms/GreedyPatternRewriteDriver.h"
+#include "llvm/ADT/TypeSwitch.h"
+#include "llvm/Support/MathExtras.h"
 
 using namespace mlir;
 using namespace mlir::tpp;
@@ -23,29 +26,80 @@ using namespace mlir::tpp;
 
 namespace {
 
-// Convert tpp.add to SCF loops.
-struct ConvertTppAddOp : public OpRewritePattern<AddOp> {
-  using OpRewritePattern<AddOp>::OpRewritePattern;
+// Return the size of dimension `dim` of the memref `value` as an index. Outer
+// dimensions of tpp operands may be dynamic.
+static Value getDimSize(OpBuilder &builder, Location loc, Value value,
+                        int64_t dim) {
+  auto memref = value.getType().cast<MemRefType>();
+  if (memref.isDynamicDim(dim))
+    return builder.create<memref::DimOp>(loc, value, dim);
+  return builder.create<arith::ConstantIndexOp>(loc, memref.getShape()[dim]);
+}
 
-  ConvertTppAddOp(MLIRContext *ctx, bool parallel)
-      : OpRewritePattern(ctx), parallel(parallel) {}
+// Load the element of the binary operand `operand` at `localIvs`. Follow the
+// broadcast rules of `BroadcastableShape`: a scalar is used as is, the shape
+// of a memref is right-aligned against the iteration space and dimensions of
+// size 1 are indexed at zero.
+static Value loadBroadcastOperand(OpBuilder &b, Location loc, Value operand,
+                                  ValueRange localIvs) {
+  auto memrefType = operand.getType().dyn_cast<MemRefType>();
+  if (!memrefType)
+    return operand;
+  ArrayRef<int64_t> shapeOperand = memrefType.getShape();
+  assert(shapeOperand.size() <= localIvs.size() && "Expect broadcastable");
+  SmallVector<Value, 2> operandIvs =
+      llvm::to_vector<2>(localIvs.take_back(shapeOperand.size()));
+  for (size_t idx = 0; idx < shapeOperand.size(); idx++) {
+    if (shapeOperand[idx] == 1)
+      operandIvs[idx] = b.create<arith::ConstantIndexOp>(loc, 0);
+  }
+  return b.create<memref::LoadOp>(loc, operand, operandIvs);
+}
 
-  LogicalResult matchAndRewrite(AddOp addOp,
+// Convert the element-wise tpp binary operations tpp.add, tpp.mul, tpp.sub,
+// tpp.div and tpp.max to SCF loops.
+template <typename OpTy>
+struct ConvertTppEltwiseBinaryOp : public OpRewritePattern<OpTy> {
+  using OpRewritePattern<OpTy>::OpRewritePattern;
+
+  ConvertTppEltwiseBinaryOp(MLIRContext *ctx, bool parallel)
+      : OpRewritePattern<OpTy>(ctx), parallel(parallel) {}
+
+  // Return the scalar computation of `op` on `lhs` and `rhs`.
+  static Value buildScalarOp(OpBuilder &b, Location loc, Operation *op,
+                             Value lhs, Value rhs) {
+    return TypeSwitch<Operation *, Value>(op)
+        .Case([&](AddOp) -> Value {
+          return b.create<arith::AddFOp>(loc, lhs, rhs);
+        })
+        .Case([&](MulOp) -> Value {
+          return b.create<arith::MulFOp>(loc, lhs, rhs);
+        })
+        .Case([&](SubOp) -> Value {
+          return b.create<arith::SubFOp>(loc, lhs, rhs);
+        })
+        .Case([&](DivOp) -> Value {
+          return b.create<arith::DivFOp>(loc, lhs, rhs);
+        })
+        .Case([&](MaxOp) -> Value {
+          return b.create<arith::MaxFOp>(loc, lhs, rhs);
+        });
+  }
+
+  LogicalResult matchAndRewrite(OpTy binaryOp,
                                 PatternRewriter &rewriter) const override {
-    if (!addOp.hasBufferSemantics())
+    if (!binaryOp.hasBufferSemantics())
       return rewriter.notifyMatchFailure(
-          addOp, "Tpp loop lowering expects memref type");
+          binaryOp, "Tpp loop lowering expects memref type");
 
-    Location loc = addOp.getLoc();
+    Location loc = binaryOp.getLoc();
 
+    // Iterate over the output, the inputs may be broadcasted.
+    Value output = binaryOp.getOutput();
     SmallVector<Value> ubs;
-    size_t rank = addOp.getInputs()[0].getType().cast<MemRefType>().getRank();
-    for (size_t idx = 0; idx < rank; idx++) {
-      Value dim = rewriter.create<arith::ConstantIndexOp>(
-          loc,
-          addOp.getInputs()[0].getType().cast<MemRefType>().getShape()[idx]);
-      ubs.push_back(dim);
-    }
+    size_t rank = output.getType().cast<MemRefType>().getRank();
+    for (size_t idx = 0; idx < rank; idx++)
+      ubs.push_back(getDimSize(rewriter, loc, output, idx));
     Value zero = rewriter.create<arith::ConstantIndexOp>(loc, 0);
     SmallVector<Value> lbs(rank, zero);
     Value one = rewriter.create<arith::ConstantIndexOp>(loc, 1);
@@ -53,11 +107,12 @@ struct ConvertTppAddOp : public OpRewritePattern<AddOp> {
 
     auto bodyBuilder = [&](OpBuilder &b, Location loc, ValueRange localIvs) {
       Value scalarLhs =
-          b.create<memref::LoadOp>(loc, addOp.getInputs()[0], localIvs);
+          loadBroadcastOperand(b, loc, binaryOp.getInputs()[0], localIvs);
       Value scalarRhs =
-          b.create<memref::LoadOp>(loc, addOp.getInputs()[1], localIvs);
-      Value addLhsAndRhs = b.create<arith::AddFOp>(loc, scalarLhs, scalarRhs);
-      b.create<memref::StoreOp>(loc, addLhsAndRhs, addOp.getOutput(), localIvs);
+          loadBroadcastOperand(b, loc, binaryOp.getInputs()[1], localIvs);
+      Value scalarResult =
+          buildScalarOp(b, loc, binaryOp, scalarLhs, scalarRhs);
+      b.create<memref::StoreOp>(loc, scalarResult, output, localIvs);
     };
 
     if (parallel)
@@ -65,7 +120,7 @@ struct ConvertTppAddOp : public OpRewritePattern<AddOp> {
     else
       (void)scf::buildLoopNest(rewriter, loc, lbs, ubs, steps, bodyBuilder);
 
-    rewriter.eraseOp(addOp);
+    rewriter.eraseOp(binaryOp);
     return success();
   }
 
@@ -83,12 +138,8 @@ void buildUnaryLoop(
 
   SmallVector<Value> ubs;
   size_t rank = tppOp.getOutput().getType().cast<MemRefType>().getRank();
-  ArrayRef<int64_t> shapeOutput =
-      tppOp.getOutput().getType().cast<MemRefType>().getShape();
-  for (size_t idx = 0; idx < rank; idx++) {
-    Value dim = rewriter.create<arith::ConstantIndexOp>(loc, shapeOutput[idx]);
-    ubs.push_back(dim);
-  }
+  for (size_t idx = 0; idx < rank; idx++)
+    ubs.push_back(getDimSize(rewriter, loc, tppOp.getOutput(), idx));
 
   Value zero = rewriter.create<arith::ConstantIndexOp>(loc, 0);
   SmallVector<Value> lbs(rank, zero);
@@ -101,6 +152,417 @@ void buildUnaryLoop(
     (void)scf::buildLoopNest(rewriter, loc, lbs, ubs, steps, bodyBuilder);
 }
 
+// Convert the element-wise tpp unary operations tpp.gelu, tpp.tanh,
+// tpp.sigmoid and tpp.exp to SCF loops.
+template <typename OpTy>
+struct ConvertTppEltwiseUnaryOp : public OpRewritePattern<OpTy> {
+  using OpRewritePattern<OpTy>::OpRewritePattern;
+
+  ConvertTppEltwiseUnaryOp(MLIRContext *ctx, bool parallel)
+      : OpRewritePattern<OpTy>(ctx), parallel(parallel) {}
+
+  // Return the scalar computation of `op` on `x`.
+  static Value buildScalarOp(OpBuilder &b, Location loc, Operation *op,
+                             Value x) {
+    auto getConstant = [&](double value) -> Value {
+      return b.create<arith::ConstantOp>(
+          loc, x.getType(), b.getFloatAttr(x.getType(), value));
+    };
+    return TypeSwitch<Operation *, Value>(op)
+        .Case([&](GeluOp) -> Value {
+          // 0.5 * x * (1 + erf(x / sqrt(2)))
+          Value scaled = b.create<arith::MulFOp>(
+              loc, x, getConstant(llvm::numbers::inv_sqrt2));
+          Value erf = b.create<math::ErfOp>(loc, scaled);
+          Value erfPlusOne =
+              b.create<arith::AddFOp>(loc, erf, getConstant(1.0));
+          Value halfX = b.create<arith::MulFOp>(loc, x, getConstant(0.5));
+          return b.create<arith::MulFOp>(loc, halfX, erfPlusOne);
+        })
+        .Case([&](TanhOp) -> Value { return b.create<math::TanhOp>(loc, x); })
+        .Case([&](SigmoidOp) -> Value {
+          // 1 / (1 + exp(-x))
+          Value negX = b.create<arith::NegFOp>(loc, x);
+          Value exp = b.create<math::ExpOp>(loc, negX);
+          Value expPlusOne =
+              b.create<arith::AddFOp>(loc, exp, getConstant(1.0));
+          return b.create<arith::DivFOp>(loc, getConstant(1.0), expPlusOne);
+        })
+        .Case([&](ExpOp) -> Value { return b.create<math::ExpOp>(loc, x); });
+  }
+
+  LogicalResult matchAndRewrite(OpTy unaryOp,
+                                PatternRewriter &rewriter) const override {
+    if (!unaryOp.hasBufferSemantics())
+      return rewriter.notifyMatchFailure(
+          unaryOp, "Tpp loop lowering expects memref type");
+
+    auto bodyBuilder = [&](OpBuilder &b, Location loc, ValueRange localIvs) {
+      Value scalarInput =
+          b.create<memref::LoadOp>(loc, unaryOp.getInputs()[0], localIvs);
+      Value scalarResult = buildScalarOp(b, loc, unaryOp, scalarInput);
+      b.create<memref::StoreOp>(loc, scalarResult, unaryOp.getOutput(),
+                                localIvs);
+    };
+    buildUnaryLoop(rewriter, unaryOp, bodyBuilder, parallel);
+
+    rewriter.eraseOp(unaryOp);
+    return success();
+  }
+
+private:
+  bool parallel;
+};
+
+// Convert the tpp reductions tpp.reduce_add and tpp.reduce_max to SCF loops.
+// The outer loop walks the dimension kept by the reduction, the inner loop
+// accumulates the reduced dimension starting from the identity element.
+template <typename OpTy>
+struct ConvertTppReduceOp : public OpRewritePattern<OpTy> {
+  using OpRewritePattern<OpTy>::OpRewritePattern;
+
+  ConvertTppReduceOp(MLIRContext *ctx, bool parallel)
+      : OpRewritePattern<OpTy>(ctx), parallel(parallel) {}
+
+  // Return the identity element of the reduction `op`.
+  static Value buildIdentity(OpBuilder &b, Location loc, Operation *op,
+                             FloatType elementType) {
+    APFloat identity =
+        isa<ReduceMaxOp>(op)
+            ? APFloat::getInf(elementType.getFloatSemantics(),
+                              /*Negative=*/true)
+            : APFloat::getZero(elementType.getFloatSemantics());
+    return b.create<arith::ConstantOp>(
+        loc, elementType, b.getFloatAttr(elementType, identity));
+  }
+
+  // Return the combination of the accumulator `acc` with `x`.
+  static Value buildScalarOp(OpBuilder &b, Location loc, Operation *op,
+                             Value acc, Value x) {
+    return TypeSwitch<Operation *, Value>(op)
+        .Case([&](ReduceAddOp) -> Value {
+          return b.create<arith::AddFOp>(loc, acc, x);
+        })
+        .Case([&](ReduceMaxOp) -> Value {
+          return b.create<arith::MaxFOp>(loc, acc, x);
+        });
+  }
+
+  LogicalResult matchAndRewrite(OpTy reduceOp,
+                                PatternRewriter &rewriter) const override {
+    if (!reduceOp.hasBufferSemantics())
+      return rewriter.notifyMatchFailure(
+          reduceOp, "Tpp loop lowering expects memref type");
+
+    Location loc = reduceOp.getLoc();
+    Value input = reduceOp.getInputs()[0];
+    Value output = reduceOp.getOutput();
+    auto elementType = input.getType()
+                           .template cast<MemRefType>()
+                           .getElementType()
+                           .template dyn_cast<FloatType>();
+    if (!elementType)
+      return rewriter.notifyMatchFailure(reduceOp, "expect a float type");
+
+    int64_t reductionDim = reduceOp.getReductionDim();
+    int64_t keptDim = 1 - reductionDim;
+    Value zero = rewriter.create<arith::ConstantIndexOp>(loc, 0);
+    Value one = rewriter.create<arith::ConstantIndexOp>(loc, 1);
+    Value keptSize = getDimSize(rewriter, loc, input, keptDim);
+    Value reducedSize = getDimSize(rewriter, loc, input, reductionDim);
+    Value identity = buildIdentity(rewriter, loc, reduceOp, elementType);
+
+    auto bodyBuilder = [&](OpBuilder &b, Location loc, ValueRange localIvs) {
+      auto innerLoop = b.create<scf::ForOp>(
+          loc, zero, reducedSize, one, ValueRange{identity},
+          [&](OpBuilder &nestedBuilder, Location nestedLoc, Value iv,
+              ValueRange iterArgs) {
+            SmallVector<Value, 2> inputIvs(2);
+            inputIvs[keptDim] = localIvs[0];
+            inputIvs[reductionDim] = iv;
+            Value scalarInput = nestedBuilder.create<memref::LoadOp>(
+                nestedLoc, input, inputIvs);
+            Value acc = buildScalarOp(nestedBuilder, nestedLoc, reduceOp,
+                                      iterArgs[0], scalarInput);
+            nestedBuilder.create<scf::YieldOp>(nestedLoc, acc);
+          });
+      SmallVector<Value, 2> outputIvs(2);
+      outputIvs[keptDim] = localIvs[0];
+      outputIvs[reductionDim] = zero;
+      b.create<memref::StoreOp>(loc, innerLoop.getResult(0), output,
+                                outputIvs);
+    };
+    if (parallel) {
+      rewriter.create<scf::ParallelOp>(loc, ValueRange{zero},
+                                       ValueRange{keptSize}, ValueRange{one},
+                                       bodyBuilder);
+    } else {
+      (void)scf::buildLoopNest(rewriter, loc, ValueRange{zero},
+                               ValueRange{keptSize}, ValueRange{one},
+                               bodyBuilder);
+    }
+
+    rewriter.eraseOp(reduceOp);
+    return success();
+  }
+
+private:
+  bool parallel;
+};
+
+// Convert tpp.softmax to SCF loops. Each row is handled in three passes over
+// its elements: the row maximum, the shifted exponentials written to the
+// output together with their sum, and the normalization by the sum.
+struct ConvertTppSoftmaxOp : public OpRewritePattern<SoftmaxOp> {
+  using OpRewritePattern<SoftmaxOp>::OpRewritePattern;
+
+  ConvertTppSoftmaxOp(MLIRContext *ctx, bool parallel)
+      : OpRewritePattern<SoftmaxOp>(ctx), parallel(parallel) {}
+
+  LogicalResult matchAndRewrite(SoftmaxOp softmaxOp,
+                                PatternRewriter &rewriter) const override {
+    if (!softmaxOp.hasBufferSemantics())
+      return rewriter.notifyMatchFailure(
+          softmaxOp, "Tpp loop lowering expects memref type");
+
+    Location loc = softmaxOp.getLoc();
+    Value input = softmaxOp.getInputs()[0];
+    Value output = softmaxOp.getOutput();
+    auto elementType = softmaxOp.getOutputType()
+                           .getElementType()
+                           .dyn_cast<FloatType>();
+    if (!elementType)
+      return rewriter.notifyMatchFailure(softmaxOp, "expect a float type");
+
+    Value zero = rewriter.create<arith::ConstantIndexOp>(loc, 0);
+    Value one = rewriter.create<arith::ConstantIndexOp>(loc, 1);
+    Value rows = getDimSize(rewriter, loc, output, 0);
+    Value cols = getDimSize(rewriter, loc, output, 1);
+    auto getConstant = [&](const APFloat &value) -> Value {
+      return rewriter.create<arith::ConstantOp>(
+          loc, elementType, rewriter.getFloatAttr(elementType, value));
+    };
+    const llvm::fltSemantics &semantics = elementType.getFloatSemantics();
+    Value minusInf = getConstant(APFloat::getInf(semantics, /*Negative=*/true));
+    Value zeroFloat = getConstant(APFloat::getZero(semantics));
+
+    auto bodyBuilder = [&](OpBuilder &b, Location loc, ValueRange localIvs) {
+      Value row = localIvs[0];
+      auto maxLoop = b.create<scf::ForOp>(
+          loc, zero, cols, one, ValueRange{minusInf},
+          [&](OpBuilder &nestedBuilder, Location nestedLoc, Value iv,
+              ValueRange iterArgs) {
+            Value x = nestedBuilder.create<memref::LoadOp>(
+                nestedLoc, input, ValueRange{row, iv});
+            Value max =
+                nestedBuilder.create<arith::MaxFOp>(nestedLoc, iterArgs[0], x);
+            nestedBuilder.create<scf::YieldOp>(nestedLoc, max);
+          });
+      auto sumLoop = b.create<scf::ForOp>(
+          loc, zero, cols, one, ValueRange{zeroFloat},
+          [&](OpBuilder &nestedBuilder, Location nestedLoc, Value iv,
+              ValueRange iterArgs) {
+            Value x = nestedBuilder.create<memref::LoadOp>(
+                nestedLoc, input, ValueRange{row, iv});
+            Value shifted = nestedBuilder.create<arith::SubFOp>(
+                nestedLoc, x, maxLoop.getResult(0));
+            Value exp = nestedBuilder.create<math::ExpOp>(nestedLoc, shifted);
+            nestedBuilder.create<memref::StoreOp>(nestedLoc, exp, output,
+                                                  ValueRange{row, iv});
+            Value sum = nestedBuilder.create<arith::AddFOp>(
+                nestedLoc, iterArgs[0], exp);
+            nestedBuilder.create<scf::YieldOp>(nestedLoc, sum);
+          });
+      b.create<scf::ForOp>(
+          loc, zero, cols, one, std::nullopt,
+          [&](OpBuilder &nestedBuilder, Location nestedLoc, Value iv,
+              ValueRange iterArgs) {
+            Value exp = nestedBuilder.create<memref::LoadOp>(
+                nestedLoc, output, ValueRange{row, iv});
+            Value div = nestedBuilder.create<arith::DivFOp>(
+                nestedLoc, exp, sumLoop.getResult(0));
+            nestedBuilder.create<memref::StoreOp>(nestedLoc, div, output,
+                                                  ValueRange{row, iv});
+            nestedBuilder.create<scf::YieldOp>(nestedLoc);
+          });
+    };
+    if (parallel) {
+      rewriter.create<scf::ParallelOp>(loc, ValueRange{zero}, ValueRange{rows},
+                                       ValueRange{one}, bodyBuilder);
+    } else {
+      (void)scf::buildLoopNest(rewriter, loc, ValueRange{zero},
+                               ValueRange{rows}, ValueRange{one}, bodyBuilder);
+    }
+
+    rewriter.eraseOp(softmaxOp);
+    return success();
+  }
+
+private:
+  bool parallel;
+};
+
+// Convert tpp.layernorm to SCF loops. Each row is handled in three passes over
+// its elements: the mean, the variance around the mean, and the normalized,
+// scaled and shifted output.
+struct ConvertTppLayerNormOp : public OpRewritePattern<LayerNormOp> {
+  using OpRewritePattern<LayerNormOp>::OpRewritePattern;
+
+  ConvertTppLayerNormOp(MLIRContext *ctx, bool parallel)
+      : OpRewritePattern<LayerNormOp>(ctx), parallel(parallel) {}
+
+  LogicalResult matchAndRewrite(LayerNormOp layerNormOp,
+                                PatternRewriter &rewriter) const override {
+    if (!layerNormOp.hasBufferSemantics())
+      return rewriter.notifyMatchFailure(
+          layerNormOp, "Tpp loop lowering expects memref type");
+
+    Location loc = layerNormOp.getLoc();
+    Value input = layerNormOp.getInputs()[0];
+    Value gamma = layerNormOp.getInputs()[1];
+    Value beta = layerNormOp.getInputs()[2];
+    Value output = layerNormOp.getOutput();
+    auto elementType = layerNormOp.getOutputType()
+                           .getElementType()
+                           .dyn_cast<FloatType>();
+    if (!elementType)
+      return rewriter.notifyMatchFailure(layerNormOp, "expect a float type");
+
+    Value zero = rewriter.create<arith::ConstantIndexOp>(loc, 0);
+    Value one = rewriter.create<arith::ConstantIndexOp>(loc, 1);
+    Value rows = getDimSize(rewriter, loc, output, 0);
+    Value cols = getDimSize(rewriter, loc, output, 1);
+    int64_t numCols = layerNormOp.getOutputType().getShape()[1];
+    auto getConstant = [&](double value) -> Value {
+      return rewriter.create<arith::ConstantOp>(
+          loc, elementType, rewriter.getFloatAttr(elementType, value));
+    };
+    Value zeroFloat = getConstant(0.0);
+    Value invNumCols = getConstant(1.0 / numCols);
+    Value epsilon = getConstant(layerNormOp.getEpsilon().convertToFloat());
+
+    auto bodyBuilder = [&](OpBuilder &b, Location loc, ValueRange localIvs) {
+      Value row = localIvs[0];
+      // Sum `valueFn` over the elements of the row.
+      auto buildRowSum = [&](function_ref<Value(OpBuilder &, Location, Value)>
+                                 valueFn) -> Value {
+        auto sumLoop = b.create<scf::ForOp>(
+            loc, zero, cols, one, ValueRange{zeroFloat},
+            [&](OpBuilder &nestedBuilder, Location nestedLoc, Value iv,
+                ValueRange iterArgs) {
+              Value x = nestedBuilder.create<memref::LoadOp>(
+                  nestedLoc, input, ValueRange{row, iv});
+              Value sum = nestedBuilder.create<arith::AddFOp>(
+                  nestedLoc, iterArgs[0], valueFn(nestedBuilder, nestedLoc, x));
+              nestedBuilder.create<scf::YieldOp>(nestedLoc, sum);
+            });
+        return b.create<arith::MulFOp>(loc, sumLoop.getResult(0), invNumCols);
+      };
+      Value mean = buildRowSum(
+          [&](OpBuilder &nestedBuilder, Location nestedLoc, Value x) {
+            return x;
+          });
+      Value var = buildRowSum(
+          [&](OpBuilder &nestedBuilder, Location nestedLoc, Value x) -> Value {
+            Value centered =
+                nestedBuilder.create<arith::SubFOp>(nestedLoc, x, mean);
+            return nestedBuilder.create<arith::MulFOp>(nestedLoc, centered,
+                                                       centered);
+          });
+      Value shiftedVar = b.create<arith::AddFOp>(loc, var, epsilon);
+      Value rstd = b.create<math::RsqrtOp>(loc, shiftedVar);
+      b.create<scf::ForOp>(
+          loc, zero, cols, one, std::nullopt,
+          [&](OpBuilder &nestedBuilder, Location nestedLoc, Value iv,
+              ValueRange iterArgs) {
+            SmallVector<Value, 2> ivs = {row, iv};
+            Value x = nestedBuilder.create<memref::LoadOp>(nestedLoc, input,
+                                                           ivs);
+            Value centered =
+                nestedBuilder.create<arith::SubFOp>(nestedLoc, x, mean);
+            Value normalized =
+                nestedBuilder.create<arith::MulFOp>(nestedLoc, centered, rstd);
+            Value scaled = nestedBuilder.create<arith::MulFOp>(
+                nestedLoc, normalized,
+                loadBroadcastOperand(nestedBuilder, nestedLoc, gamma, ivs));
+            Value shifted = nestedBuilder.create<arith::AddFOp>(
+                nestedLoc, scaled,
+                loadBroadcastOperand(nestedBuilder, nestedLoc, beta, ivs));
+            nestedBuilder.create<memref::StoreOp>(nestedLoc, shifted, output,
+                                                  ivs);
+            nestedBuilder.create<scf::YieldOp>(nestedLoc);
+          });
+    };
+    if (parallel) {
+      rewriter.create<scf::ParallelOp>(loc, ValueRange{zero}, ValueRange{rows},
+                                       ValueRange{one}, bodyBuilder);
+    } else {
+      (void)scf::buildLoopNest(rewriter, loc, ValueRange{zero},
+                               ValueRange{rows}, ValueRange{one}, bodyBuilder);
+    }
+
+    rewriter.eraseOp(layerNormOp);
+    return success();
+  }
+
+private:
+  bool parallel;
+};
+
+// Convert tpp.dequantize to SCF loops over the elements of the output.
+struct ConvertTppDequantizeOp : public OpRewritePattern<DequantizeOp> {
+  using OpRewritePattern<DequantizeOp>::OpRewritePattern;
+
+  ConvertTppDequantizeOp(MLIRContext *ctx, bool parallel)
+      : OpRewritePattern<DequantizeOp>(ctx), parallel(parallel) {}
+
+  LogicalResult matchAndRewrite(DequantizeOp dequantizeOp,
+                                PatternRewriter &rewriter) const override {
+    if (!dequantizeOp.hasBufferSemantics())
+      return rewriter.notifyMatchFailure(
+          dequantizeOp, "Tpp loop lowering expects memref type");
+
+    Location loc = dequantizeOp.getLoc();
+    Value acc = dequantizeOp.getInputs()[0];
+    Value scale = dequantizeOp.getInputs()[1];
+    Value bias = dequantizeOp.getInputs()[2];
+    Value output = dequantizeOp.getOutput();
+    Type elementType = dequantizeOp.getOutputType().getElementType();
+
+    SmallVector<Value> ubs = {getDimSize(rewriter, loc, output, 0),
+                              getDimSize(rewriter, loc, output, 1)};
+    Value zero = rewriter.create<arith::ConstantIndexOp>(loc, 0);
+    SmallVector<Value> lbs(2, zero);
+    Value one = rewriter.create<arith::ConstantIndexOp>(loc, 1);
+    SmallVector<Value> steps(2, one);
+    Value zeroFloat = rewriter.create<arith::ConstantOp>(
+        loc, elementType, rewriter.getFloatAttr(elementType, 0));
+
+    auto bodyBuilder = [&](OpBuilder &b, Location loc, ValueRange localIvs) {
+      Value scalarAcc = b.create<memref::LoadOp>(loc, acc, localIvs);
+      Value converted = b.create<arith::SIToFPOp>(loc, elementType, scalarAcc);
+      Value scaled = b.create<arith::MulFOp>(
+          loc, converted, loadBroadcastOperand(b, loc, scale, localIvs));
+      Value result = b.create<arith::AddFOp>(
+          loc, scaled, loadBroadcastOperand(b, loc, bias, localIvs));
+      if (dequantizeOp.getRelu())
+        result = b.create<arith::MaxFOp>(loc, result, zeroFloat);
+      b.create<memref::StoreOp>(loc, result, output, localIvs);
+    };
+
+    if (parallel)
+      rewriter.create<scf::ParallelOp>(loc, lbs, ubs, steps, bodyBuilder);
+    else
+      (void)scf::buildLoopNest(rewriter, loc, lbs, ubs, steps, bodyBuilder);
+
+    rewriter.eraseOp(dequantizeOp);
+    return success();
+  }
+
+private:
+  bool parallel;
+};
+
 // Converts tpp.identity to SCF loops.
 struct ConvertTppIdentityOp : public OpRewritePattern<IdentityOp> {
   using OpRewritePattern<IdentityOp>::OpRewritePattern;
@@ -228,6 +690,23 @@ private:
   bool parallel;
 };
 
+// Compute `acc + lhs * rhs`. Integer operands are sign-extended to the type
+// of the accumulator first, i8 gemms accumulate in i32.
+static Value buildMulAdd(OpBuilder &builder, Location loc, Value lhs,
+                         Value rhs, Value acc) {
+  Type accType = acc.getType();
+  if (!accType.isa<IntegerType>()) {
+    Value mul = builder.create<arith::MulFOp>(loc, lhs, rhs);
+    return builder.create<arith::AddFOp>(loc, acc, mul);
+  }
+  if (lhs.getType() != accType)
+    lhs = builder.create<arith::ExtSIOp>(loc, accType, lhs);
+  if (rhs.getType() != accType)
+    rhs = builder.create<arith::ExtSIOp>(loc, accType, rhs);
+  Value mul = builder.create<arith::MulIOp>(loc, lhs, rhs);
+  return builder.create<arith::AddIOp>(loc, acc, mul);
+}
+
 // Convert tpp.gemm to SCF loops.
 struct ConvertTppGemmOp : public OpRewritePattern<GemmOp> {
   using OpRewritePattern<GemmOp>::OpRewritePattern;
@@ -242,18 +721,18 @@ struct ConvertTppGemmOp : public OpRewritePattern<GemmOp> {
           matmulOp, "Tpp loop lowering expects memref type");
 
     Location loc = matmulOp.getLoc();
-    ArrayRef<int64_t> shapeC = matmulOp.getOutputType().getShape();
     ArrayRef<int64_t> shapeB = matmulOp.getMemRefInputType(1).getShape();
-    ArrayRef<int64_t> shapeA = matmulOp.getMemRefInputType(0).getShape();
     if (shapeB.size() == 3) {
       return rewriter.notifyMatchFailure(matmulOp,
-                                         "Packed BF16 loops unsupported");
+                                         "Packed VNNI loops unsupported");
     }
+    Value matrixA = matmulOp.getInputs()[0];
+    Value matrixC = matmulOp.getInputs()[2];
     // Parallel dims.
-    Value i = rewriter.create<arith::ConstantIndexOp>(loc, shapeC[0]);
-    Value j = rewriter.create<arith::ConstantIndexOp>(loc, shapeC[1]);
+    Value i = getDimSize(rewriter, loc, matrixC, 0);
+    Value j = getDimSize(rewriter, loc, matrixC, 1);
     // Reduction dim.
-    Value k = rewriter.create<arith::ConstantIndexOp>(loc, shapeA[1]);
+    Value k = getDimSize(rewriter, loc, matrixA, 1);
     SmallVector<Value> ubs = {i, j, k};
     // Lbs.
     Value zero = rewriter.create<arith::ConstantIndexOp>(loc, 0);
@@ -272,12 +751,15 @@ struct ConvertTppGemmOp : public OpRewritePattern<GemmOp> {
       Value localK = loopIvs[2];
       Value scalarA = b.create<memref::LoadOp>(loc, matmulOp.getInputs()[0],
                                                ValueRange{localI, localK});
-      Value scalarB = b.create<memref::LoadOp>(loc, matmulOp.getInputs()[1],
-                                               ValueRange{localK, localJ});
+      // A transposed B is stored as NxK.
+      SmallVector<Value, 2> indicesB = {localK, localJ};
+      if (matmulOp.getTransposeB())
+        std::swap(indicesB[0], indicesB[1]);
+      Value scalarB =
+          b.create<memref::LoadOp>(loc, matmulOp.getInputs()[1], indicesB);
       Value scalarC = b.create<memref::LoadOp>(loc, matmulOp.getInputs()[2],
                                                ValueRange{localI, localJ});
-      Value scalarMul = b.create<arith::MulFOp>(loc, scalarA, scalarB);
-      Value scalarAdd = b.create<arith::AddFOp>(loc, scalarC, scalarMul);
+      Value scalarAdd = buildMulAdd(b, loc, scalarA, scalarB, scalarC);
       b.create<memref::StoreOp>(loc, scalarAdd, matmulOp.getOutput(),
                                 ValueRange{localI, localJ});
     };
@@ -321,14 +803,14 @@ struct ConvertTppBrgemmOp : public OpRewritePattern<BrgemmOp> {
           brgemmOp, "Tpp loop lowering expects memref type");
 
     Location loc = brgemmOp.getLoc();
-    ArrayRef<int64_t> shapeC = brgemmOp.getOutputType().getShape();
-    ArrayRef<int64_t> shapeA = brgemmOp.getMemRefInputType(0).getShape();
+    Value matrixA = brgemmOp.getInputs()[0];
+    Value matrixC = brgemmOp.getInputs()[2];
     // Parallel dims.
-    Value i = rewriter.createOrFold<arith::ConstantIndexOp>(loc, shapeC[0]);
-    Value j = rewriter.createOrFold<arith::ConstantIndexOp>(loc, shapeC[1]);
+    Value i = getDimSize(rewriter, loc, matrixC, 0);
+    Value j = getDimSize(rewriter, loc, matrixC, 1);
     // Reduction dims.
-    Value k = rewriter.createOrFold<arith::ConstantIndexOp>(loc, shapeA[2]);
-    Value b = rewriter.createOrFold<arith::ConstantIndexOp>(loc, shapeA[0]);
+    Value k = getDimSize(rewriter, loc, matrixA, 2);
+    Value b = getDimSize(rewriter, loc, matrixA, 0);
     SmallVector<Value> ubs = {b, i, j, k};
     // Lbs.
     Value zero = rewriter.createOrFold<arith::ConstantIndexOp>(loc, 0);
@@ -348,12 +830,15 @@ struct ConvertTppBrgemmOp : public OpRewritePattern<BrgemmOp> {
       Value localK = loopIvs[3];
       Value scalarA = b.create<memref::LoadOp>(
           loc, brgemmOp.getInputs()[0], ValueRange{localB, localI, localK});
-      Value scalarB = b.create<memref::LoadOp>(
-          loc, brgemmOp.getInputs()[1], ValueRange{localB, localK, localJ});
+      // Transposed B blocks are stored as NxK.
+      SmallVector<Value, 3> indicesB = {localB, localK, localJ};
+      if (brgemmOp.getTransposeB())
+        std::swap(indicesB[1], indicesB[2]);
+      Value scalarB =
+          b.create<memref::LoadOp>(loc, brgemmOp.getInputs()[1], indicesB);
       Value scalarC = b.create<memref::LoadOp>(loc, brgemmOp.getInputs()[2],
                                                ValueRange{localI, localJ});
-      Value scalarMul = b.create<arith::MulFOp>(loc, scalarA, scalarB);
-      Value scalarAdd = b.create<arith::AddFOp>(loc, scalarC, scalarMul);
+      Value scalarAdd = buildMulAdd(b, loc, scalarA, scalarB, scalarC);
       b.create<memref::StoreOp>(loc, scalarAdd, brgemmOp.getOutput(),
                                 ValueRange{localI, localJ});
     };
@@ -405,12 +890,25 @@ struct ConvertTppFusedBrgemmOp : public OpRewritePattern<FusedBrgemmOp> {
 
 void populateTppToLoopsPatterns(RewritePatternSet &patterns, bool parallel) {
   // clang-format off
-  patterns.add<ConvertTppAddOp, 
+  patterns.add<ConvertTppEltwiseBinaryOp<AddOp>,
+               ConvertTppEltwiseBinaryOp<MulOp>,
+               ConvertTppEltwiseBinaryOp<SubOp>,
+               ConvertTppEltwiseBinaryOp<DivOp>,
+               ConvertTppEltwiseBinaryOp<MaxOp>,
                ConvertTppIdentityOp,
                ConvertTppGemmOp,
                ConvertTppBrgemmOp,
                ConvertTppFusedBrgemmOp,
                ConvertTppReluOp,
+               ConvertTppEltwiseUnaryOp<GeluOp>,
+               ConvertTppEltwiseUnaryOp<TanhOp>,
+               ConvertTppEltwiseUnaryOp<SigmoidOp>,
+               ConvertTppEltwiseUnaryOp<ExpOp>,
+               ConvertTppReduceOp<ReduceAddOp>,
+               ConvertTppReduceOp<ReduceMaxOp>,
+               ConvertTppSoftmaxOp,
+               ConvertTppLayerNormOp,
+               ConvertTppDequantizeOp,
                ConvertTppZeroOp>(patterns.getContext(), parallel);
   // clang-format on
 }
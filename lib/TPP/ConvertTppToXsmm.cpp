@@ -16,9 +16,14 @@
 #include "mlir/Dialect/Arith/IR/Arith.h"
 #include "mlir/Dialect/Func/IR/FuncOps.h"
 #include "mlir/Dialect/LLVMIR/LLVMDialect.h"
+#include "mlir/Dialect/Math/IR/Math.h"
 #include "mlir/Dialect/MemRef/IR/MemRef.h"
+#include "mlir/Dialect/SCF/IR/SCF.h"
 #include "mlir/Dialect/Utils/ReshapeOpsUtils.h"
+#include "mlir/Dialect/Utils/StaticValueUtils.h"
 #include "mlir/IR/BuiltinAttributes.h"
+#include "mlir/IR/IRMapping.h"
+#include "mlir/Interfaces/SideEffectInterfaces.h"
 #include "mlir/Transforms/GreedyPatternRewriteDriver.h"
 #include "llvm/Support/Debug.h"
 
@@ -57,6 +62,20 @@ static FailureOr<int64_t> getLeadingDim(Type type, size_t pos = 0) {
   return strides[pos];
 }
 
+// Return true if the dimensions are equal or one of them is only known at
+// runtime, in which case they must match for the op to be well-formed.
+static bool isCompatibleDim(int64_t lhs, int64_t rhs) {
+  return lhs == rhs || ShapedType::isDynamic(lhs) || ShapedType::isDynamic(rhs);
+}
+
+// Return the size of dimension `dim` of the memref `value` as an i64, for the
+// sizes only known at runtime.
+static Value getSizeAsI64(RewriterBase &rewriter, Location loc, Value value,
+                          int64_t dim) {
+  Value size = rewriter.create<memref::DimOp>(loc, value, dim);
+  return rewriter.create<arith::IndexCastOp>(loc, rewriter.getI64Type(), size);
+}
+
 // Examples:
 // If lower=[c], higher=[a, b, c], [c] reshaped into [1, 1, c].
 // If lower=[b, c], higher=[a, b, c], [b, c] reshaped into [1, b, c].
@@ -81,10 +100,10 @@ computeBcastShapeInput(ArrayRef<int64_t> higherRankShape,
     higherRankDim = higherRankShape[i];
     lowerRankDim = lowerRankShape[j];
 
-    if (lowerRankDim == 1 && higherRankDim > 1)
+    if (lowerRankDim == 1 && higherRankDim != 1)
       reshapeOutputShape[i] = 1;
     else if ((lowerRankDim > 1 && higherRankDim == 1) ||
-             (lowerRankDim == higherRankDim))
+             isCompatibleDim(lowerRankDim, higherRankDim))
       reshapeOutputShape[i] = lowerRankDim;
     else if (higherRankDim != lowerRankDim)
       assert(false && "bCast semantics for identity op broken");
@@ -141,16 +160,234 @@ getSizesAndLeadingDimsForGemmLikeOp(RewriterBase &rewriter, OpTy opTy) {
   return dims;
 }
 
+// Return the values of the sizes of `opTy` only known at runtime. The
+// innermost dimensions, and thus n, k and the leading dimensions, are static:
+// only m can be dynamic.
 template <typename OpTy>
-static ArrayAttr getGemmFlags(RewriterBase &rewriter, OpTy opTy) {
-  auto memrefB = opTy.getMemRefInputType(1);
-  xsmm::GemmFlagsAttr gemmFlag =
-      (vnni::utils::isInVnniLayout(memrefB))
-          ? xsmm::GemmFlagsAttr::get(rewriter.getContext(),
-                                     xsmm::GemmFlags::VNNI_B)
-          : xsmm::GemmFlagsAttr::get(rewriter.getContext(),
-                                     xsmm::GemmFlags::NONE);
-  return rewriter.getArrayAttr(gemmFlag);
+static SmallVector<Value> getDynamicSizesForGemmLikeOp(RewriterBase &rewriter,
+                                                       OpTy opTy) {
+  if (!opTy.getOutputType().isDynamicDim(0))
+    return {};
+  return {getSizeAsI64(rewriter, opTy.getLoc(), opTy.getInputs()[2], 0)};
+}
+
+// Return the number of blocks of the brgemm operand `operand` as an i64.
+static Value getBatchDim(RewriterBase &rewriter, Location loc, Value operand) {
+  auto memref = operand.getType().cast<MemRefType>();
+  if (memref.isDynamicDim(0))
+    return getSizeAsI64(rewriter, loc, operand, 0);
+  IntegerType integer64 = rewriter.getI64Type();
+  return rewriter.create<arith::ConstantOp>(
+      loc, integer64, rewriter.getIntegerAttr(integer64, memref.getShape()[0]));
+}
+
+// Return true if `op` is a gemm-like op accumulating into `buffer`, and only
+// reading it as its accumulator.
+static bool isGemmAccumulatingInto(Operation *op, Value buffer) {
+  if (!isa<tpp::GemmOp, tpp::BrgemmOp, tpp::FusedBrgemmOp>(op))
+    return false;
+  // The output is both the last input and the output operand. Without a binary
+  // epilogue the bias of a fused brgemm is ignored and may alias the output.
+  int64_t numUses = 2;
+  auto fusedOp = dyn_cast<tpp::FusedBrgemmOp>(op);
+  if (fusedOp && fusedOp.getBinaryKind() == tpp::FusedBinaryOpKind::NONE &&
+      fusedOp.getBiasOperand() == buffer)
+    numUses = 3;
+  return cast<tpp::TppOp>(op).getOutput() == buffer &&
+         llvm::count(op->getOperands(), buffer) == numUses;
+}
+
+// Return the first op after `op` in its block that may touch memory.
+static Operation *getNextMemoryOp(Operation *op) {
+  for (Operation *next = op->getNextNode(); next; next = next->getNextNode()) {
+    if (!isMemoryEffectFree(next) || next->getNumRegions() != 0)
+      return next;
+  }
+  return nullptr;
+}
+
+// Return the induction variables of `loop` along with their lower bound,
+// upper bound and step. Fails if `loop` is not a loop.
+static LogicalResult getLoopDims(
+    Operation *loop,
+    SmallVectorImpl<std::tuple<Value, OpFoldResult, OpFoldResult, OpFoldResult>>
+        &loopDims) {
+  if (auto forOp = dyn_cast<scf::ForOp>(loop)) {
+    loopDims.push_back({forOp.getInductionVar(), forOp.getLowerBound(),
+                        forOp.getUpperBound(), forOp.getStep()});
+    return success();
+  }
+  if (auto parallelOp = dyn_cast<scf::ParallelOp>(loop)) {
+    for (auto [iv, lb, ub, step] : llvm::zip(
+             parallelOp.getInductionVars(), parallelOp.getLowerBound(),
+             parallelOp.getUpperBound(), parallelOp.getStep())) {
+      loopDims.push_back({iv, lb, ub, step});
+    }
+    return success();
+  }
+  if (auto forallOp = dyn_cast<scf::ForallOp>(loop)) {
+    for (auto [iv, lb, ub, step] :
+         llvm::zip(forallOp.getInductionVars(), forallOp.getMixedLowerBound(),
+                   forallOp.getMixedUpperBound(), forallOp.getMixedStep())) {
+      loopDims.push_back({iv, lb, ub, step});
+    }
+    return success();
+  }
+  return failure();
+}
+
+// Return the gemm-like op writing `buffer` tile by tile within the loop nest
+// rooted at `loop`. The gemm must be the only access to `buffer` in the loop
+// nest and each iteration must write a distinct tile, so that the tiles of all
+// the iterations cover `buffer` exactly once.
+static Operation *getTiledGemm(Value buffer, Operation *loop,
+                               Operation *zeroOp) {
+  // Besides the zero and the accesses after the loop, the only use of
+  // `buffer` is the view on the tile of the current iteration.
+  memref::SubViewOp tile;
+  for (Operation *user : buffer.getUsers()) {
+    if (user == zeroOp)
+      continue;
+    Operation *ancestor = loop->getBlock()->findAncestorOpInBlock(*user);
+    if (ancestor && loop->isBeforeInBlock(ancestor))
+      continue;
+    auto subView = dyn_cast<memref::SubViewOp>(user);
+    if (!subView || tile || !loop->isProperAncestor(subView))
+      return nullptr;
+    tile = subView;
+  }
+  if (!tile)
+    return nullptr;
+
+  // The gemm is the first access to the tile.
+  Operation *gemm = nullptr;
+  for (Operation *user : tile->getUsers()) {
+    if (!isGemmAccumulatingInto(user, tile.getResult()))
+      continue;
+    if (gemm)
+      return nullptr;
+    gemm = user;
+  }
+  if (!gemm)
+    return nullptr;
+  for (Operation *user : tile->getUsers()) {
+    if (user != gemm &&
+        (user->getBlock() != gemm->getBlock() || user->isBeforeInBlock(gemm)))
+      return nullptr;
+  }
+
+  // All the enclosing regions up to `loop` are loops stepping over tiles.
+  SmallVector<std::tuple<Value, OpFoldResult, OpFoldResult, OpFoldResult>>
+      loopDims;
+  Operation *parent = gemm;
+  do {
+    parent = parent->getParentOp();
+    if (failed(getLoopDims(parent, loopDims)))
+      return nullptr;
+  } while (parent != loop);
+
+  MemRefType bufferType = tile.getSourceType();
+  if (!bufferType.hasStaticShape() ||
+      !llvm::all_of(tile.getMixedStrides(), [](OpFoldResult stride) {
+        return isConstantIntValue(stride, 1);
+      })) {
+    return nullptr;
+  }
+  llvm::SmallDenseSet<Value> tiledIvs;
+  for (auto [offset, size, dim] :
+       llvm::zip(tile.getMixedOffsets(), tile.getMixedSizes(),
+                 bufferType.getShape())) {
+    std::optional<int64_t> tileSize = getConstantIntValue(size);
+    if (!tileSize || *tileSize == 0 || dim % *tileSize != 0)
+      return nullptr;
+    if (isConstantIntValue(offset, 0) && *tileSize == dim)
+      continue;
+    Value iv = offset.dyn_cast<Value>();
+    auto *loopDim = llvm::find_if(
+        loopDims, [&](auto &loopDim) { return std::get<0>(loopDim) == iv; });
+    if (!iv || loopDim == loopDims.end() || !tiledIvs.insert(iv).second)
+      return nullptr;
+    auto [loopIv, lb, ub, step] = *loopDim;
+    if (!isConstantIntValue(lb, 0) || !isConstantIntValue(ub, dim) ||
+        !isConstantIntValue(step, *tileSize))
+      return nullptr;
+  }
+  // An induction variable not selecting the tile would accumulate several
+  // times into the same tile.
+  if (tiledIvs.size() != loopDims.size())
+    return nullptr;
+  return gemm;
+}
+
+// Return the gemm-like op whose first accumulation entirely overwrites the
+// output of `zeroOp`: either the next op accessing memory, or a gemm in the
+// loop nest right after the zero writing its output tile by tile. The zero
+// then folds into the gemm as BETA_0, saving a write pass over the output.
+static Operation *getZeroInitializedGemm(tpp::ZeroOp zeroOp) {
+  if (!zeroOp.hasBufferSemantics())
+    return nullptr;
+  Value buffer = zeroOp.getOutput();
+  Operation *next = getNextMemoryOp(zeroOp);
+  if (!next)
+    return nullptr;
+  if (isGemmAccumulatingInto(next, buffer))
+    return next;
+  if (isa<scf::ForOp, scf::ParallelOp, scf::ForallOp>(next))
+    return getTiledGemm(buffer, next, zeroOp);
+  return nullptr;
+}
+
+// Return the zero initialization of the output of the gemm-like op `op` that
+// can be folded into it, if any.
+static tpp::ZeroOp getZeroInitialization(Operation *op) {
+  SmallVector<tpp::ZeroOp> candidates;
+  for (Operation *prev = op->getPrevNode(); prev; prev = prev->getPrevNode()) {
+    if (auto zeroOp = dyn_cast<tpp::ZeroOp>(prev))
+      candidates.push_back(zeroOp);
+    if (!isMemoryEffectFree(prev) || prev->getNumRegions() != 0)
+      break;
+  }
+  Value output = cast<tpp::TppOp>(op).getOutput();
+  if (auto tile = output.getDefiningOp<memref::SubViewOp>()) {
+    for (Operation *user : tile.getSource().getUsers()) {
+      if (auto zeroOp = dyn_cast<tpp::ZeroOp>(user))
+        candidates.push_back(zeroOp);
+    }
+  }
+  for (tpp::ZeroOp zeroOp : candidates) {
+    if (getZeroInitializedGemm(zeroOp) == op)
+      return zeroOp;
+  }
+  return nullptr;
+}
+
+// Erase the zero initialization of the output of the gemm-like op `op`, if it
+// can be folded into it. Returns true if it did.
+static bool foldZeroInitialization(RewriterBase &rewriter, Operation *op) {
+  tpp::ZeroOp zeroOp = getZeroInitialization(op);
+  if (!zeroOp)
+    return false;
+  rewriter.eraseOp(zeroOp);
+  return true;
+}
+
+// Return the gemm flags of `opTy`. With `zeroInit`, the output is not read but
+// overwritten by the first accumulation.
+template <typename OpTy>
+static ArrayAttr getGemmFlags(Builder &builder, OpTy opTy,
+                              bool zeroInit = false) {
+  MLIRContext *ctx = builder.getContext();
+  SmallVector<Attribute> gemmFlags;
+  if (vnni::utils::isInVnniLayout(opTy.getMemRefInputType(1)))
+    gemmFlags.push_back(xsmm::GemmFlagsAttr::get(ctx, xsmm::GemmFlags::VNNI_B));
+  if (tpp::utils::hasTransposedB(opTy))
+    gemmFlags.push_back(
+        xsmm::GemmFlagsAttr::get(ctx, xsmm::GemmFlags::TRANS_B));
+  if (zeroInit)
+    gemmFlags.push_back(xsmm::GemmFlagsAttr::get(ctx, xsmm::GemmFlags::BETA_0));
+  if (gemmFlags.empty())
+    gemmFlags.push_back(xsmm::GemmFlagsAttr::get(ctx, xsmm::GemmFlags::NONE));
+  return builder.getArrayAttr(gemmFlags);
 }
 
 template <typename OpTy>
@@ -161,16 +398,214 @@ static xsmm::DataTypeAttr getDataType(RewriterBase &rewriter, OpTy opTy) {
   if (memrefC.getElementType().isBF16()) {
     dtype =
         xsmm::DataTypeAttr::get(rewriter.getContext(), xsmm::DataType::BF16);
+  } else if (memrefC.getElementType().isInteger(32)) {
+    // i8 inputs, accumulated in i32 (see tpp gemm verifier).
+    dtype = xsmm::DataTypeAttr::get(rewriter.getContext(), xsmm::DataType::I8);
   } else {
     assert(memrefC.getElementType().isF32() &&
-           "Element type neither bf16 nor f32");
+           "Element type neither bf16, i32 nor f32");
     dtype = xsmm::DataTypeAttr::get(rewriter.getContext(), xsmm::DataType::F32);
   }
   return dtype;
 }
 
+// Return true if `value` is computed from `iv` by side-effect free ops within
+// `loop`, that is if it can be rebuilt for another iteration.
+static bool dependsOnInductionVar(Value value, Value iv, Operation *loop) {
+  if (value == iv)
+    return true;
+  Operation *defOp = value.getDefiningOp();
+  if (!defOp || !loop->isProperAncestor(defOp) ||
+      defOp->getNumRegions() != 0 || !isMemoryEffectFree(defOp))
+    return false;
+  return llvm::any_of(defOp->getOperands(), [&](Value operand) {
+    return dependsOnInductionVar(operand, iv, loop);
+  });
+}
+
+// Rebuild `value` as computed in the next iteration by replacing `iv` with
+// `nextIv`. Returns `value` itself if it does not depend on `iv`.
+static Value cloneForNextIteration(RewriterBase &rewriter, Value value,
+                                   Value iv, Value nextIv, Operation *loop,
+                                   IRMapping &mapping) {
+  if (value == iv)
+    return nextIv;
+  if (Value mapped = mapping.lookupOrNull(value))
+    return mapped;
+  if (!dependsOnInductionVar(value, iv, loop))
+    return value;
+
+  Operation *defOp = value.getDefiningOp();
+  for (Value operand : defOp->getOperands()) {
+    Value next =
+        cloneForNextIteration(rewriter, operand, iv, nextIv, loop, mapping);
+    if (next != operand)
+      mapping.map(operand, next);
+  }
+  Operation *clone = rewriter.clone(*defOp, mapping);
+  mapping.map(defOp->getResults(), clone->getResults());
+  return mapping.lookup(value);
+}
+
+// Compute the A and B operands `op` reads in the next iteration of its
+// closest enclosing scf.for or scf.parallel. The next iteration is clamped to
+// the last one, in which case the current tiles are prefetched again. The
+// innermost induction variable that the operands depend on is stepped. Fails
+// if neither operand changes across iterations.
+static FailureOr<std::pair<Value, Value>>
+getNextIterationOperands(RewriterBase &rewriter, Operation *op) {
+  Operation *loop = op->getParentOp();
+  while (loop && !isa<scf::ForOp, scf::ParallelOp>(loop))
+    loop = loop->getParentOp();
+  if (!loop)
+    return failure();
+
+  SmallVector<std::tuple<Value, Value, Value>> ivs;
+  if (auto forOp = dyn_cast<scf::ForOp>(loop)) {
+    ivs.push_back({forOp.getInductionVar(), forOp.getStep(),
+                   forOp.getUpperBound()});
+  } else {
+    auto parallelOp = cast<scf::ParallelOp>(loop);
+    for (int64_t dim = parallelOp.getNumLoops() - 1; dim >= 0; dim--) {
+      ivs.push_back({parallelOp.getInductionVars()[dim],
+                     parallelOp.getStep()[dim],
+                     parallelOp.getUpperBound()[dim]});
+    }
+  }
+
+  Value operandA = op->getOperand(0);
+  Value operandB = op->getOperand(1);
+  Location loc = op->getLoc();
+  for (auto [iv, step, ub] : ivs) {
+    if (!dependsOnInductionVar(operandA, iv, loop) &&
+        !dependsOnInductionVar(operandB, iv, loop))
+      continue;
+
+    Value next = rewriter.create<arith::AddIOp>(loc, iv, step);
+    Value inBounds = rewriter.create<arith::CmpIOp>(
+        loc, arith::CmpIPredicate::slt, next, ub);
+    Value nextIv = rewriter.create<arith::SelectOp>(loc, inBounds, next, iv);
+    IRMapping mapping;
+    Value nextA =
+        cloneForNextIteration(rewriter, operandA, iv, nextIv, loop, mapping);
+    Value nextB =
+        cloneForNextIteration(rewriter, operandB, iv, nextIv, loop, mapping);
+    return std::make_pair(nextA, nextB);
+  }
+  return failure();
+}
+
+// Return the block holding the allocas of the scratch buffers built for `op`:
+// the body of the closest scf.parallel, as its iterations run concurrently and
+// get their own allocation scope once lowered to OpenMP, or the entry block of
+// the closest automatic allocation scope.
+static Block *getAllocaBlock(Block *block) {
+  Operation *parent = block->getParentOp();
+  while (!isa<scf::ParallelOp>(parent) &&
+         !parent->hasTrait<OpTrait::AutomaticAllocationScope>())
+    parent = parent->getParentOp();
+  return &parent->getRegion(0).front();
+}
+
+static Block *getAllocaBlock(Operation *op) {
+  return getAllocaBlock(op->getBlock());
+}
+
+// Allocate a scratch buffer of type `type` for the ops built at the current
+// insertion point, in their alloca block.
+static Value buildScratchBuffer(RewriterBase &rewriter, Location loc,
+                                MemRefType type) {
+  OpBuilder::InsertionGuard guard(rewriter);
+  rewriter.setInsertionPointToStart(
+      getAllocaBlock(rewriter.getInsertionBlock()));
+  return rewriter.create<memref::AllocaOp>(loc, type);
+}
+
+static int64_t getElementSizeInBytes(MemRefType memref) {
+  return memref.getElementTypeBitWidth() / 8;
+}
+
+// Return the stride, in elements, between two consecutive blocks of a brgemm
+// operand.
+static FailureOr<int64_t> getBatchStride(MemRefType memref) {
+  SmallVector<int64_t> strides;
+  int64_t offset;
+  if (failed(getStridesAndOffset(memref, strides, offset)) ||
+      strides[0] == ShapedType::kDynamic)
+    return failure();
+  return strides[0];
+}
+
+// Build the array of byte offsets of the `batch` blocks of an operand whose
+// blocks are `batchStride` elements apart. The content is invariant, so it is
+// filled once next to the allocation by a loop storing `iv * stride`.
+static Value buildBatchOffsets(RewriterBase &rewriter, Operation *op,
+                               int64_t batch, int64_t batchStride,
+                               int64_t elementSize) {
+  OpBuilder::InsertionGuard guard(rewriter);
+  rewriter.setInsertionPointToStart(getAllocaBlock(op));
+  Location loc = op->getLoc();
+  IntegerType integer64 = rewriter.getI64Type();
+  Value offsets = rewriter.create<memref::AllocaOp>(
+      loc, MemRefType::get({batch}, integer64));
+  Value zero = rewriter.create<arith::ConstantIndexOp>(loc, 0);
+  Value one = rewriter.create<arith::ConstantIndexOp>(loc, 1);
+  Value numBlocks = rewriter.create<arith::ConstantIndexOp>(loc, batch);
+  Value stride =
+      rewriter.create<arith::ConstantIndexOp>(loc, batchStride * elementSize);
+  rewriter.create<scf::ForOp>(
+      loc, zero, numBlocks, one, std::nullopt,
+      [&](OpBuilder &nestedBuilder, Location nestedLoc, Value iv,
+          ValueRange iterArgs) {
+        Value offset =
+            nestedBuilder.create<arith::MulIOp>(nestedLoc, iv, stride);
+        offset = nestedBuilder.create<arith::IndexCastOp>(nestedLoc,
+                                                          integer64, offset);
+        nestedBuilder.create<memref::StoreOp>(nestedLoc, offset, offsets, iv);
+        nestedBuilder.create<scf::YieldOp>(nestedLoc);
+      });
+  return offsets;
+}
+
+// Build the array of the addresses of `blocks` at the current insertion point.
+static Value buildBlockAddresses(RewriterBase &rewriter, Operation *op,
+                                 ArrayRef<Value> blocks) {
+  Location loc = op->getLoc();
+  IntegerType integer64 = rewriter.getI64Type();
+  MemRefType addressesType =
+      MemRefType::get({static_cast<int64_t>(blocks.size())}, integer64);
+  Value addresses;
+  {
+    OpBuilder::InsertionGuard guard(rewriter);
+    rewriter.setInsertionPointToStart(getAllocaBlock(op));
+    addresses = rewriter.create<memref::AllocaOp>(loc, addressesType);
+  }
+
+  for (auto [idx, block] : llvm::enumerate(blocks)) {
+    auto memrefType = block.getType().cast<MemRefType>();
+    Type indexType = rewriter.getIndexType();
+    SmallVector<Type> sizesTypes(memrefType.getRank(), indexType);
+    auto meta = rewriter.create<memref::ExtractStridedMetadataOp>(
+        loc, MemRefType::get({}, memrefType.getElementType()), indexType,
+        sizesTypes, sizesTypes, block);
+    Value base = rewriter.create<memref::ExtractAlignedPointerAsIndexOp>(
+        loc, indexType, block);
+    Value elementSize = rewriter.create<arith::ConstantIndexOp>(
+        loc, getElementSizeInBytes(memrefType));
+    Value offset =
+        rewriter.create<arith::MulIOp>(loc, meta.getOffset(), elementSize);
+    Value address = rewriter.create<arith::IndexCastOp>(
+        loc, integer64, rewriter.create<arith::AddIOp>(loc, base, offset));
+    Value pos = rewriter.create<arith::ConstantIndexOp>(loc, idx);
+    rewriter.create<memref::StoreOp>(loc, address, addresses, pos);
+  }
+  return addresses;
+}
+
 struct ConvertTppGemmOp : public OpRewritePattern<tpp::GemmOp> {
-  using OpRewritePattern<tpp::GemmOp>::OpRewritePattern;
+  ConvertTppGemmOp(MLIRContext *context, bool prefetch, bool foldZeroInit)
+      : OpRewritePattern<tpp::GemmOp>(context), prefetch(prefetch),
+        foldZeroInit(foldZeroInit) {}
 
   LogicalResult matchAndRewrite(tpp::GemmOp matmulOp,
                                 PatternRewriter &rewriter) const override {
@@ -188,8 +623,28 @@ struct ConvertTppGemmOp : public OpRewritePattern<tpp::GemmOp> {
 
     auto dtype = getDataType(rewriter, matmulOp);
     IntegerType integer64 = IntegerType::get(rewriter.getContext(), 64);
+    bool zeroInit = foldZeroInit && foldZeroInitialization(rewriter, matmulOp);
+
+    if (prefetch) {
+      auto nextOperands = getNextIterationOperands(rewriter, matmulOp);
+      if (succeeded(nextOperands)) {
+        Value dispatched = rewriter.create<xsmm::GemmPrefetchDispatchOp>(
+            loc, integer64, *dims,
+            getDynamicSizesForGemmLikeOp(rewriter, matmulOp),
+            getGemmFlags(rewriter, matmulOp, zeroInit), dtype);
+        SmallVector<Value, 6> invokeOperands{
+            dispatched,          matmulOp.getInputs()[0],
+            matmulOp.getInputs()[1], matmulOp.getInputs()[2],
+            nextOperands->first, nextOperands->second};
+        rewriter.replaceOpWithNewOp<xsmm::GemmPrefetchOp>(matmulOp, dtype,
+                                                          invokeOperands);
+        return success();
+      }
+    }
+
     Value dispatched = rewriter.create<xsmm::GemmDispatchOp>(
-        loc, integer64, *dims, getGemmFlags(rewriter, matmulOp), dtype);
+        loc, integer64, *dims, getDynamicSizesForGemmLikeOp(rewriter, matmulOp),
+        getGemmFlags(rewriter, matmulOp, zeroInit), dtype);
 
     SmallVector<Value, 6> invokeOperands;
     invokeOperands.push_back(dispatched);
@@ -200,10 +655,16 @@ struct ConvertTppGemmOp : public OpRewritePattern<tpp::GemmOp> {
     rewriter.replaceOpWithNewOp<xsmm::GemmOp>(matmulOp, dtype, invokeOperands);
     return success();
   }
+
+private:
+  bool prefetch;
+  bool foldZeroInit;
 };
 
 struct ConvertTppBrgemmOp : public OpRewritePattern<tpp::BrgemmOp> {
-  using OpRewritePattern<tpp::BrgemmOp>::OpRewritePattern;
+  ConvertTppBrgemmOp(MLIRContext *context, bool prefetch, bool foldZeroInit)
+      : OpRewritePattern<tpp::BrgemmOp>(context), prefetch(prefetch),
+        foldZeroInit(foldZeroInit) {}
 
   LogicalResult matchAndRewrite(tpp::BrgemmOp brgemmOp,
                                 PatternRewriter &rewriter) const override {
@@ -224,11 +685,77 @@ struct ConvertTppBrgemmOp : public OpRewritePattern<tpp::BrgemmOp> {
     auto dtype = getDataType(rewriter, brgemmOp);
     IntegerType integer64 = IntegerType::get(rewriter.getContext(), 64);
 
+    // The stride-based kernel assumes densely packed blocks. Views striding
+    // over the batch dimension go through the offset-based kernel. So do
+    // blocks with a dynamic number of rows: densely packed ones would have a
+    // dynamic batch stride.
+    auto memrefA = brgemmOp.getMemRefInputType(0);
+    auto batchStrideA = getBatchStride(memrefA);
+    auto batchStrideB = getBatchStride(memrefB);
+    if (failed(batchStrideA) || failed(batchStrideB)) {
+      return rewriter.notifyMatchFailure(brgemmOp,
+                                         "Cannot compute batch strides");
+    }
+    ArrayRef<int64_t> sizes = dims->asArrayRef();
+    int64_t m = sizes[0], n = sizes[1], k = sizes[2], lda = sizes[3],
+            ldb = sizes[4];
+    // Transposed B blocks are NxK.
+    int64_t rowsB = brgemmOp.getTransposeB() ? n : k;
+    bool useOffsets = ShapedType::isDynamic(m) || *batchStrideA != lda * m ||
+                      *batchStrideB != ldb * rowsB;
+    if (useOffsets && ShapedType::isDynamic(batchSize)) {
+      return rewriter.notifyMatchFailure(
+          brgemmOp, "Cannot compute offsets of a dynamic batch");
+    }
+
+    bool zeroInit =
+        foldZeroInit && foldZeroInitialization(rewriter, brgemmOp);
+
+    if (useOffsets) {
+      Value dispatched = rewriter.create<xsmm::BrgemmOffsDispatchOp>(
+          loc, integer64, *dims,
+          getDynamicSizesForGemmLikeOp(rewriter, brgemmOp),
+          getGemmFlags(rewriter, brgemmOp, zeroInit), dtype);
+      Value offsetsA =
+          buildBatchOffsets(rewriter, brgemmOp, batchSize, *batchStrideA,
+                            getElementSizeInBytes(memrefA));
+      Value offsetsB =
+          buildBatchOffsets(rewriter, brgemmOp, batchSize, *batchStrideB,
+                            getElementSizeInBytes(memrefB));
+      Value batchDim = rewriter.create<arith::ConstantOp>(
+          loc, integer64, rewriter.getIntegerAttr(integer64, batchSize));
+      SmallVector<Value, 7> invokeOperands{
+          dispatched, brgemmOp.getInputs()[0], brgemmOp.getInputs()[1],
+          brgemmOp.getInputs()[2], offsetsA, offsetsB, batchDim};
+      rewriter.replaceOpWithNewOp<xsmm::BrgemmOffsOp>(brgemmOp, dtype,
+                                                      invokeOperands);
+      return success();
+    }
+
+    if (prefetch) {
+      auto nextOperands = getNextIterationOperands(rewriter, brgemmOp);
+      if (succeeded(nextOperands)) {
+        Value dispatched = rewriter.create<xsmm::BrgemmPrefetchDispatchOp>(
+            loc, integer64, *dims,
+            getDynamicSizesForGemmLikeOp(rewriter, brgemmOp),
+            getGemmFlags(rewriter, brgemmOp, zeroInit), dtype);
+        Value batchDim = getBatchDim(rewriter, loc, brgemmOp.getInputs()[1]);
+        SmallVector<Value, 7> invokeOperands{
+            dispatched,          brgemmOp.getInputs()[0],
+            brgemmOp.getInputs()[1], brgemmOp.getInputs()[2],
+            nextOperands->first, nextOperands->second,
+            batchDim};
+        rewriter.replaceOpWithNewOp<xsmm::BrgemmPrefetchOp>(brgemmOp, dtype,
+                                                            invokeOperands);
+        return success();
+      }
+    }
+
     Value dispatched = rewriter.create<xsmm::BrgemmDispatchOp>(
-        loc, integer64, *dims, getGemmFlags(rewriter, brgemmOp), dtype);
+        loc, integer64, *dims, getDynamicSizesForGemmLikeOp(rewriter, brgemmOp),
+        getGemmFlags(rewriter, brgemmOp, zeroInit), dtype);
 
-    Value batchDim = rewriter.create<arith::ConstantOp>(
-        loc, integer64, rewriter.getIntegerAttr(integer64, batchSize));
+    Value batchDim = getBatchDim(rewriter, loc, brgemmOp.getInputs()[1]);
     SmallVector<Value, 6> invokeOperands;
     invokeOperands.push_back(dispatched);
     invokeOperands.append(brgemmOp->getOperands().begin(),
@@ -240,6 +767,106 @@ struct ConvertTppBrgemmOp : public OpRewritePattern<tpp::BrgemmOp> {
                                                 invokeOperands);
     return success();
   }
+
+private:
+  bool prefetch;
+  bool foldZeroInit;
+};
+
+// Return the gemm after `gemmOp` in the same block accumulating into the same
+// output with the same kernel, skipping side-effect free ops only. The whole
+// chain is dispatched with the flags of its head: with square B tiles a
+// transposed and a plain gemm have the same types, so compare the flags too.
+static tpp::GemmOp getNextChainedGemm(tpp::GemmOp gemmOp) {
+  Builder builder(gemmOp.getContext());
+  for (Operation *op = gemmOp->getNextNode(); op; op = op->getNextNode()) {
+    if (auto nextGemm = dyn_cast<tpp::GemmOp>(op)) {
+      if (nextGemm.getInputs()[2] == gemmOp.getInputs()[2] &&
+          nextGemm.getMemRefInputType(0) == gemmOp.getMemRefInputType(0) &&
+          nextGemm.getMemRefInputType(1) == gemmOp.getMemRefInputType(1) &&
+          nextGemm.getTransposeB() == gemmOp.getTransposeB() &&
+          getGemmFlags(builder, nextGemm) == getGemmFlags(builder, gemmOp))
+        return nextGemm;
+      return nullptr;
+    }
+    if (!isMemoryEffectFree(op) || op->getNumRegions() != 0)
+      return nullptr;
+  }
+  return nullptr;
+}
+
+static tpp::GemmOp getPrevChainedGemm(tpp::GemmOp gemmOp) {
+  for (Operation *op = gemmOp->getPrevNode(); op; op = op->getPrevNode()) {
+    if (auto prevGemm = dyn_cast<tpp::GemmOp>(op))
+      return getNextChainedGemm(prevGemm) == gemmOp ? prevGemm : nullptr;
+    if (!isMemoryEffectFree(op) || op->getNumRegions() != 0)
+      return nullptr;
+  }
+  return nullptr;
+}
+
+// Rewrite a chain of gemms accumulating into the same output, with only
+// side-effect free ops in between, into a single address-based brgemm. The
+// blocks of A and B need not be a fixed stride apart or even in the same
+// buffer.
+struct ConvertTppGemmChainOp : public OpRewritePattern<tpp::GemmOp> {
+  ConvertTppGemmChainOp(MLIRContext *context, bool foldZeroInit)
+      : OpRewritePattern<tpp::GemmOp>(context, /*benefit=*/2),
+        foldZeroInit(foldZeroInit) {}
+
+  LogicalResult matchAndRewrite(tpp::GemmOp gemmOp,
+                                PatternRewriter &rewriter) const override {
+    if (!gemmOp.hasBufferSemantics()) {
+      return rewriter.notifyMatchFailure(gemmOp,
+                                         "xsmm expects buffer semantics");
+    }
+    // Start from the head of the chain.
+    if (getPrevChainedGemm(gemmOp))
+      return rewriter.notifyMatchFailure(gemmOp, "Not the head of the chain");
+    SmallVector<tpp::GemmOp> chain = {gemmOp};
+    while (tpp::GemmOp next = getNextChainedGemm(chain.back()))
+      chain.push_back(next);
+    if (chain.size() < 2)
+      return rewriter.notifyMatchFailure(gemmOp, "Expect a chain of gemms");
+
+    auto dims = getSizesAndLeadingDimsForGemmLikeOp(rewriter, gemmOp);
+    if (failed(dims)) {
+      return rewriter.notifyMatchFailure(
+          gemmOp, "Cannot compute leading dims or sizes");
+    }
+
+    bool zeroInit = foldZeroInit && foldZeroInitialization(rewriter, gemmOp);
+
+    // All the operands are available at the last gemm, and no op in between
+    // touches memory.
+    tpp::GemmOp lastGemm = chain.back();
+    Location loc = lastGemm.getLoc();
+    rewriter.setInsertionPoint(lastGemm);
+    SmallVector<Value> blocksA, blocksB;
+    for (tpp::GemmOp gemm : chain) {
+      blocksA.push_back(gemm.getInputs()[0]);
+      blocksB.push_back(gemm.getInputs()[1]);
+    }
+    Value addressesA = buildBlockAddresses(rewriter, lastGemm, blocksA);
+    Value addressesB = buildBlockAddresses(rewriter, lastGemm, blocksB);
+
+    auto dtype = getDataType(rewriter, gemmOp);
+    IntegerType integer64 = IntegerType::get(rewriter.getContext(), 64);
+    Value dispatched = rewriter.create<xsmm::BrgemmAddrDispatchOp>(
+        loc, integer64, *dims, getDynamicSizesForGemmLikeOp(rewriter, gemmOp),
+        getGemmFlags(rewriter, gemmOp, zeroInit), dtype);
+    Value batchDim = rewriter.create<arith::ConstantOp>(
+        loc, integer64, rewriter.getIntegerAttr(integer64, chain.size()));
+    SmallVector<Value, 5> invokeOperands{dispatched, addressesA, addressesB,
+                                         gemmOp.getInputs()[2], batchDim};
+    rewriter.create<xsmm::BrgemmAddrOp>(loc, dtype, invokeOperands);
+    for (tpp::GemmOp gemm : chain)
+      rewriter.eraseOp(gemm);
+    return success();
+  }
+
+private:
+  bool foldZeroInit;
 };
 
 // Forward decl.
@@ -248,7 +875,9 @@ static xsmm::BinaryFlags getBinaryBCast(MemRefType operandType,
                                         size_t operandNumber);
 
 struct ConvertTppFusedBrgemmOp : public OpRewritePattern<tpp::FusedBrgemmOp> {
-  using OpRewritePattern<tpp::FusedBrgemmOp>::OpRewritePattern;
+  ConvertTppFusedBrgemmOp(MLIRContext *context, bool foldZeroInit)
+      : OpRewritePattern<tpp::FusedBrgemmOp>(context),
+        foldZeroInit(foldZeroInit) {}
 
   ArrayAttr getUnaryFlags(RewriterBase &rewriter,
                           tpp::FusedBrgemmOp brgemmOp) const {
@@ -281,11 +910,21 @@ struct ConvertTppFusedBrgemmOp : public OpRewritePattern<tpp::FusedBrgemmOp> {
                                    tpp::FusedBrgemmOp brgemmOp) const {
     auto kind = brgemmOp.getUnaryKind();
     auto ctx = rewriter.getContext();
-    if (kind == tpp::FusedUnaryOpKind::NONE)
+    switch (kind) {
+    case tpp::FusedUnaryOpKind::NONE:
       return xsmm::UnaryKindAttr::get(ctx, xsmm::UnaryKind::NONE);
-    if (kind == tpp::FusedUnaryOpKind::RELU)
+    case tpp::FusedUnaryOpKind::RELU:
       return xsmm::UnaryKindAttr::get(ctx, xsmm::UnaryKind::RELU);
-    assert(false && "invalid unary kind");
+    case tpp::FusedUnaryOpKind::GELU:
+      return xsmm::UnaryKindAttr::get(ctx, xsmm::UnaryKind::GELU);
+    case tpp::FusedUnaryOpKind::TANH:
+      return xsmm::UnaryKindAttr::get(ctx, xsmm::UnaryKind::TANH);
+    case tpp::FusedUnaryOpKind::SIGMOID:
+      return xsmm::UnaryKindAttr::get(ctx, xsmm::UnaryKind::SIGMOID);
+    case tpp::FusedUnaryOpKind::EXP:
+      return xsmm::UnaryKindAttr::get(ctx, xsmm::UnaryKind::EXP);
+    }
+    llvm_unreachable("invalid unary kind");
   }
 
   LogicalResult matchAndRewrite(tpp::FusedBrgemmOp brgemmOp,
@@ -316,20 +955,19 @@ struct ConvertTppFusedBrgemmOp : public OpRewritePattern<tpp::FusedBrgemmOp> {
       return rewriter.notifyMatchFailure(
           brgemmOp, "Cannot compute leading dims or sizes");
     }
-    auto memrefB = brgemmOp.getMemRefInputType(1);
-    int64_t batchSize = memrefB.getShape()[0];
-
     auto dtype = getDataType(rewriter, brgemmOp);
     IntegerType integer64 = IntegerType::get(rewriter.getContext(), 64);
+    bool zeroInit =
+        foldZeroInit && foldZeroInitialization(rewriter, brgemmOp);
 
     Value dispatched = rewriter.create<xsmm::FusedBrgemmDispatchOp>(
-        loc, integer64, *dims, getBinaryKind(rewriter, brgemmOp),
-        getUnaryKind(rewriter, brgemmOp), getGemmFlags(rewriter, brgemmOp),
+        loc, integer64, *dims, getDynamicSizesForGemmLikeOp(rewriter, brgemmOp),
+        getBinaryKind(rewriter, brgemmOp), getUnaryKind(rewriter, brgemmOp),
+        getGemmFlags(rewriter, brgemmOp, zeroInit),
         getUnaryFlags(rewriter, brgemmOp), getBinaryFlags(rewriter, brgemmOp),
         dtype);
 
-    Value batchDim = rewriter.create<arith::ConstantOp>(
-        loc, integer64, rewriter.getIntegerAttr(integer64, batchSize));
+    Value batchDim = getBatchDim(rewriter, loc, brgemmOp.getInputs()[1]);
     SmallVector<Value, 6> invokeOperands;
     invokeOperands.push_back(dispatched);
     invokeOperands.append(brgemmOp->getOperands().begin(),
@@ -341,6 +979,9 @@ struct ConvertTppFusedBrgemmOp : public OpRewritePattern<tpp::FusedBrgemmOp> {
                                                      invokeOperands);
     return success();
   }
+
+private:
+  bool foldZeroInit;
 };
 
 // ======================================== Unary/Binary Ops Lowering
@@ -366,9 +1007,14 @@ static LogicalResult lowerTPPtoXSMM(tpp::TppOp op, PatternRewriter &rewriter,
     dtype = xsmm::DataTypeAttr::get(ctx, xsmm::DataType::F32);
   }
 
-  Value dispatched =
-      rewriter.create<DispatchOp>(loc, integer64, kindAttr, dimsAttr,
-                                  rewriter.getArrayAttr(flagsAttr), dtype);
+  // The innermost dimensions, and thus n and the leading dimensions, are
+  // static: only m can be dynamic.
+  SmallVector<Value> dynamicDims;
+  if (ShapedType::isDynamic(dims[0]))
+    dynamicDims.push_back(getSizeAsI64(rewriter, loc, op.getOutput(), 0));
+  Value dispatched = rewriter.create<DispatchOp>(
+      loc, integer64, kindAttr, dimsAttr, dynamicDims,
+      rewriter.getArrayAttr(flagsAttr), dtype);
 
   SmallVector<Value> invokeOperands;
   invokeOperands.push_back(dispatched);
@@ -401,13 +1047,14 @@ static xsmm::UnaryFlags getUnaryFlags(tpp::TppOp tppOp) {
   assert(shapeOutput.size() == bShapeInput.size());
   shapeInput = bShapeInput;
 
-  if (shapeInput[1] == 1 && shapeOutput[1] > 1)
+  if (shapeInput[1] == 1 && shapeOutput[1] != 1)
     return xsmm::UnaryFlags::BCAST_ROW;
 
-  if (shapeInput[0] == 1 && shapeOutput[0] > 1)
+  if (shapeInput[0] == 1 && shapeOutput[0] != 1)
     return xsmm::UnaryFlags::BCAST_COL;
 
-  if (shapeInput[0] == shapeOutput[0] && shapeInput[1] == shapeOutput[1])
+  if (isCompatibleDim(shapeInput[0], shapeOutput[0]) &&
+      isCompatibleDim(shapeInput[1], shapeOutput[1]))
     return xsmm::UnaryFlags::NONE;
 
   assert(false && "failed to get bCast for tpp op");
@@ -469,13 +1116,391 @@ struct ConvertTppReluOp : public OpRewritePattern<tpp::ReluOp> {
   }
 };
 
+struct ConvertTppGeluOp : public OpRewritePattern<tpp::GeluOp> {
+  using OpRewritePattern<tpp::GeluOp>::OpRewritePattern;
+
+  LogicalResult matchAndRewrite(tpp::GeluOp geluOp,
+                                PatternRewriter &rewriter) const override {
+    return lowerUnaryTPPtoXSMM(rewriter, geluOp, xsmm::UnaryKind::GELU);
+  }
+};
+
+struct ConvertTppTanhOp : public OpRewritePattern<tpp::TanhOp> {
+  using OpRewritePattern<tpp::TanhOp>::OpRewritePattern;
+
+  LogicalResult matchAndRewrite(tpp::TanhOp tanhOp,
+                                PatternRewriter &rewriter) const override {
+    return lowerUnaryTPPtoXSMM(rewriter, tanhOp, xsmm::UnaryKind::TANH);
+  }
+};
+
+struct ConvertTppSigmoidOp : public OpRewritePattern<tpp::SigmoidOp> {
+  using OpRewritePattern<tpp::SigmoidOp>::OpRewritePattern;
+
+  LogicalResult matchAndRewrite(tpp::SigmoidOp sigmoidOp,
+                                PatternRewriter &rewriter) const override {
+    return lowerUnaryTPPtoXSMM(rewriter, sigmoidOp, xsmm::UnaryKind::SIGMOID);
+  }
+};
+
+struct ConvertTppExpOp : public OpRewritePattern<tpp::ExpOp> {
+  using OpRewritePattern<tpp::ExpOp>::OpRewritePattern;
+
+  LogicalResult matchAndRewrite(tpp::ExpOp expOp,
+                                PatternRewriter &rewriter) const override {
+    return lowerUnaryTPPtoXSMM(rewriter, expOp, xsmm::UnaryKind::EXP);
+  }
+};
+
+// Lower the tpp reduction `OpTy` to the LIBXSMM unary reduce kernel `kind`.
+// LIBXSMM sees the operands transposed, in column-major order: reducing each
+// row of the input (Mx1 output) collapses the LIBXSMM rows, reducing each
+// column (1xN output) collapses the LIBXSMM columns.
+template <typename OpTy, xsmm::UnaryKind kind>
+struct ConvertTppReduceOp : public OpRewritePattern<OpTy> {
+  using OpRewritePattern<OpTy>::OpRewritePattern;
+
+  LogicalResult matchAndRewrite(OpTy reduceOp,
+                                PatternRewriter &rewriter) const override {
+    if (!reduceOp.hasBufferSemantics()) {
+      return rewriter.notifyMatchFailure(reduceOp,
+                                         "xsmm expects a memref type");
+    }
+
+    auto inputMemRef =
+        reduceOp.getInputs()[0].getType().template cast<MemRefType>();
+    int64_t m = inputMemRef.getShape()[0];
+    int64_t n = inputMemRef.getShape()[1];
+    auto ldi = getLeadingDim(inputMemRef);
+    if (failed(ldi))
+      return rewriter.notifyMatchFailure(reduceOp, "cannot compute ldi");
+
+    // LIBXSMM writes the reduced values as a single contiguous vector.
+    xsmm::UnaryFlags flags = xsmm::UnaryFlags::REDUCE_ROWS;
+    if (reduceOp.getReductionDim() == 1) {
+      auto ldo = getLeadingDim(reduceOp.getOutputType());
+      if (failed(ldo) || *ldo != 1) {
+        return rewriter.notifyMatchFailure(reduceOp,
+                                           "expect a contiguous output");
+      }
+    } else {
+      // The dynamic size of m is taken from the output.
+      if (ShapedType::isDynamic(m)) {
+        return rewriter.notifyMatchFailure(
+            reduceOp, "expect a static number of reduced rows");
+      }
+      flags = xsmm::UnaryFlags::REDUCE_COLS;
+    }
+
+    return lowerTPPtoXSMM<xsmm::UnaryKind, xsmm::UnaryFlags,
+                          xsmm::UnaryKindAttr, xsmm::UnaryFlagsAttr,
+                          xsmm::UnaryDispatchOp, xsmm::UnaryOp>(
+        reduceOp, rewriter, inputMemRef.getElementType(), kind, flags,
+        {m, n, *ldi, /*ldo=*/n});
+  }
+};
+
+// Bytes of output the row-wise normalizations work on at once, so that a block
+// of rows stays in the L1 data cache across the kernels that read it.
+static constexpr int64_t kRowBlockBytes = 32 * 1024;
+
+// Return the number of rows of `memref` a row-wise normalization processes at
+// once: the largest divisor of the row count whose rows fit in kRowBlockBytes,
+// or a single row if the row count is dynamic.
+static int64_t getRowBlockSize(MemRefType memref) {
+  int64_t numRows = memref.getShape()[0];
+  if (ShapedType::isDynamic(numRows))
+    return 1;
+  int64_t rowBytes = memref.getShape()[1] * getElementSizeInBytes(memref);
+  for (int64_t rows = numRows; rows > 1; --rows) {
+    if (numRows % rows == 0 && rows * rowBytes <= kRowBlockBytes)
+      return rows;
+  }
+  return 1;
+}
+
+// Call `bodyFn` with the offset of each block of `rowBlock` rows of `output`,
+// within a parallel loop over the blocks: the blocks are independent, and
+// scratch buffers built in `bodyFn` with buildScratchBuffer are private to each
+// block. No loop is built if a single block covers all the rows.
+static void forEachRowBlock(RewriterBase &rewriter, Location loc, Value output,
+                            int64_t rowBlock,
+                            function_ref<void(Value)> bodyFn) {
+  auto outputMemRef = output.getType().cast<MemRefType>();
+  Value zero = rewriter.create<arith::ConstantIndexOp>(loc, 0);
+  if (rowBlock == outputMemRef.getShape()[0]) {
+    bodyFn(zero);
+    return;
+  }
+  Value numRows =
+      outputMemRef.isDynamicDim(0)
+          ? rewriter.create<memref::DimOp>(loc, output, 0).getResult()
+          : rewriter.create<arith::ConstantIndexOp>(
+                loc, outputMemRef.getShape()[0]);
+  Value step = rewriter.create<arith::ConstantIndexOp>(loc, rowBlock);
+  auto loop = rewriter.create<scf::ParallelOp>(
+      loc, ValueRange{zero}, ValueRange{numRows}, ValueRange{step});
+  OpBuilder::InsertionGuard guard(rewriter);
+  rewriter.setInsertionPoint(loop.getBody()->getTerminator());
+  bodyFn(loop.getInductionVars()[0]);
+}
+
+// Return the `rowBlock` rows of the 2d `memref` starting at row `offset`.
+static Value getRowBlock(RewriterBase &rewriter, Location loc, Value memref,
+                         Value offset, int64_t rowBlock) {
+  auto memrefType = memref.getType().cast<MemRefType>();
+  if (rowBlock == memrefType.getShape()[0])
+    return memref;
+  SmallVector<OpFoldResult> offsets = {offset, rewriter.getIndexAttr(0)};
+  SmallVector<OpFoldResult> sizes = {
+      rewriter.getIndexAttr(rowBlock),
+      rewriter.getIndexAttr(memrefType.getShape()[1])};
+  SmallVector<OpFoldResult> strides(2, rewriter.getIndexAttr(1));
+  return rewriter.create<memref::SubViewOp>(loc, memref, offsets, sizes,
+                                            strides);
+}
+
+// Decompose a tpp.softmax into a sequence of tpp operations, each mapping to a
+// single LIBXSMM kernel, applied block of rows by block of rows so that each
+// block stays in cache across the sequence: the row maxima and the row sums go
+// through a scratch buffer holding one value per row of the block, the
+// exponentials are written in place into the output.
+struct ConvertTppSoftmaxOp : public OpRewritePattern<tpp::SoftmaxOp> {
+  using OpRewritePattern<tpp::SoftmaxOp>::OpRewritePattern;
+
+  LogicalResult matchAndRewrite(tpp::SoftmaxOp softmaxOp,
+                                PatternRewriter &rewriter) const override {
+    if (!softmaxOp.hasBufferSemantics()) {
+      return rewriter.notifyMatchFailure(softmaxOp,
+                                         "xsmm expects a memref type");
+    }
+
+    Location loc = softmaxOp.getLoc();
+    Value input = softmaxOp.getInputs()[0];
+    Value output = softmaxOp.getOutput();
+    MemRefType outputMemRef = softmaxOp.getOutputType();
+    int64_t rowBlock = getRowBlockSize(outputMemRef);
+    auto rowsType =
+        MemRefType::get({rowBlock, 1}, outputMemRef.getElementType());
+
+    // exp(x - max(x)) / sum(exp(x - max(x))), row by row.
+    forEachRowBlock(rewriter, loc, output, rowBlock, [&](Value offset) {
+      Value in = getRowBlock(rewriter, loc, input, offset, rowBlock);
+      Value out = getRowBlock(rewriter, loc, output, offset, rowBlock);
+      Value rows = buildScratchBuffer(rewriter, loc, rowsType);
+      rewriter.create<tpp::ReduceMaxOp>(loc, in, rows);
+      rewriter.create<tpp::SubOp>(loc, ValueRange{in, rows}, out);
+      rewriter.create<tpp::ExpOp>(loc, out, out);
+      rewriter.create<tpp::ReduceAddOp>(loc, out, rows);
+      rewriter.create<tpp::DivOp>(loc, ValueRange{out, rows}, out);
+    });
+    rewriter.eraseOp(softmaxOp);
+    return success();
+  }
+};
+
+// Decompose a tpp.layernorm into a sequence of tpp operations, each mapping to
+// a single LIBXSMM kernel, applied block of rows by block of rows so that each
+// block stays in cache across the sequence. The row statistics go through
+// scratch buffers holding one value per row of the block and are finalized by
+// a loop over these rows; the squared centered input goes through a scratch
+// buffer the size of the block.
+struct ConvertTppLayerNormOp : public OpRewritePattern<tpp::LayerNormOp> {
+  using OpRewritePattern<tpp::LayerNormOp>::OpRewritePattern;
+
+  LogicalResult matchAndRewrite(tpp::LayerNormOp layerNormOp,
+                                PatternRewriter &rewriter) const override {
+    if (!layerNormOp.hasBufferSemantics()) {
+      return rewriter.notifyMatchFailure(layerNormOp,
+                                         "xsmm expects a memref type");
+    }
+
+    Location loc = layerNormOp.getLoc();
+    Value input = layerNormOp.getInputs()[0];
+    Value gamma = layerNormOp.getInputs()[1];
+    Value beta = layerNormOp.getInputs()[2];
+    Value output = layerNormOp.getOutput();
+    MemRefType outputMemRef = layerNormOp.getOutputType();
+    auto elementType = outputMemRef.getElementType().cast<FloatType>();
+    int64_t numCols = outputMemRef.getShape()[1];
+    int64_t rowBlock = getRowBlockSize(outputMemRef);
+    auto rowsType = MemRefType::get({rowBlock, 1}, elementType);
+    auto blockType = MemRefType::get({rowBlock, numCols}, elementType);
+
+    // Update each row statistic of the block in place with `updateFn`.
+    Value zero = rewriter.create<arith::ConstantIndexOp>(loc, 0);
+    Value one = rewriter.create<arith::ConstantIndexOp>(loc, 1);
+    Value numRows = rewriter.create<arith::ConstantIndexOp>(loc, rowBlock);
+    auto getConstant = [&](double value) -> Value {
+      return rewriter.create<arith::ConstantOp>(
+          loc, elementType, rewriter.getFloatAttr(elementType, value));
+    };
+    auto updateRows =
+        [&](Value rows,
+            function_ref<Value(OpBuilder &, Location, Value)> updateFn) {
+          rewriter.create<scf::ForOp>(
+              loc, zero, numRows, one, std::nullopt,
+              [&](OpBuilder &nestedBuilder, Location nestedLoc, Value iv,
+                  ValueRange iterArgs) {
+                Value stat = nestedBuilder.create<memref::LoadOp>(
+                    nestedLoc, rows, ValueRange{iv, zero});
+                nestedBuilder.create<memref::StoreOp>(
+                    nestedLoc, updateFn(nestedBuilder, nestedLoc, stat), rows,
+                    ValueRange{iv, zero});
+                nestedBuilder.create<scf::YieldOp>(nestedLoc);
+              });
+        };
+    Value invNumCols = getConstant(1.0 / numCols);
+    Value epsilon = getConstant(layerNormOp.getEpsilon().convertToFloat());
+
+    forEachRowBlock(rewriter, loc, output, rowBlock, [&](Value offset) {
+      Value in = getRowBlock(rewriter, loc, input, offset, rowBlock);
+      Value out = getRowBlock(rewriter, loc, output, offset, rowBlock);
+      Value mean = buildScratchBuffer(rewriter, loc, rowsType);
+      Value rstd = buildScratchBuffer(rewriter, loc, rowsType);
+      Value squared = buildScratchBuffer(rewriter, loc, blockType);
+      // mean = sum(x) / N.
+      rewriter.create<tpp::ReduceAddOp>(loc, in, mean);
+      updateRows(mean, [&](OpBuilder &b, Location statLoc, Value sum) -> Value {
+        return b.create<arith::MulFOp>(statLoc, sum, invNumCols);
+      });
+      // c = x - mean, rstd = rsqrt(sum(c * c) / N + epsilon).
+      rewriter.create<tpp::SubOp>(loc, ValueRange{in, mean}, out);
+      rewriter.create<tpp::MulOp>(loc, ValueRange{out, out}, squared);
+      rewriter.create<tpp::ReduceAddOp>(loc, squared, rstd);
+      updateRows(rstd, [&](OpBuilder &b, Location statLoc, Value sum) -> Value {
+        Value var = b.create<arith::MulFOp>(statLoc, sum, invNumCols);
+        Value shifted = b.create<arith::AddFOp>(statLoc, var, epsilon);
+        return b.create<math::RsqrtOp>(statLoc, shifted);
+      });
+      // out = c * rstd * gamma + beta.
+      rewriter.create<tpp::MulOp>(loc, ValueRange{out, rstd}, out);
+      rewriter.create<tpp::MulOp>(loc, ValueRange{out, gamma}, out);
+      rewriter.create<tpp::AddOp>(loc, ValueRange{out, beta}, out);
+    });
+    rewriter.eraseOp(layerNormOp);
+    return success();
+  }
+};
+
+// Map the broadcast of the operand `operandNumber`, 1 or 2, of a ternary
+// kernel to the ternary flags. The broadcast is the one of a binary operand.
+static xsmm::TernaryFlags getTernaryBCast(MemRefType operandType,
+                                          MemRefType outputType,
+                                          size_t operandNumber) {
+  assert((operandNumber == 1 || operandNumber == 2) && "Expect idx 1 or 2");
+  bool isIn1 = operandNumber == 1;
+  switch (getBinaryBCast(operandType, outputType, /*operandNumber=*/1)) {
+  case xsmm::BinaryFlags::NONE:
+    return xsmm::TernaryFlags::NONE;
+  case xsmm::BinaryFlags::BCAST_ROW_IN_1:
+    return isIn1 ? xsmm::TernaryFlags::BCAST_ROW_IN_1
+                 : xsmm::TernaryFlags::BCAST_ROW_IN_2;
+  case xsmm::BinaryFlags::BCAST_COL_IN_1:
+    return isIn1 ? xsmm::TernaryFlags::BCAST_COL_IN_1
+                 : xsmm::TernaryFlags::BCAST_COL_IN_2;
+  case xsmm::BinaryFlags::BCAST_SCALAR_IN_1:
+    return isIn1 ? xsmm::TernaryFlags::BCAST_SCALAR_IN_1
+                 : xsmm::TernaryFlags::BCAST_SCALAR_IN_2;
+  default:
+    llvm_unreachable("unexpected broadcast of the second operand");
+  }
+}
+
+// Lower a tpp.dequantize to a chain of LIBXSMM kernels on the tile: an identity
+// converting the i32 accumulator into the output type, a ternary muladd
+// applying the scale and the bias in place, then the optional relu.
+struct ConvertTppDequantizeOp : public OpRewritePattern<tpp::DequantizeOp> {
+  using OpRewritePattern<tpp::DequantizeOp>::OpRewritePattern;
+
+  LogicalResult matchAndRewrite(tpp::DequantizeOp dequantizeOp,
+                                PatternRewriter &rewriter) const override {
+    if (!dequantizeOp.hasBufferSemantics()) {
+      return rewriter.notifyMatchFailure(dequantizeOp,
+                                         "xsmm expects a memref type");
+    }
+
+    Location loc = dequantizeOp.getLoc();
+    Value acc = dequantizeOp.getInputs()[0];
+    Value scale = dequantizeOp.getInputs()[1];
+    Value bias = dequantizeOp.getInputs()[2];
+    Value output = dequantizeOp.getOutput();
+    MemRefType outputMemRef = dequantizeOp.getOutputType();
+    auto ldi = getLeadingDim(acc.getType());
+    auto ldo = getLeadingDim(outputMemRef);
+    auto ldScale = getLeadingDim(scale.getType());
+    auto ldBias = getLeadingDim(bias.getType());
+    if (failed(ldi) || failed(ldo) || failed(ldScale) || failed(ldBias)) {
+      return rewriter.notifyMatchFailure(dequantizeOp,
+                                         "cannot compute leading dims");
+    }
+
+    auto *ctx = rewriter.getContext();
+    IntegerType integer64 = IntegerType::get(ctx, 64);
+    xsmm::DataTypeAttr dtype = getDataType(rewriter, dequantizeOp);
+    int64_t m = outputMemRef.getShape()[0];
+    int64_t n = outputMemRef.getShape()[1];
+    // Only m can be dynamic, see lowerTPPtoXSMM.
+    SmallVector<Value> dynamicDims;
+    if (ShapedType::isDynamic(m))
+      dynamicDims.push_back(getSizeAsI64(rewriter, loc, output, 0));
+
+    // out = acc, converted from i32.
+    auto identity = xsmm::UnaryKindAttr::get(ctx, xsmm::UnaryKind::IDENTITY);
+    Value convert = rewriter.create<xsmm::UnaryDispatchOp>(
+        loc, integer64, identity,
+        DenseI64ArrayAttr::get(ctx, {m, n, *ldi, *ldo}), dynamicDims,
+        rewriter.getArrayAttr(
+            xsmm::UnaryFlagsAttr::get(ctx, xsmm::UnaryFlags::NONE)),
+        dtype, xsmm::DataTypeAttr::get(ctx, xsmm::DataType::I32));
+    rewriter.create<xsmm::UnaryOp>(loc, dtype, identity,
+                                   ValueRange{convert, acc, output});
+
+    // out = out * scale + bias.
+    SmallVector<Attribute> flags;
+    SmallVector<Value> operands = {scale, bias};
+    for (auto [idx, operand] : llvm::enumerate(operands)) {
+      xsmm::TernaryFlags flag = getTernaryBCast(
+          operand.getType().cast<MemRefType>(), outputMemRef, idx + 1);
+      if (flag != xsmm::TernaryFlags::NONE)
+        flags.push_back(xsmm::TernaryFlagsAttr::get(ctx, flag));
+    }
+    if (flags.empty()) {
+      flags.push_back(
+          xsmm::TernaryFlagsAttr::get(ctx, xsmm::TernaryFlags::NONE));
+    }
+    auto muladd = xsmm::TernaryKindAttr::get(ctx, xsmm::TernaryKind::MULADD);
+    Value scaleAndBias = rewriter.create<xsmm::TernaryDispatchOp>(
+        loc, integer64, muladd,
+        DenseI64ArrayAttr::get(ctx, {m, n, *ldo, *ldScale, *ldBias, *ldo}),
+        dynamicDims, rewriter.getArrayAttr(flags), dtype);
+    rewriter.create<xsmm::TernaryOp>(
+        loc, dtype, muladd,
+        ValueRange{scaleAndBias, output, scale, bias, output});
+
+    if (dequantizeOp.getRelu())
+      rewriter.create<tpp::ReluOp>(loc, output, output);
+    rewriter.eraseOp(dequantizeOp);
+    return success();
+  }
+};
+
 struct ConvertTppZeroOp : public OpRewritePattern<tpp::ZeroOp> {
-  using OpRewritePattern<tpp::ZeroOp>::OpRewritePattern;
+  ConvertTppZeroOp(MLIRContext *context, bool foldZeroInit)
+      : OpRewritePattern<tpp::ZeroOp>(context), foldZeroInit(foldZeroInit) {}
 
   LogicalResult matchAndRewrite(tpp::ZeroOp zeroOp,
                                 PatternRewriter &rewriter) const override {
+    // Left to the gemm it folds into.
+    if (foldZeroInit && getZeroInitializedGemm(zeroOp)) {
+      return rewriter.notifyMatchFailure(zeroOp,
+                                         "Folded into the consuming gemm");
+    }
     return lowerUnaryTPPtoXSMM(rewriter, zeroOp, xsmm::UnaryKind::ZERO);
   }
+
+private:
+  bool foldZeroInit;
 };
 
 // Given the operand type and the output type return the broadcast
@@ -531,46 +1556,56 @@ static xsmm::BinaryFlags getBinaryBCast(MemRefType operandType,
   if (llvm::all_of(bOperandShape, isOne))
     return getBCastEnum(BCastType::SCALAR, operandNumber);
 
-  if (bOperandShape[1] == 1 && shapeOutput[1] > 1)
+  if (bOperandShape[1] == 1 && shapeOutput[1] != 1)
     return getBCastEnum(BCastType::ROW, operandNumber);
-  if (bOperandShape[0] == 1 && shapeOutput[0] > 1)
+  if (bOperandShape[0] == 1 && shapeOutput[0] != 1)
     return getBCastEnum(BCastType::COL, operandNumber);
-  if (bOperandShape == shapeOutput)
+  if (isCompatibleDim(bOperandShape[0], shapeOutput[0]) &&
+      isCompatibleDim(bOperandShape[1], shapeOutput[1]))
     return getBCastEnum(BCastType::NONE, operandNumber);
 
-  assert(false && "failed to get bCast for tpp.add");
+  assert(false && "failed to get bCast for tpp binary op");
 }
 
-struct ConvertTppAddOp : public OpRewritePattern<tpp::AddOp> {
-  using OpRewritePattern<tpp::AddOp>::OpRewritePattern;
+// Lower the element-wise tpp binary operation `OpTy` to the LIBXSMM binary
+// kernel `kind`. The broadcast of the operands maps to the binary flags.
+template <typename OpTy, xsmm::BinaryKind kind>
+struct ConvertTppEltwiseBinaryOp : public OpRewritePattern<OpTy> {
+  using OpRewritePattern<OpTy>::OpRewritePattern;
 
-  LogicalResult matchAndRewrite(tpp::AddOp addOp,
+  LogicalResult matchAndRewrite(OpTy binaryOp,
                                 PatternRewriter &rewriter) const override {
-    if (!addOp.hasBufferSemantics())
-      return rewriter.notifyMatchFailure(addOp, "xsmm expects a memref type");
+    if (!binaryOp.hasBufferSemantics()) {
+      return rewriter.notifyMatchFailure(binaryOp,
+                                         "xsmm expects a memref type");
+    }
 
-    MemRefType outputMemRef = addOp.getOutputType();
+    MemRefType outputMemRef = binaryOp.getOutputType();
     assert(outputMemRef.getRank() == 2 && "expect rank 2 for TPP ops");
 
     int64_t m = outputMemRef.getShape()[0];
     int64_t n = outputMemRef.getShape()[1];
 
-    auto lhsMemRef = addOp.getInputs()[0].getType().cast<MemRefType>();
-    auto rhsMemRef = addOp.getInputs()[1].getType().cast<MemRefType>();
+    auto lhsMemRef =
+        binaryOp.getInputs()[0].getType().template cast<MemRefType>();
+    auto rhsMemRef =
+        binaryOp.getInputs()[1].getType().template cast<MemRefType>();
 
     auto ldiLhsDim = getLeadingDim(lhsMemRef);
     if (failed(ldiLhsDim))
-      return rewriter.notifyMatchFailure(addOp, "Cannot compute ldi on lhs");
+      return rewriter.notifyMatchFailure(binaryOp,
+                                         "Cannot compute ldi on lhs");
     int64_t ldiLhs = *ldiLhsDim;
 
     auto ldiRhsDim = getLeadingDim(rhsMemRef);
     if (failed(ldiRhsDim))
-      return rewriter.notifyMatchFailure(addOp, "Cannot compute ldi on rhs");
+      return rewriter.notifyMatchFailure(binaryOp,
+                                         "Cannot compute ldi on rhs");
     int64_t ldiRhs = *ldiRhsDim;
 
     auto ldoDim = getLeadingDim(outputMemRef);
     if (failed(ldoDim))
-      return rewriter.notifyMatchFailure(addOp, "Cannot compute ldo");
+      return rewriter.notifyMatchFailure(binaryOp, "Cannot compute ldo");
     int64_t ldo = *ldoDim;
 
     xsmm::BinaryFlags bCastOnLhs = getBinaryBCast(lhsMemRef, outputMemRef, 0);
@@ -582,29 +1617,49 @@ struct ConvertTppAddOp : public OpRewritePattern<tpp::AddOp> {
     xsmm::BinaryFlags bCast =
         (bCastOnLhs != xsmm::BinaryFlags::NONE) ? bCastOnLhs : bCastOnRhs;
 
-    return lowerBinaryTPPtoXSMM(addOp, rewriter, outputMemRef.getElementType(),
-                                xsmm::BinaryKind::ADD, bCast,
+    return lowerBinaryTPPtoXSMM(binaryOp, rewriter,
+                                outputMemRef.getElementType(), kind, bCast,
                                 {m, n, ldiLhs, ldiRhs, ldo});
   }
 };
 
 struct ConvertTppToXsmm : public ConvertTppToXsmmBase<ConvertTppToXsmm> {
+  ConvertTppToXsmm() = default;
+  ConvertTppToXsmm(bool prefetch, bool foldZeroInit) {
+    this->prefetch = prefetch;
+    this->foldZeroInit = foldZeroInit;
+  }
   void runOnOperation() override {
     RewritePatternSet patterns(&getContext());
-    tpp::populateTppToXsmmPatterns(patterns);
+    tpp::populateTppToXsmmPatterns(patterns, prefetch, foldZeroInit);
     (void)applyPatternsAndFoldGreedily(getOperation(), std::move(patterns));
   }
 };
 
 } // namespace
 
-void mlir::tpp::populateTppToXsmmPatterns(RewritePatternSet &patterns) {
-  patterns.add<ConvertTppIdentityOp, ConvertTppReluOp, ConvertTppZeroOp,
-               ConvertTppAddOp, ConvertTppGemmOp, ConvertTppBrgemmOp,
-               ConvertTppFusedBrgemmOp>(patterns.getContext());
+void mlir::tpp::populateTppToXsmmPatterns(RewritePatternSet &patterns,
+                                          bool prefetch, bool foldZeroInit) {
+  patterns.add<ConvertTppIdentityOp, ConvertTppReluOp, ConvertTppGeluOp,
+               ConvertTppTanhOp, ConvertTppSigmoidOp, ConvertTppExpOp,
+               ConvertTppEltwiseBinaryOp<tpp::AddOp, xsmm::BinaryKind::ADD>,
+               ConvertTppEltwiseBinaryOp<tpp::MulOp, xsmm::BinaryKind::MUL>,
+               ConvertTppEltwiseBinaryOp<tpp::SubOp, xsmm::BinaryKind::SUB>,
+               ConvertTppEltwiseBinaryOp<tpp::DivOp, xsmm::BinaryKind::DIV>,
+               ConvertTppEltwiseBinaryOp<tpp::MaxOp, xsmm::BinaryKind::MAX>,
+               ConvertTppReduceOp<tpp::ReduceAddOp,
+                                  xsmm::UnaryKind::REDUCE_X_OP_ADD>,
+               ConvertTppReduceOp<tpp::ReduceMaxOp,
+                                  xsmm::UnaryKind::REDUCE_X_OP_MAX>,
+               ConvertTppSoftmaxOp, ConvertTppLayerNormOp,
+               ConvertTppDequantizeOp>(patterns.getContext());
+  patterns.add<ConvertTppZeroOp, ConvertTppGemmChainOp,
+               ConvertTppFusedBrgemmOp>(patterns.getContext(), foldZeroInit);
+  patterns.add<ConvertTppGemmOp, ConvertTppBrgemmOp>(patterns.getContext(),
+                                                     prefetch, foldZeroInit);
 }
 
 std::unique_ptr<OperationPass<func::FuncOp>>
-mlir::tpp::createConvertTppToXsmmPass() {
-  return std::make_unique<ConvertTppToXsmm>();
+mlir::tpp::createConvertTppToXsmmPass(bool prefetch, bool foldZeroInit) {
+  return std::make_unique<ConvertTppToXsmm>(prefetch, foldZeroInit);
 }
@@ -14,6 +14,9 @@
 #include "mlir/Dialect/Func/IR/FuncOps.h"
 #include "mlir/Dialect/LLVMIR/LLVMDialect.h"
 #include "mlir/Dialect/MemRef/IR/MemRef.h"
+#include "mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/IR/PatternMatch.h"
+#include "mlir/IR/SymbolTable.h"
 #include "mlir/Transforms/GreedyPatternRewriteDriver.h"
 
 using namespace mlir;
@@ -31,11 +34,12 @@ namespace {
 
 static SmallVector<Type> extractInvokeOperandTypes(OperandRange operands,
                                                    IndexType indexType,
-                                                   PatternRewriter &rewriter) {
+                                                   PatternRewriter &rewriter,
+                                                   unsigned numDataTypes) {
   SmallVector<Type> results;
-  // One extra operand for datatype
+  // Extra operands for the datatypes
   IntegerType integer64 = IntegerType::get(rewriter.getContext(), 64);
-  results.push_back(integer64);
+  results.append(numDataTypes, integer64);
   for (Value operand : operands) {
     Type operandType = operand.getType();
     if (auto memrefType = operandType.dyn_cast<MemRefType>()) {
@@ -55,11 +59,13 @@ static SmallVector<Type> extractInvokeOperandTypes(OperandRange operands,
 // extract the aligned pointer and the offset.
 static SmallVector<Value> getOperands(OpBuilder &builder, Location loc,
                                       ValueRange operands,
-                                      IntegerAttr dataTypeAttr) {
+                                      ArrayRef<IntegerAttr> dataTypeAttrs) {
   SmallVector<Value> res;
   IntegerType integer64 = IntegerType::get(builder.getContext(), 64);
-  res.push_back(
-      builder.create<arith::ConstantOp>(loc, integer64, dataTypeAttr));
+  for (IntegerAttr dataTypeAttr : dataTypeAttrs) {
+    res.push_back(
+        builder.create<arith::ConstantOp>(loc, integer64, dataTypeAttr));
+  }
 
   for (Value operand : operands) {
     auto memrefType = operand.getType().dyn_cast<MemRefType>();
@@ -91,14 +97,16 @@ static SmallVector<Value> getOperands(OpBuilder &builder, Location loc,
   return res;
 }
 
+// Build the call to `funcName`. The leading operands are the data types, most
+// kernels take a single one.
 static LogicalResult buildInvokeCall(Location loc, std::string funcName,
                                      Operation *op, PatternRewriter &rewriter,
-                                     IntegerAttr dataTypeAttr) {
+                                     ArrayRef<IntegerAttr> dataTypeAttrs) {
   FlatSymbolRefAttr fnName = SymbolRefAttr::get(op->getContext(), funcName);
   ModuleOp module = op->getParentOfType<ModuleOp>();
   auto libFnType = rewriter.getFunctionType(
       extractInvokeOperandTypes(op->getOperands(), rewriter.getIndexType(),
-                                rewriter),
+                                rewriter, dataTypeAttrs.size()),
       {});
 
   if (!module.lookupSymbol(fnName)) {
@@ -113,7 +121,7 @@ static LogicalResult buildInvokeCall(Location loc, std::string funcName,
 
   rewriter.create<func::CallOp>(
       loc, fnName.getValue(), TypeRange(),
-      getOperands(rewriter, loc, op->getOperands(), dataTypeAttr));
+      getOperands(rewriter, loc, op->getOperands(), dataTypeAttrs));
   return success();
 }
 
@@ -122,8 +130,7 @@ struct ConvertTernaryXsmmOp : public OpRewritePattern<TernaryOp> {
 
   LogicalResult matchAndRewrite(TernaryOp ternaryOp,
                                 PatternRewriter &rewriter) const override {
-    std::string funcName =
-        "xsmm_" + stringifyEnum(ternaryOp.getCallee()).str() + "_invoke";
+    std::string funcName = "xsmm_ternary_invoke";
     if (succeeded(buildInvokeCall(ternaryOp.getLoc(), funcName, ternaryOp,
                                   rewriter, ternaryOp.getDataTypeAttr()))) {
       rewriter.eraseOp(ternaryOp);
@@ -163,6 +170,83 @@ struct ConvertBrgemmXsmmOp : public OpRewritePattern<BrgemmOp> {
   }
 };
 
+struct ConvertGemmPrefetchXsmmOp : public OpRewritePattern<GemmPrefetchOp> {
+  using OpRewritePattern<GemmPrefetchOp>::OpRewritePattern;
+
+  LogicalResult matchAndRewrite(GemmPrefetchOp gemmOp,
+                                PatternRewriter &rewriter) const override {
+    std::string funcName = "xsmm_gemm_prefetch_invoke";
+    if (succeeded(buildInvokeCall(gemmOp.getLoc(), funcName, gemmOp, rewriter,
+                                  gemmOp.getDataTypeAttr()))) {
+      rewriter.eraseOp(gemmOp);
+      return success();
+    }
+    return failure();
+  }
+};
+
+struct ConvertBrgemmPrefetchXsmmOp
+    : public OpRewritePattern<BrgemmPrefetchOp> {
+  using OpRewritePattern<BrgemmPrefetchOp>::OpRewritePattern;
+
+  LogicalResult matchAndRewrite(BrgemmPrefetchOp brgemmOp,
+                                PatternRewriter &rewriter) const override {
+    std::string funcName = "xsmm_brgemm_prefetch_invoke";
+    if (succeeded(buildInvokeCall(brgemmOp.getLoc(), funcName, brgemmOp,
+                                  rewriter, brgemmOp.getDataTypeAttr()))) {
+      rewriter.eraseOp(brgemmOp);
+      return success();
+    }
+    return failure();
+  }
+};
+
+struct ConvertBrgemmOffsXsmmOp : public OpRewritePattern<BrgemmOffsOp> {
+  using OpRewritePattern<BrgemmOffsOp>::OpRewritePattern;
+
+  LogicalResult matchAndRewrite(BrgemmOffsOp brgemmOp,
+                                PatternRewriter &rewriter) const override {
+    std::string funcName = "xsmm_brgemm_offs_invoke";
+    if (succeeded(buildInvokeCall(brgemmOp.getLoc(), funcName, brgemmOp,
+                                  rewriter, brgemmOp.getDataTypeAttr()))) {
+      rewriter.eraseOp(brgemmOp);
+      return success();
+    }
+    return failure();
+  }
+};
+
+struct ConvertBrgemmAddrXsmmOp : public OpRewritePattern<BrgemmAddrOp> {
+  using OpRewritePattern<BrgemmAddrOp>::OpRewritePattern;
+
+  LogicalResult matchAndRewrite(BrgemmAddrOp brgemmOp,
+                                PatternRewriter &rewriter) const override {
+    std::string funcName = "xsmm_brgemm_addr_invoke";
+    if (succeeded(buildInvokeCall(brgemmOp.getLoc(), funcName, brgemmOp,
+                                  rewriter, brgemmOp.getDataTypeAttr()))) {
+      rewriter.eraseOp(brgemmOp);
+      return success();
+    }
+    return failure();
+  }
+};
+
+// Return the data type of the input of `unaryOp` if it differs from the data
+// type of the kernel, std::nullopt otherwise.
+static std::optional<DataType> getConvertedDataType(UnaryOp unaryOp) {
+  auto inputType = unaryOp.getInputs()[1].getType().cast<MemRefType>();
+  auto outputType = unaryOp.getInputs()[2].getType().cast<MemRefType>();
+  Type inputElementType = inputType.getElementType();
+  if (inputElementType == outputType.getElementType())
+    return std::nullopt;
+  if (inputElementType.isInteger(32))
+    return DataType::I32;
+  if (inputElementType.isBF16())
+    return DataType::BF16;
+  assert(inputElementType.isF32() && "unexpected input type");
+  return DataType::F32;
+}
+
 struct ConvertUnaryXsmmOp : public OpRewritePattern<UnaryOp> {
   using OpRewritePattern<UnaryOp>::OpRewritePattern;
 
@@ -173,10 +257,19 @@ struct ConvertUnaryXsmmOp : public OpRewritePattern<UnaryOp> {
     // "unary" to "unary_scalar"). We also don't want to convert
     // the scalar to a memref by using an alloc/alloca.
     std::string funcName = "xsmm_unary_invoke";
-    if (unaryOp.hasScalarInput())
+    SmallVector<IntegerAttr> dataTypeAttrs = {unaryOp.getDataTypeAttr()};
+    if (unaryOp.hasScalarInput()) {
       funcName = "xsmm_unary_scalar_invoke";
+    } else if (std::optional<DataType> inputDataType =
+                   getConvertedDataType(unaryOp)) {
+      // A converting kernel also takes the type of its input, under its own
+      // name as the pointer types differ.
+      funcName = "xsmm_unary_convert_invoke";
+      dataTypeAttrs.push_back(
+          DataTypeAttr::get(rewriter.getContext(), *inputDataType));
+    }
     if (succeeded(buildInvokeCall(unaryOp.getLoc(), funcName, unaryOp, rewriter,
-                                  unaryOp.getDataTypeAttr()))) {
+                                  dataTypeAttrs))) {
       rewriter.eraseOp(unaryOp);
       return success();
     }
@@ -266,6 +359,31 @@ void addKindOperand(RewriterBase &rewriter, BrgemmDispatchOp dispatchOp,
   /* do nothing */
 }
 
+void addKindOperand(RewriterBase &rewriter, GemmPrefetchDispatchOp dispatchOp,
+                    SmallVectorImpl<Value> &dispatchOperands,
+                    SmallVectorImpl<Type> &dispatchOperandTypes) {
+  /* do nothing */
+}
+
+void addKindOperand(RewriterBase &rewriter,
+                    BrgemmPrefetchDispatchOp dispatchOp,
+                    SmallVectorImpl<Value> &dispatchOperands,
+                    SmallVectorImpl<Type> &dispatchOperandTypes) {
+  /* do nothing */
+}
+
+void addKindOperand(RewriterBase &rewriter, BrgemmOffsDispatchOp dispatchOp,
+                    SmallVectorImpl<Value> &dispatchOperands,
+                    SmallVectorImpl<Type> &dispatchOperandTypes) {
+  /* do nothing */
+}
+
+void addKindOperand(RewriterBase &rewriter, BrgemmAddrDispatchOp dispatchOp,
+                    SmallVectorImpl<Value> &dispatchOperands,
+                    SmallVectorImpl<Type> &dispatchOperandTypes) {
+  /* do nothing */
+}
+
 void addKindOperand(RewriterBase &rewriter, FusedBrgemmDispatchOp dispatchOp,
                     SmallVectorImpl<Value> &dispatchOperands,
                     SmallVectorImpl<Type> &dispatchOperandTypes) {
@@ -337,13 +455,30 @@ static LogicalResult buildDispatchOp(RewriterBase &rewriter, OpTy dispatchOp,
       loc, integer64, cast<TypedAttr>(dispatchOp.getDataTypeAttr())));
   dispatchOperandTypes.push_back(integer64);
 
-  // Dispatch the inputs.
+  // A converting unary also dispatches the data type of its input.
+  if (auto unaryDispatchOp = dyn_cast_or_null<xsmm::UnaryDispatchOp>(
+          dispatchOp.getOperation())) {
+    if (auto inputDataType = unaryDispatchOp.getInputDataTypeAttr()) {
+      dispatchOperands.push_back(rewriter.create<arith::ConstantOp>(
+          loc, integer64, cast<TypedAttr>(inputDataType)));
+      dispatchOperandTypes.push_back(integer64);
+    }
+  }
+
+  // Dispatch the inputs. The sizes only known at runtime are forwarded, the
+  // runtime caches the kernel per concrete shape.
   ArrayRef<int64_t> integers = dispatchOp.getInputsAttr().asArrayRef();
+  auto dynamicInputs = dispatchOp.getDynamicInputs().begin();
   size_t arrayAttrSize = integers.size();
   for (size_t idx = 0; idx < arrayAttrSize; idx++) {
-    IntegerAttr attr = IntegerAttr::get(rewriter.getI64Type(), integers[idx]);
-    dispatchOperands.push_back(
-        rewriter.create<arith::ConstantOp>(loc, integer64, attr));
+    if (ShapedType::isDynamic(integers[idx])) {
+      dispatchOperands.push_back(*dynamicInputs++);
+    } else {
+      IntegerAttr attr =
+          IntegerAttr::get(rewriter.getI64Type(), integers[idx]);
+      dispatchOperands.push_back(
+          rewriter.create<arith::ConstantOp>(loc, integer64, attr));
+    }
     dispatchOperandTypes.push_back(integer64);
   }
 
@@ -359,6 +494,10 @@ static LogicalResult buildDispatchOp(RewriterBase &rewriter, OpTy dispatchOp,
         intAttr = static_cast<int64_t>(GemmFlags::VNNI_B);
       if (gemmFlag.getValue() == GemmFlags::VNNI_B)
         intAttr = static_cast<int64_t>(GemmFlags::VNNI_A);
+      if (gemmFlag.getValue() == GemmFlags::TRANS_A)
+        intAttr = static_cast<int64_t>(GemmFlags::TRANS_B);
+      if (gemmFlag.getValue() == GemmFlags::TRANS_B)
+        intAttr = static_cast<int64_t>(GemmFlags::TRANS_A);
     }
     oredFlag |= intAttr;
   }
@@ -398,6 +537,50 @@ struct ConvertBrgemmDispatchOp : public OpRewritePattern<BrgemmDispatchOp> {
   }
 };
 
+struct ConvertGemmPrefetchDispatchOp
+    : public OpRewritePattern<GemmPrefetchDispatchOp> {
+  using OpRewritePattern<GemmPrefetchDispatchOp>::OpRewritePattern;
+
+  LogicalResult matchAndRewrite(GemmPrefetchDispatchOp dispatchOp,
+                                PatternRewriter &rewriter) const override {
+    return buildDispatchOp<GemmPrefetchDispatchOp>(
+        rewriter, dispatchOp, "xsmm_gemm_prefetch_dispatch");
+  }
+};
+
+struct ConvertBrgemmPrefetchDispatchOp
+    : public OpRewritePattern<BrgemmPrefetchDispatchOp> {
+  using OpRewritePattern<BrgemmPrefetchDispatchOp>::OpRewritePattern;
+
+  LogicalResult matchAndRewrite(BrgemmPrefetchDispatchOp dispatchOp,
+                                PatternRewriter &rewriter) const override {
+    return buildDispatchOp<BrgemmPrefetchDispatchOp>(
+        rewriter, dispatchOp, "xsmm_brgemm_prefetch_dispatch");
+  }
+};
+
+struct ConvertBrgemmOffsDispatchOp
+    : public OpRewritePattern<BrgemmOffsDispatchOp> {
+  using OpRewritePattern<BrgemmOffsDispatchOp>::OpRewritePattern;
+
+  LogicalResult matchAndRewrite(BrgemmOffsDispatchOp dispatchOp,
+                                PatternRewriter &rewriter) const override {
+    return buildDispatchOp<BrgemmOffsDispatchOp>(rewriter, dispatchOp,
+                                                 "xsmm_brgemm_offs_dispatch");
+  }
+};
+
+struct ConvertBrgemmAddrDispatchOp
+    : public OpRewritePattern<BrgemmAddrDispatchOp> {
+  using OpRewritePattern<BrgemmAddrDispatchOp>::OpRewritePattern;
+
+  LogicalResult matchAndRewrite(BrgemmAddrDispatchOp dispatchOp,
+                                PatternRewriter &rewriter) const override {
+    return buildDispatchOp<BrgemmAddrDispatchOp>(rewriter, dispatchOp,
+                                                 "xsmm_brgemm_addr_dispatch");
+  }
+};
+
 struct ConvertTernaryDispatchOp : public OpRewritePattern<TernaryDispatchOp> {
   using OpRewritePattern<TernaryDispatchOp>::OpRewritePattern;
 
@@ -423,8 +606,10 @@ struct ConvertUnaryDispatchOp : public OpRewritePattern<UnaryDispatchOp> {
 
   LogicalResult matchAndRewrite(UnaryDispatchOp dispatchOp,
                                 PatternRewriter &rewriter) const override {
-    return buildDispatchOp<UnaryDispatchOp>(rewriter, dispatchOp,
-                                            "xsmm_unary_dispatch");
+    std::string funcName = "xsmm_unary_dispatch";
+    if (dispatchOp.getInputDataType())
+      funcName = "xsmm_unary_convert_dispatch";
+    return buildDispatchOp<UnaryDispatchOp>(rewriter, dispatchOp, funcName);
   }
 };
 
@@ -447,9 +632,95 @@ struct ConvertFusedBrgemmOp : public OpRewritePattern<FusedBrgemmDispatchOp> {
   }
 };
 
+// Replace each dispatch with a lookup of a module-level handle holding the
+// kernel address. The handle is zero-initialized and filled by the first
+// caller; dispatching is idempotent, so concurrent first callers at worst
+// dispatch the same kernel twice. The handle is published with an atomic
+// exchange and read with an acquire load, so a thread observing a kernel
+// address also observes the generated code. Dispatches with the same
+// attributes share a handle, also across functions; distinct dispatches of the
+// same kind get uniqued handle names. Dispatches with sizes only known at
+// runtime may return a different kernel at each call and are left alone.
+static void buildGlobalDispatchHandles(ModuleOp module) {
+  SmallVector<Operation *> dispatchOps;
+  module->walk([&](Operation *op) {
+    if (isa<GemmDispatchOp, BrgemmDispatchOp, GemmPrefetchDispatchOp,
+            BrgemmPrefetchDispatchOp, BrgemmOffsDispatchOp,
+            BrgemmAddrDispatchOp, FusedBrgemmDispatchOp, UnaryDispatchOp,
+            BinaryDispatchOp, TernaryDispatchOp>(op) &&
+        op->getNumOperands() == 0)
+      dispatchOps.push_back(op);
+  });
+  if (dispatchOps.empty())
+    return;
+
+  SymbolTable symbolTable(module);
+  IRRewriter rewriter(module.getContext());
+  IntegerType integer64 = rewriter.getI64Type();
+  MemRefType handleType = MemRefType::get({}, integer64);
+  auto initialValue = DenseElementsAttr::get(
+      RankedTensorType::get({}, integer64), rewriter.getI64IntegerAttr(0));
+  DenseMap<std::pair<OperationName, DictionaryAttr>, memref::GlobalOp>
+      handles;
+
+  for (Operation *dispatchOp : dispatchOps) {
+    Location loc = dispatchOp->getLoc();
+    memref::GlobalOp &handle =
+        handles[{dispatchOp->getName(), dispatchOp->getAttrDictionary()}];
+    if (!handle) {
+      // Must not clash with the names of the runtime functions.
+      std::string name = "__" + dispatchOp->getName().getStringRef().str();
+      std::replace(name.begin(), name.end(), '.', '_');
+      rewriter.setInsertionPointToStart(module.getBody());
+      handle = rewriter.create<memref::GlobalOp>(
+          loc, name + "_handle", rewriter.getStringAttr("private"), handleType,
+          initialValue, /*constant=*/false, /*alignment=*/IntegerAttr());
+      symbolTable.insert(handle);
+    }
+
+    rewriter.setInsertionPoint(dispatchOp);
+    Value global = rewriter.create<memref::GetGlobalOp>(loc, handleType,
+                                                        handle.getSymName());
+    // memref.load has no atomic form, load through the raw pointer.
+    Value handleAsIndex =
+        rewriter.create<memref::ExtractAlignedPointerAsIndexOp>(
+            loc, rewriter.getIndexType(), global);
+    Value handleAsI64 =
+        rewriter.create<arith::IndexCastOp>(loc, integer64, handleAsIndex);
+    Value handlePtr = rewriter.create<LLVM::IntToPtrOp>(
+        loc, LLVM::LLVMPointerType::get(integer64), handleAsI64);
+    Value cached = rewriter.create<LLVM::LoadOp>(
+        loc, integer64, handlePtr, /*alignment=*/8, /*isVolatile=*/false,
+        /*isNonTemporal=*/false, LLVM::AtomicOrdering::acquire);
+    Value zero = rewriter.create<arith::ConstantOp>(
+        loc, integer64, rewriter.getI64IntegerAttr(0));
+    Value isUninitialized = rewriter.create<arith::CmpIOp>(
+        loc, arith::CmpIPredicate::eq, cached, zero);
+    auto ifOp = rewriter.create<scf::IfOp>(
+        loc, isUninitialized,
+        [&](OpBuilder &builder, Location loc) {
+          Value kernel = builder.clone(*dispatchOp)->getResult(0);
+          builder.create<memref::AtomicRMWOp>(loc, integer64,
+                                              arith::AtomicRMWKind::assign,
+                                              kernel, global, ValueRange{});
+          builder.create<scf::YieldOp>(loc, kernel);
+        },
+        [&](OpBuilder &builder, Location loc) {
+          builder.create<scf::YieldOp>(loc, cached);
+        });
+    rewriter.replaceOp(dispatchOp, ifOp.getResults());
+  }
+}
+
 struct ConvertXsmmToFunc : public ConvertXsmmToFuncBase<ConvertXsmmToFunc> {
   ConvertXsmmToFunc() = default;
+  ConvertXsmmToFunc(bool globalDispatchHandles) {
+    this->globalDispatchHandles = globalDispatchHandles;
+  }
   void runOnOperation() override {
+    if (globalDispatchHandles)
+      buildGlobalDispatchHandles(getOperation());
+
     RewritePatternSet patterns(&getContext());
     tpp::populateXsmmToFuncPatterns(patterns);
     (void)applyPatternsAndFoldGreedily(getOperation(), std::move(patterns));
@@ -459,17 +730,20 @@ struct ConvertXsmmToFunc : public ConvertXsmmToFuncBase<ConvertXsmmToFunc> {
 } // namespace
 
 void mlir::tpp::populateXsmmToFuncPatterns(RewritePatternSet &patterns) {
-  patterns
-      .add<ConvertTernaryXsmmOp, ConvertBinaryXsmmOp, ConvertUnaryXsmmOp,
-           ConvertGemmXsmmOp, ConvertBrgemmXsmmOp, ConvertFusedBrgemmXsmmOp>(
-          patterns.getContext());
+  patterns.add<ConvertTernaryXsmmOp, ConvertBinaryXsmmOp, ConvertUnaryXsmmOp,
+               ConvertGemmXsmmOp, ConvertBrgemmXsmmOp,
+               ConvertGemmPrefetchXsmmOp, ConvertBrgemmPrefetchXsmmOp,
+               ConvertBrgemmOffsXsmmOp, ConvertBrgemmAddrXsmmOp,
+               ConvertFusedBrgemmXsmmOp>(patterns.getContext());
   patterns.add<ConvertTernaryDispatchOp, ConvertBinaryDispatchOp,
                ConvertUnaryDispatchOp, ConvertGemmDispatchOp,
-               ConvertBrgemmDispatchOp, ConvertFusedBrgemmOp>(
+               ConvertBrgemmDispatchOp, ConvertGemmPrefetchDispatchOp,
+               ConvertBrgemmPrefetchDispatchOp, ConvertBrgemmOffsDispatchOp,
+               ConvertBrgemmAddrDispatchOp, ConvertFusedBrgemmOp>(
       patterns.getContext());
 }
 
 std::unique_ptr<OperationPass<ModuleOp>>
-mlir::tpp::createConvertXsmmToFuncPass() {
-  return std::make_unique<ConvertXsmmToFunc>();
+mlir::tpp::createConvertXsmmToFuncPass(bool globalDispatchHandles) {
+  return std::make_unique<ConvertXsmmToFunc>(globalDispatchHandles);
 }
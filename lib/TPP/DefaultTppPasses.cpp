@@ -45,6 +45,50 @@ llvm::cl::opt<bool>
                    llvm::cl::desc("Disable default pipeline execution"),
                    llvm::cl::init(false));
 
+llvm::cl::opt<bool> xsmmGlobalDispatch(
+    "xsmm-global-dispatch",
+    llvm::cl::desc("Default pipeline - cache XSMM dispatches in globals"),
+    llvm::cl::init(false));
+
+llvm::cl::opt<bool> defCombineXsmmDispatch(
+    "def-xsmm-combine-dispatch",
+    llvm::cl::desc("Default pipeline - hoist and combine XSMM dispatches"),
+    llvm::cl::init(true));
+
+llvm::cl::opt<bool> defXsmmPrefetch(
+    "def-xsmm-prefetch",
+    llvm::cl::desc("Default pipeline - prefetch next GEMM/BRGEMM tiles"),
+    llvm::cl::init(false));
+
+llvm::cl::opt<bool> defXsmmFoldZeroInit(
+    "def-xsmm-fold-zero-init",
+    llvm::cl::desc("Default pipeline - fold zero initializations into "
+                   "GEMM/BRGEMM as BETA_0"),
+    llvm::cl::init(true));
+
+llvm::cl::opt<bool> defConvBrgemm(
+    "def-conv-brgemm",
+    llvm::cl::desc("Default pipeline - map packed convolutions to BRGEMM"),
+    llvm::cl::init(false));
+
+llvm::cl::opt<bool> defAutoBlock(
+    "def-auto-block",
+    llvm::cl::desc("Default pipeline - select blocking factors per op with "
+                   "the cost model instead of 32"),
+    llvm::cl::init(false));
+
+llvm::cl::opt<std::string> defTuningDb(
+    "def-tuning-db",
+    llvm::cl::desc("Default pipeline - take blocking factors and tile sizes "
+                   "from the tuning database written by tpp-run --autotune"),
+    llvm::cl::init(""));
+
+llvm::cl::opt<bool> defThreadAwareTiles(
+    "def-thread-aware-tiles",
+    llvm::cl::desc("Default pipeline - select the tile sizes of the parallel "
+                   "loops to balance the work across OMP_NUM_THREADS"),
+    llvm::cl::init(false));
+
 #define GEN_PASS_CLASSES
 #include "TPP/Passes.h.inc"
 
@@ -155,7 +199,14 @@ private:
     // that they are hoisted out of loops.
     pm.addNestedPass<func::FuncOp>(createCleanupPass());
 
-    pm.addPass(createConvertXsmmToFuncPass());
+    // Dispatches are pure, hoist the ones LICM could not reach (e.g., nested
+    // in conditionals) out of parallel loops before they become opaque
+    // function calls. Otherwise, each thread dispatches on every iteration
+    // once the loops are converted to OpenMP.
+    if (defCombineXsmmDispatch)
+      pm.addPass(createCombineXsmmDispatchPass());
+
+    pm.addPass(createConvertXsmmToFuncPass(xsmmGlobalDispatch));
     pm.addPass(createConvertPerfToFuncPass());
   }
 };
@@ -234,17 +285,26 @@ private:
   void constructPipeline() override {
     pm.clear();
 
+    // Map normalization chains before tiling and fusion split them apart.
+    pm.addPass(createConvertNormalizationToTppPass());
+
     // Preprocess convolutions.
     pm.addPass(createConvInitSimplifyPass());
+    // Fold inference batch-norm into the constant weights before packing.
+    pm.addPass(createFoldBatchNormPass());
     pm.addPass(createCleanupPass());
     if (defPipePack) {
-      pm.addPass(createPackConv2DNhwcHwcfPass({32, 32}));
-      pm.addPass(createPackConv2DNchwFchwPass({32, 32}));
-      pm.addPass(createRewriteConvToMatmulOrBrgemmPass());
+      // Ops can override the blocking factors with `tpp.block_factors`,
+      // possibly set from the tuning database.
+      if (!defTuningDb.empty())
+        pm.addPass(createApplyTuningDatabasePass(defTuningDb));
+      pm.addPass(createPackConv2DNhwcHwcfPass({32, 32}, defAutoBlock));
+      pm.addPass(createPackConv2DNchwFchwPass({32, 32}, defAutoBlock));
+      pm.addPass(createRewriteConvToMatmulOrBrgemmPass(defConvBrgemm));
 
       // Convert ops to packed layouts.
       if (defPackMatmul)
-        pm.addPass(createPackMatmulPass({32, 32, 32}));
+        pm.addPass(createPackMatmulPass({32, 32, 32}, defAutoBlock));
       pm.addPass(createPackVNNIPass());
     }
 
@@ -259,7 +319,7 @@ private:
     // Looks like we want to agressively remove tensor.empty before fusion.
     // See: `test/Passes/tile-and-fuse-with-cse.mlir`.
     pm.addPass(createCleanupPass());
-    pm.addPass(createTileConsumerAndFuseProducersPass());
+    pm.addPass(createTileConsumerAndFuseProducersPass(defThreadAwareTiles));
     pm.addPass(createCleanupPass());
 
     // Generalize tensor.pack and tensor.unpack.
@@ -321,6 +381,7 @@ struct TppLoweringPass : public TppLoweringBase<TppLoweringPass>,
         .insert<xsmm::XsmmDialect,
                 scf::SCFDialect,
                 memref::MemRefDialect,
+                math::MathDialect,
                 tpp::TppDialect>();
     // clang-format on
   }
@@ -347,8 +408,11 @@ private:
     else {
       // Memref to tpp conversion patterns.
       pm.addPass(createConvertMemRefToTppPass());
+      // Fuse epilogues exposed after bufferization.
+      pm.addPass(createCombineTppPass());
       // Tpp to Xsmm conversion patterns.
-      pm.addPass(createConvertTppToXsmmPass());
+      pm.addPass(
+          createConvertTppToXsmmPass(defXsmmPrefetch, defXsmmFoldZeroInit));
     }
   }
 };
@@ -201,6 +201,37 @@ struct ReluBufferizationInterface
   }
 };
 
+// Element-wise unary operations, reductions and tpp.softmax share the
+// bufferization of tpp.relu.
+template <typename OpTy>
+struct UnaryBufferizationInterface
+    : public BufferizableOpInterface::ExternalModel<
+          UnaryBufferizationInterface<OpTy>, OpTy> {
+  bool bufferizesToMemoryRead(Operation *op, OpOperand &opOperand,
+                              const AnalysisState &state) const {
+    return bufferizesToMemoryReadUnaryImpl(op, opOperand, state);
+  }
+
+  bool bufferizesToMemoryWrite(Operation *op, OpOperand &opOperand,
+                               const AnalysisState &state) const {
+    return bufferizesToMemoryWriteUnaryImpl(op, opOperand, state);
+  }
+
+  AliasingOpResultList getAliasingOpResults(Operation *op, OpOperand &opOperand,
+                                            const AnalysisState &state) const {
+    return getAliasingOpResultsUnaryImpl(op, opOperand, state);
+  }
+
+  LogicalResult bufferize(Operation *op, RewriterBase &rewriter,
+                          const BufferizationOptions &options) const {
+    return bufferizeUnaryOp<OpTy>(op, rewriter, options);
+  }
+
+  bool bufferizesToAllocation(Operation *op, OpResult opResult) const {
+    return bufferizesToAllocationUnaryImpl(op, opResult);
+  }
+};
+
 struct IdentityBufferizationInterface
     : public BufferizableOpInterface::ExternalModel<
           IdentityBufferizationInterface, tpp::IdentityOp> {
@@ -430,6 +461,46 @@ struct AddBufferizationInterface
   }
 };
 
+// Element-wise binary operations share the bufferization of tpp.add.
+template <typename OpTy>
+struct EltwiseBinaryBufferizationInterface
+    : public BufferizableOpInterface::ExternalModel<
+          EltwiseBinaryBufferizationInterface<OpTy>, OpTy> {
+  bool bufferizesToMemoryRead(Operation *op, OpOperand &opOperand,
+                              const AnalysisState &state) const {
+    return bufferizesToMemoryReadBinaryImpl(op, opOperand, state);
+  }
+
+  bool bufferizesToMemoryWrite(Operation *op, OpOperand &opOperand,
+                               const AnalysisState &state) const {
+    return bufferizesToMemoryWriteBinaryImpl(op, opOperand, state);
+  }
+
+  bool isNotConflicting(Operation *op, OpOperand *uRead,
+                        OpOperand *uConflictingWrite,
+                        const AnalysisState &state) const {
+    // See AddBufferizationInterface.
+    if (uRead->get() != uConflictingWrite->get())
+      return false;
+    Liveness liveness(op->getParentOfType<mlir::CallableOpInterface>());
+    return liveness.isDeadAfter(uRead->get(), op);
+  }
+
+  AliasingOpResultList getAliasingOpResults(Operation *op, OpOperand &opOperand,
+                                            const AnalysisState &state) const {
+    return getAliasingOpResultsBinaryImpl(op, opOperand, state);
+  }
+
+  LogicalResult bufferize(Operation *op, RewriterBase &rewriter,
+                          const BufferizationOptions &options) const {
+    return bufferizeBinaryOp<OpTy>(op, rewriter, options);
+  }
+
+  bool bufferizesToAllocation(Operation *op, OpResult opResult) const {
+    return bufferizesToAllocationBinaryImpl(op, opResult);
+  }
+};
+
 //===----------------------------------------------------------------------===//
 // Ternary
 //===----------------------------------------------------------------------===//
@@ -452,7 +523,8 @@ static LogicalResult bufferizeTernaryOp(Operation *op, RewriterBase &rewriter,
   if (failed(bufferC))
     return failure();
   rewriter.create<OpTy>(ternaryOp.getLoc(),
-                        ValueRange{*bufferA, *bufferB, *bufferC}, *bufferC);
+                        ValueRange{*bufferA, *bufferB, *bufferC}, *bufferC,
+                        ternaryOp.getTransposeB());
   replaceOpWithBufferizedValues(rewriter, op, *bufferC);
   return success();
 }
@@ -616,6 +688,129 @@ struct FusedBrgemmBufferizationInterface
   }
 };
 
+//===----------------------------------------------------------------------===//
+// LayerNorm
+//===----------------------------------------------------------------------===//
+
+// tpp.layernorm bufferizes like a unary operation on its first input: the
+// output may reuse the input buffer, gamma and beta are only read.
+struct LayerNormBufferizationInterface
+    : public BufferizableOpInterface::ExternalModel<
+          LayerNormBufferizationInterface, tpp::LayerNormOp> {
+  bool bufferizesToMemoryRead(Operation *op, OpOperand &opOperand,
+                              const AnalysisState &state) const {
+    return true;
+  }
+
+  bool bufferizesToMemoryWrite(Operation *op, OpOperand &opOperand,
+                               const AnalysisState &state) const {
+    return opOperand.getOperandNumber() == 0 &&
+           bufferizesToMemoryWriteUnaryImpl(op, opOperand, state);
+  }
+
+  AliasingOpResultList getAliasingOpResults(Operation *op, OpOperand &opOperand,
+                                            const AnalysisState &state) const {
+    if (opOperand.getOperandNumber() != 0)
+      return {};
+    return getAliasingOpResultsUnaryImpl(op, opOperand, state);
+  }
+
+  LogicalResult bufferize(Operation *op, RewriterBase &rewriter,
+                          const BufferizationOptions &options) const {
+    auto layerNormOp = cast<tpp::LayerNormOp>(op);
+    Location loc = layerNormOp.getLoc();
+    SmallVector<Value> buffers;
+    for (Value input : layerNormOp.getInputs()) {
+      FailureOr<Value> buffer = getBufferOrScalar(rewriter, input, options);
+      if (failed(buffer))
+        return failure();
+      buffers.push_back(*buffer);
+    }
+    Value output = buffers[0];
+    // Out-of-place bufferization.
+    if (!canBufferizeOnOperand(op, layerNormOp.getInputs()[0], options)) {
+      bool dealloc = shouldDeallocateOpResult(
+          layerNormOp.getResult(0).cast<OpResult>(), options);
+      FailureOr<Value> alloc = allocateTensorForShapedValue(
+          rewriter, loc, layerNormOp.getResult(0),
+          /*escape=*/!dealloc, options, /*copy=*/false);
+      if (failed(alloc))
+        return failure();
+      FailureOr<Value> allocBuffer =
+          getBufferOrScalar(rewriter, *alloc, options);
+      if (failed(allocBuffer))
+        return failure();
+      output = *allocBuffer;
+    }
+    rewriter.create<tpp::LayerNormOp>(loc, buffers, output,
+                                      layerNormOp.getEpsilonAttr());
+    replaceOpWithBufferizedValues(rewriter, op, output);
+    return success();
+  }
+
+  bool bufferizesToAllocation(Operation *op, OpResult opResult) const {
+    Value input = cast<tpp::LayerNormOp>(op).getInputs()[0];
+    BufferizationOptions options;
+    return !canBufferizeOnOperand(op, input, options);
+  }
+};
+
+//===----------------------------------------------------------------------===//
+// Dequantize
+//===----------------------------------------------------------------------===//
+
+// tpp.dequantize writes a float result from an i32 accumulator: no input
+// buffer can hold the output, it is always allocated.
+struct DequantizeBufferizationInterface
+    : public BufferizableOpInterface::ExternalModel<
+          DequantizeBufferizationInterface, tpp::DequantizeOp> {
+  bool bufferizesToMemoryRead(Operation *op, OpOperand &opOperand,
+                              const AnalysisState &state) const {
+    return true;
+  }
+
+  bool bufferizesToMemoryWrite(Operation *op, OpOperand &opOperand,
+                               const AnalysisState &state) const {
+    return false;
+  }
+
+  AliasingOpResultList getAliasingOpResults(Operation *op, OpOperand &opOperand,
+                                            const AnalysisState &state) const {
+    return {};
+  }
+
+  LogicalResult bufferize(Operation *op, RewriterBase &rewriter,
+                          const BufferizationOptions &options) const {
+    auto dequantizeOp = cast<tpp::DequantizeOp>(op);
+    Location loc = dequantizeOp.getLoc();
+    SmallVector<Value> buffers;
+    for (Value input : dequantizeOp.getInputs()) {
+      FailureOr<Value> buffer = getBufferOrScalar(rewriter, input, options);
+      if (failed(buffer))
+        return failure();
+      buffers.push_back(*buffer);
+    }
+    bool dealloc = shouldDeallocateOpResult(
+        dequantizeOp.getResult(0).cast<OpResult>(), options);
+    FailureOr<Value> alloc = allocateTensorForShapedValue(
+        rewriter, loc, dequantizeOp.getResult(0),
+        /*escape=*/!dealloc, options, /*copy=*/false);
+    if (failed(alloc))
+      return failure();
+    FailureOr<Value> output = getBufferOrScalar(rewriter, *alloc, options);
+    if (failed(output))
+      return failure();
+    rewriter.create<tpp::DequantizeOp>(loc, buffers, *output,
+                                       dequantizeOp.getRelu());
+    replaceOpWithBufferizedValues(rewriter, op, *output);
+    return success();
+  }
+
+  bool bufferizesToAllocation(Operation *op, OpResult opResult) const {
+    return true;
+  }
+};
+
 } // namespace
 } // namespace tpp
 } // namespace mlir
@@ -626,8 +821,29 @@ void registerBufferizableOpInterfaceExternalModels(DialectRegistry &registry) {
   registry.addExtension(+[](MLIRContext *ctx, tpp::TppDialect *dialect) {
     IdentityOp::attachInterface<tpp::IdentityBufferizationInterface>(*ctx);
     ReluOp::attachInterface<tpp::ReluBufferizationInterface>(*ctx);
+    GeluOp::attachInterface<tpp::UnaryBufferizationInterface<GeluOp>>(*ctx);
+    TanhOp::attachInterface<tpp::UnaryBufferizationInterface<TanhOp>>(*ctx);
+    SigmoidOp::attachInterface<
+        tpp::UnaryBufferizationInterface<SigmoidOp>>(*ctx);
+    ExpOp::attachInterface<tpp::UnaryBufferizationInterface<ExpOp>>(*ctx);
+    ReduceAddOp::attachInterface<
+        tpp::UnaryBufferizationInterface<ReduceAddOp>>(*ctx);
+    ReduceMaxOp::attachInterface<
+        tpp::UnaryBufferizationInterface<ReduceMaxOp>>(*ctx);
+    SoftmaxOp::attachInterface<
+        tpp::UnaryBufferizationInterface<SoftmaxOp>>(*ctx);
+    LayerNormOp::attachInterface<tpp::LayerNormBufferizationInterface>(*ctx);
+    DequantizeOp::attachInterface<tpp::DequantizeBufferizationInterface>(*ctx);
     ZeroOp::attachInterface<tpp::ZeroBufferizationInterface>(*ctx);
     AddOp::attachInterface<tpp::AddBufferizationInterface>(*ctx);
+    MulOp::attachInterface<tpp::EltwiseBinaryBufferizationInterface<MulOp>>(
+        *ctx);
+    SubOp::attachInterface<tpp::EltwiseBinaryBufferizationInterface<SubOp>>(
+        *ctx);
+    DivOp::attachInterface<tpp::EltwiseBinaryBufferizationInterface<DivOp>>(
+        *ctx);
+    MaxOp::attachInterface<tpp::EltwiseBinaryBufferizationInterface<MaxOp>>(
+        *ctx);
     GemmOp::attachInterface<tpp::GemmBufferizationInterface>(*ctx);
     BrgemmOp::attachInterface<tpp::BrgemmBufferizationInterface>(*ctx);
     FusedBrgemmOp::attachInterface<tpp::FusedBrgemmBufferizationInterface>(
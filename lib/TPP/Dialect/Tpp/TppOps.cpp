@@ -11,6 +11,7 @@
 #include "TPP/Dialect/Tpp/TppUtils.h"
 #include "TPP/VNNIUtils.h"
 #include "mlir/IR/OpImplementation.h"
+#include "mlir/IR/TypeUtilities.h"
 
 #define GET_OP_CLASSES
 #include "TPP/Dialect/Tpp/TppOps.cpp.inc"
@@ -26,6 +27,7 @@ constexpr std::string_view UNARY_KIND = "unary_kind";
 constexpr std::string_view BINARY_KIND = "binary_kind";
 constexpr std::string_view UNARY = "unary";
 constexpr std::string_view BINARY = "binary";
+constexpr std::string_view EPSILON = "epsilon";
 } // namespace
 
 //===----------------------------------------------------------------------===//
@@ -227,6 +229,126 @@ void ReluOp::getEffects(
   getEffectsImpl(*this, effects);
 }
 
+//===----------------------------------------------------------------------===//
+// GeluOp
+//===----------------------------------------------------------------------===//
+
+// Builder for memref abstraction.
+void GeluOp::build(OpBuilder &builder, OperationState &state, Value input,
+                   Value output) {
+  tppOpBuilderMemRef(builder, state, input, output);
+}
+
+// Builder for tensor abstraction.
+void GeluOp::build(OpBuilder &builder, OperationState &state, Value input,
+                   Type outputType) {
+  tppOpBuilderTensor(builder, state, input, outputType);
+}
+
+void GeluOp::print(OpAsmPrinter &printer) {
+  printTppOp(printer, getInputs(), getOutputs(), getResultTypes(), *this);
+}
+
+ParseResult GeluOp::parse(OpAsmParser &parser, OperationState &result) {
+  return parseTppOp(parser, result);
+}
+
+void GeluOp::getEffects(
+    SmallVectorImpl<SideEffects::EffectInstance<MemoryEffects::Effect>>
+        &effects) {
+  getEffectsImpl(*this, effects);
+}
+
+//===----------------------------------------------------------------------===//
+// TanhOp
+//===----------------------------------------------------------------------===//
+
+// Builder for memref abstraction.
+void TanhOp::build(OpBuilder &builder, OperationState &state, Value input,
+                   Value output) {
+  tppOpBuilderMemRef(builder, state, input, output);
+}
+
+// Builder for tensor abstraction.
+void TanhOp::build(OpBuilder &builder, OperationState &state, Value input,
+                   Type outputType) {
+  tppOpBuilderTensor(builder, state, input, outputType);
+}
+
+void TanhOp::print(OpAsmPrinter &printer) {
+  printTppOp(printer, getInputs(), getOutputs(), getResultTypes(), *this);
+}
+
+ParseResult TanhOp::parse(OpAsmParser &parser, OperationState &result) {
+  return parseTppOp(parser, result);
+}
+
+void TanhOp::getEffects(
+    SmallVectorImpl<SideEffects::EffectInstance<MemoryEffects::Effect>>
+        &effects) {
+  getEffectsImpl(*this, effects);
+}
+
+//===----------------------------------------------------------------------===//
+// SigmoidOp
+//===----------------------------------------------------------------------===//
+
+// Builder for memref abstraction.
+void SigmoidOp::build(OpBuilder &builder, OperationState &state, Value input,
+                      Value output) {
+  tppOpBuilderMemRef(builder, state, input, output);
+}
+
+// Builder for tensor abstraction.
+void SigmoidOp::build(OpBuilder &builder, OperationState &state, Value input,
+                      Type outputType) {
+  tppOpBuilderTensor(builder, state, input, outputType);
+}
+
+void SigmoidOp::print(OpAsmPrinter &printer) {
+  printTppOp(printer, getInputs(), getOutputs(), getResultTypes(), *this);
+}
+
+ParseResult SigmoidOp::parse(OpAsmParser &parser, OperationState &result) {
+  return parseTppOp(parser, result);
+}
+
+void SigmoidOp::getEffects(
+    SmallVectorImpl<SideEffects::EffectInstance<MemoryEffects::Effect>>
+        &effects) {
+  getEffectsImpl(*this, effects);
+}
+
+//===----------------------------------------------------------------------===//
+// ExpOp
+//===----------------------------------------------------------------------===//
+
+// Builder for memref abstraction.
+void ExpOp::build(OpBuilder &builder, OperationState &state, Value input,
+                  Value output) {
+  tppOpBuilderMemRef(builder, state, input, output);
+}
+
+// Builder for tensor abstraction.
+void ExpOp::build(OpBuilder &builder, OperationState &state, Value input,
+                  Type outputType) {
+  tppOpBuilderTensor(builder, state, input, outputType);
+}
+
+void ExpOp::print(OpAsmPrinter &printer) {
+  printTppOp(printer, getInputs(), getOutputs(), getResultTypes(), *this);
+}
+
+ParseResult ExpOp::parse(OpAsmParser &parser, OperationState &result) {
+  return parseTppOp(parser, result);
+}
+
+void ExpOp::getEffects(
+    SmallVectorImpl<SideEffects::EffectInstance<MemoryEffects::Effect>>
+        &effects) {
+  getEffectsImpl(*this, effects);
+}
+
 //===----------------------------------------------------------------------===//
 // ZeroOp
 //===----------------------------------------------------------------------===//
@@ -302,6 +424,380 @@ void AddOp::getEffects(
   getEffectsImpl(*this, effects);
 }
 
+//===----------------------------------------------------------------------===//
+// MulOp
+//===----------------------------------------------------------------------===//
+
+// Builder for memref abstraction.
+void MulOp::build(OpBuilder &builder, OperationState &state, ValueRange inputs,
+                  Value output) {
+  tppOpBuilderMemRef(builder, state, inputs, output);
+}
+
+// Builder for tensor abstraction.
+void MulOp::build(OpBuilder &builder, OperationState &state, ValueRange inputs,
+                  Type outputType) {
+  tppOpBuilderTensor(builder, state, inputs, outputType);
+}
+
+void MulOp::print(OpAsmPrinter &printer) {
+  printTppOp(printer, getInputs(), getOutputs(), getResultTypes(), *this);
+}
+
+ParseResult MulOp::parse(OpAsmParser &parser, OperationState &result) {
+  return parseTppOp(parser, result);
+}
+
+void MulOp::getEffects(
+    SmallVectorImpl<SideEffects::EffectInstance<MemoryEffects::Effect>>
+        &effects) {
+  getEffectsImpl(*this, effects);
+}
+
+//===----------------------------------------------------------------------===//
+// SubOp
+//===----------------------------------------------------------------------===//
+
+// Builder for memref abstraction.
+void SubOp::build(OpBuilder &builder, OperationState &state, ValueRange inputs,
+                  Value output) {
+  tppOpBuilderMemRef(builder, state, inputs, output);
+}
+
+// Builder for tensor abstraction.
+void SubOp::build(OpBuilder &builder, OperationState &state, ValueRange inputs,
+                  Type outputType) {
+  tppOpBuilderTensor(builder, state, inputs, outputType);
+}
+
+void SubOp::print(OpAsmPrinter &printer) {
+  printTppOp(printer, getInputs(), getOutputs(), getResultTypes(), *this);
+}
+
+ParseResult SubOp::parse(OpAsmParser &parser, OperationState &result) {
+  return parseTppOp(parser, result);
+}
+
+void SubOp::getEffects(
+    SmallVectorImpl<SideEffects::EffectInstance<MemoryEffects::Effect>>
+        &effects) {
+  getEffectsImpl(*this, effects);
+}
+
+//===----------------------------------------------------------------------===//
+// DivOp
+//===----------------------------------------------------------------------===//
+
+// Builder for memref abstraction.
+void DivOp::build(OpBuilder &builder, OperationState &state, ValueRange inputs,
+                  Value output) {
+  tppOpBuilderMemRef(builder, state, inputs, output);
+}
+
+// Builder for tensor abstraction.
+void DivOp::build(OpBuilder &builder, OperationState &state, ValueRange inputs,
+                  Type outputType) {
+  tppOpBuilderTensor(builder, state, inputs, outputType);
+}
+
+void DivOp::print(OpAsmPrinter &printer) {
+  printTppOp(printer, getInputs(), getOutputs(), getResultTypes(), *this);
+}
+
+ParseResult DivOp::parse(OpAsmParser &parser, OperationState &result) {
+  return parseTppOp(parser, result);
+}
+
+void DivOp::getEffects(
+    SmallVectorImpl<SideEffects::EffectInstance<MemoryEffects::Effect>>
+        &effects) {
+  getEffectsImpl(*this, effects);
+}
+
+//===----------------------------------------------------------------------===//
+// MaxOp
+//===----------------------------------------------------------------------===//
+
+// Builder for memref abstraction.
+void MaxOp::build(OpBuilder &builder, OperationState &state, ValueRange inputs,
+                  Value output) {
+  tppOpBuilderMemRef(builder, state, inputs, output);
+}
+
+// Builder for tensor abstraction.
+void MaxOp::build(OpBuilder &builder, OperationState &state, ValueRange inputs,
+                  Type outputType) {
+  tppOpBuilderTensor(builder, state, inputs, outputType);
+}
+
+void MaxOp::print(OpAsmPrinter &printer) {
+  printTppOp(printer, getInputs(), getOutputs(), getResultTypes(), *this);
+}
+
+ParseResult MaxOp::parse(OpAsmParser &parser, OperationState &result) {
+  return parseTppOp(parser, result);
+}
+
+void MaxOp::getEffects(
+    SmallVectorImpl<SideEffects::EffectInstance<MemoryEffects::Effect>>
+        &effects) {
+  getEffectsImpl(*this, effects);
+}
+
+//===----------------------------------------------------------------------===//
+// Reduce ops
+//===----------------------------------------------------------------------===//
+
+// Return the output type of the tpp reduction `tppOp`.
+static ShapedType getReduceOutputType(TppOp tppOp) {
+  if (tppOp.hasTensorSemantics())
+    return tppOp.getResultType();
+  return tppOp.getOutputType();
+}
+
+static int64_t getReductionDimImpl(TppOp tppOp) {
+  auto inputType = tppOp.getInputs()[0].getType().cast<ShapedType>();
+  ShapedType outputType = getReduceOutputType(tppOp);
+  // Reducing a unit dimension is a copy, either dimension works.
+  if (outputType.getShape()[0] == 1 && inputType.getShape()[0] != 1)
+    return 0;
+  return 1;
+}
+
+static LogicalResult verifyReduceOp(TppOp tppOp) {
+  auto inputType = tppOp.getInputs()[0].getType().dyn_cast<ShapedType>();
+  if (!inputType || inputType.getRank() != 2)
+    return tppOp->emitOpError("expects a 2d input");
+  ArrayRef<int64_t> shapeInput = inputType.getShape();
+  ArrayRef<int64_t> shapeOutput = getReduceOutputType(tppOp).getShape();
+  bool reduceRows = shapeOutput[0] == shapeInput[0] && shapeOutput[1] == 1;
+  bool reduceCols = shapeOutput[0] == 1 && shapeOutput[1] == shapeInput[1];
+  if (!reduceRows && !reduceCols)
+    return tppOp->emitOpError("expects a Mx1 or 1xN output for a MxN input");
+  return success();
+}
+
+void ReduceAddOp::build(OpBuilder &builder, OperationState &state, Value input,
+                        Value output) {
+  tppOpBuilderMemRef(builder, state, input, output);
+}
+
+void ReduceAddOp::build(OpBuilder &builder, OperationState &state, Value input,
+                        Type outputType) {
+  tppOpBuilderTensor(builder, state, input, outputType);
+}
+
+void ReduceAddOp::print(OpAsmPrinter &printer) {
+  printTppOp(printer, getInputs(), getOutputs(), getResultTypes(), *this);
+}
+
+ParseResult ReduceAddOp::parse(OpAsmParser &parser, OperationState &result) {
+  return parseTppOp(parser, result);
+}
+
+LogicalResult ReduceAddOp::verify() { return verifyReduceOp(*this); }
+
+int64_t ReduceAddOp::getReductionDim() { return getReductionDimImpl(*this); }
+
+void ReduceAddOp::getEffects(
+    SmallVectorImpl<SideEffects::EffectInstance<MemoryEffects::Effect>>
+        &effects) {
+  getEffectsImpl(*this, effects);
+}
+
+void ReduceMaxOp::build(OpBuilder &builder, OperationState &state, Value input,
+                        Value output) {
+  tppOpBuilderMemRef(builder, state, input, output);
+}
+
+void ReduceMaxOp::build(OpBuilder &builder, OperationState &state, Value input,
+                        Type outputType) {
+  tppOpBuilderTensor(builder, state, input, outputType);
+}
+
+void ReduceMaxOp::print(OpAsmPrinter &printer) {
+  printTppOp(printer, getInputs(), getOutputs(), getResultTypes(), *this);
+}
+
+ParseResult ReduceMaxOp::parse(OpAsmParser &parser, OperationState &result) {
+  return parseTppOp(parser, result);
+}
+
+LogicalResult ReduceMaxOp::verify() { return verifyReduceOp(*this); }
+
+int64_t ReduceMaxOp::getReductionDim() { return getReductionDimImpl(*this); }
+
+void ReduceMaxOp::getEffects(
+    SmallVectorImpl<SideEffects::EffectInstance<MemoryEffects::Effect>>
+        &effects) {
+  getEffectsImpl(*this, effects);
+}
+
+//===----------------------------------------------------------------------===//
+// SoftmaxOp
+//===----------------------------------------------------------------------===//
+
+void SoftmaxOp::build(OpBuilder &builder, OperationState &state, Value input,
+                      Value output) {
+  tppOpBuilderMemRef(builder, state, input, output);
+}
+
+void SoftmaxOp::build(OpBuilder &builder, OperationState &state, Value input,
+                      Type outputType) {
+  tppOpBuilderTensor(builder, state, input, outputType);
+}
+
+void SoftmaxOp::print(OpAsmPrinter &printer) {
+  printTppOp(printer, getInputs(), getOutputs(), getResultTypes(), *this);
+}
+
+ParseResult SoftmaxOp::parse(OpAsmParser &parser, OperationState &result) {
+  return parseTppOp(parser, result);
+}
+
+LogicalResult SoftmaxOp::verify() {
+  auto inputType = getInputs()[0].getType().dyn_cast<ShapedType>();
+  if (!inputType || inputType.getRank() != 2)
+    return emitOpError("expects a 2d input");
+  ShapedType outputType;
+  if (hasTensorSemantics())
+    outputType = getResultType();
+  else
+    outputType = getOutputType();
+  if (failed(verifyCompatibleShape(inputType.getShape(),
+                                   outputType.getShape()))) {
+    return emitOpError("expects the output to have the shape of the input");
+  }
+  return success();
+}
+
+void SoftmaxOp::getEffects(
+    SmallVectorImpl<SideEffects::EffectInstance<MemoryEffects::Effect>>
+        &effects) {
+  getEffectsImpl(*this, effects);
+}
+
+//===----------------------------------------------------------------------===//
+// LayerNormOp
+//===----------------------------------------------------------------------===//
+
+void LayerNormOp::build(OpBuilder &builder, OperationState &state,
+                        ValueRange inputs, Value output, FloatAttr epsilon) {
+  tppOpBuilderMemRef(builder, state, inputs, output);
+  state.addAttribute(EPSILON, epsilon);
+}
+
+void LayerNormOp::build(OpBuilder &builder, OperationState &state,
+                        ValueRange inputs, Type outputType,
+                        FloatAttr epsilon) {
+  tppOpBuilderTensor(builder, state, inputs, outputType);
+  state.addAttribute(EPSILON, epsilon);
+}
+
+void LayerNormOp::print(OpAsmPrinter &printer) {
+  printTppOp(printer, getInputs(), getOutputs(), getResultTypes(), *this);
+}
+
+ParseResult LayerNormOp::parse(OpAsmParser &parser, OperationState &result) {
+  return parseTppOp(parser, result);
+}
+
+LogicalResult LayerNormOp::verify() {
+  auto inputType = getInputs()[0].getType().dyn_cast<ShapedType>();
+  if (!inputType || inputType.getRank() != 2)
+    return emitOpError("expects a 2d input");
+  ShapedType outputType;
+  if (hasTensorSemantics())
+    outputType = getResultType();
+  else
+    outputType = getOutputType();
+  if (failed(verifyCompatibleShape(inputType.getShape(),
+                                   outputType.getShape()))) {
+    return emitOpError("expects the output to have the shape of the input");
+  }
+  // gamma and beta hold one value per column: N or 1xN.
+  int64_t numCols = inputType.getShape()[1];
+  for (Value operand : getInputs().drop_front()) {
+    auto operandType = operand.getType().dyn_cast<ShapedType>();
+    if (!operandType || operandType.getShape().back() != numCols ||
+        (operandType.getRank() == 2 && operandType.getShape()[0] != 1)) {
+      return emitOpError("expects gamma and beta to be N or 1xN for a MxN "
+                         "input");
+    }
+  }
+  return success();
+}
+
+void LayerNormOp::getEffects(
+    SmallVectorImpl<SideEffects::EffectInstance<MemoryEffects::Effect>>
+        &effects) {
+  getEffectsImpl(*this, effects);
+}
+
+//===----------------------------------------------------------------------===//
+// DequantizeOp
+//===----------------------------------------------------------------------===//
+
+void DequantizeOp::build(OpBuilder &builder, OperationState &state,
+                         ValueRange inputs, Value output, bool relu) {
+  tppOpBuilderMemRef(builder, state, inputs, output);
+  if (relu)
+    state.addAttribute(getReluAttrName(state.name), builder.getUnitAttr());
+}
+
+void DequantizeOp::build(OpBuilder &builder, OperationState &state,
+                         ValueRange inputs, Type outputType, bool relu) {
+  tppOpBuilderTensor(builder, state, inputs, outputType);
+  if (relu)
+    state.addAttribute(getReluAttrName(state.name), builder.getUnitAttr());
+}
+
+void DequantizeOp::print(OpAsmPrinter &printer) {
+  printTppOp(printer, getInputs(), getOutputs(), getResultTypes(), *this);
+}
+
+ParseResult DequantizeOp::parse(OpAsmParser &parser, OperationState &result) {
+  return parseTppOp(parser, result);
+}
+
+LogicalResult DequantizeOp::verify() {
+  auto accType = getInputs()[0].getType().dyn_cast<ShapedType>();
+  if (!accType || accType.getRank() != 2 ||
+      !accType.getElementType().isInteger(32))
+    return emitOpError("expects a 2d i32 accumulator");
+  ShapedType outputType;
+  if (hasTensorSemantics())
+    outputType = getResultType();
+  else
+    outputType = getOutputType();
+  if (failed(verifyCompatibleShape(accType.getShape(),
+                                   outputType.getShape()))) {
+    return emitOpError(
+        "expects the output to have the shape of the accumulator");
+  }
+  // scale and bias hold one value per column: N or 1xN.
+  int64_t numCols = accType.getShape()[1];
+  for (Value operand : getInputs().drop_front()) {
+    auto operandType = operand.getType().dyn_cast<ShapedType>();
+    if (!operandType || operandType.getShape().back() != numCols ||
+        (operandType.getRank() == 2 && operandType.getShape()[0] != 1)) {
+      return emitOpError("expects scale and bias to be N or 1xN for a MxN "
+                         "accumulator");
+    }
+    if (operandType.getElementType() != outputType.getElementType()) {
+      return emitOpError(
+          "expects scale and bias to have the element type of the output");
+    }
+  }
+  return success();
+}
+
+void DequantizeOp::getEffects(
+    SmallVectorImpl<SideEffects::EffectInstance<MemoryEffects::Effect>>
+        &effects) {
+  getEffectsImpl(*this, effects);
+}
+
 //===----------------------------------------------------------------------===//
 // GemmOp
 //===----------------------------------------------------------------------===//
@@ -319,10 +815,11 @@ validateVnniGemmOperand(OpTy operation, ArrayRef<int64_t> shape,
       return operation->emitOpError("operand 1 fails to verify expected shape");
     return success();
   }
-  if (!elementType.isBF16()) {
-    return operation->emitOpError() << "operand 1 invalid element type for "
-                                       "VNNI layout expect bf16, but got: "
-                                    << elementType << "\n";
+  if (!elementType.isBF16() && !elementType.isInteger(8)) {
+    return operation->emitOpError()
+           << "operand 1 invalid element type for VNNI layout expect bf16 or "
+              "i8, but got: "
+           << elementType << "\n";
   }
   if (shape[2] != vnni::utils::getVnniBlockingFactor(elementType)) {
     return operation->emitOpError() << "operand 1 invalid VNNI layout expect "
@@ -335,8 +832,10 @@ validateVnniGemmOperand(OpTy operation, ArrayRef<int64_t> shape,
   return success();
 }
 
+// With `transposeB`, B is expected as NxK, in the canonical layout.
 template <typename OpTy>
-static LogicalResult verifyGemmLikeOperands(OpTy operation) {
+static LogicalResult verifyGemmLikeOperands(OpTy operation,
+                                            bool transposeB = false) {
 
   static_assert(llvm::is_one_of<OpTy, BrgemmOp, FusedBrgemmOp, GemmOp>::value,
                 "applies to brgemm, fused_brgemm or gemm operations");
@@ -354,6 +853,19 @@ static LogicalResult verifyGemmLikeOperands(OpTy operation) {
            << "result type differs from destination operand type";
   }
 
+  // Integer gemms take i8 inputs and accumulate in i32.
+  Type elementTypeA = shapedA.getElementType();
+  Type elementTypeB = shapedB.getElementType();
+  Type elementTypeC = shapedC.getElementType();
+  if (elementTypeA.isa<IntegerType>() || elementTypeB.isa<IntegerType>() ||
+      elementTypeC.isa<IntegerType>()) {
+    if (!elementTypeA.isInteger(8) || !elementTypeB.isInteger(8) ||
+        !elementTypeC.isInteger(32)) {
+      return operation.emitOpError()
+             << "expects i8 inputs and i32 output for integer types";
+    }
+  }
+
   // Validate operand C.
   if (shapedC.getRank() != 2) {
     return operation.emitOpError()
@@ -386,23 +898,38 @@ static LogicalResult verifyGemmLikeOperands(OpTy operation) {
   // Drop the batch dim for brgemm, already checked.
   auto shapeB =
       (isGemmOp) ? shapedB.getShape() : shapedB.getShape().drop_front();
+  if (transposeB) {
+    if (shapeB.size() != 2 || shapeB[0] != n || shapeB[1] != k) {
+      return operation.emitOpError(
+          "operand 1 fails to verify expected transposed shape");
+    }
+    return success();
+  }
   return validateVnniGemmOperand(operation, shapeB, shapedB.getElementType(), k,
                                  n);
 }
 
 // Verify gemm operation.
-LogicalResult GemmOp::verify() { return verifyGemmLikeOperands(*this); }
+LogicalResult GemmOp::verify() {
+  return verifyGemmLikeOperands(*this, getTransposeB());
+}
 
 // Builder for memref abstraction.
 void GemmOp::build(OpBuilder &builder, OperationState &state, ValueRange inputs,
-                   Value output) {
+                   Value output, bool transposeB) {
   tppOpBuilderMemRef(builder, state, inputs, output);
+  if (transposeB)
+    state.addAttribute(getTransposeBAttrName(state.name),
+                       builder.getUnitAttr());
 }
 
 // Builder for tensor abstraction.
 void GemmOp::build(OpBuilder &builder, OperationState &state, ValueRange inputs,
-                   Type outputType) {
+                   Type outputType, bool transposeB) {
   tppOpBuilderTensor(builder, state, inputs, outputType);
+  if (transposeB)
+    state.addAttribute(getTransposeBAttrName(state.name),
+                       builder.getUnitAttr());
 }
 
 ParseResult GemmOp::parse(OpAsmParser &parser, OperationState &result) {
@@ -423,18 +950,26 @@ void GemmOp::getEffects(
 // BrgemmOp
 //===----------------------------------------------------------------------===//
 
-LogicalResult BrgemmOp::verify() { return verifyGemmLikeOperands(*this); }
+LogicalResult BrgemmOp::verify() {
+  return verifyGemmLikeOperands(*this, getTransposeB());
+}
 
 // Builder for memref abstraction.
 void BrgemmOp::build(OpBuilder &builder, OperationState &state,
-                     ValueRange inputs, Value output) {
+                     ValueRange inputs, Value output, bool transposeB) {
   tppOpBuilderMemRef(builder, state, inputs, output);
+  if (transposeB)
+    state.addAttribute(getTransposeBAttrName(state.name),
+                       builder.getUnitAttr());
 }
 
 // Builder for tensor abstraction.
 void BrgemmOp::build(OpBuilder &builder, OperationState &state,
-                     ValueRange inputs, Type outputType) {
+                     ValueRange inputs, Type outputType, bool transposeB) {
   tppOpBuilderTensor(builder, state, inputs, outputType);
+  if (transposeB)
+    state.addAttribute(getTransposeBAttrName(state.name),
+                       builder.getUnitAttr());
 }
 
 ParseResult BrgemmOp::parse(OpAsmParser &parser, OperationState &result) {
@@ -458,6 +993,10 @@ void BrgemmOp::getEffects(
 LogicalResult FusedBrgemmOp::verify() {
   if (failed(verifyGemmLikeOperands(*this)))
     return failure();
+  auto elementTypeC =
+      getInputs()[2].getType().cast<ShapedType>().getElementType();
+  if (elementTypeC.isa<IntegerType>())
+    return emitOpError() << "integer types are not supported";
   Type biasType = getBiasOperand().getType();
   int64_t rank = biasType.cast<ShapedType>().getRank();
   if (rank != 1 && rank != 2)
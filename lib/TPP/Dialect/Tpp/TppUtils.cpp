@@ -13,6 +13,7 @@
 #include "mlir/Dialect/Arith/IR/Arith.h"
 #include "mlir/Dialect/Linalg/IR/Linalg.h"
 #include "mlir/Dialect/Linalg/Utils/Utils.h"
+#include "mlir/Dialect/Math/IR/Math.h"
 #include "mlir/Dialect/MemRef/IR/MemRef.h"
 #include "mlir/Dialect/Tensor/IR/Tensor.h"
 #include "mlir/IR/Matchers.h"
@@ -20,6 +21,7 @@
 #include "mlir/IR/Value.h"
 #include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/TypeSwitch.h"
+#include "llvm/Support/MathExtras.h"
 
 namespace mlir {
 namespace tpp {
@@ -66,6 +68,14 @@ bool isZeroTensor(Value val) {
   return isZeroOp(defOp);
 }
 
+bool hasTransposedB(Operation *op) {
+  if (auto gemmOp = dyn_cast<tpp::GemmOp>(op))
+    return gemmOp.getTransposeB();
+  if (auto brgemmOp = dyn_cast<tpp::BrgemmOp>(op))
+    return brgemmOp.getTransposeB();
+  return false;
+}
+
 // Returns true if the attribute represent "all zeros"
 bool isZeroAttr(Attribute attribute) {
   return TypeSwitch<Attribute, bool>(attribute)
@@ -119,8 +129,8 @@ static bool isTppOp(linalg::GenericOp linalgOp) {
   using namespace tpp::structured_match;
   auto tppMatcher =
       StructuredOpMatcher::make<linalg::GenericOp>()
-          .output(MatchAll(), HasStaticShape())
-          .input(MatchAll(), HasStaticShape())
+          .output(MatchAll(), HasStaticInnerDim())
+          .input(MatchAll(), HasStaticInnerDim())
           .operation(NumRegions(EqualsTo(1)))
           .operation(HasTensorSemantics())
           .operation(VerifyInterface(OpTrait::tpp::checkUnitStrideInnerLoop));
@@ -172,6 +182,114 @@ bool isTppAdd(linalg::GenericOp linalgOp, SmallVectorImpl<Value> *operands) {
   return isTppBinaryOp(linalgOp) && addMatcher.match(linalgOp);
 }
 
+// Return true if the linalg.generic can be mapped to a tpp.mul.
+bool isTppMul(linalg::GenericOp linalgOp, SmallVectorImpl<Value> *operands) {
+  using namespace tpp::structured_match;
+  auto mulMatcher = StructuredOpMatcher::make<linalg::GenericOp>().region(
+      MatchOne(0), WithSingleOp<arith::MulFOp>(operands));
+  return isTppBinaryOp(linalgOp) && mulMatcher.match(linalgOp);
+}
+
+// Return true if the linalg.generic can be mapped to a tpp.sub.
+// The captured operands follow the order of the scalar operation.
+bool isTppSub(linalg::GenericOp linalgOp, SmallVectorImpl<Value> *operands) {
+  using namespace tpp::structured_match;
+  auto subMatcher = StructuredOpMatcher::make<linalg::GenericOp>().region(
+      MatchOne(0), WithSingleOp<arith::SubFOp>(operands));
+  return isTppBinaryOp(linalgOp) && subMatcher.match(linalgOp);
+}
+
+// Return true if the linalg.generic can be mapped to a tpp.div.
+// The captured operands follow the order of the scalar operation.
+bool isTppDiv(linalg::GenericOp linalgOp, SmallVectorImpl<Value> *operands) {
+  using namespace tpp::structured_match;
+  auto divMatcher = StructuredOpMatcher::make<linalg::GenericOp>().region(
+      MatchOne(0), WithSingleOp<arith::DivFOp>(operands));
+  return isTppBinaryOp(linalgOp) && divMatcher.match(linalgOp);
+}
+
+// Return true if the linalg.generic can be mapped to a tpp.max.
+bool isTppMax(linalg::GenericOp linalgOp, SmallVectorImpl<Value> *operands) {
+  using namespace tpp::structured_match;
+  auto maxMatcher = StructuredOpMatcher::make<linalg::GenericOp>().region(
+      MatchOne(0), WithSingleOp<arith::MaxFOp>(operands));
+  return isTppBinaryOp(linalgOp) && maxMatcher.match(linalgOp);
+}
+
+// Return true if `linalgOp` reduces its 2d input along a single dimension and
+// its output keeps the other one, either as a 1d output or as a 2d output with
+// a unit reduced dimension.
+static bool isTppReduceOp(linalg::LinalgOp linalgOp) {
+  using namespace tpp::structured_match;
+  auto reduceMatcher =
+      StructuredOpMatcher::make<linalg::LinalgOp>()
+          .operation(NumDpsInits(EqualsTo(1)))
+          .operation(NumDpsInputs(EqualsTo(1)))
+          .operation(NumRegions(EqualsTo(1)))
+          .operation(HasTensorSemantics())
+          .operation(NumOfLoops(EqualsTo(2)))
+          .input(MatchAll(), HasStaticInnerDim())
+          .output(MatchAll(), HasStaticInnerDim())
+          .input(MatchAll(), HasRank({2}))
+          .output(MatchAll(), HasRank({1, 2}))
+          .input(MatchAll(), HasMap(Identity()))
+          .operation(VerifyInterface(OpTrait::tpp::checkUnitStrideInnerLoop));
+  if (!reduceMatcher.match(linalgOp))
+    return false;
+
+  auto iteratorTypes = linalgOp.getIteratorTypesArray();
+  if (llvm::count(iteratorTypes, mlir::utils::IteratorType::reduction) != 1)
+    return false;
+  int64_t reductionDim =
+      iteratorTypes[0] == mlir::utils::IteratorType::reduction ? 0 : 1;
+  MLIRContext *ctx = linalgOp.getContext();
+  AffineExpr parallelDim = getAffineDimExpr(1 - reductionDim, ctx);
+  AffineMap outputMap =
+      linalgOp.getMatchingIndexingMap(linalgOp.getDpsInitOperand(0));
+  if (outputMap.getNumResults() == 1)
+    return outputMap.getResult(0) == parallelDim;
+  SmallVector<AffineExpr, 2> expectedResults(2, getAffineConstantExpr(0, ctx));
+  expectedResults[1 - reductionDim] = parallelDim;
+  return outputMap.getResults() == ArrayRef<AffineExpr>(expectedResults);
+}
+
+// Return true if `linalgOp` is a tpp reduction whose body combines the input
+// with the accumulator using `OpTy`. Capture the input and the init.
+template <typename OpTy>
+static bool isTppReduceOpWithBody(linalg::LinalgOp linalgOp,
+                                  SmallVectorImpl<Value> *operands) {
+  using namespace tpp::structured_match;
+  SmallVector<Value> captured;
+  auto bodyMatcher = StructuredOpMatcher::make<linalg::LinalgOp>().region(
+      MatchOne(0), WithSingleOp<OpTy>(&captured));
+  if (!isTppReduceOp(linalgOp) || !bodyMatcher.match(linalgOp))
+    return false;
+
+  Value input = linalgOp.getDpsInputOperand(0)->get();
+  Value init = linalgOp.getDpsInitOperand(0)->get();
+  ArrayRef<Value> combined = ArrayRef<Value>(captured).take_front(2);
+  if (!llvm::is_contained(combined, input) ||
+      !llvm::is_contained(combined, init))
+    return false;
+  if (operands) {
+    operands->push_back(input);
+    operands->push_back(init);
+  }
+  return true;
+}
+
+// Return true if the linalg operation can be mapped to a tpp.reduce_add.
+bool isTppReduceAdd(linalg::LinalgOp linalgOp,
+                    SmallVectorImpl<Value> *operands) {
+  return isTppReduceOpWithBody<arith::AddFOp>(linalgOp, operands);
+}
+
+// Return true if the linalg operation can be mapped to a tpp.reduce_max.
+bool isTppReduceMax(linalg::LinalgOp linalgOp,
+                    SmallVectorImpl<Value> *operands) {
+  return isTppReduceOpWithBody<arith::MaxFOp>(linalgOp, operands);
+}
+
 static bool hasReluBody(Operation *op, SmallVectorImpl<Value> *captured) {
   if (!isa<linalg::GenericOp>(op))
     return false;
@@ -240,6 +358,165 @@ bool isTppRelu(linalg::GenericOp linalgOp, SmallVectorImpl<Value> *operands) {
   return isTppUnaryOp(linalgOp) && reluMatcher.match(linalgOp);
 }
 
+// Return true if `value` is a float constant equal to `expected`, up to the
+// rounding of the literal.
+static bool isFloatConstant(Value value, double expected) {
+  FloatAttr attr;
+  if (!matchPattern(value, m_Constant<FloatAttr>(&attr)))
+    return false;
+  return std::abs(attr.getValueAsDouble() - expected) <=
+         1e-6 * std::max(1.0, std::abs(expected));
+}
+
+// Return the operand of the commutative `OpTy` defining `value` that is not
+// the float constant `constant`, nullptr otherwise.
+template <typename OpTy>
+static Value matchWithConstant(Value value, double constant) {
+  auto op = value.getDefiningOp<OpTy>();
+  if (!op)
+    return nullptr;
+  if (isFloatConstant(op.getRhs(), constant))
+    return op.getLhs();
+  if (isFloatConstant(op.getLhs(), constant))
+    return op.getRhs();
+  return nullptr;
+}
+
+// Collect the factors of the product tree rooted at `value`.
+static void getProductFactors(Value value, SmallVectorImpl<Value> &factors) {
+  if (auto mulOp = value.getDefiningOp<arith::MulFOp>()) {
+    getProductFactors(mulOp.getLhs(), factors);
+    getProductFactors(mulOp.getRhs(), factors);
+    return;
+  }
+  factors.push_back(value);
+}
+
+// Match exp(x) and return x.
+static Value matchExp(Value value) {
+  auto expOp = value.getDefiningOp<math::ExpOp>();
+  return expOp ? expOp.getOperand() : nullptr;
+}
+
+// Match tanh(x) and return x.
+static Value matchTanh(Value value) {
+  auto tanhOp = value.getDefiningOp<math::TanhOp>();
+  return tanhOp ? tanhOp.getOperand() : nullptr;
+}
+
+// Match 1 / (1 + exp(-x)) and return x.
+static Value matchSigmoid(Value value) {
+  auto divOp = value.getDefiningOp<arith::DivFOp>();
+  if (!divOp || !isFloatConstant(divOp.getLhs(), 1.0))
+    return nullptr;
+  Value exp = matchWithConstant<arith::AddFOp>(divOp.getRhs(), 1.0);
+  Value negX = exp ? matchExp(exp) : nullptr;
+  if (!negX)
+    return nullptr;
+  if (auto negOp = negX.getDefiningOp<arith::NegFOp>())
+    return negOp.getOperand();
+  auto subOp = negX.getDefiningOp<arith::SubFOp>();
+  if (subOp && isFloatConstant(subOp.getLhs(), 0.0))
+    return subOp.getRhs();
+  return nullptr;
+}
+
+// Match 0.5 * x * (1 + erf(x / sqrt(2))), in any association order of the
+// product, and return x.
+static Value matchGelu(Value value) {
+  SmallVector<Value> factors;
+  getProductFactors(value, factors);
+  if (factors.size() != 3)
+    return nullptr;
+  auto half = llvm::find_if(
+      factors, [](Value factor) { return isFloatConstant(factor, 0.5); });
+  auto erfPlusOne = llvm::find_if(factors, [](Value factor) {
+    Value erf = matchWithConstant<arith::AddFOp>(factor, 1.0);
+    return erf && erf.getDefiningOp<math::ErfOp>();
+  });
+  if (half == factors.end() || erfPlusOne == factors.end())
+    return nullptr;
+  Value x = nullptr;
+  for (Value factor : factors) {
+    if (factor != *half && factor != *erfPlusOne)
+      x = factor;
+  }
+  Value erf = matchWithConstant<arith::AddFOp>(*erfPlusOne, 1.0);
+  Value erfOperand = erf.getDefiningOp<math::ErfOp>().getOperand();
+  if (x == matchWithConstant<arith::MulFOp>(erfOperand,
+                                            llvm::numbers::inv_sqrt2))
+    return x;
+  auto divOp = erfOperand.getDefiningOp<arith::DivFOp>();
+  if (divOp && divOp.getLhs() == x &&
+      isFloatConstant(divOp.getRhs(), llvm::numbers::sqrt2))
+    return x;
+  return nullptr;
+}
+
+namespace {
+// Helper matcher functor for element-wise unary bodies. `matchFn` matches the
+// yielded value f(x) and returns x, which must be a block argument.
+struct WithUnaryBody {
+  using MatchFn = Value (*)(Value);
+
+  WithUnaryBody() = delete;
+  WithUnaryBody(MatchFn matchFn, SmallVectorImpl<Value> *captures)
+      : matchFn(matchFn), captures(captures){};
+
+  bool operator()(Region *region, Operation *op) {
+    auto linalgOp = dyn_cast<linalg::GenericOp>(op);
+    if (!linalgOp || linalgOp.getNumDpsInits() != 1)
+      return false;
+    Operation *yieldOp = linalgOp.getBlock()->getTerminator();
+    if (yieldOp->getNumOperands() != 1)
+      return false;
+    auto blockArg =
+        dyn_cast_or_null<BlockArgument>(matchFn(yieldOp->getOperand(0)));
+    if (!blockArg || blockArg.getParentBlock() != linalgOp.getBlock())
+      return false;
+    if (captures) {
+      captures->push_back(linalgOp.getMatchingOpOperand(blockArg)->get());
+      captures->push_back(linalgOp.getDpsInitOperand(0)->get());
+    }
+    return true;
+  }
+
+private:
+  MatchFn matchFn;
+  SmallVectorImpl<Value> *captures;
+};
+} // namespace
+
+static bool isTppEltwiseUnary(linalg::GenericOp linalgOp,
+                              WithUnaryBody::MatchFn matchFn,
+                              SmallVectorImpl<Value> *operands) {
+  using namespace tpp::structured_match;
+  auto unaryMatcher = StructuredOpMatcher::make<linalg::GenericOp>().region(
+      MatchOne(0), WithUnaryBody(matchFn, operands));
+  return isTppUnaryOp(linalgOp) && unaryMatcher.match(linalgOp);
+}
+
+// Return true if the linalg.generic can be mapped to a tpp.gelu.
+bool isTppGelu(linalg::GenericOp linalgOp, SmallVectorImpl<Value> *operands) {
+  return isTppEltwiseUnary(linalgOp, matchGelu, operands);
+}
+
+// Return true if the linalg.generic can be mapped to a tpp.tanh.
+bool isTppTanh(linalg::GenericOp linalgOp, SmallVectorImpl<Value> *operands) {
+  return isTppEltwiseUnary(linalgOp, matchTanh, operands);
+}
+
+// Return true if the linalg.generic can be mapped to a tpp.sigmoid.
+bool isTppSigmoid(linalg::GenericOp linalgOp,
+                  SmallVectorImpl<Value> *operands) {
+  return isTppEltwiseUnary(linalgOp, matchSigmoid, operands);
+}
+
+// Return true if the linalg.generic can be mapped to a tpp.exp.
+bool isTppExp(linalg::GenericOp linalgOp, SmallVectorImpl<Value> *operands) {
+  return isTppEltwiseUnary(linalgOp, matchExp, operands);
+}
+
 // Return true if the linalg.generic can be mapped to a tpp.identity.
 bool isTppIdentity(linalg::GenericOp linalgOp,
                    SmallVectorImpl<Value> *operands) {
@@ -280,6 +557,317 @@ bool isTppZero(linalg::GenericOp linalgOp, SmallVectorImpl<Value> *operands) {
   return true;
 }
 
+// Return the Mx1 tensor broadcast along the rows by `val`: either `val` itself
+// or the input of a tpp.identity-like linalg.generic producing `val`.
+static Value getRowBroadcastSource(Value val) {
+  auto isColumn = [](Value val) {
+    auto type = val.getType().dyn_cast<RankedTensorType>();
+    return type && type.getRank() == 2 && type.getShape()[1] == 1;
+  };
+  if (isColumn(val))
+    return val;
+  auto bcastOp = val.getDefiningOp<linalg::GenericOp>();
+  SmallVector<Value> operands;
+  if (!bcastOp || !isTppIdentity(bcastOp, &operands) ||
+      !isColumn(operands[0]))
+    return nullptr;
+  return operands[0];
+}
+
+// Return true if `val` broadcasts along the rows the result of a row reduction
+// of type `OpTy`. Capture the input and the init of the reduction.
+template <typename OpTy>
+static bool isBroadcastRowReduction(Value val,
+                                    SmallVectorImpl<Value> &operands) {
+  Value reduced = getRowBroadcastSource(val);
+  if (!reduced)
+    return false;
+  auto reduceOp = reduced.getDefiningOp<linalg::LinalgOp>();
+  if (!reduceOp || !isTppReduceOpWithBody<OpTy>(reduceOp, &operands))
+    return false;
+  // The reduction runs within each row, over the innermost dimension.
+  return reduceOp.getIteratorTypesArray()[1] ==
+         mlir::utils::IteratorType::reduction;
+}
+
+// Return true if the linalg.generic divides exp(x) by its row sums.
+bool isTppSoftmax(linalg::GenericOp linalgOp,
+                  SmallVectorImpl<Value> *operands) {
+  SmallVector<Value> divOperands;
+  if (!isTppDiv(linalgOp, &divOperands) || divOperands.size() < 2)
+    return false;
+  Value numerator = divOperands[0];
+  Value init = linalgOp.getDpsInitOperand(0)->get();
+  if (numerator.getType() != init.getType())
+    return false;
+
+  // The numerator is exp(x), the denominator sums it within each row.
+  auto expOp = numerator.getDefiningOp<linalg::GenericOp>();
+  SmallVector<Value> expOperands;
+  if (!expOp || !isTppExp(expOp, &expOperands) ||
+      expOperands[0].getType() != numerator.getType())
+    return false;
+  SmallVector<Value> sumOperands;
+  if (!isBroadcastRowReduction<arith::AddFOp>(divOperands[1], sumOperands) ||
+      sumOperands[0] != numerator || !isZeroTensor(sumOperands[1]))
+    return false;
+
+  // Subtracting the row maximum does not change the result: look through it,
+  // tpp.softmax is stabilized anyway. The init of the maximum is irrelevant.
+  Value input = expOperands[0];
+  auto subOp = input.getDefiningOp<linalg::GenericOp>();
+  SmallVector<Value> subOperands;
+  if (subOp && isTppSub(subOp, &subOperands) && subOperands.size() >= 2 &&
+      subOperands[0].getType() == input.getType()) {
+    SmallVector<Value> maxOperands;
+    if (isBroadcastRowReduction<arith::MaxFOp>(subOperands[1], maxOperands) &&
+        maxOperands[0] == subOperands[0])
+      input = subOperands[0];
+  }
+
+  if (operands) {
+    operands->push_back(input);
+    operands->push_back(init);
+  }
+  return true;
+}
+
+// Return x if `val` holds the mean of each row of x as a Mx1 tensor: the row
+// sums of x, from a zero init, divided by N or scaled by 1/N.
+static Value getRowMeanInput(Value val) {
+  auto scaleOp = val.getDefiningOp<linalg::GenericOp>();
+  if (!scaleOp || !isTppUnaryOp(scaleOp) || scaleOp.getNumDpsInputs() != 1)
+    return nullptr;
+  SmallVector<Value> sumOperands;
+  Value sum = scaleOp.getDpsInputOperand(0)->get();
+  if (!isBroadcastRowReduction<arith::AddFOp>(sum, sumOperands) ||
+      getRowBroadcastSource(sum) != sum || !isZeroTensor(sumOperands[1]))
+    return nullptr;
+
+  auto rowSize = static_cast<double>(
+      sumOperands[0].getType().cast<ShapedType>().getShape()[1]);
+  Block *body = scaleOp.getBlock();
+  Value in = body->getArgument(0);
+  Value mean = body->getTerminator()->getOperand(0);
+  if (matchWithConstant<arith::MulFOp>(mean, 1.0 / rowSize) == in)
+    return sumOperands[0];
+  auto divOp = mean.getDefiningOp<arith::DivFOp>();
+  if (divOp && divOp.getLhs() == in && isFloatConstant(divOp.getRhs(), rowSize))
+    return sumOperands[0];
+  return nullptr;
+}
+
+// Return v if `val` is 1 / sqrt(v + epsilon), element-wise on a Mx1 tensor.
+// Capture epsilon.
+static Value getRsqrtInput(Value val, FloatAttr &epsilon) {
+  auto rsqrtOp = val.getDefiningOp<linalg::GenericOp>();
+  if (!rsqrtOp || getRowBroadcastSource(val) != val ||
+      !isTppUnaryOp(rsqrtOp) || rsqrtOp.getNumDpsInputs() != 1)
+    return nullptr;
+  Block *body = rsqrtOp.getBlock();
+  Value in = body->getArgument(0);
+  Value rsqrt = body->getTerminator()->getOperand(0);
+  Value denominator = nullptr;
+  if (auto mathRsqrtOp = rsqrt.getDefiningOp<math::RsqrtOp>()) {
+    denominator = mathRsqrtOp.getOperand();
+  } else if (auto divOp = rsqrt.getDefiningOp<arith::DivFOp>()) {
+    auto sqrtOp = divOp.getRhs().getDefiningOp<math::SqrtOp>();
+    if (sqrtOp && isFloatConstant(divOp.getLhs(), 1.0))
+      denominator = sqrtOp.getOperand();
+  }
+  auto addOp =
+      denominator ? denominator.getDefiningOp<arith::AddFOp>() : nullptr;
+  if (!addOp)
+    return nullptr;
+  Value eps = addOp.getLhs() == in ? addOp.getRhs() : addOp.getLhs();
+  if ((addOp.getLhs() != in && addOp.getRhs() != in) ||
+      !matchPattern(eps, m_Constant<FloatAttr>(&epsilon)))
+    return nullptr;
+  return rsqrtOp.getDpsInputOperand(0)->get();
+}
+
+// Return true if `val` holds one value per column of a MxN tensor: N or 1xN.
+static bool isColumnVector(Value val, int64_t numCols) {
+  auto type = val.getType().dyn_cast<RankedTensorType>();
+  if (!type || type.getShape().back() != numCols)
+    return false;
+  return type.getRank() == 1 ||
+         (type.getRank() == 2 && type.getShape()[0] == 1);
+}
+
+// Match the commutative binary tpp operation `isBinaryOp` on `val` and capture
+// the operand of type `type` first.
+static bool matchBinaryWithOperand(
+    Value val, Type type,
+    bool (*isBinaryOp)(linalg::GenericOp, SmallVectorImpl<Value> *),
+    SmallVectorImpl<Value> &operands) {
+  auto linalgOp = val.getDefiningOp<linalg::GenericOp>();
+  if (!linalgOp || !isBinaryOp(linalgOp, &operands) || operands.size() < 2)
+    return false;
+  if (operands[0].getType() != type)
+    std::swap(operands[0], operands[1]);
+  return operands[0].getType() == type;
+}
+
+// Return true if the linalg.generic adds beta to the normalized input scaled
+// by gamma.
+bool isTppLayerNorm(linalg::GenericOp linalgOp,
+                    SmallVectorImpl<Value> *operands, FloatAttr *epsilon) {
+  Value init = linalgOp.getDpsInitOperand(0)->get();
+  Type type = init.getType();
+  auto tensorType = type.dyn_cast<RankedTensorType>();
+  if (!tensorType || tensorType.getRank() != 2)
+    return false;
+  int64_t numCols = tensorType.getShape()[1];
+
+  // y = n * gamma + beta.
+  SmallVector<Value> addOperands;
+  SmallVector<Value> scaleOperands;
+  if (!matchBinaryWithOperand(linalgOp->getResult(0), type, isTppAdd,
+                              addOperands) ||
+      !isColumnVector(addOperands[1], numCols) ||
+      !matchBinaryWithOperand(addOperands[0], type, isTppMul,
+                              scaleOperands) ||
+      !isColumnVector(scaleOperands[1], numCols))
+    return false;
+
+  // n = c * rsqrt(mean(c * c) + epsilon).
+  SmallVector<Value> normOperands;
+  if (!matchBinaryWithOperand(scaleOperands[0], type, isTppMul,
+                              normOperands))
+    return false;
+  // The broadcast of the Mx1 factor may have the type of c as well.
+  if (!getRowBroadcastSource(normOperands[1]))
+    std::swap(normOperands[0], normOperands[1]);
+  Value centered = normOperands[0];
+  FloatAttr eps;
+  Value rstd = getRowBroadcastSource(normOperands[1]);
+  Value var = rstd ? getRsqrtInput(rstd, eps) : nullptr;
+  Value squared = var ? getRowMeanInput(var) : nullptr;
+  auto squareOp =
+      squared ? squared.getDefiningOp<linalg::GenericOp>() : nullptr;
+  SmallVector<Value> squareOperands;
+  if (centered.getType() != type || !squareOp ||
+      !isTppMul(squareOp, &squareOperands) ||
+      squareOperands.size() != 2 || squareOperands[0] != centered ||
+      squareOperands[1] != centered)
+    return false;
+
+  // c = x - mean(x).
+  auto subOp = centered.getDefiningOp<linalg::GenericOp>();
+  SmallVector<Value> subOperands;
+  if (!subOp || !isTppSub(subOp, &subOperands) || subOperands.size() != 2 ||
+      subOperands[0].getType() != type)
+    return false;
+  Value input = subOperands[0];
+  Value mean = getRowBroadcastSource(subOperands[1]);
+  if (!mean || getRowMeanInput(mean) != input)
+    return false;
+
+  if (operands) {
+    operands->push_back(input);
+    operands->push_back(scaleOperands[1]);
+    operands->push_back(addOperands[1]);
+    operands->push_back(init);
+  }
+  if (epsilon)
+    *epsilon = eps;
+  return true;
+}
+
+// Return true if `map` reads one value per column of the 2d iteration space:
+// (i, j) -> (j) or (i, j) -> (0, j).
+static bool isColumnMap(AffineMap map) {
+  if (map.getNumDims() != 2 || map.getNumResults() == 0 ||
+      map.getNumResults() > 2)
+    return false;
+  if (map.getResults().back() != getAffineDimExpr(1, map.getContext()))
+    return false;
+  return map.getNumResults() == 1 ||
+         map.getResult(0) == getAffineConstantExpr(0, map.getContext());
+}
+
+// Return true if the linalg.generic converts an i32 accumulator to float, then
+// scales and shifts its columns, optionally followed by a relu.
+bool isTppDequantize(linalg::GenericOp linalgOp,
+                     SmallVectorImpl<Value> *operands, bool *relu) {
+  using namespace tpp::structured_match;
+  // clang-format off
+  auto dequantizeMatcher =
+      StructuredOpMatcher::make<linalg::GenericOp>()
+          .operation(NumDpsInits(EqualsTo(1)))
+          .operation(NumDpsInputs(EqualsTo(3)))
+          .operation(NumRegions(EqualsTo(1)))
+          .operation(HasTensorSemantics())
+          .operation(NumOfLoops(EqualsTo(2)))
+          .dim(MatchAll(), mlir::utils::IteratorType::parallel)
+          .output(MatchAll(), HasRank({2}))
+          .output(MatchAll(), HasStaticInnerDim())
+          .output(MatchAll(), HasMap(Identity()))
+          .input(MatchOne(0), HasMap(Identity()));
+  // clang-format on
+  if (!dequantizeMatcher.match(linalgOp))
+    return false;
+  Value init = linalgOp.getDpsInitOperand(0)->get();
+  Value acc = linalgOp.getDpsInputOperand(0)->get();
+  Value scale = linalgOp.getDpsInputOperand(1)->get();
+  Value bias = linalgOp.getDpsInputOperand(2)->get();
+  Type elementType = getElementTypeOrSelf(init);
+  int64_t numCols = init.getType().cast<ShapedType>().getShape()[1];
+  if (!getElementTypeOrSelf(acc).isInteger(32) ||
+      !elementType.isa<FloatType>() ||
+      getElementTypeOrSelf(scale) != elementType ||
+      getElementTypeOrSelf(bias) != elementType ||
+      !isColumnVector(scale, numCols) || !isColumnVector(bias, numCols) ||
+      !isColumnMap(linalgOp.getMatchingIndexingMap(
+          linalgOp.getDpsInputOperand(1))) ||
+      !isColumnMap(linalgOp.getMatchingIndexingMap(
+          linalgOp.getDpsInputOperand(2))))
+    return false;
+
+  // y = max(sitofp(a) * s + b, 0), the max is optional.
+  Block *body = linalgOp.getBlock();
+  Value result = body->getTerminator()->getOperand(0);
+  int64_t numOps = 4;
+  bool hasRelu = false;
+  if (auto maxOp = result.getDefiningOp<arith::MaxFOp>()) {
+    result = maxOp.getLhs();
+    if (!isZeroTensor(maxOp.getRhs()))
+      result = isZeroTensor(maxOp.getLhs()) ? maxOp.getRhs() : nullptr;
+    hasRelu = true;
+    numOps++;
+  }
+  auto addOp = result ? result.getDefiningOp<arith::AddFOp>() : nullptr;
+  if (!addOp)
+    return false;
+  Value shift = body->getArgument(2);
+  Value scaled = addOp.getLhs() == shift ? addOp.getRhs() : addOp.getLhs();
+  auto mulOp = scaled.getDefiningOp<arith::MulFOp>();
+  if ((addOp.getLhs() != shift && addOp.getRhs() != shift) || !mulOp)
+    return false;
+  Value factor = body->getArgument(1);
+  Value converted = mulOp.getLhs() == factor ? mulOp.getRhs() : mulOp.getLhs();
+  auto convertOp = converted.getDefiningOp<arith::SIToFPOp>();
+  if ((mulOp.getLhs() != factor && mulOp.getRhs() != factor) || !convertOp ||
+      convertOp.getIn() != body->getArgument(0))
+    return false;
+  // Nothing else but constants in the body.
+  if (llvm::count_if(*body, [](Operation &op) {
+        return !isa<arith::ConstantOp>(op);
+      }) != numOps)
+    return false;
+
+  if (operands) {
+    operands->push_back(acc);
+    operands->push_back(scale);
+    operands->push_back(bias);
+    operands->push_back(init);
+  }
+  if (relu)
+    *relu = hasRelu;
+  return true;
+}
+
 LogicalResult splitAndReplaceFusedOp(tpp::FusedBrgemmOp fusedBrgemmOp,
                                      PatternRewriter &rewriter) {
   if (!fusedBrgemmOp.hasBufferSemantics())
@@ -307,6 +895,18 @@ LogicalResult splitAndReplaceFusedOp(tpp::FusedBrgemmOp fusedBrgemmOp,
   case tpp::FusedUnaryOpKind::RELU:
     rewriter.create<tpp::ReluOp>(loc, out, out);
     break;
+  case tpp::FusedUnaryOpKind::GELU:
+    rewriter.create<tpp::GeluOp>(loc, out, out);
+    break;
+  case tpp::FusedUnaryOpKind::TANH:
+    rewriter.create<tpp::TanhOp>(loc, out, out);
+    break;
+  case tpp::FusedUnaryOpKind::SIGMOID:
+    rewriter.create<tpp::SigmoidOp>(loc, out, out);
+    break;
+  case tpp::FusedUnaryOpKind::EXP:
+    rewriter.create<tpp::ExpOp>(loc, out, out);
+    break;
   case tpp::FusedUnaryOpKind::NONE:
     break;
   }
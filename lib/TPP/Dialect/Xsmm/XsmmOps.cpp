@@ -10,6 +10,7 @@
 #include "TPP/Dialect/Xsmm/XsmmEnum.h"
 #include "mlir/IR/Builders.h"
 #include "mlir/IR/OpImplementation.h"
+#include "mlir/Interfaces/ViewLikeInterface.h"
 
 #define GET_OP_CLASSES
 #include "TPP/Dialect/Xsmm/XsmmOps.cpp.inc"
@@ -20,6 +21,7 @@ using namespace mlir::xsmm;
 namespace {
 constexpr std::string_view INPUTS = "inputs";
 constexpr std::string_view DATA_TYPE = "data_type";
+constexpr std::string_view INPUT_DATA_TYPE = "input_data_type";
 constexpr std::string_view FLAGS_NAME = "flags";
 constexpr std::string_view KIND = "kind";
 constexpr std::string_view UNARY_FLAGS_NAME = "unary_flags";
@@ -41,17 +43,23 @@ static ParseResult parseEnum(EnumClass &value, OpAsmParser &parser) {
   return success();
 }
 
+// Parse the inputs, constants or SSA values for the sizes only known at
+// runtime: `[%m, 64, 32, 32, 64, 64]`.
 static ParseResult parseInputImpl(OpAsmParser &parser, OperationState &result) {
-  DenseI64ArrayAttr kindAttr;
-  if (parser.parseCustomAttributeWithFallback(kindAttr, Type{}, INPUTS,
-                                              result.attributes)) {
+  SmallVector<OpAsmParser::UnresolvedOperand> dynamicInputs;
+  DenseI64ArrayAttr inputsAttr;
+  if (parseDynamicIndexList(parser, dynamicInputs, inputsAttr) ||
+      parser.resolveOperands(dynamicInputs, parser.getBuilder().getI64Type(),
+                             result.operands)) {
     return failure();
   }
+  result.addAttribute(INPUTS, inputsAttr);
   return success();
 }
 
 static ParseResult parseDataTypeImpl(OpAsmParser &parser,
-                                     OperationState &result) {
+                                     OperationState &result,
+                                     bool allowInputDataType = false) {
   auto &builder = parser.getBuilder();
   if (parser.parseKeyword(DATA_TYPE) || parser.parseEqual())
     return failure();
@@ -62,6 +70,16 @@ static ParseResult parseDataTypeImpl(OpAsmParser &parser,
                       DataTypeAttr::get(builder.getContext(), dataType));
   result.addTypes(builder.getIntegerType(64));
 
+  // Parse the optional input data type of a converting kernel.
+  if (allowInputDataType &&
+      succeeded(parser.parseOptionalKeyword(INPUT_DATA_TYPE))) {
+    DataType inputDataType;
+    if (parser.parseEqual() || parseEnum(inputDataType, parser))
+      return failure();
+    result.addAttribute(INPUT_DATA_TYPE,
+                        DataTypeAttr::get(builder.getContext(), inputDataType));
+  }
+
   // Parse the optional attribute list
   return parser.parseOptionalAttrDict(result.attributes);
 }
@@ -104,6 +122,38 @@ ParseResult BrgemmDispatchOp::parse(OpAsmParser &parser,
   return parseDataTypeImpl(parser, result);
 }
 
+ParseResult GemmPrefetchDispatchOp::parse(OpAsmParser &parser,
+                                          OperationState &result) {
+  if (failed(parseInputImpl(parser, result)) ||
+      failed(parserFlagsImpl<GemmFlags>(parser, result, FLAGS_NAME)))
+    return failure();
+  return parseDataTypeImpl(parser, result);
+}
+
+ParseResult BrgemmPrefetchDispatchOp::parse(OpAsmParser &parser,
+                                            OperationState &result) {
+  if (failed(parseInputImpl(parser, result)) ||
+      failed(parserFlagsImpl<GemmFlags>(parser, result, FLAGS_NAME)))
+    return failure();
+  return parseDataTypeImpl(parser, result);
+}
+
+ParseResult BrgemmOffsDispatchOp::parse(OpAsmParser &parser,
+                                        OperationState &result) {
+  if (failed(parseInputImpl(parser, result)) ||
+      failed(parserFlagsImpl<GemmFlags>(parser, result, FLAGS_NAME)))
+    return failure();
+  return parseDataTypeImpl(parser, result);
+}
+
+ParseResult BrgemmAddrDispatchOp::parse(OpAsmParser &parser,
+                                        OperationState &result) {
+  if (failed(parseInputImpl(parser, result)) ||
+      failed(parserFlagsImpl<GemmFlags>(parser, result, FLAGS_NAME)))
+    return failure();
+  return parseDataTypeImpl(parser, result);
+}
+
 ParseResult FusedBrgemmDispatchOp::parse(OpAsmParser &parser,
                                          OperationState &result) {
   // Parse inputs.
@@ -141,7 +191,7 @@ ParseResult UnaryDispatchOp::parse(OpAsmParser &parser,
   if (failed(parseInputImpl(parser, result)) ||
       failed(parserFlagsImpl<UnaryFlags>(parser, result, FLAGS_NAME)))
     return failure();
-  return parseDataTypeImpl(parser, result);
+  return parseDataTypeImpl(parser, result, /*allowInputDataType=*/true);
 }
 
 ParseResult BinaryDispatchOp::parse(OpAsmParser &parser,
@@ -174,7 +224,8 @@ ParseResult TernaryDispatchOp::parse(OpAsmParser &parser,
 
 template <typename OpTy>
 static void printerInputImpl(OpAsmPrinter &printer, OpTy op) {
-  printer << " [" << op.getInputs() << ']';
+  printer << ' ';
+  printDynamicIndexList(printer, op, op.getDynamicInputs(), op.getInputs());
 };
 
 template <typename OpTy>
@@ -182,11 +233,16 @@ static void printerDataTypeImpl(OpAsmPrinter &printer, OpTy op) {
   printer << DATA_TYPE << " = ";
   auto dataType = op.getDataType();
   printer << xsmm::stringifyDataType(dataType);
+  if (auto inputDataType = op->template getAttrOfType<DataTypeAttr>(
+          INPUT_DATA_TYPE)) {
+    printer << " " << INPUT_DATA_TYPE << " = "
+            << xsmm::stringifyDataType(inputDataType.getValue());
+  }
   printer.printOptionalAttrDict(
       op->getAttrs(),
-      /*elidedAttrs=*/{DATA_TYPE, FLAGS_NAME, INPUTS, KIND, FLAGS_NAME,
-                       UNARY_FLAGS_NAME, BINARY_FLAGS_NAME, BINARY_KIND,
-                       UNARY_KIND});
+      /*elidedAttrs=*/{DATA_TYPE, INPUT_DATA_TYPE, FLAGS_NAME, INPUTS, KIND,
+                       FLAGS_NAME, UNARY_FLAGS_NAME, BINARY_FLAGS_NAME,
+                       BINARY_KIND, UNARY_KIND});
 }
 
 template <typename AttrTy>
@@ -214,6 +270,34 @@ void BrgemmDispatchOp::print(OpAsmPrinter &printer) {
   printerDataTypeImpl<BrgemmDispatchOp>(printer, *this);
 }
 
+void GemmPrefetchDispatchOp::print(OpAsmPrinter &printer) {
+  printerInputImpl<GemmPrefetchDispatchOp>(printer, *this);
+  auto getOpFlags = [this]() -> ArrayAttr { return this->getFlags(); };
+  printerFlagsImpl<GemmFlagsAttr>(printer, getOpFlags, FLAGS_NAME);
+  printerDataTypeImpl<GemmPrefetchDispatchOp>(printer, *this);
+}
+
+void BrgemmPrefetchDispatchOp::print(OpAsmPrinter &printer) {
+  printerInputImpl<BrgemmPrefetchDispatchOp>(printer, *this);
+  auto getOpFlags = [this]() -> ArrayAttr { return this->getFlags(); };
+  printerFlagsImpl<GemmFlagsAttr>(printer, getOpFlags, FLAGS_NAME);
+  printerDataTypeImpl<BrgemmPrefetchDispatchOp>(printer, *this);
+}
+
+void BrgemmOffsDispatchOp::print(OpAsmPrinter &printer) {
+  printerInputImpl<BrgemmOffsDispatchOp>(printer, *this);
+  auto getOpFlags = [this]() -> ArrayAttr { return this->getFlags(); };
+  printerFlagsImpl<GemmFlagsAttr>(printer, getOpFlags, FLAGS_NAME);
+  printerDataTypeImpl<BrgemmOffsDispatchOp>(printer, *this);
+}
+
+void BrgemmAddrDispatchOp::print(OpAsmPrinter &printer) {
+  printerInputImpl<BrgemmAddrDispatchOp>(printer, *this);
+  auto getOpFlags = [this]() -> ArrayAttr { return this->getFlags(); };
+  printerFlagsImpl<GemmFlagsAttr>(printer, getOpFlags, FLAGS_NAME);
+  printerDataTypeImpl<BrgemmAddrDispatchOp>(printer, *this);
+}
+
 void FusedBrgemmDispatchOp::print(OpAsmPrinter &printer) {
   printerInputImpl<FusedBrgemmDispatchOp>(printer, *this);
   printer << "[" << getBinaryKind() << "," << getUnaryKind() << "] ";
@@ -286,25 +370,47 @@ static LogicalResult verifyGemmFlags(ArrayAttr flags, DataType dataType,
   for (auto flag : flags) {
     flagsAsInt.push_back(flag.cast<IntegerAttr>().getInt());
   }
-  // VNNI flags must be specified only for bf16 type
-  if (dataType != DataType::BF16 && llvm::any_of(flagsAsInt, [](int64_t flag) {
+  // VNNI flags must be specified only for bf16 or i8 type
+  if (dataType != DataType::BF16 && dataType != DataType::I8 &&
+      llvm::any_of(flagsAsInt, [](int64_t flag) {
         return (flag == static_cast<int64_t>(GemmFlags::VNNI_B) ||
                 flag == static_cast<int64_t>(GemmFlags::VNNI_A) ||
                 flag == static_cast<int64_t>(GemmFlags::VNNI_C));
       })) {
-    return op->emitOpError() << "VNNI flags but type is not bf16";
+    return op->emitOpError() << "VNNI flags but type is not bf16 or i8";
+  }
+  // A transposed operand is read in the canonical layout, not in VNNI.
+  auto hasFlag = [&](GemmFlags flag) {
+    return llvm::is_contained(flagsAsInt, static_cast<int64_t>(flag));
+  };
+  if ((hasFlag(GemmFlags::TRANS_A) && hasFlag(GemmFlags::VNNI_A)) ||
+      (hasFlag(GemmFlags::TRANS_B) && hasFlag(GemmFlags::VNNI_B))) {
+    return op->emitOpError() << "transposed operand cannot be in VNNI layout";
   }
   return success();
 }
 
 template <typename OpTy>
 static LogicalResult verifyInputs(OpTy op, size_t expected) {
-  // `inputs` are leading dimensions and sizes
-  size_t numInputs = op.getInputs().size();
+  // `inputs` are leading dimensions and sizes, the ones only known at runtime
+  // are passed as operands.
+  ArrayRef<int64_t> inputs = op.getInputs();
+  if (llvm::any_of(inputs, [](int64_t input) {
+        return input < 0 && !ShapedType::isDynamic(input);
+      })) {
+    return op.emitOpError() << "expect non-negative inputs";
+  }
+  size_t numInputs = inputs.size();
   if (numInputs != expected) {
     return op.emitOpError()
            << "expect " << expected << " args but got: " << numInputs;
   }
+  size_t numDynamicInputs = llvm::count_if(inputs, ShapedType::isDynamic);
+  if (numDynamicInputs != op.getDynamicInputs().size()) {
+    return op.emitOpError()
+           << "expect " << numDynamicInputs
+           << " dynamic inputs but got: " << op.getDynamicInputs().size();
+  }
   return success();
 }
 
@@ -323,11 +429,30 @@ LogicalResult BrgemmDispatchOp::verify() {
   return verifyGemmLikeOp<BrgemmDispatchOp>(*this);
 }
 
+LogicalResult GemmPrefetchDispatchOp::verify() {
+  return verifyGemmLikeOp<GemmPrefetchDispatchOp>(*this);
+}
+
+LogicalResult BrgemmPrefetchDispatchOp::verify() {
+  return verifyGemmLikeOp<BrgemmPrefetchDispatchOp>(*this);
+}
+
+LogicalResult BrgemmOffsDispatchOp::verify() {
+  return verifyGemmLikeOp<BrgemmOffsDispatchOp>(*this);
+}
+
+LogicalResult BrgemmAddrDispatchOp::verify() {
+  return verifyGemmLikeOp<BrgemmAddrDispatchOp>(*this);
+}
+
 LogicalResult UnaryDispatchOp::verify() {
   if (failed(verifyUniquenessAndConsistency<UnaryFlags>(
           getFlags(), getOperation(), FLAGS_NAME))) {
     return failure();
   }
+  // Only the identity converts between types.
+  if (getInputDataType() && getKind() != UnaryKind::IDENTITY)
+    return emitOpError() << "expect identity to convert the input type";
   // 'inputs' = [m, n, lda, ldo]
   return verifyInputs(*this, /*expected=*/4);
 }
@@ -342,10 +467,12 @@ LogicalResult BinaryDispatchOp::verify() {
 }
 
 LogicalResult TernaryDispatchOp::verify() {
-  // 'inputs' = [m, n, k, lda, ldb, ldc]
-  if (failed(verifyInputs(*this, /*expected=*/6)))
+  if (failed(verifyUniquenessAndConsistency<TernaryFlags>(
+          getFlags(), getOperation(), FLAGS_NAME))) {
     return failure();
-  return success();
+  }
+  // 'inputs' = [m, n, ldi0, ldi1, ldi2, ldo]
+  return verifyInputs(*this, /*expected=*/6);
 }
 
 LogicalResult FusedBrgemmDispatchOp::verify() {
@@ -357,6 +484,9 @@ LogicalResult FusedBrgemmDispatchOp::verify() {
   }
   if (failed(verifyGemmLikeOp<FusedBrgemmDispatchOp>(*this)))
     return failure();
+  // The fused epilogue operates on the output type, i32 is not supported.
+  if (getDataType() == xsmm::DataType::I8)
+    return emitOpError() << "i8 is not supported";
   // Verify the flags are consistent with the type of unary or binary specified.
   auto unaryKind = getUnaryKind();
   if (unaryKind == xsmm::UnaryKind::NONE) {
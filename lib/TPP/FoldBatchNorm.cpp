@@ -0,0 +1,295 @@
+//===- FoldBatchNorm.cpp -----------------------------------------*- C++-*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "TPP/Dialect/Tpp/TppUtils.h"
+#include "TPP/Passes.h"
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/Dialect/Func/IR/FuncOps.h"
+#include "mlir/Dialect/Linalg/IR/Linalg.h"
+#include "mlir/Dialect/Linalg/Utils/Utils.h"
+#include "mlir/Dialect/Math/IR/Math.h"
+#include "mlir/Dialect/Tensor/IR/Tensor.h"
+#include "mlir/IR/Matchers.h"
+#include "mlir/Transforms/GreedyPatternRewriteDriver.h"
+#include "llvm/ADT/TypeSwitch.h"
+#include <cmath>
+
+using namespace mlir;
+
+#define GEN_PASS_CLASSES
+#include "TPP/Passes.h.inc"
+
+namespace {
+
+// Returns the constant feeding a per-channel operand of `linalgOp`, that is an
+// operand indexed only by the innermost loop, or a splat.
+static std::optional<DenseElementsAttr>
+getChannelConstant(linalg::LinalgOp linalgOp, OpOperand *operand,
+                   int64_t numChannels) {
+  DenseElementsAttr attr;
+  if (!linalgOp.isDpsInput(operand) ||
+      !matchPattern(operand->get(), m_Constant(&attr)) ||
+      !attr.getElementType().isa<FloatType>())
+    return std::nullopt;
+  if (attr.isSplat())
+    return attr;
+  AffineMap map = linalgOp.getMatchingIndexingMap(operand);
+  AffineExpr innermost =
+      getAffineDimExpr(linalgOp.getNumLoops() - 1, linalgOp.getContext());
+  if (map.getNumResults() != 1 || map.getResult(0) != innermost ||
+      attr.getNumElements() != numChannels)
+    return std::nullopt;
+  return attr;
+}
+
+// Evaluates for the given output channel a value of the body of `genericOp`
+// that does not depend on the conv/matmul result.
+static std::optional<double> evalChannelValue(linalg::GenericOp genericOp,
+                                              Value value, int64_t channel,
+                                              int64_t numChannels) {
+  if (auto arg = dyn_cast<BlockArgument>(value)) {
+    if (arg.getOwner()->getParentOp() != genericOp)
+      return std::nullopt;
+    auto attr = getChannelConstant(
+        genericOp, genericOp.getMatchingOpOperand(arg), numChannels);
+    if (!attr)
+      return std::nullopt;
+    int64_t idx = attr->isSplat() ? 0 : channel;
+    return attr->getValues<APFloat>()[idx].convertToDouble();
+  }
+
+  FloatAttr floatAttr;
+  if (matchPattern(value, m_Constant(&floatAttr)))
+    return floatAttr.getValueAsDouble();
+
+  Operation *op = value.getDefiningOp();
+  if (!op || op->getParentOp() != genericOp)
+    return std::nullopt;
+  SmallVector<double, 2> operands;
+  for (Value operand : op->getOperands()) {
+    auto cst = evalChannelValue(genericOp, operand, channel, numChannels);
+    if (!cst)
+      return std::nullopt;
+    operands.push_back(*cst);
+  }
+  return TypeSwitch<Operation *, std::optional<double>>(op)
+      .Case<arith::AddFOp>([&](auto) { return operands[0] + operands[1]; })
+      .Case<arith::SubFOp>([&](auto) { return operands[0] - operands[1]; })
+      .Case<arith::MulFOp>([&](auto) { return operands[0] * operands[1]; })
+      .Case<arith::DivFOp>([&](auto) { return operands[0] / operands[1]; })
+      .Case<math::SqrtOp>([&](auto) { return std::sqrt(operands[0]); })
+      .Case<math::RsqrtOp>([&](auto) { return 1.0 / std::sqrt(operands[0]); })
+      .Default([&](Operation *) { return std::nullopt; });
+}
+
+// Composes into `y = scale * x + shift` the per-channel affine chain of the
+// body of `genericOp` computing `value` from `x`.
+static LogicalResult composeChannelAffine(linalg::GenericOp genericOp,
+                                          Value value, BlockArgument x,
+                                          int64_t channel, int64_t numChannels,
+                                          double &scale, double &shift) {
+  if (value == x) {
+    scale = 1.0;
+    shift = 0.0;
+    return success();
+  }
+  Operation *op = value.getDefiningOp();
+  if (!op || op->getParentOp() != genericOp ||
+      !isa<arith::AddFOp, arith::SubFOp, arith::MulFOp, arith::DivFOp>(op))
+    return failure();
+
+  // The chain goes through the lhs, or any side of a commutative op.
+  Value chain = op->getOperand(0);
+  std::optional<double> cst =
+      evalChannelValue(genericOp, op->getOperand(1), channel, numChannels);
+  if (!cst && isa<arith::AddFOp, arith::MulFOp>(op)) {
+    chain = op->getOperand(1);
+    cst = evalChannelValue(genericOp, op->getOperand(0), channel, numChannels);
+  }
+  if (!cst || failed(composeChannelAffine(genericOp, chain, x, channel,
+                                          numChannels, scale, shift)))
+    return failure();
+
+  if (isa<arith::AddFOp>(op)) {
+    shift += *cst;
+  } else if (isa<arith::SubFOp>(op)) {
+    shift -= *cst;
+  } else if (isa<arith::MulFOp>(op)) {
+    scale *= *cst;
+    shift *= *cst;
+  } else {
+    scale /= *cst;
+    shift /= *cst;
+  }
+  return success();
+}
+
+// Returns the per-channel values the conv/matmul output is initialized with:
+// zero, or a constant broadcasted along the channels.
+static std::optional<SmallVector<double>> getChannelBias(Value init,
+                                                         int64_t numChannels) {
+  if (tpp::utils::isZeroTensor(init))
+    return SmallVector<double>(numChannels, 0.0);
+  auto broadcastOp = init.getDefiningOp<linalg::GenericOp>();
+  if (!broadcastOp || broadcastOp.getNumDpsInputs() != 1 ||
+      !tpp::utils::hasOnlyOp<linalg::YieldOp>(broadcastOp.getRegion()))
+    return std::nullopt;
+  OpOperand *input = broadcastOp.getDpsInputOperand(0);
+  Value yielded = broadcastOp.getBody()->getTerminator()->getOperand(0);
+  if (yielded != broadcastOp.getMatchingBlockArgument(input))
+    return std::nullopt;
+  auto attr = getChannelConstant(broadcastOp, input, numChannels);
+  if (!attr)
+    return std::nullopt;
+  SmallVector<double> bias;
+  for (int64_t channel = 0; channel < numChannels; channel++) {
+    int64_t idx = attr->isSplat() ? 0 : channel;
+    bias.push_back(attr->getValues<APFloat>()[idx].convertToDouble());
+  }
+  return bias;
+}
+
+static APFloat convertToSemantics(double value,
+                                  const llvm::fltSemantics &semantics) {
+  APFloat result(value);
+  bool losesInfo = false;
+  (void)result.convert(semantics, APFloat::rmNearestTiesToEven, &losesInfo);
+  return result;
+}
+
+// Fold a per-channel affine (i.e., an inference batch-norm with constant
+// statistics) consuming a conv or matmul with constant weights into the
+// weights and the bias: `(W * x + b) * scale + shift` becomes
+// `(W * scale) * x + (b * scale + shift)`.
+struct FoldChannelAffineIntoWeights
+    : public OpRewritePattern<linalg::GenericOp> {
+  using OpRewritePattern<linalg::GenericOp>::OpRewritePattern;
+
+  LogicalResult matchAndRewrite(linalg::GenericOp linalgOp,
+                                PatternRewriter &rewriter) const override {
+    if (!linalgOp.hasTensorSemantics() || !linalg::isElementwise(linalgOp) ||
+        linalgOp->getNumResults() != 1)
+      return failure();
+
+    // Look for the conv/matmul producer, read in place.
+    OpOperand *producerOperand = nullptr;
+    for (OpOperand *operand : linalgOp.getDpsInputOperands()) {
+      Operation *producer = operand->get().getDefiningOp();
+      if (isa_and_nonnull<linalg::MatmulOp, linalg::Conv2DNhwcHwcfOp>(
+              producer) &&
+          linalgOp.getMatchingIndexingMap(operand).isIdentity()) {
+        producerOperand = operand;
+        break;
+      }
+    }
+    if (!producerOperand || !producerOperand->get().hasOneUse())
+      return rewriter.notifyMatchFailure(linalgOp, "expects a conv or matmul");
+    auto producer =
+        cast<linalg::LinalgOp>(producerOperand->get().getDefiningOp());
+    if (producer->getNumResults() != 1 ||
+        producerOperand->get().getType() != linalgOp->getResult(0).getType())
+      return failure();
+
+    // Output channels are the innermost dimension of both the output and the
+    // weights (KxN for matmul, HWCF for conv).
+    auto outputType = linalgOp->getResult(0).getType().cast<ShapedType>();
+    int64_t numChannels = outputType.getShape().back();
+    if (ShapedType::isDynamic(numChannels))
+      return failure();
+    OpOperand *weightsOperand = producer.getDpsInputOperand(1);
+    DenseElementsAttr weights;
+    if (!matchPattern(weightsOperand->get(), m_Constant(&weights)) ||
+        !weights.getElementType().isa<FloatType>() ||
+        weights.getType().getShape().back() != numChannels)
+      return rewriter.notifyMatchFailure(linalgOp,
+                                         "expects constant weights");
+    OpOperand *initOperand = producer.getDpsInitOperand(0);
+    auto bias = getChannelBias(initOperand->get(), numChannels);
+    if (!bias)
+      return rewriter.notifyMatchFailure(linalgOp, "expects a constant bias");
+
+    BlockArgument x = linalgOp.getMatchingBlockArgument(producerOperand);
+    Value yielded = linalgOp.getBody()->getTerminator()->getOperand(0);
+    SmallVector<double> scales, shifts;
+    for (int64_t channel = 0; channel < numChannels; channel++) {
+      double scale, shift;
+      if (failed(composeChannelAffine(linalgOp, yielded, x, channel,
+                                      numChannels, scale, shift)))
+        return rewriter.notifyMatchFailure(linalgOp,
+                                           "expects a per-channel affine");
+      scales.push_back(scale);
+      shifts.push_back(shift);
+    }
+
+    Location loc = linalgOp.getLoc();
+    SmallVector<APFloat> newWeights;
+    for (auto [idx, weight] : llvm::enumerate(weights.getValues<APFloat>())) {
+      newWeights.push_back(convertToSemantics(
+          weight.convertToDouble() * scales[idx % numChannels],
+          weight.getSemantics()));
+    }
+    Value newWeightsCst = rewriter.create<arith::ConstantOp>(
+        loc, DenseElementsAttr::get(weights.getType(), newWeights));
+
+    Value newInit = initOperand->get();
+    auto elementType = outputType.getElementType().cast<FloatType>();
+    SmallVector<APFloat> newBias;
+    bool isZeroBias = true;
+    for (int64_t channel = 0; channel < numChannels; channel++) {
+      double value = (*bias)[channel] * scales[channel] + shifts[channel];
+      isZeroBias &= value == 0.0;
+      newBias.push_back(
+          convertToSemantics(value, elementType.getFloatSemantics()));
+    }
+    if (!isZeroBias || !tpp::utils::isZeroTensor(newInit)) {
+      // Initialize the output with the new bias, broadcasted along the
+      // channels.
+      auto biasType = RankedTensorType::get({numChannels}, elementType);
+      Value biasCst = rewriter.create<arith::ConstantOp>(
+          loc, DenseElementsAttr::get(biasType, newBias));
+      // The batch may be dynamic: take the sizes from the original init.
+      Value empty = rewriter.create<tensor::EmptyOp>(
+          loc, tensor::getMixedSizes(rewriter, loc, initOperand->get()),
+          elementType);
+      int64_t rank = outputType.getRank();
+      SmallVector<AffineMap> maps = {
+          AffineMap::get(rank, 0, rewriter.getAffineDimExpr(rank - 1)),
+          rewriter.getMultiDimIdentityMap(rank)};
+      SmallVector<utils::IteratorType> iteratorTypes(
+          rank, utils::IteratorType::parallel);
+      newInit = rewriter
+                    .create<linalg::GenericOp>(
+                        loc, outputType, biasCst, empty, maps, iteratorTypes,
+                        [](OpBuilder &b, Location loc, ValueRange args) {
+                          b.create<linalg::YieldOp>(loc, args[0]);
+                        })
+                    .getResult(0);
+    }
+
+    Operation *newProducer = rewriter.clone(*producer);
+    newProducer->setOperand(weightsOperand->getOperandNumber(), newWeightsCst);
+    newProducer->setOperand(initOperand->getOperandNumber(), newInit);
+    rewriter.replaceOp(linalgOp, newProducer->getResults());
+    return success();
+  }
+};
+
+struct FoldBatchNorm : public FoldBatchNormBase<FoldBatchNorm> {
+  void runOnOperation() override {
+    RewritePatternSet patterns(getOperation().getContext());
+    patterns.add<FoldChannelAffineIntoWeights>(patterns.getContext());
+    (void)applyPatternsAndFoldGreedily(getOperation(), std::move(patterns));
+  }
+};
+
+} // namespace
+
+std::unique_ptr<OperationPass<func::FuncOp>>
+mlir::tpp::createFoldBatchNormPass() {
+  return std::make_unique<FoldBatchNorm>();
+}
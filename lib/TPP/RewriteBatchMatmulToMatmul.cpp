@@ -8,12 +8,15 @@
 
 #include "TPP/Passes.h"
 #include "TPP/TransformUtils.h"
+#include "mlir/Dialect/Arith/IR/Arith.h"
 #include "mlir/Dialect/Func/IR/FuncOps.h"
 #include "mlir/Dialect/Linalg/IR/Linalg.h"
 #include "mlir/Dialect/Linalg/Transforms/Transforms.h"
 #include "mlir/Dialect/SCF/IR/SCF.h"
 #include "mlir/Dialect/SCF/Transforms/TileUsingInterface.h"
 #include "mlir/Dialect/SCF/Utils/Utils.h"
+#include "mlir/Dialect/Tensor/IR/Tensor.h"
+#include "mlir/IR/TypeUtilities.h"
 #include "mlir/Transforms/GreedyPatternRewriteDriver.h"
 
 using namespace mlir;
@@ -21,6 +24,166 @@ using namespace mlir;
 #define GEN_PASS_CLASSES
 #include "TPP/Passes.h.inc"
 
+using MapList = ArrayRef<ArrayRef<AffineExpr>>;
+
+// Return true if `op` is a linalg.batch_matmul or a linalg.generic with the
+// same semantics, possibly with one input broadcasted along the batch
+// dimension, i.e., B is [k, n] or A is [m, k].
+static bool isBatchMatmulLike(Operation *op) {
+  if (isa<linalg::BatchMatmulOp>(op))
+    return true;
+  auto genericOp = dyn_cast<linalg::GenericOp>(op);
+  if (!genericOp || genericOp.getNumDpsInputs() != 2 ||
+      genericOp.getNumDpsInits() != 1 || genericOp.getNumLoops() != 4 ||
+      !linalgx::utils::hasMulAddBody(genericOp)) {
+    return false;
+  }
+  SmallVector<utils::IteratorType> iteratorTypes =
+      genericOp.getIteratorTypesArray();
+  if (!linalg::isParallelIterator(iteratorTypes[0]) ||
+      !linalg::isParallelIterator(iteratorTypes[1]) ||
+      !linalg::isParallelIterator(iteratorTypes[2]) ||
+      !linalg::isReductionIterator(iteratorTypes[3])) {
+    return false;
+  }
+  AffineExpr b, m, n, k;
+  bindDims(genericOp.getContext(), b, m, n, k);
+  SmallVector<AffineMap> maps = genericOp.getIndexingMapsArray();
+  return maps == AffineMap::inferFromExprList(
+                     MapList{{b, m, k}, {b, k, n}, {b, m, n}}) ||
+         maps == AffineMap::inferFromExprList(
+                     MapList{{b, m, k}, {k, n}, {b, m, n}}) ||
+         maps == AffineMap::inferFromExprList(
+                     MapList{{m, k}, {b, k, n}, {b, m, n}});
+}
+
+// Return true if B is shared by all the batches of `linalgOp`.
+static bool hasBroadcastedB(linalg::LinalgOp linalgOp) {
+  Value rhs = linalgOp.getDpsInputOperand(1)->get();
+  return rhs.getType().cast<ShapedType>().getRank() == 2;
+}
+
+// Fold a linalg.broadcast along the batch dimension into its batch matmul
+// consumer. The broadcasted operand is not materialized but read by every
+// batch. If both inputs are broadcasted, only B is folded.
+static FailureOr<linalg::LinalgOp>
+foldBroadcastIntoBatchMatmul(RewriterBase &rewriter,
+                             linalg::BatchMatmulOp batchMatmulOp) {
+  if (!batchMatmulOp.hasTensorSemantics())
+    return failure();
+  auto getBroadcastSource = [](Value operand) -> Value {
+    auto broadcastOp = operand.getDefiningOp<linalg::BroadcastOp>();
+    if (!broadcastOp || broadcastOp.getDimensions() != ArrayRef<int64_t>{0})
+      return nullptr;
+    return broadcastOp.getInput();
+  };
+
+  Value lhs = batchMatmulOp.getDpsInputOperand(0)->get();
+  Value rhs = batchMatmulOp.getDpsInputOperand(1)->get();
+  Value init = batchMatmulOp.getDpsInitOperand(0)->get();
+  Type elementType = init.getType().cast<ShapedType>().getElementType();
+  if (getElementTypeOrSelf(lhs.getType()) != elementType ||
+      getElementTypeOrSelf(rhs.getType()) != elementType) {
+    return failure();
+  }
+
+  AffineExpr b, m, n, k;
+  bindDims(batchMatmulOp.getContext(), b, m, n, k);
+  SmallVector<AffineExpr> lhsExprs = {b, m, k};
+  SmallVector<AffineExpr> rhsExprs = {b, k, n};
+  if (Value source = getBroadcastSource(rhs)) {
+    rhs = source;
+    rhsExprs = {k, n};
+  } else if (Value source = getBroadcastSource(lhs)) {
+    lhs = source;
+    lhsExprs = {m, k};
+  } else {
+    return failure();
+  }
+  SmallVector<AffineMap> maps =
+      AffineMap::inferFromExprList(MapList{lhsExprs, rhsExprs, {b, m, n}});
+  SmallVector<utils::IteratorType> iteratorTypes = {
+      utils::IteratorType::parallel, utils::IteratorType::parallel,
+      utils::IteratorType::parallel, utils::IteratorType::reduction};
+
+  bool isFloat = elementType.isa<FloatType>();
+  auto genericOp = rewriter.create<linalg::GenericOp>(
+      batchMatmulOp.getLoc(), init.getType(), ValueRange{lhs, rhs},
+      ValueRange{init}, maps, iteratorTypes,
+      [&](OpBuilder &builder, Location loc, ValueRange args) {
+        Value mul =
+            (isFloat)
+                ? builder.create<arith::MulFOp>(loc, args[0], args[1])
+                      .getResult()
+                : builder.create<arith::MulIOp>(loc, args[0], args[1])
+                      .getResult();
+        Value add = (isFloat)
+                        ? builder.create<arith::AddFOp>(loc, args[2], mul)
+                              .getResult()
+                        : builder.create<arith::AddIOp>(loc, args[2], mul)
+                              .getResult();
+        builder.create<linalg::YieldOp>(loc, add);
+      });
+  rewriter.replaceOp(batchMatmulOp, genericOp->getResults());
+  return cast<linalg::LinalgOp>(genericOp.getOperation());
+}
+
+// Pack the heads of a batch matmul sharing B into a single matmul, i.e.,
+// [b, m, n] += [b, m, k] * [k, n] becomes [b * m, n] += [b * m, k] * [k, n],
+// so that B is reused across heads. Batch and M must be static.
+static FailureOr<linalg::MatmulOp> packHeads(RewriterBase &rewriter,
+                                             linalg::LinalgOp linalgOp) {
+  Value lhs = linalgOp.getDpsInputOperand(0)->get();
+  Value rhs = linalgOp.getDpsInputOperand(1)->get();
+  Value init = linalgOp.getDpsInitOperand(0)->get();
+  auto initType = init.getType().cast<ShapedType>();
+  if (initType.isDynamicDim(0) || initType.isDynamicDim(1))
+    return failure();
+
+  Location loc = linalgOp.getLoc();
+  SmallVector<ReassociationIndices> reassociation = {{0, 1}, {2}};
+  Value packedLhs =
+      rewriter.create<tensor::CollapseShapeOp>(loc, lhs, reassociation);
+  Value packedInit =
+      rewriter.create<tensor::CollapseShapeOp>(loc, init, reassociation);
+  auto matmulOp = rewriter.create<linalg::MatmulOp>(
+      loc, packedInit.getType(), ValueRange{packedLhs, rhs},
+      ValueRange{packedInit});
+  rewriter.replaceOpWithNewOp<tensor::ExpandShapeOp>(
+      linalgOp, initType, matmulOp.getResult(0), reassociation);
+  return matmulOp;
+}
+
+// Return the tile size along a dimension of size `size`: `tileSize` if it
+// evenly divides `size`, 0 (i.e., no tiling) otherwise. Taking full tiles
+// only makes all the iterations share one gemm kernel.
+static int64_t getFullTileSize(int64_t size, int64_t tileSize) {
+  if (tileSize <= 0 || ShapedType::isDynamic(size) || size <= tileSize ||
+      size % tileSize != 0) {
+    return 0;
+  }
+  return tileSize;
+}
+
+// Tile `op` with `tileSizes` and mark the outermost loop as parallel.
+static LogicalResult tileAndMarkParallel(RewriterBase &rewriter,
+                                         TilingInterface op,
+                                         ArrayRef<int64_t> tileSizes) {
+  scf::SCFTilingOptions tilingOptions;
+  tilingOptions.setTileSizes(tileSizes);
+  FailureOr<scf::SCFTilingResult> tilingResult =
+      scf::tileUsingSCFForOp(rewriter, op, tilingOptions);
+  if (failed(tilingResult))
+    return failure();
+  if (!tilingResult->loops.empty()) {
+    tilingResult->loops[0]->setAttr(
+        linalgx::utils::kLoopParallel,
+        rewriter.getStringAttr(linalgx::utils::kLoopRoot));
+  }
+  rewriter.replaceOp(op, tilingResult->replacements);
+  return success();
+}
+
 namespace {
 
 struct RankReducedExtractSliceOp
@@ -31,7 +194,7 @@ struct RankReducedExtractSliceOp
                                 PatternRewriter &rewriter) const override {
     // Limit the replacement to sliceOp with batch matmul as users.
     if (!llvm::all_of(sliceOp->getUsers(), [](Operation *user) {
-          return isa<linalg::BatchMatmulOp>(user);
+          return isBatchMatmulLike(user);
         })) {
       return failure();
     }
@@ -67,7 +230,7 @@ struct RankReducedParallelInsertSliceOp
                                 PatternRewriter &rewriter) const override {
     // Limit the replacement to sliceOp with batch matmul as users.
     if (!llvm::all_of(sliceOp->getUsers(), [](Operation *user) {
-          return isa<linalg::BatchMatmulOp>(user);
+          return isBatchMatmulLike(user);
         })) {
       return failure();
     }
@@ -94,16 +257,24 @@ struct RankReducedParallelInsertSliceOp
   }
 };
 
+// Rewrite a batch matmul with a unit batch to a matmul. Broadcasted operands
+// are used as they are.
 struct RewriteBatchMatmulToMatmulImpl
-    : public OpRewritePattern<linalg::BatchMatmulOp> {
-  using OpRewritePattern<linalg::BatchMatmulOp>::OpRewritePattern;
+    : public OpInterfaceRewritePattern<linalg::LinalgOp> {
+  using OpInterfaceRewritePattern<linalg::LinalgOp>::OpInterfaceRewritePattern;
 
-  LogicalResult matchAndRewrite(linalg::BatchMatmulOp linalgOp,
+  LogicalResult matchAndRewrite(linalg::LinalgOp linalgOp,
                                 PatternRewriter &rewriter) const override {
+    if (!isBatchMatmulLike(linalgOp))
+      return failure();
     auto operands = linalgOp.getDpsInputOperands();
     operands.append(linalgOp.getDpsInitOperands());
     SmallVector<Value> matmulOperands;
     for (OpOperand *operand : operands) {
+      if (operand->get().getType().cast<ShapedType>().getRank() == 2) {
+        matmulOperands.push_back(operand->get());
+        continue;
+      }
       tensor::ExpandShapeOp expandOp =
           operand->get().getDefiningOp<tensor::ExpandShapeOp>();
       if (!expandOp || expandOp.getSrcType().getRank() != 2)
@@ -123,26 +294,61 @@ struct RewriteBatchMatmulToMatmul
   void runOnOperation() override {
     auto &ctx = getContext();
     IRRewriter rewriter(&ctx);
-    // Step 1. tiling.
-    getOperation()->walk([&](linalg::BatchMatmulOp batchMatmulOp) {
-      scf::SCFTilingOptions tilingOptions;
-      tilingOptions.setTileSizes({1, 0, 0});
-      FailureOr<scf::SCFTilingResult> tilingResult = scf::tileUsingSCFForOp(
-          rewriter, cast<TilingInterface>(batchMatmulOp.getOperation()),
-          tilingOptions);
-      if (failed(tilingResult))
-        return signalPassFailure();
-      tilingResult->loops[0]->setAttr(
-          linalgx::utils::kLoopParallel,
-          rewriter.getStringAttr(linalgx::utils::kLoopRoot));
-      rewriter.replaceOp(batchMatmulOp, tilingResult->replacements);
+    // Step 1. fold broadcasts along the batch dimension.
+    SmallVector<linalg::LinalgOp> batchMatmulOps;
+    getOperation()->walk([&](linalg::LinalgOp linalgOp) {
+      if (isBatchMatmulLike(linalgOp))
+        batchMatmulOps.push_back(linalgOp);
     });
+    for (linalg::LinalgOp &linalgOp : batchMatmulOps) {
+      auto batchMatmulOp =
+          dyn_cast<linalg::BatchMatmulOp>(linalgOp.getOperation());
+      if (!batchMatmulOp)
+        continue;
+      rewriter.setInsertionPoint(batchMatmulOp);
+      FailureOr<linalg::LinalgOp> genericOp =
+          foldBroadcastIntoBatchMatmul(rewriter, batchMatmulOp);
+      if (succeeded(genericOp))
+        linalgOp = *genericOp;
+    }
+
+    // Step 2. tiling. The batches and the M-tiles run in parallel. If B is
+    // shared, pack the heads first and tile the resulting matmul along M.
+    for (linalg::LinalgOp linalgOp : batchMatmulOps) {
+      rewriter.setInsertionPoint(linalgOp);
+      auto initType =
+          linalgOp.getDpsInitOperand(0)->get().getType().cast<ShapedType>();
+      // Pack the heads only if the packed M has full tiles to run in parallel,
+      // otherwise keep the batches as the parallel dimension.
+      int64_t packedTileSize = 0;
+      if (linalgOp.hasTensorSemantics() && hasBroadcastedB(linalgOp) &&
+          !initType.isDynamicDim(0) && !initType.isDynamicDim(1)) {
+        packedTileSize = getFullTileSize(
+            initType.getDimSize(0) * initType.getDimSize(1), tileM);
+      }
+      if (packedTileSize != 0) {
+        FailureOr<linalg::MatmulOp> matmulOp = packHeads(rewriter, linalgOp);
+        if (succeeded(matmulOp)) {
+          rewriter.setInsertionPoint(*matmulOp);
+          if (failed(tileAndMarkParallel(
+                  rewriter, cast<TilingInterface>(matmulOp->getOperation()),
+                  {packedTileSize, 0, 0})))
+            return signalPassFailure();
+          continue;
+        }
+      }
+      int64_t tileSize = getFullTileSize(initType.getDimSize(1), tileM);
+      if (failed(tileAndMarkParallel(
+              rewriter, cast<TilingInterface>(linalgOp.getOperation()),
+              {1, tileSize, 0, 0})))
+        return signalPassFailure();
+    }
 
-    // Step2:
+    // Step 3:
     // - replace scf.for with scf.forall.
     // - replace extract/insert slice with ranked reduced extract/insert slice
     // and expand shape ops.
-    // - replace linalg.batch_matmul with linalg.matmul.
+    // - replace the batch matmuls with linalg.matmul.
     RewritePatternSet patterns(&ctx);
     linalg::populateLinalgTilingCanonicalizationPatterns(patterns);
     tensor::populateMergeConsecutiveInsertExtractSlicePatterns(patterns);
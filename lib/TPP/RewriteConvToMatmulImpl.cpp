@@ -9,196 +9,124 @@
 #include "TPP/Dialect/Tpp/TppUtils.h"
 #include "TPP/TransformUtils.h"
 #include "TPP/Transforms.h"
+#include "mlir/Dialect/Affine/IR/AffineOps.h"
+#include "mlir/Dialect/Arith/IR/Arith.h"
 #include "mlir/Dialect/Linalg/IR/Linalg.h"
 #include "mlir/Dialect/Linalg/Utils/Utils.h"
+#include "mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/Dialect/Tensor/IR/Tensor.h"
 #include "mlir/IR/BuiltinTypes.h"
+#include "mlir/Support/MathExtras.h"
 
 using namespace mlir;
 
-// Return the size of the image slice to extract and use into the GEMM
-// operation. If we have a slide window (R and S are not 1). The size
-// of the image slice depend on the filter and on the output.
-static SmallVector<OpFoldResult>
-computeSizeGemmForImage(OpBuilder &builder, linalg::LinalgOp linalgOp) {
-  OpOperand *image = linalgOp.getDpsInputOperands()[0];
-  unsigned rank = image->get().getType().cast<ShapedType>().getRank();
-  SmallVector<OpFoldResult> sizes;
-  sizes.reserve(rank);
-
-  // All other dimesions but the last two are not involved and we
-  // can simply use size of 1.
-  for (size_t idx = 0, e = rank - /*GEMM operand size=*/2; idx < e; idx++)
-    sizes.push_back(builder.getIndexAttr(1));
-
-  OpOperand *output = linalgOp.getDpsInitOperands()[0];
-  OpOperand *filter = linalgOp.getDpsInputOperands()[1];
-  ArrayRef<int64_t> outputShape =
-      output->get().getType().cast<ShapedType>().getShape();
-  ArrayRef<int64_t> filterShape =
-      filter->get().getType().cast<ShapedType>().getShape();
-  int64_t mIdx = outputShape.size() - 2;
-  int64_t kIdx = filterShape.size() - 2;
-  sizes.push_back(linalg::createFoldedDimOp(builder, linalgOp.getLoc(),
-                                            output->get(), mIdx));
-  sizes.push_back(linalg::createFoldedDimOp(builder, linalgOp.getLoc(),
-                                            filter->get(), kIdx));
-  return sizes;
+// Return the coefficient of dimension `pos` in the linear expression `expr`.
+static std::optional<int64_t> getDimCoefficient(AffineExpr expr, unsigned pos,
+                                                unsigned numDims) {
+  MLIRContext *ctx = expr.getContext();
+  SmallVector<AffineExpr> dimOnly(numDims, getAffineConstantExpr(0, ctx));
+  dimOnly[pos] = getAffineConstantExpr(1, ctx);
+  auto coefficient = expr.replaceDims(dimOnly).dyn_cast<AffineConstantExpr>();
+  if (!coefficient)
+    return std::nullopt;
+  return coefficient.getValue();
 }
 
-// Return success if `expr` is either a dimExpr or a mul expression dim * cst OR
-// cst * dim.
-static LogicalResult isDimExprOrMulExpr(AffineExpr expr,
-                                        AffineExpr &multiplicativeFactor) {
-  if (auto dimExpr = expr.dyn_cast<AffineDimExpr>())
-    return success();
-  if (auto mulExpr = expr.dyn_cast<AffineBinaryOpExpr>()) {
-    if (mulExpr.getKind() != AffineExprKind::Mul)
-      return failure();
-    auto lhs = mulExpr.getLHS();
-    auto rhs = mulExpr.getRHS();
-    // Assert if we find a symbol. We need to check that we don't have them in
-    // the preconditions for this pattern. `verifyConvolutionInterface` allows
-    // them.
-    if (auto symbol = lhs.dyn_cast<AffineSymbolExpr>())
-      assert(false && "unexpected symbol expr");
-    if (auto symbol = rhs.dyn_cast<AffineSymbolExpr>())
-      assert(false && "unexpected symbol expr");
-    // If the lhs is a constant the rhs is a dim and viceversa.
-    if (auto constant = lhs.dyn_cast<AffineConstantExpr>()) {
-      if (auto dim = rhs.dyn_cast<AffineDimExpr>()) {
-        multiplicativeFactor = multiplicativeFactor * constant.getValue();
-        return success();
-      }
-      return failure();
-    }
-    if (auto constant = rhs.dyn_cast<AffineConstantExpr>()) {
-      if (auto dim = lhs.dyn_cast<AffineDimExpr>()) {
-        multiplicativeFactor = multiplicativeFactor * constant.getValue();
-        return success();
-      }
-      return failure();
-    }
+// Return the slice of `operand` touched by the loops of `linalgOp` that are
+// not materialized. The first `ivs.size()` loops are materialized and their
+// induction variables feed the offsets; the remaining ones are the GEMM or
+// BRGEMM loops and define sizes and strides. Each operand dimension can
+// involve at most one of the GEMM/BRGEMM loops. The stride is the coefficient
+// of that loop in the access expression, this takes into account strides on
+// the image (i.e., Q * stride + S * dilation on W). Dilations and strides on H
+// land in the offsets as the loops iterating over P, R and S are materialized.
+static FailureOr<Value> getSlicedConvOperand(OpBuilder &builder,
+                                             OpOperand *operand,
+                                             linalg::LinalgOp linalgOp,
+                                             ValueRange ivs,
+                                             ValueRange valuesToUse,
+                                             unsigned desiredResultRank) {
+  Location loc = linalgOp.getLoc();
+  MLIRContext *ctx = linalgOp.getContext();
+  Value operandToUse = valuesToUse[operand->getOperandNumber()];
+  AffineMap map = linalgOp.getMatchingIndexingMap(operand);
+  if (map.getNumSymbols() != 0)
     return failure();
-  }
-  return failure();
-}
+  SmallVector<int64_t> loopRanges = linalgOp.getStaticLoopRanges();
+  unsigned numIvs = ivs.size();
+  unsigned numLoops = map.getNumDims();
 
-// Walk `convExpr` in pre-order and extract a constant if any.
-static LogicalResult walkConvExpr(AffineExpr convExpr,
-                                  AffineExpr &multiplicativeFactor) {
-  if (auto dimExpr = convExpr.dyn_cast<AffineDimExpr>())
-    return success();
-  if (auto binExpr = convExpr.dyn_cast<AffineBinaryOpExpr>()) {
-    if (binExpr.getKind() != AffineExprKind::Add)
-      return failure();
-    return success(
-        succeeded(isDimExprOrMulExpr(binExpr.getLHS(), multiplicativeFactor)) &&
-        succeeded(isDimExprOrMulExpr(binExpr.getRHS(), multiplicativeFactor)));
-  }
-  return failure();
-}
+  AffineExpr zero = getAffineConstantExpr(0, ctx);
+  // Keep the materialized dimensions and drop the others.
+  SmallVector<AffineExpr> outerDims(numLoops, zero);
+  for (unsigned pos = 0; pos < numIvs; pos++)
+    outerDims[pos] = getAffineDimExpr(pos, ctx);
 
-static FailureOr<Value> getSlicedConvOperandImpl(OpBuilder &builder,
-                                                 linalg::LinalgOp linalgOp,
-                                                 OpOperand *operand,
-                                                 ValueRange ivs,
-                                                 ValueRange valuesToUse) {
-  Value operandToUse = valuesToUse[operand->getOperandNumber()];
-  ShapedType operandType = operandToUse.getType().cast<ShapedType>();
-  size_t rank = operandType.getRank();
-  bool isImage = operand->getOperandNumber() == 0;
-  unsigned desiredResultRank = 2;
-
-  SmallVector<OpFoldResult> offsets, sizes;
-  offsets.reserve(rank);
-  sizes.reserve(rank);
-
-  // Offset into the tensor is the induction var or 0.
-  for (size_t idx = 0, e = ivs.size(); idx < e; idx++)
-    offsets.push_back(ivs[idx]);
-  for (size_t idx = ivs.size(), e = rank; idx < e; idx++)
-    offsets.push_back(builder.getIndexAttr(0));
-
-  // If the filter has R and S not 1 we need to deal with a sliding window. The
-  // sizes of the matmul depend on the filter and output, use
-  // `computeSizeGemmForImage` to compute them.
-  if (isImage) {
-    sizes = computeSizeGemmForImage(builder, linalgOp);
-  } else {
-    // Get full sizes from [rank - desiredResultRank, rank).
-    for (size_t idx = 0, e = rank - desiredResultRank; idx < e; idx++)
+  SmallVector<OpFoldResult> offsets, sizes, strides;
+  for (AffineExpr expr : map.getResults()) {
+    AffineMap offsetMap =
+        AffineMap::get(numIvs, /*symbolCount=*/0, expr.replaceDims(outerDims));
+    offsets.push_back(affine::makeComposedFoldedAffineApply(
+        builder, loc, offsetMap, getAsOpFoldResult(ivs)));
+
+    std::optional<unsigned> innerDim;
+    for (unsigned pos = numIvs; pos < numLoops; pos++) {
+      if (!expr.isFunctionOfDim(pos))
+        continue;
+      if (innerDim)
+        return failure();
+      innerDim = pos;
+    }
+    if (!innerDim) {
       sizes.push_back(builder.getIndexAttr(1));
-    for (size_t idx = rank - desiredResultRank, e = rank; idx < e; idx++)
-      sizes.push_back(linalg::createFoldedDimOp(builder, linalgOp.getLoc(),
-                                                operand->get(), idx));
-  }
+      strides.push_back(builder.getIndexAttr(1));
+      continue;
+    }
+    if (ShapedType::isDynamic(loopRanges[*innerDim]))
+      return failure();
+    sizes.push_back(builder.getIndexAttr(loopRanges[*innerDim]));
 
-  // We need to take into accound possible strides on W. Strides on the H
-  // are already computed using affine maps as the loops iterating over H are
-  // materialized. The W dimension is the last - 1 dimension.
-  SmallVector<OpFoldResult> strides(rank, builder.getIndexAttr(1));
-  if (isImage) {
-    AffineMap imageMap = linalgOp.getMatchingIndexingMap(operand);
-    AffineExpr wExpr = imageMap.getResult(imageMap.getNumResults() - 2);
-    AffineExpr multiplicativeFactor =
-        getAffineConstantExpr(1, linalgOp.getContext());
-    // By definition a convolution affine expression can either be:
-    // a) AffineDimExpr
-    // b) AffineDimExpr + AffineDimExpr
-    // c) AffineDimExpr * AffineConstantExpr/AffineSymbolExpr + AffineDimExpr
-    assert(succeeded(walkConvExpr(wExpr, multiplicativeFactor)) &&
-           "something went really wrong");
-    strides[strides.size() - 2] = builder.getIndexAttr(
-        multiplicativeFactor.cast<AffineConstantExpr>().getValue());
+    std::optional<int64_t> stride =
+        getDimCoefficient(expr, *innerDim, numLoops);
+    if (!stride || *stride <= 0)
+      return failure();
+    strides.push_back(builder.getIndexAttr(*stride));
   }
   return linalgx::utils::getSliceOperand(builder, linalgOp, operandToUse,
                                          offsets, sizes, strides,
                                          desiredResultRank);
 }
 
-// Extract the sliced version of `operand` such that we can use it in a
-// linalg.matmul.
-static FailureOr<Value> getSlicedConvOperand(OpBuilder &builder,
-                                             OpOperand *operand,
-                                             linalg::LinalgOp linalgOp,
-                                             ValueRange ivs,
-                                             ValueRange valuesToUse) {
-  Location loc = linalgOp.getLoc();
-  FailureOr<SmallVector<Value>> involvedDimForOperand =
-      linalgx::utils::getInvolvedLocalDimsForOperand(
-          builder, loc, operand, linalgOp.getMatchingIndexingMap(operand), ivs);
-  if (failed(involvedDimForOperand))
-    return failure();
-  return getSlicedConvOperandImpl(builder, linalgOp, operand,
-                                  *involvedDimForOperand, valuesToUse);
-}
-
+// Slice image, filter and output. The image and the filter are
+// `inputResultRank`-D (2 for GEMM, 3 for BRGEMM), the output is always 2-D.
 static FailureOr<SmallVector<Value>>
 getSlicedConvOperands(OpBuilder &builder, ValueRange localIvs,
-                      linalg::LinalgOp linalgOp, ValueRange valuesToUse) {
+                      linalg::LinalgOp linalgOp, ValueRange valuesToUse,
+                      unsigned inputResultRank) {
   assert(linalgOp->getNumOperands() == 3 && "expect 3 input/output operands");
   assert(linalgOp.getDpsInputOperands().size() == 2 &&
          "expect 2 input operands");
 
   SmallVector<Value> slicedOperands;
   OpOperand *image = linalgOp.getDpsInputOperands()[0];
-  FailureOr<Value> slicedImage =
-      getSlicedConvOperand(builder, image, linalgOp, localIvs, valuesToUse);
+  FailureOr<Value> slicedImage = getSlicedConvOperand(
+      builder, image, linalgOp, localIvs, valuesToUse, inputResultRank);
 
   if (failed(slicedImage))
     return failure();
   slicedOperands.push_back(*slicedImage);
 
   OpOperand *filter = linalgOp.getDpsInputOperands()[1];
-  FailureOr<Value> slicedFilter =
-      getSlicedConvOperand(builder, filter, linalgOp, localIvs, valuesToUse);
+  FailureOr<Value> slicedFilter = getSlicedConvOperand(
+      builder, filter, linalgOp, localIvs, valuesToUse, inputResultRank);
   if (failed(slicedFilter))
     return failure();
   slicedOperands.push_back(*slicedFilter);
 
   OpOperand *output = linalgOp.getDpsInitOperands()[0];
   FailureOr<Value> slicedOutput =
-      getSlicedConvOperand(builder, output, linalgOp, localIvs, valuesToUse);
+      getSlicedConvOperand(builder, output, linalgOp, localIvs, valuesToUse,
+                           /*desiredResultRank=*/2);
   if (failed(slicedOutput))
     return failure();
   slicedOperands.push_back(*slicedOutput);
@@ -222,22 +150,38 @@ static bool checkMappingToMatmul(linalg::LinalgOp linalgOp) {
   return match;
 }
 
-FailureOr<linalg::MatmulOp>
-mlir::linalgx::rewriteConvToMatmul(RewriterBase &rewriter,
-                                   linalg::LinalgOp linalgOp) {
-  if (!llvm::isa_and_nonnull<linalg::GenericOp>(linalgOp))
-    return rewriter.notifyMatchFailure(linalgOp, "require a linalg.generic");
-
-  if (failed(mlir::linalg::detail::verifyConvolutionInterface(linalgOp)))
-    return rewriter.notifyMatchFailure(linalgOp,
-                                       "operation is not a convolution");
+// Check if the four innermost loops can be mapped to a BRGEMM operation:
+// [r, p, p, r] where the outermost reduction is the batch. Check also the body
+// and make sure it is a matmul-like.
+static bool checkMappingToBrgemm(linalg::LinalgOp linalgOp) {
+  if (!linalgx::utils::hasMulAddBody(linalgOp))
+    return false;
+  SmallVector<utils::IteratorType> iteratorTypes =
+      linalgOp.getIteratorTypesArray();
+  if (iteratorTypes.size() < 4)
+    return false;
+  size_t size = iteratorTypes.size() - 1;
+  bool match = linalg::isReductionIterator(iteratorTypes[size]) &&
+               linalg::isParallelIterator(iteratorTypes[size - 1]) &&
+               linalg::isParallelIterator(iteratorTypes[size - 2]) &&
+               linalg::isReductionIterator(iteratorTypes[size - 3]);
+  return match;
+}
 
-  if (!checkMappingToMatmul(linalgOp))
-    return rewriter.notifyMatchFailure(
-        linalgOp, "cannot match operation iterators with matmul iterators");
+// Materialize all the loops but the `numContractionLoops` innermost ones and
+// replace the convolution with `OpTy` operating on slices of the image, the
+// filter and the output.
+template <typename OpTy>
+static FailureOr<OpTy> rewriteConvToContraction(RewriterBase &rewriter,
+                                                linalg::LinalgOp linalgOp,
+                                                unsigned numContractionLoops) {
+  static_assert(llvm::is_one_of<OpTy, linalg::MatmulOp,
+                                linalg::BatchReduceMatmulOp>::value,
+                "applies to only matmul or batch reduce matmul operations");
+  unsigned inputResultRank = numContractionLoops - 1;
 
-  // peel-out all loops but the three innermost.
-  unsigned upTo = linalgOp.getNumLoops() - /*GEMM loops=*/3;
+  // peel-out all loops but the contraction ones.
+  unsigned upTo = linalgOp.getNumLoops() - numContractionLoops;
   FailureOr<SmallVector<Range>> maybeLoopRanges =
       linalgx::utils::getLoopsToMaterialize(rewriter, linalgOp, upTo);
   if (failed(maybeLoopRanges))
@@ -245,15 +189,16 @@ mlir::linalgx::rewriteConvToMatmul(RewriterBase &rewriter,
   SmallVector<Range> loopRanges = *maybeLoopRanges;
 
   SmallVector<Value> ivs, tensorResults;
-  linalg::MatmulOp matmul = nullptr;
-  auto gemmBuilder = [&](OpBuilder &builder, Location loc, ValueRange localIvs,
-                         ValueRange operandsValuesToUse) -> scf::ValueVector {
+  OpTy contraction = nullptr;
+  auto contractionBuilder =
+      [&](OpBuilder &builder, Location loc, ValueRange localIvs,
+          ValueRange operandsValuesToUse) -> scf::ValueVector {
     assert(operandsValuesToUse.size() ==
                static_cast<size_t>(linalgOp->getNumOperands()) &&
            "expect the number of operands and inputs and outputs to match");
     ivs.assign(localIvs.begin(), localIvs.end());
-    FailureOr<SmallVector<Value>> maybeSlicedOperands =
-        getSlicedConvOperands(builder, localIvs, linalgOp, operandsValuesToUse);
+    FailureOr<SmallVector<Value>> maybeSlicedOperands = getSlicedConvOperands(
+        builder, localIvs, linalgOp, operandsValuesToUse, inputResultRank);
     if (failed(maybeSlicedOperands)) {
       assert(0 && "failed to generate loops for op");
       return {};
@@ -261,16 +206,14 @@ mlir::linalgx::rewriteConvToMatmul(RewriterBase &rewriter,
     SmallVector<Value> slicedOperands = *maybeSlicedOperands;
     assert(slicedOperands.size() == 3 && "expect three operands");
 
-    matmul = (linalgOp.hasTensorSemantics())
-                 ? builder.create<linalg::MatmulOp>(
-                       loc, slicedOperands[2].getType(),
-                       ValueRange{slicedOperands[0], slicedOperands[1]},
-                       slicedOperands[2])
-                 : builder.create<linalg::MatmulOp>(
-                       loc, ValueRange{slicedOperands[0], slicedOperands[1]},
-                       slicedOperands[2]);
+    SmallVector<Value> inputs = {slicedOperands[0], slicedOperands[1]};
+    contraction =
+        (linalgOp.hasTensorSemantics())
+            ? builder.create<OpTy>(loc, slicedOperands[2].getType(), inputs,
+                                   slicedOperands[2])
+            : builder.create<OpTy>(loc, inputs, slicedOperands[2]);
     tensorResults = insertSlicesBack(builder, loc, linalgOp, slicedOperands,
-                                     matmul->getResults());
+                                     contraction->getResults());
 
     return scf::ValueVector(tensorResults.begin(), tensorResults.end());
   };
@@ -279,11 +222,11 @@ mlir::linalgx::rewriteConvToMatmul(RewriterBase &rewriter,
   if (linalgOp.hasBufferSemantics()) {
     linalg::GenerateLoopNest<scf::ParallelOp>::doit(
         rewriter, loc, loopRanges, linalgOp, linalgOp.getIteratorTypesArray(),
-        gemmBuilder);
+        contractionBuilder);
   } else {
     linalg::GenerateLoopNest<scf::ForOp>::doit(
         rewriter, loc, loopRanges, linalgOp, linalgOp.getIteratorTypesArray(),
-        gemmBuilder);
+        contractionBuilder);
   }
 
   // see: `Tiling.cpp` in Linalg/Transforms
@@ -307,6 +250,256 @@ mlir::linalgx::rewriteConvToMatmul(RewriterBase &rewriter,
 
   rewriter.replaceOp(linalgOp, outermostLoop ? outermostLoop->getResults()
                                              : tensorResults);
-  assert(matmul && "invalid return");
-  return matmul;
+  assert(contraction && "invalid return");
+  return contraction;
+}
+
+FailureOr<linalg::MatmulOp>
+mlir::linalgx::rewriteConvToMatmul(RewriterBase &rewriter,
+                                   linalg::LinalgOp linalgOp) {
+  if (!llvm::isa_and_nonnull<linalg::GenericOp>(linalgOp))
+    return rewriter.notifyMatchFailure(linalgOp, "require a linalg.generic");
+
+  if (failed(mlir::linalg::detail::verifyConvolutionInterface(linalgOp)))
+    return rewriter.notifyMatchFailure(linalgOp,
+                                       "operation is not a convolution");
+
+  if (!checkMappingToMatmul(linalgOp))
+    return rewriter.notifyMatchFailure(
+        linalgOp, "cannot match operation iterators with matmul iterators");
+
+  return rewriteConvToContraction<linalg::MatmulOp>(rewriter, linalgOp,
+                                                    /*GEMM loops=*/3);
+}
+
+FailureOr<linalg::BatchReduceMatmulOp>
+mlir::linalgx::rewriteConvToBRGemmOp(RewriterBase &rewriter,
+                                     linalg::LinalgOp linalgOp) {
+  if (!llvm::isa_and_nonnull<linalg::GenericOp>(linalgOp))
+    return rewriter.notifyMatchFailure(linalgOp, "require a linalg.generic");
+
+  if (failed(mlir::linalg::detail::verifyConvolutionInterface(linalgOp)))
+    return rewriter.notifyMatchFailure(linalgOp,
+                                       "operation is not a convolution");
+
+  if (!checkMappingToBrgemm(linalgOp))
+    return rewriter.notifyMatchFailure(
+        linalgOp, "cannot match operation iterators with brgemm iterators");
+
+  return rewriteConvToContraction<linalg::BatchReduceMatmulOp>(
+      rewriter, linalgOp, /*BRGEMM loops=*/4);
+}
+
+// Return the range [lo, hi) of output positions `o` for which the image
+// position `o * stride + offset` falls in [0, extent).
+static std::pair<int64_t, int64_t> getValidOutputRange(int64_t offset,
+                                                       int64_t stride,
+                                                       int64_t extent,
+                                                       int64_t numOutputs) {
+  int64_t lo = std::max<int64_t>(0, ceilDiv(-offset, stride));
+  int64_t hi = std::min<int64_t>(numOutputs,
+                                 floorDiv(extent - 1 - offset, stride) + 1);
+  return {lo, std::max(lo, hi)};
+}
+
+FailureOr<SmallVector<Value>>
+mlir::linalgx::rewritePaddedConvToBRGemmOp(RewriterBase &rewriter,
+                                           linalg::LinalgOp linalgOp) {
+  if (!llvm::isa_and_nonnull<linalg::GenericOp>(linalgOp))
+    return rewriter.notifyMatchFailure(linalgOp, "require a linalg.generic");
+
+  if (!linalgOp.hasTensorSemantics())
+    return rewriter.notifyMatchFailure(linalgOp, "require tensor semantics");
+
+  if (failed(mlir::linalg::detail::verifyConvolutionInterface(linalgOp)))
+    return rewriter.notifyMatchFailure(linalgOp,
+                                       "operation is not a convolution");
+
+  if (linalgOp.getNumLoops() != 9 || !checkMappingToBrgemm(linalgOp))
+    return rewriter.notifyMatchFailure(
+        linalgOp, "cannot match operation iterators with brgemm iterators");
+
+  OpOperand *image = linalgOp.getDpsInputOperands()[0];
+  OpOperand *filter = linalgOp.getDpsInputOperands()[1];
+  OpOperand *output = linalgOp.getDpsInitOperands()[0];
+  auto padOp = image->get().getDefiningOp<tensor::PadOp>();
+  if (!padOp || !linalgx::utils::isZeroPaddingOnDims(padOp, {2, 3}))
+    return rewriter.notifyMatchFailure(linalgOp,
+                                       "expect a zero-padded image on H and W");
+
+  // Expect the blocked convolution interchanged as [N K' P R S C' Q k c]:
+  // output[N][K'][P][Q][k] +=
+  //   image[N][C'][P * sh + R * dh][Q * sw + S * dw][c] *
+  //   filter[K'][C'][R][S][c][k]
+  MLIRContext *ctx = linalgOp.getContext();
+  unsigned numLoops = linalgOp.getNumLoops();
+  AffineExpr n, tileK, p, r, s, tileC, q, k, c;
+  bindDims(ctx, n, tileK, p, r, s, tileC, q, k, c);
+  AffineMap imageMap = linalgOp.getMatchingIndexingMap(image);
+  if (imageMap.getNumResults() != 5)
+    return rewriter.notifyMatchFailure(linalgOp, "expect a blocked image");
+  std::optional<int64_t> sh =
+      getDimCoefficient(imageMap.getResult(2), /*P=*/2, numLoops);
+  std::optional<int64_t> dh =
+      getDimCoefficient(imageMap.getResult(2), /*R=*/3, numLoops);
+  std::optional<int64_t> sw =
+      getDimCoefficient(imageMap.getResult(3), /*Q=*/6, numLoops);
+  std::optional<int64_t> dw =
+      getDimCoefficient(imageMap.getResult(3), /*S=*/4, numLoops);
+  if (!sh || !dh || !sw || !dw || *sh <= 0 || *sw <= 0)
+    return rewriter.notifyMatchFailure(linalgOp, "expect constant strides");
+  using MapList = ArrayRef<ArrayRef<AffineExpr>>;
+  auto infer = [](MapList m) { return AffineMap::inferFromExprList(m); };
+  SmallVector<AffineMap> expectedMaps =
+      infer({{n, tileC, p * *sh + r * *dh, q * *sw + s * *dw, c},
+             {tileK, tileC, r, s, c, k},
+             {n, tileK, p, q, k}});
+  if (linalgOp.getIndexingMapsArray() != expectedMaps)
+    return rewriter.notifyMatchFailure(
+        linalgOp, "expect an interchanged blocked convolution");
+
+  SmallVector<int64_t> loopRanges = linalgOp.getStaticLoopRanges();
+  if (llvm::any_of(loopRanges, ShapedType::isDynamic))
+    return rewriter.notifyMatchFailure(linalgOp, "require static shape");
+  int64_t sizeN = loopRanges[0], sizeTileK = loopRanges[1],
+          sizeP = loopRanges[2], sizeR = loopRanges[3], sizeS = loopRanges[4],
+          sizeTileC = loopRanges[5], sizeQ = loopRanges[6],
+          sizeK = loopRanges[7], sizeC = loopRanges[8];
+
+  Value source = padOp.getSource();
+  ArrayRef<int64_t> sourceShape = padOp.getSourceType().getShape();
+  int64_t sizeH = sourceShape[2], sizeW = sourceShape[3];
+  int64_t lowH = padOp.getStaticLow()[2], lowW = padOp.getStaticLow()[3];
+  Type elementType = padOp.getSourceType().getElementType();
+
+  Location loc = linalgOp.getLoc();
+  auto zeroIdx = rewriter.create<arith::ConstantIndexOp>(loc, 0);
+  auto oneIdx = rewriter.create<arith::ConstantIndexOp>(loc, 1);
+  SmallVector<Value> lbs(3, zeroIdx), steps(3, oneIdx);
+  SmallVector<Value> ubs = {
+      rewriter.create<arith::ConstantIndexOp>(loc, sizeN),
+      rewriter.create<arith::ConstantIndexOp>(loc, sizeTileK),
+      rewriter.create<arith::ConstantIndexOp>(loc, sizeP)};
+
+  OpFoldResult zeroAttr = rewriter.getIndexAttr(0);
+  OpFoldResult oneAttr = rewriter.getIndexAttr(1);
+  auto getAttrs = [&](ArrayRef<int64_t> values) {
+    return llvm::to_vector(llvm::map_range(values, [&](int64_t value) {
+      return OpFoldResult(rewriter.getIndexAttr(value));
+    }));
+  };
+
+  // Materialize N, K' and P. For each row P we accumulate the filter taps
+  // (R, S) that read at least one pixel of the unpadded image. The padding
+  // contributes zero, so the taps reading only padding are skipped: boundary
+  // rows run fewer BRGEMMs and boundary columns use a smaller M.
+  scf::LoopNest loopNest = scf::buildLoopNest(
+      rewriter, loc, lbs, ubs, steps, ValueRange{output->get()},
+      [&](OpBuilder &b, Location loc, ValueRange ivs,
+          ValueRange iterArgs) -> scf::ValueVector {
+        Value ivN = ivs[0], ivTileK = ivs[1], ivP = ivs[2];
+        SmallVector<OpFoldResult> rowOffsets = {ivN, ivTileK, ivP, zeroAttr,
+                                                zeroAttr};
+        SmallVector<OpFoldResult> rowSizes =
+            getAttrs({1, 1, 1, sizeQ, sizeK});
+        SmallVector<OpFoldResult> unitStrides(5, oneAttr);
+        Value outRow = b.create<tensor::ExtractSliceOp>(
+            loc, RankedTensorType::get({sizeQ, sizeK}, elementType),
+            iterArgs[0], rowOffsets, rowSizes, unitStrides);
+
+        for (int64_t tapR = 0; tapR < sizeR; tapR++) {
+          for (int64_t tapS = 0; tapS < sizeS; tapS++) {
+            int64_t pLo, pHi, qLo, qHi;
+            std::tie(pLo, pHi) =
+                getValidOutputRange(tapR * *dh - lowH, *sh, sizeH, sizeP);
+            std::tie(qLo, qHi) =
+                getValidOutputRange(tapS * *dw - lowW, *sw, sizeW, sizeQ);
+            // The tap reads only padding.
+            if (pLo >= pHi || qLo >= qHi)
+              continue;
+            int64_t sizeM = qHi - qLo;
+
+            auto buildTap = [&](OpBuilder &b, Location loc,
+                                Value acc) -> Value {
+              AffineExpr d0;
+              bindDims(ctx, d0);
+              OpFoldResult h = affine::makeComposedFoldedAffineApply(
+                  b, loc, AffineMap::get(1, 0, d0 * *sh + tapR * *dh - lowH),
+                  {OpFoldResult(ivP)});
+              int64_t w = qLo * *sw + tapS * *dw - lowW;
+              Value imageSlice = b.create<tensor::ExtractSliceOp>(
+                  loc,
+                  RankedTensorType::get({sizeTileC, sizeM, sizeC},
+                                        elementType),
+                  source,
+                  SmallVector<OpFoldResult>{ivN, zeroAttr, h,
+                                            b.getIndexAttr(w), zeroAttr},
+                  getAttrs({1, sizeTileC, 1, sizeM, sizeC}),
+                  getAttrs({1, 1, 1, *sw, 1}));
+              Value filterSlice = b.create<tensor::ExtractSliceOp>(
+                  loc,
+                  RankedTensorType::get({sizeTileC, sizeC, sizeK},
+                                        elementType),
+                  filter->get(),
+                  SmallVector<OpFoldResult>{ivTileK, zeroAttr,
+                                            b.getIndexAttr(tapR),
+                                            b.getIndexAttr(tapS), zeroAttr,
+                                            zeroAttr},
+                  getAttrs({1, sizeTileC, 1, 1, sizeC, sizeK}),
+                  SmallVector<OpFoldResult>(6, oneAttr));
+              if (sizeM == sizeQ) {
+                return b
+                    .create<linalg::BatchReduceMatmulOp>(
+                        loc, acc.getType(),
+                        ValueRange{imageSlice, filterSlice}, acc)
+                    .getResult(0);
+              }
+              SmallVector<OpFoldResult> tileOffsets = {b.getIndexAttr(qLo),
+                                                       zeroAttr};
+              SmallVector<OpFoldResult> tileSizes = getAttrs({sizeM, sizeK});
+              SmallVector<OpFoldResult> tileStrides(2, oneAttr);
+              Value accTile = b.create<tensor::ExtractSliceOp>(
+                  loc, acc, tileOffsets, tileSizes, tileStrides);
+              Value brgemm = b.create<linalg::BatchReduceMatmulOp>(
+                                  loc, accTile.getType(),
+                                  ValueRange{imageSlice, filterSlice}, accTile)
+                                 .getResult(0);
+              return b.create<tensor::InsertSliceOp>(loc, brgemm, acc,
+                                                     tileOffsets, tileSizes,
+                                                     tileStrides);
+            };
+
+            if (pLo == 0 && pHi == sizeP) {
+              outRow = buildTap(b, loc, outRow);
+              continue;
+            }
+            // Only rows in [pLo, pHi) see this tap.
+            Value lo = b.create<arith::ConstantIndexOp>(loc, pLo);
+            Value hi = b.create<arith::ConstantIndexOp>(loc, pHi);
+            Value cond = b.create<arith::AndIOp>(
+                loc,
+                b.create<arith::CmpIOp>(loc, arith::CmpIPredicate::sge, ivP,
+                                        lo),
+                b.create<arith::CmpIOp>(loc, arith::CmpIPredicate::slt, ivP,
+                                        hi));
+            Value acc = outRow;
+            auto ifOp = b.create<scf::IfOp>(
+                loc, cond,
+                [&](OpBuilder &b, Location loc) {
+                  b.create<scf::YieldOp>(loc, buildTap(b, loc, acc));
+                },
+                [&](OpBuilder &b, Location loc) {
+                  b.create<scf::YieldOp>(loc, acc);
+                });
+            outRow = ifOp.getResult(0);
+          }
+        }
+        Value result = b.create<tensor::InsertSliceOp>(
+            loc, outRow, iterArgs[0], rowOffsets, rowSizes, unitStrides);
+        return {result};
+      });
+
+  rewriter.replaceOp(linalgOp, loopNest.results);
+  return SmallVector<Value>(loopNest.results.begin(),
+                            loopNest.results.end());
 }
@@ -33,32 +33,6 @@ static bool hasStaticShape(Value image, Value filter, Value output) {
            (!outputType.hasStaticShape()));
 }
 
-// return true if the conv has stride != 1.
-template <typename CONVOP> static bool hasStride(CONVOP convOp) {
-  if (DenseIntElementsAttr strides = convOp.getStrides()) {
-    auto values = strides.getValues<APInt>();
-    if (llvm::any_of(values, [](const APInt &value) {
-          return value.getSExtValue() != 1;
-        })) {
-      return true;
-    }
-  }
-  return false;
-}
-
-// return true if the conv has dilation != 1.
-template <typename CONVOP> static bool hasDilation(CONVOP convOp) {
-  if (DenseIntElementsAttr dilations = convOp.getDilations()) {
-    auto values = dilations.getValues<APInt>();
-    if (llvm::any_of(values, [](const APInt &value) {
-          return value.getSExtValue() != 1;
-        })) {
-      return true;
-    }
-  }
-  return false;
-}
-
 // Check dimension at index 'i' and 'j'. If both are '1' return true
 // otherwise false. The operand is expected to have static shape.
 static bool hasFilterWithRandSEqualOne(OpOperand *filter, unsigned i,
@@ -72,6 +46,30 @@ static bool hasFilterWithRandSEqualOne(OpOperand *filter, unsigned i,
   return ((filterShape[i] == 1) && (filterShape[j] == 1));
 }
 
+// Return true if H and W on the image match P and Q on the output. With R = S
+// = 1 this is the case only for unit strides.
+static bool hasImageMatchingOutput(OpOperand *image, OpOperand *output) {
+  ShapedType imageType = image->get().getType().cast<ShapedType>();
+  ShapedType outputType = output->get().getType().cast<ShapedType>();
+  if (!imageType.hasStaticShape() || !outputType.hasStaticShape())
+    return false;
+  ArrayRef<int64_t> imageShape = imageType.getShape();
+  ArrayRef<int64_t> outputShape = outputType.getShape();
+  return imageShape[2] == outputShape[2] && imageShape[3] == outputShape[3];
+}
+
+// Return true if the blocked convolution can be collapsed and mapped to a
+// single BRGEMM over C' (see `CollapseFilterAndImage`).
+static bool isCollapsibleBlockedConv(linalg::GenericOp linalgOp) {
+  if (!tpp::utils::isMarkedWithTpp(linalgOp, "tpp.BlockedConv2DNchwFchwOp"))
+    return false;
+  OpOperand *image = linalgOp.getDpsInputOperands()[0];
+  OpOperand *filter = linalgOp.getDpsInputOperands()[1];
+  OpOperand *output = linalgOp.getDpsInitOperands()[0];
+  return hasFilterWithRandSEqualOne(filter, /*Rpos=*/2, /*Spos=*/3) &&
+         hasImageMatchingOutput(image, output);
+}
+
 struct RewriteConv2DNhwcHwcfToMatmul : OpRewritePattern<linalg::GenericOp> {
   using OpRewritePattern::OpRewritePattern;
 
@@ -159,10 +157,6 @@ struct GeneralizeConv2DNhwcHwcf : OpRewritePattern<linalg::Conv2DNhwcHwcfOp> {
 
   LogicalResult matchAndRewrite(linalg::Conv2DNhwcHwcfOp convOp,
                                 PatternRewriter &rewriter) const override {
-    // Do not handle convolutions with dilation.
-    if (hasDilation<linalg::Conv2DNhwcHwcfOp>(convOp))
-      return failure();
-
     // [N][H][W][C]
     Value image = convOp.image();
     // [R][S][C][K]
@@ -193,11 +187,6 @@ struct BlockConv2DNchwFchw : OpRewritePattern<linalg::Conv2DNchwFchwOp> {
 
   LogicalResult
   blockConv2DNchwFchwPreconditions(linalg::Conv2DNchwFchwOp convOp) const {
-    // do not handle convolutions with dilation and strides.
-    if (hasStride<linalg::Conv2DNchwFchwOp>(convOp) ||
-        hasDilation<linalg::Conv2DNchwFchwOp>(convOp))
-      return failure();
-
     // [N][C][H][W]
     Value image = convOp.image();
     // [K][C][R][S]
@@ -328,18 +317,13 @@ struct RewriteConv2DNchwFchwToMatmul : OpRewritePattern<linalg::GenericOp> {
   }
 };
 
-// Prepare for BRGEMM. Requires R = S = 1. The pattern collapses
-// H and W on the image and P and Q on the output.
+// Prepare for BRGEMM. Requires R = S = 1 and unit strides. The pattern
+// collapses H and W on the image and P and Q on the output.
 struct CollapseFilterAndImage : OpRewritePattern<linalg::GenericOp> {
   using OpRewritePattern::OpRewritePattern;
 
   LogicalResult collapseFilterPreconditions(linalg::GenericOp linalgOp) const {
-    if (!tpp::utils::isMarkedWithTpp(linalgOp, "tpp.BlockedConv2DNchwFchwOp"))
-      return failure();
-    OpOperand *filter = linalgOp.getDpsInputOperands()[1];
-    if (!hasFilterWithRandSEqualOne(filter, /*Rpos=*/2, /*Spos=*/3))
-      return failure();
-    return success();
+    return success(isCollapsibleBlockedConv(linalgOp));
   }
 
   SmallVector<ReassociationExprs, 2>
@@ -544,11 +528,77 @@ struct InterchangeAfterBlockingAndCollapsing
   }
 };
 
+// Interchange a blocked convolution that cannot be collapsed (R and S not 1,
+// strides or dilations) to expose a BRGEMM over C'.
+struct InterchangeIteratorsForBrgemm : OpRewritePattern<linalg::GenericOp> {
+  using OpRewritePattern::OpRewritePattern;
+
+  LogicalResult matchAndRewrite(linalg::GenericOp linalgOp,
+                                PatternRewriter &rewriter) const override {
+    if (!linalgx::utils::isBlockedConvolution(linalgOp) ||
+        isCollapsibleBlockedConv(linalgOp))
+      return failure();
+
+    // clang-format off
+    // N                [parallel]
+    //  K'              [parallel]
+    //   P              [parallel]
+    //    Q             [parallel]
+    //     k            [parallel]
+    //      C'          [reduction]
+    //       R          [reduction]
+    //        S         [reduction]
+    //         c        [reduction]
+    //          output[N][K'][P][Q][k] += image[N][C'][P * sh + R * dh][Q * sw + S * dw][c] * filter[K'][C'][R][S][c][k]
+
+    // expose BRGEMM by interchange:
+
+    // N                [parallel]
+    //  K'              [parallel]
+    //   P              [parallel]
+    //    R             [reduction]
+    //     S            [reduction]
+    //      C'          [reduction] // BRGEMM red dimension
+    //      /* GEMM */
+    //       Q          [parallel]
+    //        k         [parallel]
+    //         c        [reduction]
+    //
+    // For a given (P, R, S) the rows of the image are Q * sw + S * dw, which
+    // is a strided view on W with stride sw. The batch over C' has a constant
+    // stride H * W * c.
+    // clang-format on
+
+    SmallVector<unsigned> interchangeVector = {0, 1, 2, 6, 7, 5, 3, 4, 8};
+    FailureOr<linalg::GenericOp> maybeInterchange =
+        interchangeGenericOp(rewriter, linalgOp, interchangeVector);
+    if (failed(maybeInterchange))
+      return failure();
+    StringAttr name =
+        rewriter.getStringAttr("tpp.BlockedAndInterConv2DNchwFchwOp");
+    (*maybeInterchange).setLibraryCallAttr(name);
+    return success();
+  }
+};
+
 struct MapToBRGEMM : OpRewritePattern<linalg::GenericOp> {
   using OpRewritePattern::OpRewritePattern;
 
   LogicalResult matchAndRewrite(linalg::GenericOp linalgOp,
                                 PatternRewriter &rewriter) const override {
+    if (tpp::utils::isMarkedWithTpp(linalgOp,
+                                    "tpp.BlockedAndInterConv2DNchwFchwOp")) {
+      // Zero padding on the image is fused into the BRGEMM boundaries, the
+      // padded image is never read.
+      if (succeeded(
+              mlir::linalgx::rewritePaddedConvToBRGemmOp(rewriter, linalgOp)))
+        return success();
+      FailureOr<linalg::BatchReduceMatmulOp> brgemm =
+          mlir::linalgx::rewriteConvToBRGemmOp(rewriter, linalgOp);
+      if (failed(brgemm))
+        return failure();
+      return success();
+    }
     if (!tpp::utils::isMarkedWithTpp(
             linalgOp, "tpp.BlockedCollapsedAndInterConv2DNchwFchwOp"))
       return failure();
@@ -579,6 +629,10 @@ void populateRewriteBlockedConvPatterns(RewritePatternSet &patterns,
   // [*][* ][P * Q][k] = [*][* ][H * W][c] * [* ][* ][c][k] // GEMM with c as red.
   // [*][* ][P * Q][k] = [*][C'][H * W][c] * [* ][C'][c][k] // BRGEMM with C' as red.
   //
+  // otherwise (R, S != 1, strides or dilations) -> loops over P, R and S
+  //
+  // [*][* ][*][Q][k] = [*][C'][*][Q * sw][c] * [* ][C'][*][*][c][k] // BRGEMM with C' as red.
+  //
   // clang-format on
 
   // Rewrite to GEMM.
@@ -589,7 +643,8 @@ void populateRewriteBlockedConvPatterns(RewritePatternSet &patterns,
   // Rewrite to BRGEMM.
   else {
     patterns.insert<CollapseFilterAndImage,
-                    InterchangeAfterBlockingAndCollapsing, MapToBRGEMM>(
+                    InterchangeAfterBlockingAndCollapsing,
+                    InterchangeIteratorsForBrgemm, MapToBRGEMM>(
         patterns.getContext());
   }
 }
@@ -612,6 +667,6 @@ struct RewriteConvToMatmulOrBrgemm
 } // end namespace
 
 std::unique_ptr<OperationPass<func::FuncOp>>
-mlir::tpp::createRewriteConvToMatmulOrBrgemmPass() {
-  return std::make_unique<RewriteConvToMatmulOrBrgemm>();
+mlir::tpp::createRewriteConvToMatmulOrBrgemmPass(bool enableBrgemm) {
+  return std::make_unique<RewriteConvToMatmulOrBrgemm>(enableBrgemm);
 }
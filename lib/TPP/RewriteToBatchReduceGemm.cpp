@@ -130,8 +130,10 @@ static LogicalResult checkVNNIAccessPatterns(linalg::LinalgOp linalgOp) {
 // Check the access pattern that must match the one expected for BRGEMM.
 // We extract the 3 innermost dimensions for the input and the 2 innermost
 // dimensions for the output. We then check that they equal:
-// [p3, p4] += [r1, p3, r2] * [r1, r2, p4].
-static LogicalResult checkAccessPatterns(linalg::LinalgOp linalgOp) {
+// [p3, p4] += [r1, p3, r2] * [r1, r2, p4], or with `transposeB`:
+// [p3, p4] += [r1, p3, r2] * [r1, p4, r2].
+static LogicalResult checkAccessPatterns(linalg::LinalgOp linalgOp,
+                                         bool transposeB = false) {
   SmallVector<AffineMap> maps;
   for (OpOperand &operand : linalgOp->getOpOperands()) {
     AffineMap map = linalgOp.getMatchingIndexingMap(&operand);
@@ -153,7 +155,10 @@ static LogicalResult checkAccessPatterns(linalg::LinalgOp linalgOp) {
   SmallVector<AffineMap> expectedMaps;
 
   bindDims(linalgOp.getContext(), r1, p3, p4, r2);
-  expectedMaps = infer({{r1, p3, r2}, {r1, r2, p4}, {p3, p4}});
+  if (transposeB)
+    expectedMaps = infer({{r1, p3, r2}, {r1, p4, r2}, {p3, p4}});
+  else
+    expectedMaps = infer({{r1, p3, r2}, {r1, r2, p4}, {p3, p4}});
 
   if (compressedDimMaps != expectedMaps)
     return failure();
@@ -232,7 +237,9 @@ static Operation *getOuterMostLoop(ArrayRef<Value> ivs) {
 // operation.
 // 2. The innermost dimensions for the generic must be [r, p, p, r]. r =
 // reduction p = parallel. Outermost dimensions must be parallel.
-// 3. Access pattern must be [p3, p4] += [r1, p3, r2] * [r1, r2, p4].
+// 3. Access pattern must be [p3, p4] += [r1, p3, r2] * [r1, r2, p4]. With B
+// blocks read transposed, [p3, p4] += [r1, p3, r2] * [r1, p4, r2], the
+// generic maps to a tpp.brgemm reading B in place.
 FailureOr<SmallVector<Value>>
 mlir::linalgx::rewriteToBRGemmOp(RewriterBase &rewriter,
                                  linalg::LinalgOp linalgOp) {
@@ -248,9 +255,13 @@ mlir::linalgx::rewriteToBRGemmOp(RewriterBase &rewriter,
         linalgOp, "failed to match structurally with BRGEMM");
   }
 
+  bool transposeB = false;
   if (failed(checkAccessPatterns(linalgOp))) {
-    return rewriter.notifyMatchFailure(
-        linalgOp, "failed to match BRGEMM access patterns");
+    if (failed(checkAccessPatterns(linalgOp, /*transposeB=*/true))) {
+      return rewriter.notifyMatchFailure(
+          linalgOp, "failed to match BRGEMM access patterns");
+    }
+    transposeB = true;
   }
 
   // Materialize outer loops.
@@ -280,15 +291,28 @@ mlir::linalgx::rewriteToBRGemmOp(RewriterBase &rewriter,
     SmallVector<Value> slicedOperands = *maybeSlicedOperands;
     assert(slicedOperands.size() == 3 && "expect three operands");
 
-    linalg::BatchReduceMatmulOp brgemm =
-        (linalgOp.hasTensorSemantics())
-            ? builder.create<linalg::BatchReduceMatmulOp>(
-                  loc, slicedOperands[2].getType(),
-                  ValueRange{slicedOperands[0], slicedOperands[1]},
-                  slicedOperands[2])
-            : builder.create<linalg::BatchReduceMatmulOp>(
-                  loc, ValueRange{slicedOperands[0], slicedOperands[1]},
-                  slicedOperands[2]);
+    // Linalg has no batch-reduce matmul reading B transposed, map directly to
+    // tpp.
+    Operation *brgemm = nullptr;
+    if (transposeB) {
+      ValueRange inputs = slicedOperands;
+      brgemm = (linalgOp.hasTensorSemantics())
+                   ? builder.create<tpp::BrgemmOp>(
+                         loc, inputs, slicedOperands[2].getType(),
+                         /*transposeB=*/true)
+                   : builder.create<tpp::BrgemmOp>(loc, inputs,
+                                                   slicedOperands[2],
+                                                   /*transposeB=*/true);
+    } else {
+      brgemm = (linalgOp.hasTensorSemantics())
+                   ? builder.create<linalg::BatchReduceMatmulOp>(
+                         loc, slicedOperands[2].getType(),
+                         ValueRange{slicedOperands[0], slicedOperands[1]},
+                         slicedOperands[2])
+                   : builder.create<linalg::BatchReduceMatmulOp>(
+                         loc, ValueRange{slicedOperands[0], slicedOperands[1]},
+                         slicedOperands[2]);
+    }
     tensorResults =
         (loopRanges.empty())
             ? brgemm->getResults()
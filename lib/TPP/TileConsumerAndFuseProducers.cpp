@@ -6,6 +6,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include "TPP/BlockingFactors.h"
 #include "TPP/Passes.h"
 #include "TPP/TransformUtils.h"
 #include "TPP/Transforms.h"
@@ -21,6 +22,8 @@
 #include "mlir/Transforms/GreedyPatternRewriteDriver.h"
 #include "llvm/ADT/TypeSwitch.h"
 #include "llvm/Support/Debug.h"
+#include "llvm/Support/FormatVariadic.h"
+#include <cmath>
 #include <queue>
 
 using namespace mlir;
@@ -499,6 +502,94 @@ static SmallVector<int64_t> getDefaultTileSizes(linalg::LinalgOp linalgOp) {
   return {32, 32};
 }
 
+// Smallest tile on the i and j dimensions of an unpacked matmul: below, the
+// micro-kernel is mostly overhead.
+static constexpr int64_t kMinMatmulTile = 16;
+
+// Select the tile sizes of the outer parallel loops of `rootOp`, the fusion
+// root anchored at `linalgOp`, to balance the work items of the scf.forall
+// across `numThreads`. The forall is collapsed into a single parallel loop,
+// thus the work items are the product of the tile counts. Candidates give full
+// tiles and are multiples of the smallest tile accepted by the mapping to
+// BRGEMM (one block for packed ops). On ties, keep the candidate closest to
+// the default tiles. Report the predicted load imbalance as a remark.
+static SmallVector<int64_t> getThreadAwareTileSizes(linalg::LinalgOp linalgOp,
+                                                    Operation *rootOp,
+                                                    int64_t numThreads) {
+  SmallVector<int64_t> defaultTiles = getDefaultTileSizes(linalgOp);
+  auto rootLinalgOp = dyn_cast<linalg::LinalgOp>(rootOp);
+  if (!rootLinalgOp)
+    return defaultTiles;
+  SmallVector<int64_t> loopRanges = rootLinalgOp.getStaticLoopRanges();
+  if (loopRanges.size() < defaultTiles.size())
+    return defaultTiles;
+
+  int64_t granule = isa<linalg::MatmulOp>(linalgOp) ? kMinMatmulTile : 1;
+  SmallVector<SmallVector<int64_t>> dimCandidates;
+  for (int64_t range : ArrayRef<int64_t>(loopRanges).take_front(
+           defaultTiles.size())) {
+    if (ShapedType::isDynamic(range))
+      return defaultTiles;
+    SmallVector<int64_t> candidates;
+    for (int64_t tile = granule; tile <= range; tile += granule)
+      if (range % tile == 0)
+        candidates.push_back(tile);
+    if (candidates.empty())
+      return defaultTiles;
+    dimCandidates.push_back(std::move(candidates));
+  }
+
+  // Distance in powers of two from the default tiles.
+  auto getDistance = [&](ArrayRef<int64_t> tiles) {
+    double distance = 0.0;
+    for (auto [tile, defaultTile] : llvm::zip_equal(tiles, defaultTiles))
+      distance += std::abs(std::log2(static_cast<double>(tile) /
+                                     static_cast<double>(defaultTile)));
+    return distance;
+  };
+  auto getWorkItems = [&](ArrayRef<int64_t> tiles) {
+    int64_t workItems = 1;
+    for (auto [tile, range] : llvm::zip(tiles, loopRanges))
+      workItems *= range / tile;
+    return workItems;
+  };
+
+  // Enumerate the cartesian product of the per-dimension candidates.
+  SmallVector<int64_t> bestTiles;
+  double bestBalance = 0.0;
+  double bestDistance = 0.0;
+  SmallVector<size_t> indices(dimCandidates.size(), 0);
+  SmallVector<int64_t> tiles(dimCandidates.size());
+  while (true) {
+    for (size_t dim : llvm::seq<size_t>(0, indices.size()))
+      tiles[dim] = dimCandidates[dim][indices[dim]];
+    double balance =
+        linalgx::utils::getLoadBalance(getWorkItems(tiles), numThreads);
+    double distance = getDistance(tiles);
+    constexpr double kEpsilon = 1e-9;
+    if (bestTiles.empty() || balance > bestBalance + kEpsilon ||
+        (balance > bestBalance - kEpsilon && distance < bestDistance)) {
+      bestTiles = tiles;
+      bestBalance = balance;
+      bestDistance = distance;
+    }
+    size_t dim = 0;
+    while (dim < indices.size() &&
+           ++indices[dim] == dimCandidates[dim].size())
+      indices[dim++] = 0;
+    if (dim == indices.size())
+      break;
+  }
+
+  int64_t workItems = getWorkItems(bestTiles);
+  InFlightDiagnostic remark = linalgOp.emitRemark() << "tile sizes [";
+  llvm::interleaveComma(bestTiles, remark);
+  remark << "]: " << workItems << " work items on " << numThreads
+         << " threads, predicted load imbalance "
+         << llvm::formatv("{0:F1}", 100.0 * (1.0 - bestBalance)).str() << "%";
+  return bestTiles;
+}
+
 static Operation *
 getLastFusableConsumer(linalg::LinalgOp linalgOp,
                        llvm::SmallDenseSet<Operation *> &visitedConsumers) {
@@ -548,6 +639,10 @@ struct TileConsumerAndFuseProducers
   TileConsumerAndFuseProducers(ArrayRef<int64_t> tileSizes) {
     this->tileSizes = tileSizes;
   }
+  TileConsumerAndFuseProducers(bool threadAware, int64_t numThreads) {
+    this->threadAware = threadAware;
+    this->numThreads = numThreads;
+  }
   void getDependentDialects(DialectRegistry &registry) const override {
     registry.insert<scf::SCFDialect>();
     linalg::registerTilingInterfaceExternalModels(registry);
@@ -568,6 +663,10 @@ struct TileConsumerAndFuseProducers
     // Set to keep track of fused ops.
     llvm::SmallDenseSet<Operation *> fusedOps;
 
+    linalgx::utils::BlockingOptions threadOptions;
+    threadOptions.numThreads = this->numThreads;
+    int64_t targetThreads = linalgx::utils::getNumThreads(threadOptions);
+
     SmallVector<linalg::LinalgOp> linalgOperations;
     func->walk([&](linalg::LinalgOp linalgOp) {
       if ((isConvolutionLike(linalgOp) || isMatmulLike(linalgOp)) &&
@@ -584,9 +683,15 @@ struct TileConsumerAndFuseProducers
       if (this->startFromLastFusableConsumer)
         rootOp = getLastFusableConsumer(linalgOp, visitedConsumers);
       fusionRoots.insert(rootOp);
-      defaultTiles[rootOp] = (this->tileSizes.empty())
-                                 ? getDefaultTileSizes(linalgOp)
-                                 : llvm::to_vector(this->tileSizes);
+      if (auto tiles = linalgx::utils::getTileSizesOverride(linalgOp))
+        defaultTiles[rootOp] = *tiles;
+      else if (!this->tileSizes.empty())
+        defaultTiles[rootOp] = llvm::to_vector(this->tileSizes);
+      else if (this->threadAware)
+        defaultTiles[rootOp] =
+            getThreadAwareTileSizes(linalgOp, rootOp, targetThreads);
+      else
+        defaultTiles[rootOp] = getDefaultTileSizes(linalgOp);
     }
     LLVM_DEBUG(llvm::dbgs() << "#fusionRoots: " << fusionRoots.size() << "\n");
 
@@ -679,8 +784,10 @@ struct ElementWiseFusion : ElementWiseFusionBase<ElementWiseFusion> {
 } // end namespace
 
 std::unique_ptr<OperationPass<func::FuncOp>>
-mlir::tpp::createTileConsumerAndFuseProducersPass() {
-  return std::make_unique<TileConsumerAndFuseProducers>();
+mlir::tpp::createTileConsumerAndFuseProducersPass(bool threadAware,
+                                                  int64_t numThreads) {
+  return std::make_unique<TileConsumerAndFuseProducers>(threadAware,
+                                                        numThreads);
 }
 
 std::unique_ptr<OperationPass<func::FuncOp>>
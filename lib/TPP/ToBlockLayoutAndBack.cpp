@@ -6,12 +6,14 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include "TPP/BlockingFactors.h"
 #include "TPP/Dialect/Tpp/TppOps.h"
 #include "TPP/Dialect/Tpp/TppUtils.h"
 #include "TPP/Passes.h"
 #include "TPP/TransformUtils.h"
 #include "TPP/Transforms.h"
 #include "TPP/VNNIUtils.h"
+#include "mlir/Dialect/Arith/IR/Arith.h"
 #include "mlir/Dialect/Bufferization/IR/Bufferization.h"
 #include "mlir/Dialect/Func/IR/FuncOps.h"
 #include "mlir/Dialect/Linalg/IR/Linalg.h"
@@ -35,18 +37,27 @@ using namespace mlir;
 // Utils
 //===----------------------------------------------------------------------===//
 
-// Helper function to create the pack operation.
+// Helper function to create the pack operation. Dynamic dimensions are packed
+// with static blocks, the number of blocks is computed at runtime and the last
+// block is padded with zeros as the size may not be a multiple of the block.
 static Value toPackLayoutImpl(OpBuilder &builder, Location loc, Value input,
                               ArrayRef<OpFoldResult> tiles,
                               ArrayRef<int64_t> innerDimsPos,
                               ArrayRef<int64_t> outerDimsPerm) {
+  auto inputType = input.getType().cast<RankedTensorType>();
+  if (!inputType.hasStaticShape()) {
+    Value output = tensor::PackOp::createDestinationTensor(
+        builder, loc, input, tiles, innerDimsPos, outerDimsPerm);
+    Value zero = builder.create<arith::ConstantOp>(
+        loc, builder.getZeroAttr(inputType.getElementType()));
+    return builder.create<tensor::PackOp>(loc, input, output, innerDimsPos,
+                                          tiles, zero, outerDimsPerm);
+  }
   SmallVector<Value> dynamicTiles;
   SmallVector<int64_t> staticTiles;
   dispatchIndexOpFoldResults(tiles, dynamicTiles, staticTiles);
-  RankedTensorType result =
-      tensor::PackOp::inferPackedType(input.getType().cast<RankedTensorType>(),
-                                      staticTiles, innerDimsPos, outerDimsPerm);
-  auto inputType = input.getType().cast<RankedTensorType>();
+  RankedTensorType result = tensor::PackOp::inferPackedType(
+      inputType, staticTiles, innerDimsPos, outerDimsPerm);
   ArrayRef<int64_t> shape = result.getShape();
   Value output =
       builder.create<tensor::EmptyOp>(loc, shape, inputType.getElementType());
@@ -239,12 +250,36 @@ packConvolutions(RewriterBase &rewriter, OpTy convOp,
   SmallVector<Value> inputOperands = convOp.getDpsInputOperands();
   SmallVector<Value> outputOperands = convOp.getDpsInitOperands();
 
-  // pack the image and the filter.
+  // pack the image and the filter. Zero padding on H and W commutes with
+  // packing as only the channels are blocked: pack the unpadded image and pad
+  // the packed one. Later patterns can then read the unpadded image directly.
   Value image = inputOperands[0];
+  SmallVector<int64_t, 2> spatialDims =
+      (isConv2DNhwcHwcfOp) ? SmallVector<int64_t, 2>{1, 2}
+                           : SmallVector<int64_t, 2>{2, 3};
+  auto padOp = image.getDefiningOp<tensor::PadOp>();
+  bool packUnpaddedImage =
+      padOp && linalgx::utils::isZeroPaddingOnDims(padOp, spatialDims);
+  if (packUnpaddedImage)
+    image = padOp.getSource();
   Value packedImage =
       (isConv2DNhwcHwcfOp)
           ? toPackLayoutNPQK_NKPQk(rewriter, loc, image, tiles[0])
           : toPackLayoutNCHW_NCHWc(rewriter, loc, image, tiles[0]);
+  if (packUnpaddedImage) {
+    // [N][C'][H][W][c]
+    SmallVector<OpFoldResult> low(5, rewriter.getIndexAttr(0));
+    SmallVector<OpFoldResult> high(5, rewriter.getIndexAttr(0));
+    for (auto [packedDim, dim] : llvm::enumerate(spatialDims)) {
+      low[packedDim + 2] = rewriter.getIndexAttr(padOp.getStaticLow()[dim]);
+      high[packedDim + 2] = rewriter.getIndexAttr(padOp.getStaticHigh()[dim]);
+    }
+    Type elementType = getElementTypeOrSelf(packedImage.getType());
+    Value zero = rewriter.create<arith::ConstantOp>(
+        loc, elementType, rewriter.getZeroAttr(elementType));
+    packedImage = rewriter.create<tensor::PadOp>(
+        loc, /*resultType=*/Type(), packedImage, low, high, zero);
+  }
   Value filter = inputOperands[1];
   Value packedFilter =
       (isConv2DNhwcHwcfOp)
@@ -266,6 +301,13 @@ packConvolutions(RewriterBase &rewriter, OpTy convOp,
     strides[0] = strideValues[0];
     strides[1] = strideValues[1];
   }
+  SmallVector<int64_t, 2> dilations = {1, 1};
+  if (DenseIntElementsAttr dilationsAttr = convOp.getDilations()) {
+    auto dilationValues = dilationsAttr.getValues<int64_t>();
+    assert(dilationValues.size() == 2 && "expect two dilation values");
+    dilations[0] = dilationValues[0];
+    dilations[1] = dilationValues[1];
+  }
 
   // Swap convolution with generic.
   //         N   K   P   Q   k   C   R   S   c
@@ -275,7 +317,9 @@ packConvolutions(RewriterBase &rewriter, OpTy convOp,
       AffineMap::get(/*dims=*/9, /*symbols=*/0, {p1, p2, p3, p4, p5}, ctx);
   AffineMap mapImg = AffineMap::get(
       /*dims=*/9, /*symbols=*/0,
-      {p1, r1, p3 * strides[0] + r2, p4 * strides[1] + r3, r4}, ctx);
+      {p1, r1, p3 * strides[0] + r2 * dilations[0],
+       p4 * strides[1] + r3 * dilations[1], r4},
+      ctx);
   AffineMap mapFil =
       AffineMap::get(/*dims=*/9, /*symbols=*/0, {p2, r1, r2, r3, r4, p5}, ctx);
   linalg::GenericOp replacementOp = rewriter.create<linalg::GenericOp>(
@@ -292,6 +336,8 @@ packConvolutions(RewriterBase &rewriter, OpTy convOp,
                               replacementOp.getRegion().begin());
   if (auto metadata = convOp->getAttr("metadata"))
     replacementOp->setAttr("metadata", metadata);
+  if (auto tiles = convOp->getAttr(linalgx::utils::kTileSizesAttrName))
+    replacementOp->setAttr(linalgx::utils::kTileSizesAttrName, tiles);
 
   // convert back from pack layout.
   Value outPackedTensor = replacementOp.getResult(0);
@@ -384,12 +430,17 @@ packMatmulOpImpl(RewriterBase &rewriter, OpTy matmulOp,
       llvm::is_one_of<OpTy, linalg::MatmulOp, linalg::BatchMatmulOp>::value,
       "applies to only matmul or batch matmul operations");
 
-  if (matmulOp.hasDynamicShape())
-    return rewriter.notifyMatchFailure(matmulOp, "require static shape");
-
   if (matmulOp.hasBufferSemantics())
     return rewriter.notifyMatchFailure(matmulOp, "require tensor semantics");
 
+  // Dynamic dimensions are fine as long as the blocks are static, the number
+  // of blocks is then computed at runtime.
+  if (llvm::any_of(tiles, [](OpFoldResult tile) {
+        return !getConstantIntValue(tile);
+      })) {
+    return rewriter.notifyMatchFailure(matmulOp, "require static tiles");
+  }
+
   OpFoldResult tileOnI = tiles[0];
   OpFoldResult tileOnJ = tiles[1];
   OpFoldResult tileOnK = tiles[2];
@@ -426,6 +477,8 @@ packMatmulOpImpl(RewriterBase &rewriter, OpTy matmulOp,
       /*doc=*/"", /*libraryCall=*/"");
   rewriter.inlineRegionBefore(matmulOp.getRegion(), replacementOp.getRegion(),
                               replacementOp.getRegion().begin());
+  if (auto tiles = matmulOp->getAttr(linalgx::utils::kTileSizesAttrName))
+    replacementOp->setAttr(linalgx::utils::kTileSizesAttrName, tiles);
 
   // convert back from pack layout.
   Value outPackTensor = replacementOp.getResult(0);
@@ -458,6 +511,137 @@ mlir::linalgx::packMatmulOp(RewriterBase &rewriter, linalg::MatmulOp matmulOp,
   return packMatmulOpImpl<linalg::MatmulOp>(rewriter, matmulOp, tiles);
 }
 
+//===----------------------------------------------------------------------===//
+// MatmulOp (remainders)
+//===----------------------------------------------------------------------===//
+//  i      j        i     k      k      j
+// [100 x 72] += [100 x 40] * [40 x 72]
+//
+// tile factors on i, j and k = 32
+//
+// [96 x 64] += [96 x 32] * [32 x 64]   main part, packed and mapped to BRGEMM
+// [96 x 64] += [96 x  8] * [ 8 x 64]   remainder on k
+// [96 x  8] += [96 x 40] * [40 x  8]   remainder on j
+// [ 4 x 72] += [ 4 x 40] * [40 x 72]   remainder on i
+//
+// The remainders stay static linalg.matmul and map to smaller GEMMs. They are
+// tagged with the tile sizes to parallelize them along the dimensions they
+// still have full tiles on.
+FailureOr<linalg::MatmulOp>
+mlir::linalgx::peelMatmulOp(RewriterBase &rewriter, linalg::MatmulOp matmulOp,
+                            ArrayRef<int64_t> tiles) {
+  if (tiles.size() != 3)
+    return rewriter.notifyMatchFailure(matmulOp, "require 3 tile factors");
+  if (matmulOp.hasDynamicShape())
+    return rewriter.notifyMatchFailure(matmulOp, "require static shape");
+  if (matmulOp.hasBufferSemantics())
+    return rewriter.notifyMatchFailure(matmulOp, "require tensor semantics");
+
+  // Loop ranges are [i, j, k].
+  SmallVector<int64_t> dims = matmulOp.getStaticLoopRanges();
+  bool hasRemainder = false;
+  for (auto [dim, tile] : llvm::zip_equal(dims, tiles)) {
+    if (tile <= 0 || dim < tile)
+      return rewriter.notifyMatchFailure(matmulOp,
+                                         "expect a full tile on each dim");
+    hasRemainder |= dim % tile != 0;
+  }
+  if (!hasRemainder)
+    return rewriter.notifyMatchFailure(matmulOp, "nothing to peel");
+
+  int64_t dimI = dims[0], dimJ = dims[1], dimK = dims[2];
+  int64_t mainI = dimI - dimI % tiles[0];
+  int64_t mainJ = dimJ - dimJ % tiles[1];
+  int64_t mainK = dimK - dimK % tiles[2];
+
+  Location loc = matmulOp.getLoc();
+  MLIRContext *ctx = rewriter.getContext();
+  SmallVector<OpFoldResult> strides(2, rewriter.getIndexAttr(1));
+  auto extractSlice = [&](Value source, ArrayRef<int64_t> offsets,
+                          ArrayRef<int64_t> sizes) -> Value {
+    auto sourceType = source.getType().cast<RankedTensorType>();
+    if (llvm::all_of(offsets, [](int64_t offset) { return offset == 0; }) &&
+        sourceType.getShape() == sizes)
+      return source;
+    return rewriter.create<tensor::ExtractSliceOp>(
+        loc, source, getAsIndexOpFoldResult(ctx, offsets),
+        getAsIndexOpFoldResult(ctx, sizes), strides);
+  };
+  auto insertSlice = [&](Value source, Value dest,
+                         ArrayRef<int64_t> offsets) -> Value {
+    if (source.getType() == dest.getType())
+      return source;
+    ArrayRef<int64_t> sizes =
+        source.getType().cast<RankedTensorType>().getShape();
+    return rewriter.create<tensor::InsertSliceOp>(
+        loc, source, dest, getAsIndexOpFoldResult(ctx, offsets),
+        getAsIndexOpFoldResult(ctx, sizes), strides);
+  };
+  auto createMatmul = [&](Value lhs, Value rhs, Value acc,
+                          ArrayRef<int64_t> tileSizes) {
+    auto remainderOp = rewriter.create<linalg::MatmulOp>(
+        loc, acc.getType(), ValueRange{lhs, rhs}, ValueRange{acc});
+    if (llvm::any_of(tileSizes, [](int64_t tile) { return tile != 0; }))
+      remainderOp->setAttr(linalgx::utils::kTileSizesAttrName,
+                           rewriter.getDenseI64ArrayAttr(tileSizes));
+    return remainderOp;
+  };
+
+  Value matrixA = matmulOp.getInputs()[0];
+  Value matrixB = matmulOp.getInputs()[1];
+  Value matrixC = matmulOp.getOutputs()[0];
+
+  // Main part, keeps the per-op overrides of the original matmul.
+  Value mainC = extractSlice(matrixC, {0, 0}, {mainI, mainJ});
+  auto mainOp = rewriter.create<linalg::MatmulOp>(
+      loc, mainC.getType(),
+      ValueRange{extractSlice(matrixA, {0, 0}, {mainI, mainK}),
+                 extractSlice(matrixB, {0, 0}, {mainK, mainJ})},
+      ValueRange{mainC});
+  for (StringRef name :
+       {linalgx::utils::kBlockFactorsAttrName,
+        linalgx::utils::kTileSizesAttrName}) {
+    if (Attribute attr = matmulOp->getAttr(name))
+      mainOp->setAttr(name, attr);
+  }
+  Value mainResult = mainOp.getResult(0);
+
+  // Remainder on k, accumulates on the main part.
+  if (mainK < dimK) {
+    mainResult =
+        createMatmul(extractSlice(matrixA, {0, mainK}, {mainI, dimK - mainK}),
+                     extractSlice(matrixB, {mainK, 0}, {dimK - mainK, mainJ}),
+                     mainResult, {tiles[0], tiles[1]})
+            .getResult(0);
+  }
+  Value result = insertSlice(mainResult, matrixC, {0, 0});
+
+  // Remainder on j, for the rows of the main part.
+  if (mainJ < dimJ) {
+    Value remainder =
+        createMatmul(extractSlice(matrixA, {0, 0}, {mainI, dimK}),
+                     extractSlice(matrixB, {0, mainJ}, {dimK, dimJ - mainJ}),
+                     extractSlice(matrixC, {0, mainJ}, {mainI, dimJ - mainJ}),
+                     {tiles[0], 0})
+            .getResult(0);
+    result = insertSlice(remainder, result, {0, mainJ});
+  }
+
+  // Remainder on i, for all the columns.
+  if (mainI < dimI) {
+    Value remainder =
+        createMatmul(extractSlice(matrixA, {mainI, 0}, {dimI - mainI, dimK}),
+                     matrixB,
+                     extractSlice(matrixC, {mainI, 0}, {dimI - mainI, dimJ}),
+                     {0, mainJ == dimJ ? tiles[1] : 0})
+            .getResult(0);
+    result = insertSlice(remainder, result, {mainI, 0});
+  }
+
+  rewriter.replaceOp(matmulOp, result);
+  return mainOp;
+}
+
 //===----------------------------------------------------------------------===//
 // BatchMatmulOp
 //===----------------------------------------------------------------------===//
@@ -487,8 +671,8 @@ mlir::linalgx::packVNNIMatmulOp(RewriterBase &rewriter,
                                 linalg::GenericOp matmulOp) {
   if (matmulOp.getInputs().size() > 0) {
     auto elementType = getElementTypeOrSelf(matmulOp.getInputs()[0].getType());
-    if (!elementType.isBF16())
-      return rewriter.notifyMatchFailure(matmulOp, "require bf16 type");
+    if (!elementType.isBF16() && !elementType.isInteger(8))
+      return rewriter.notifyMatchFailure(matmulOp, "require bf16 or i8 type");
   }
 
   if (matmulOp.hasDynamicShape())
@@ -554,8 +738,8 @@ FailureOr<tpp::BrgemmOp>
 mlir::linalgx::packVNNIBRGemmOp(RewriterBase &rewriter,
                                 linalg::BatchReduceMatmulOp brgemmOp) {
   auto elementType = getElementTypeOrSelf(brgemmOp.getInputs()[0].getType());
-  if (!elementType.isBF16())
-    return rewriter.notifyMatchFailure(brgemmOp, "require bf16 type");
+  if (!elementType.isBF16() && !elementType.isInteger(8))
+    return rewriter.notifyMatchFailure(brgemmOp, "require bf16 or i8 type");
 
   if (brgemmOp.hasDynamicShape())
     return rewriter.notifyMatchFailure(brgemmOp, "require static shape");
@@ -570,7 +754,8 @@ mlir::linalgx::packVNNIBRGemmOp(RewriterBase &rewriter,
     return rewriter.notifyMatchFailure(brgemmOp,
                                        "unsupported blocking factor for type");
   }
-  SmallVector<OpFoldResult, 1> tilesOnK = {rewriter.getI64IntegerAttr(2)};
+  SmallVector<OpFoldResult, 1> tilesOnK = {
+      rewriter.getI64IntegerAttr(*blockingFactor)};
 
   Location loc = brgemmOp.getLoc();
   // Reshape input B.
@@ -634,25 +819,82 @@ struct BubbleUpThroughFillOp : public OpRewritePattern<tensor::PackOp> {
 // Passes
 //===----------------------------------------------------------------------===//
 
+// Return the blocking factors for `linalgOp`: the per-op override if any, else
+// the cost model selection if `costModel` is set, else `blockingFactors`.
+template <typename OpTy>
+static FailureOr<SmallVector<int64_t>> getBlockingFactors(
+    OpTy linalgOp, ArrayRef<int64_t> blockingFactors,
+    const std::optional<linalgx::utils::BlockingOptions> &costModel) {
+  if (auto factors = linalgx::utils::getBlockingFactorsOverride(linalgOp))
+    return *factors;
+  if (costModel) {
+    FailureOr<SmallVector<int64_t>> factors;
+    if constexpr (llvm::is_one_of<OpTy, linalg::MatmulOp,
+                                  linalg::BatchMatmulOp>::value)
+      factors = linalgx::utils::getMatmulBlockingFactors(linalgOp, *costModel);
+    else
+      factors = linalgx::utils::getConvBlockingFactors(linalgOp, *costModel);
+    if (succeeded(factors))
+      return factors;
+  }
+  if (blockingFactors.empty())
+    return failure();
+  return llvm::to_vector(blockingFactors);
+}
+
+// Return the cost model options if `autoBlock` is set.
+static std::optional<linalgx::utils::BlockingOptions>
+getCostModelOptions(bool autoBlock, int64_t l1CacheSize, int64_t l2CacheSize,
+                    int64_t numThreads) {
+  if (!autoBlock)
+    return std::nullopt;
+  linalgx::utils::BlockingOptions options;
+  options.l1CacheSize = l1CacheSize;
+  options.l2CacheSize = l2CacheSize;
+  options.numThreads = numThreads;
+  return options;
+}
+
 // Pack MatmulOp and BatchMatmulOp.
 template <typename OpTy> struct PackMatmulImpl : public OpRewritePattern<OpTy> {
   PackMatmulImpl(MLIRContext *context, ArrayRef<int64_t> blockingFactors,
-                 PatternBenefit benefit = 1)
+                 std::optional<linalgx::utils::BlockingOptions> costModel,
+                 bool peelRemainders, PatternBenefit benefit = 1)
       : OpRewritePattern<OpTy>(context, benefit),
-        blockingFactors(blockingFactors) {}
+        blockingFactors(blockingFactors), costModel(costModel),
+        peelRemainders(peelRemainders) {}
 
   LogicalResult matchAndRewrite(OpTy matmulOp,
                                 PatternRewriter &rewriter) const override {
+    FailureOr<SmallVector<int64_t>> factors =
+        getBlockingFactors(matmulOp, blockingFactors, costModel);
+    if (failed(factors))
+      return rewriter.notifyMatchFailure(matmulOp, "no blocking factors");
+    // Split off the remainders, pack the part with full tiles.
+    bool peeled = false;
+    if constexpr (std::is_same_v<OpTy, linalg::MatmulOp>) {
+      if (peelRemainders) {
+        FailureOr<linalg::MatmulOp> mainOp =
+            mlir::linalgx::peelMatmulOp(rewriter, matmulOp, *factors);
+        if (succeeded(mainOp)) {
+          matmulOp = *mainOp;
+          peeled = true;
+          rewriter.setInsertionPoint(matmulOp);
+        }
+      }
+    }
     FailureOr<linalg::GenericOp> packedMatmul = mlir::linalgx::packMatmulOp(
         rewriter, matmulOp,
-        getAsOpFoldResult(rewriter.getI64ArrayAttr(blockingFactors)));
+        getAsOpFoldResult(rewriter.getI64ArrayAttr(*factors)));
     if (failed(packedMatmul))
-      return failure();
+      return success(peeled);
     return success();
   }
 
 private:
-  ArrayRef<int64_t> blockingFactors;
+  SmallVector<int64_t> blockingFactors;
+  std::optional<linalgx::utils::BlockingOptions> costModel;
+  bool peelRemainders = false;
 };
 
 // Entry point for packing a matmul operation.
@@ -664,17 +906,19 @@ private:
 // KB is the batch reduce dimension.
 struct PackMatmul : public PackMatmulBase<PackMatmul> {
   PackMatmul() = default;
-  PackMatmul(ArrayRef<int64_t> blockingFactors) {
+  PackMatmul(ArrayRef<int64_t> blockingFactors, bool autoBlock) {
     this->blockingFactors = blockingFactors;
+    this->autoBlock = autoBlock;
   }
 
   void runOnOperation() override {
-    if (blockingFactors.empty())
-      return;
     MLIRContext *ctx = getOperation().getContext();
     RewritePatternSet patterns(ctx);
     patterns.add<PackMatmulImpl<linalg::MatmulOp>,
-                 PackMatmulImpl<linalg::BatchMatmulOp>>(ctx, blockingFactors);
+                 PackMatmulImpl<linalg::BatchMatmulOp>>(
+        ctx, blockingFactors,
+        getCostModelOptions(autoBlock, l1CacheSize, l2CacheSize, numThreads),
+        peelRemainders);
     linalg::populateLinalgDeGeneralizationPatterns(patterns);
     (void)applyPatternsAndFoldGreedily(getOperation(), std::move(patterns));
   }
@@ -683,16 +927,21 @@ struct PackMatmul : public PackMatmulBase<PackMatmul> {
 struct DoItOnConv2DNchwFchw
     : public OpRewritePattern<linalg::Conv2DNchwFchwOp> {
   DoItOnConv2DNchwFchw(MLIRContext *context, ArrayRef<int64_t> blockingFactors,
+                       std::optional<linalgx::utils::BlockingOptions> costModel,
                        PatternBenefit benefit = 1)
       : OpRewritePattern<linalg::Conv2DNchwFchwOp>(context, benefit),
-        blockingFactors(blockingFactors) {}
+        blockingFactors(blockingFactors), costModel(costModel) {}
 
   LogicalResult matchAndRewrite(linalg::Conv2DNchwFchwOp linalgOp,
                                 PatternRewriter &rewriter) const override {
+    FailureOr<SmallVector<int64_t>> factors =
+        getBlockingFactors(linalgOp, blockingFactors, costModel);
+    if (failed(factors))
+      return rewriter.notifyMatchFailure(linalgOp, "no blocking factors");
     FailureOr<linalg::GenericOp> genericOp =
         mlir::linalgx::packConv2DNchwFchwOp(
             rewriter, linalgOp,
-            getAsOpFoldResult(rewriter.getI64ArrayAttr(blockingFactors)));
+            getAsOpFoldResult(rewriter.getI64ArrayAttr(*factors)));
     if (failed(genericOp))
       return failure();
     return success();
@@ -700,20 +949,22 @@ struct DoItOnConv2DNchwFchw
 
 private:
   SmallVector<int64_t> blockingFactors;
+  std::optional<linalgx::utils::BlockingOptions> costModel;
 };
 
 struct PackConv2DNchwFchw : public PackConv2DNchwFchwBase<PackConv2DNchwFchw> {
   PackConv2DNchwFchw() = default;
-  PackConv2DNchwFchw(ArrayRef<int64_t> blockingFactors) {
+  PackConv2DNchwFchw(ArrayRef<int64_t> blockingFactors, bool autoBlock) {
     this->blockingFactors = blockingFactors;
+    this->autoBlock = autoBlock;
   }
 
   void runOnOperation() override {
-    if (blockingFactors.empty())
-      return;
     MLIRContext *ctx = getOperation().getContext();
     RewritePatternSet patterns(ctx);
-    patterns.add<DoItOnConv2DNchwFchw>(ctx, blockingFactors);
+    patterns.add<DoItOnConv2DNchwFchw>(
+        ctx, blockingFactors,
+        getCostModelOptions(autoBlock, l1CacheSize, l2CacheSize, numThreads));
     (void)applyPatternsAndFoldGreedily(getOperation(), std::move(patterns));
   }
 };
@@ -721,16 +972,21 @@ struct PackConv2DNchwFchw : public PackConv2DNchwFchwBase<PackConv2DNchwFchw> {
 struct DoItOnConv2DNhwcHwcf
     : public OpRewritePattern<linalg::Conv2DNhwcHwcfOp> {
   DoItOnConv2DNhwcHwcf(MLIRContext *context, ArrayRef<int64_t> blockingFactors,
+                       std::optional<linalgx::utils::BlockingOptions> costModel,
                        PatternBenefit benefit = 1)
       : OpRewritePattern<linalg::Conv2DNhwcHwcfOp>(context, benefit),
-        blockingFactors(blockingFactors) {}
+        blockingFactors(blockingFactors), costModel(costModel) {}
 
   LogicalResult matchAndRewrite(linalg::Conv2DNhwcHwcfOp linalgOp,
                                 PatternRewriter &rewriter) const override {
+    FailureOr<SmallVector<int64_t>> factors =
+        getBlockingFactors(linalgOp, blockingFactors, costModel);
+    if (failed(factors))
+      return rewriter.notifyMatchFailure(linalgOp, "no blocking factors");
     FailureOr<linalg::GenericOp> maybeGeneric =
         mlir::linalgx::packConv2DNhwcHwcfOp(
             rewriter, linalgOp,
-            getAsOpFoldResult(rewriter.getI64ArrayAttr(blockingFactors)));
+            getAsOpFoldResult(rewriter.getI64ArrayAttr(*factors)));
     if (failed(maybeGeneric))
       return failure();
     return success();
@@ -738,20 +994,22 @@ struct DoItOnConv2DNhwcHwcf
 
 private:
   SmallVector<int64_t> blockingFactors;
+  std::optional<linalgx::utils::BlockingOptions> costModel;
 };
 
 struct PackConv2DNhwcHwcf : PackConv2DNhwcHwcfBase<PackConv2DNhwcHwcf> {
   PackConv2DNhwcHwcf() = default;
-  PackConv2DNhwcHwcf(ArrayRef<int64_t> blockingFactors) {
+  PackConv2DNhwcHwcf(ArrayRef<int64_t> blockingFactors, bool autoBlock) {
     this->blockingFactors = blockingFactors;
+    this->autoBlock = autoBlock;
   }
 
   void runOnOperation() override {
-    if (blockingFactors.empty())
-      return;
     MLIRContext *ctx = getOperation().getContext();
     RewritePatternSet patterns(ctx);
-    patterns.add<DoItOnConv2DNhwcHwcf>(ctx, blockingFactors);
+    patterns.add<DoItOnConv2DNhwcHwcf>(
+        ctx, blockingFactors,
+        getCostModelOptions(autoBlock, l1CacheSize, l2CacheSize, numThreads));
     (void)applyPatternsAndFoldGreedily(getOperation(), std::move(patterns));
   }
 };
@@ -843,18 +1101,21 @@ void mlir::tpp::populateSinkPackPatterns(RewritePatternSet &patterns) {
 }
 
 std::unique_ptr<OperationPass<func::FuncOp>>
-mlir::tpp::createPackMatmulPass(ArrayRef<int64_t> blockingFactors) {
-  return std::make_unique<PackMatmul>(blockingFactors);
+mlir::tpp::createPackMatmulPass(ArrayRef<int64_t> blockingFactors,
+                                bool autoBlock) {
+  return std::make_unique<PackMatmul>(blockingFactors, autoBlock);
 }
 
 std::unique_ptr<OperationPass<func::FuncOp>>
-mlir::tpp::createPackConv2DNchwFchwPass(ArrayRef<int64_t> blockingFactors) {
-  return std::make_unique<PackConv2DNchwFchw>(blockingFactors);
+mlir::tpp::createPackConv2DNchwFchwPass(ArrayRef<int64_t> blockingFactors,
+                                        bool autoBlock) {
+  return std::make_unique<PackConv2DNchwFchw>(blockingFactors, autoBlock);
 }
 
 std::unique_ptr<OperationPass<func::FuncOp>>
-mlir::tpp::createPackConv2DNhwcHwcfPass(ArrayRef<int64_t> blockingFactors) {
-  return std::make_unique<PackConv2DNhwcHwcf>(blockingFactors);
+mlir::tpp::createPackConv2DNhwcHwcfPass(ArrayRef<int64_t> blockingFactors,
+                                        bool autoBlock) {
+  return std::make_unique<PackConv2DNhwcHwcf>(blockingFactors, autoBlock);
 }
 
 std::unique_ptr<OperationPass<func::FuncOp>> mlir::tpp::createPackVNNIPass() {
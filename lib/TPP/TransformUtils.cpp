@@ -17,6 +17,7 @@
 #include "mlir/Dialect/SCF/Utils/Utils.h"
 #include "mlir/Dialect/Tensor/IR/Tensor.h"
 #include "mlir/IR/AffineExprVisitor.h"
+#include "mlir/IR/Matchers.h"
 
 namespace mlir {
 
@@ -104,7 +105,12 @@ bool hasMulAddBody(linalg::LinalgOp linalgOp,
   Region &region = linalgOp->getRegion(0);
   if (!region.hasOneBlock())
     return false;
-  if (std::distance(region.front().begin(), region.front().end()) != 3)
+  // Mul, add and yield. Integer inputs may be sign-extended to the type of the
+  // accumulator, as for i8 matmuls accumulating in i32.
+  Block &block = region.front();
+  int64_t numExts = llvm::count_if(
+      block, [](Operation &op) { return isa<arith::ExtSIOp>(op); });
+  if (std::distance(block.begin(), block.end()) - numExts != 3)
     return false;
   bool isFloat =
       isAddMul<arith::AddFOp, arith::MulFOp>(linalgOp, capturedOperands);
@@ -113,6 +119,24 @@ bool hasMulAddBody(linalg::LinalgOp linalgOp,
   return (isFloat || isInt);
 }
 
+bool isZeroPaddingOnDims(tensor::PadOp padOp, ArrayRef<int64_t> dims) {
+  Value padValue = padOp.getConstantPaddingValue();
+  if (!padValue || !(matchPattern(padValue, m_AnyZeroFloat()) ||
+                     matchPattern(padValue, m_Zero())))
+    return false;
+  ArrayRef<int64_t> low = padOp.getStaticLow();
+  ArrayRef<int64_t> high = padOp.getStaticHigh();
+  for (size_t idx = 0, e = low.size(); idx < e; idx++) {
+    if (ShapedType::isDynamic(low[idx]) || ShapedType::isDynamic(high[idx]))
+      return false;
+    if (llvm::is_contained(dims, static_cast<int64_t>(idx)))
+      continue;
+    if (low[idx] != 0 || high[idx] != 0)
+      return false;
+  }
+  return true;
+}
+
 // Given localIvs being outermost dimensions of the current linalg operation,
 // return the dimensions used by a given operand looking at its access map. As
 // a simple example consider the following: map operand = (d0, d1, d2, d3, d4,
@@ -389,9 +413,12 @@ bool isBlockedMatmul(Operation *op) {
     .input(MatchOne(0), HasMap(ProjectedPermutation(), &aMap))
     .input(MatchOne(1), HasMap(Any(), &bMap))
     .output(MatchOne(0), HasMap(ProjectedPermutation(), &cMap))
-    .region(MatchOne(0), 
-            WithOpChain<arith::MulFOp, 
-                        arith::AddFOp>(/*captures=*/nullptr));
+    .region(MatchOne(0), [](Region *region, Operation *op) {
+      return WithOpChain<arith::MulFOp,
+                         arith::AddFOp>(/*captures=*/nullptr)(region, op) ||
+             WithOpChain<arith::ExtSIOp, arith::ExtSIOp, arith::MulIOp,
+                         arith::AddIOp>(/*captures=*/nullptr)(region, op);
+    });
   // clang-format on
   if (!maybeBlockMatmul.match(linalgOp))
     return false;
@@ -0,0 +1,167 @@
+//===- TuningDatabase.cpp ----------------------------------------*- C++-*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "TPP/TuningDatabase.h"
+#include "TPP/BlockingFactors.h"
+#include "mlir/Dialect/Linalg/IR/Linalg.h"
+#include "mlir/IR/Builders.h"
+#include "mlir/IR/BuiltinAttributes.h"
+#include "mlir/IR/TypeUtilities.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/FormatVariadic.h"
+#include "llvm/Support/JSON.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/TargetParser/Host.h"
+
+using namespace mlir;
+using namespace mlir::tpp;
+
+static LogicalResult setError(std::string *errorMessage,
+                              const llvm::Twine &msg) {
+  if (errorMessage)
+    *errorMessage = msg.str();
+  return failure();
+}
+
+static bool parseIntList(const llvm::json::Array *array,
+                         SmallVectorImpl<int64_t> &values) {
+  if (!array)
+    return false;
+  for (const llvm::json::Value &value : *array) {
+    std::optional<int64_t> intValue = value.getAsInteger();
+    if (!intValue)
+      return false;
+    values.push_back(*intValue);
+  }
+  return true;
+}
+
+FailureOr<TuningDatabase> TuningDatabase::load(StringRef path,
+                                               std::string *errorMessage) {
+  TuningDatabase db;
+  if (!llvm::sys::fs::exists(path))
+    return db;
+
+  auto buffer = llvm::MemoryBuffer::getFile(path);
+  if (!buffer) {
+    (void)setError(errorMessage, "cannot read tuning database '" + path +
+                                     "': " + buffer.getError().message());
+    return failure();
+  }
+  llvm::Expected<llvm::json::Value> json =
+      llvm::json::parse((*buffer)->getBuffer());
+  if (!json) {
+    (void)setError(errorMessage, "invalid tuning database '" + path +
+                                     "': " + llvm::toString(json.takeError()));
+    return failure();
+  }
+
+  const llvm::json::Object *cpus = json->getAsObject();
+  if (!cpus) {
+    (void)setError(errorMessage,
+                   "invalid tuning database '" + path + "': expect an object");
+    return failure();
+  }
+  for (const auto &cpu : *cpus) {
+    const llvm::json::Object *ops = cpu.second.getAsObject();
+    if (!ops)
+      continue;
+    for (const auto &op : *ops) {
+      const llvm::json::Object *fields = op.second.getAsObject();
+      if (!fields)
+        continue;
+      TuningEntry entry;
+      if (!parseIntList(fields->getArray("block-factors"),
+                        entry.blockingFactors) ||
+          !parseIntList(fields->getArray("tile-sizes"), entry.tileSizes)) {
+        (void)setError(errorMessage, "invalid tuning database '" + path +
+                                         "': malformed entry '" +
+                                         op.first.str() + "'");
+        return failure();
+      }
+      entry.time = fields->getNumber("time").value_or(0.0);
+      db.entries[cpu.first.str()][op.first.str()] = std::move(entry);
+    }
+  }
+  return db;
+}
+
+LogicalResult TuningDatabase::save(StringRef path,
+                                   std::string *errorMessage) const {
+  llvm::json::Object cpus;
+  for (const auto &cpu : entries) {
+    llvm::json::Object ops;
+    for (const auto &op : cpu.second) {
+      const TuningEntry &entry = op.second;
+      ops[op.first()] = llvm::json::Object{
+          {"block-factors", llvm::json::Array(entry.blockingFactors)},
+          {"tile-sizes", llvm::json::Array(entry.tileSizes)},
+          {"time", entry.time}};
+    }
+    cpus[cpu.first()] = std::move(ops);
+  }
+
+  std::error_code ec;
+  llvm::raw_fd_ostream os(path, ec, llvm::sys::fs::OF_Text);
+  if (ec)
+    return setError(errorMessage, "cannot write tuning database '" + path +
+                                      "': " + ec.message());
+  os << llvm::formatv("{0:2}", llvm::json::Value(std::move(cpus))) << "\n";
+  return success();
+}
+
+std::optional<TuningEntry> TuningDatabase::lookup(StringRef cpu,
+                                                  StringRef key) const {
+  auto cpuIt = entries.find(cpu);
+  if (cpuIt == entries.end())
+    return std::nullopt;
+  auto opIt = cpuIt->second.find(key);
+  if (opIt == cpuIt->second.end())
+    return std::nullopt;
+  return opIt->second;
+}
+
+void TuningDatabase::insert(StringRef cpu, StringRef key,
+                            const TuningEntry &entry) {
+  llvm::StringMap<TuningEntry> &ops = entries[cpu];
+  auto it = ops.find(key);
+  if (it != ops.end() && it->second.time <= entry.time)
+    return;
+  ops[key] = entry;
+}
+
+FailureOr<std::string> mlir::tpp::getTuningKey(linalg::LinalgOp linalgOp) {
+  if (!isa<linalg::MatmulOp, linalg::BatchMatmulOp, linalg::Conv2DNhwcHwcfOp,
+           linalg::Conv2DNchwFchwOp>(linalgOp))
+    return failure();
+  if (linalgOp.hasDynamicShape())
+    return failure();
+
+  std::string key;
+  llvm::raw_string_ostream os(key);
+  os << linalgOp->getName() << " "
+     << getElementTypeOrSelf(linalgOp.getDpsInputOperand(0)->get().getType())
+     << " ";
+  llvm::interleave(linalgOp.getStaticLoopRanges(), os, "x");
+  return os.str();
+}
+
+std::string mlir::tpp::getHostCpuName() {
+  return llvm::sys::getHostCPUName().str();
+}
+
+void mlir::tpp::applyTuningEntry(Operation *op, const TuningEntry &entry) {
+  Builder builder(op->getContext());
+  if (!entry.blockingFactors.empty())
+    op->setAttr(linalgx::utils::kBlockFactorsAttrName,
+                builder.getDenseI64ArrayAttr(entry.blockingFactors));
+  if (!entry.tileSizes.empty())
+    op->setAttr(linalgx::utils::kTileSizesAttrName,
+                builder.getDenseI64ArrayAttr(entry.tileSizes));
+}
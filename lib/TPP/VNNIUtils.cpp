@@ -21,11 +21,13 @@ std::optional<int64_t> getVnniBlockingFactor(Type type) {
   auto elementType = getElementTypeOrSelf(type);
   if (elementType.isBF16())
     return libxsmm_cpuid_dot_pack_factor(LIBXSMM_DATATYPE_BF16);
+  if (elementType.isInteger(8))
+    return libxsmm_cpuid_dot_pack_factor(LIBXSMM_DATATYPE_I8);
   return std::nullopt;
 }
 
 bool isInVnniLayout(MemRefType memref) {
-  if (memref.getRank() < 3 || !memref.getElementType().isBF16())
+  if (memref.getRank() < 3 || !vnni::utils::getVnniBlockingFactor(memref))
     return false;
   return memref.getShape()[memref.getRank() - 1] ==
          vnni::utils::getVnniBlockingFactor(memref);
@@ -0,0 +1,267 @@
+//===- XsmmKernelCache.cpp - Persistent cache for XSMM kernels ------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements the on-disk cache for LIBXSMM JIT kernels. Each kernel
+// is stored in its own file, named after a hash of its key. The file starts
+// with a header holding the LIBXSMM version, the full key and a checksum of
+// the code, so that hash collisions, corrupted files and files from a
+// different LIBXSMM version or CPU are detected and ignored. Files are written
+// to a temporary name and renamed, so concurrent processes sharing a cache
+// directory never observe partial kernels. Only the kernel kinds known to be
+// position independent are cached.
+//
+//===----------------------------------------------------------------------===//
+
+#include "XsmmKernelCache.h"
+#include "libxsmm.h" // NOLINT [build/include_subdir]
+
+#include <atomic>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace {
+
+// "TPP-XSMM" in little endian, with the last byte bumped on each format
+// change.
+constexpr uint64_t kKernelFileMagic = 0x4e4d53582d505054ULL;
+
+constexpr unsigned kVersionSize = 32;
+
+struct KernelFileHeader {
+  uint64_t magic;
+  // LIBXSMM_VERSION, truncated and zero padded.
+  char version[kVersionSize];
+  uint64_t codeSize;
+  // hashBytes() of the code.
+  uint64_t checksum;
+  int64_t fields[XsmmKernelKey::kMaxFields];
+};
+
+struct KernelCacheState {
+  KernelCacheState() {
+    const char *envDir = getenv("TPP_XSMM_CACHE_DIR");
+    if (envDir && *envDir)
+      dir = envDir;
+    const char *envVerbose = getenv("TPP_XSMM_CACHE_VERBOSE");
+    if (!dir.empty() && envVerbose && atoi(envVerbose) != 0)
+      atexit(printStats);
+  }
+
+  static void printStats();
+
+  // Cache directory, empty when the cache is disabled.
+  std::string dir;
+  // Kernels already known to this process, either mapped from disk or
+  // generated by the JIT.
+  std::unordered_map<std::string, void *> kernels;
+  std::mutex mutex;
+  std::atomic<int64_t> hits{0};
+  std::atomic<int64_t> misses{0};
+};
+
+// Never destroyed, so that it is still valid in the atexit handler.
+KernelCacheState &getState() {
+  static KernelCacheState *state = new KernelCacheState();
+  return *state;
+}
+
+void KernelCacheState::printStats() {
+  KernelCacheState &state = getState();
+  fprintf(stderr, "XSMM kernel cache: %" PRId64 " hits, %" PRId64 " misses\n",
+          state.hits.load(), state.misses.load());
+}
+
+// FNV-1a.
+uint64_t hashBytes(const void *data, size_t size) {
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  const unsigned char *bytes = reinterpret_cast<const unsigned char *>(data);
+  for (size_t i = 0; i < size; i++) {
+    hash ^= bytes[i];
+    hash *= 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+// Fill `version` with the version of the LIBXSMM in use.
+void getVersion(char (&version)[kVersionSize]) {
+  memset(version, 0, kVersionSize);
+  strncpy(version, LIBXSMM_VERSION, kVersionSize - 1);
+}
+
+// The JIT-ed code of the gemm kernels only uses relative addressing, so it
+// can be mapped anywhere. Eltwise and fused kernels may embed the absolute
+// address of constant tables of the process that generated them.
+bool isRelocatable(const XsmmKernelKey &key) {
+  auto kind = static_cast<XsmmKernelKind>(key.fields[0]);
+  return kind == XsmmKernelKind::GEMM || kind == XsmmKernelKind::BRGEMM;
+}
+
+std::string getKernelPath(const std::string &dir, const XsmmKernelKey &key) {
+  char name[32];
+  snprintf(name, sizeof(name), "/xsmm-%016" PRIx64 ".bin", key.hash());
+  return dir + name;
+}
+
+size_t getMappedSize(size_t codeSize) {
+  size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  return (codeSize + pageSize - 1) / pageSize * pageSize;
+}
+
+// Load the kernel stored at `path` into fresh executable memory. Returns
+// nullptr if the file does not exist or does not hold the kernel for `key`.
+void *mapKernel(const std::string &path, const XsmmKernelKey &key,
+                size_t &mappedSize) {
+  FILE *file = fopen(path.c_str(), "rb");
+  if (!file)
+    return nullptr;
+
+  KernelFileHeader header;
+  char version[kVersionSize];
+  getVersion(version);
+  if (fread(&header, sizeof(header), 1, file) != 1 ||
+      header.magic != kKernelFileMagic || header.codeSize == 0 ||
+      memcmp(header.version, version, kVersionSize) != 0 ||
+      memcmp(header.fields, key.fields, sizeof(key.fields)) != 0) {
+    fclose(file);
+    return nullptr;
+  }
+
+  mappedSize = getMappedSize(header.codeSize);
+  void *code = mmap(nullptr, mappedSize, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (code == MAP_FAILED) {
+    fclose(file);
+    return nullptr;
+  }
+  bool loaded = fread(code, 1, header.codeSize, file) == header.codeSize &&
+                hashBytes(code, header.codeSize) == header.checksum &&
+                mprotect(code, mappedSize, PROT_READ | PROT_EXEC) == 0;
+  fclose(file);
+  if (!loaded) {
+    munmap(code, mappedSize);
+    return nullptr;
+  }
+  return code;
+}
+
+// Store the code of `kernel` at `path`. Failures are not fatal: the kernel is
+// simply generated again by the next process.
+void storeKernel(const std::string &path, const XsmmKernelKey &key,
+                 const void *kernel) {
+  libxsmm_kernel_info info;
+  if (libxsmm_get_kernel_info(kernel, &info) != EXIT_SUCCESS ||
+      info.code_size == 0)
+    return;
+
+  KernelFileHeader header;
+  header.magic = kKernelFileMagic;
+  getVersion(header.version);
+  header.codeSize = info.code_size;
+  header.checksum = hashBytes(kernel, info.code_size);
+  memcpy(header.fields, key.fields, sizeof(key.fields));
+
+  std::string tmpPath = path + "." + std::to_string(getpid()) + ".tmp";
+  FILE *file = fopen(tmpPath.c_str(), "wb");
+  if (!file)
+    return;
+  bool written = fwrite(&header, sizeof(header), 1, file) == 1 &&
+                 fwrite(kernel, 1, info.code_size, file) == info.code_size;
+  if (fclose(file) != 0 || !written ||
+      rename(tmpPath.c_str(), path.c_str()) != 0)
+    remove(tmpPath.c_str());
+}
+
+std::string getKeyId(const XsmmKernelKey &key) {
+  return std::string(reinterpret_cast<const char *>(key.fields),
+                     sizeof(key.fields));
+}
+
+} // namespace
+
+XsmmKernelKey::XsmmKernelKey(XsmmKernelKind kind,
+                             std::initializer_list<int64_t> args) {
+  // Kernels are only reused with the exact same LIBXSMM and CPU.
+  static const int64_t versionHash = static_cast<int64_t>(
+      hashBytes(LIBXSMM_VERSION, strlen(LIBXSMM_VERSION)));
+  constexpr unsigned kNumHeaderFields = 3;
+  if (args.size() > kMaxFields - kNumHeaderFields) {
+    fprintf(stderr, "too many fields in XSMM kernel cache key\n");
+    exit(-1);
+  }
+  memset(fields, 0, sizeof(fields));
+  fields[0] = static_cast<int64_t>(kind);
+  fields[1] = libxsmm_get_target_archid();
+  fields[2] = versionHash;
+  unsigned idx = kNumHeaderFields;
+  for (int64_t arg : args)
+    fields[idx++] = arg;
+}
+
+uint64_t XsmmKernelKey::hash() const {
+  uint64_t hash = 0;
+  for (int64_t field : fields)
+    hash = (hash ^ static_cast<uint64_t>(field)) * 0x9e3779b97f4a7c15ULL;
+  return hash ^ (hash >> 32);
+}
+
+void *xsmmKernelCacheLookup(const XsmmKernelKey &key) {
+  KernelCacheState &state = getState();
+  if (state.dir.empty() || !isRelocatable(key))
+    return nullptr;
+
+  std::string id = getKeyId(key);
+  {
+    std::lock_guard<std::mutex> lock(state.mutex);
+    auto it = state.kernels.find(id);
+    if (it != state.kernels.end())
+      return it->second;
+  }
+
+  size_t mappedSize = 0;
+  void *kernel = mapKernel(getKernelPath(state.dir, key), key, mappedSize);
+  if (!kernel) {
+    state.misses++;
+    return nullptr;
+  }
+  state.hits++;
+
+  std::lock_guard<std::mutex> lock(state.mutex);
+  auto inserted = state.kernels.emplace(id, kernel);
+  // Another thread mapped the same kernel in the meantime; keep theirs.
+  if (!inserted.second)
+    munmap(kernel, mappedSize);
+  return inserted.first->second;
+}
+
+void xsmmKernelCacheInsert(const XsmmKernelKey &key, const void *kernel) {
+  KernelCacheState &state = getState();
+  if (state.dir.empty() || !isRelocatable(key))
+    return;
+
+  {
+    std::lock_guard<std::mutex> lock(state.mutex);
+    state.kernels.emplace(getKeyId(key), const_cast<void *>(kernel));
+  }
+  storeKernel(getKernelPath(state.dir, key), key, kernel);
+}
+
+extern "C" void xsmm_kernel_cache_stats(int64_t *hits, int64_t *misses) {
+  KernelCacheState &state = getState();
+  if (hits)
+    *hits = state.hits.load();
+  if (misses)
+    *misses = state.misses.load();
+}
@@ -0,0 +1,62 @@
+//===- XsmmKernelCache.h - Persistent cache for XSMM kernels ----*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file declares an opt-in, on-disk cache for LIBXSMM JIT kernels. When
+// the environment variable TPP_XSMM_CACHE_DIR names a writable directory, the
+// code of every relocatable kernel (gemm and brgemm) generated by the dispatch
+// functions is stored there, keyed by kernel kind, data type, shape, flags and
+// target architecture. Later processes map the stored code back as executable
+// memory instead of invoking the JIT again. Setting TPP_XSMM_CACHE_VERBOSE
+// prints the hit/miss counters at exit. Entities in this file must be
+// compliant with C++11.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef TPP_EXECUTIONENGINE_XSMMKERNELCACHE_H
+#define TPP_EXECUTIONENGINE_XSMMKERNELCACHE_H
+
+#include "mlir/ExecutionEngine/RunnerUtils.h"
+
+#include <cstdint>
+#include <initializer_list>
+
+enum class XsmmKernelKind : int64_t {
+  GEMM = 1,
+  BRGEMM = 2,
+  UNARY = 3,
+  BINARY = 4,
+  FUSED_BRGEMM = 5,
+  TERNARY = 6
+};
+
+// Identifies a kernel: its kind, the target architecture and all the dispatch
+// arguments that affect code generation.
+struct XsmmKernelKey {
+  static constexpr unsigned kMaxFields = 16;
+
+  XsmmKernelKey(XsmmKernelKind kind, std::initializer_list<int64_t> args);
+
+  // Stable across processes, used to name the cached kernel files.
+  uint64_t hash() const;
+
+  int64_t fields[kMaxFields];
+};
+
+// Return the kernel cached for `key`, or nullptr if the cache is disabled or
+// the kernel has not been generated yet.
+void *xsmmKernelCacheLookup(const XsmmKernelKey &key);
+
+// Record `kernel`, freshly generated by LIBXSMM, as the kernel for `key`.
+void xsmmKernelCacheInsert(const XsmmKernelKey &key, const void *kernel);
+
+// Number of kernels mapped from disk (hits) and generated by the JIT while the
+// cache was enabled (misses) in this process.
+extern "C" MLIR_RUNNERUTILS_EXPORT void xsmm_kernel_cache_stats(int64_t *hits,
+                                                                int64_t *misses);
+
+#endif // TPP_EXECUTIONENGINE_XSMMKERNELCACHE_H
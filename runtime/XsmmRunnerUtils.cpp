@@ -13,8 +13,13 @@
 //===----------------------------------------------------------------------===//
 
 #include "XsmmRunnerUtils.h"
+#include "XsmmKernelCache.h"
 #include "libxsmm.h" // NOLINT [build/include_subdir]
 
+#include <atomic>
+#include <cinttypes>
+#include <cstring>
+
 // Helper function prototypes.
 static void printXsmmStruct(const libxsmm_gemm_shape &gemmShape,
                             FILE *outfile = stderr);
@@ -22,6 +27,8 @@ static void printXsmmStruct(const libxsmm_meltw_unary_shape &unaryShape,
                             FILE *outfile = stderr);
 static void printXsmmStruct(const libxsmm_meltw_binary_shape &binaryShape,
                             FILE *outfile = stderr);
+static void printXsmmStruct(const libxsmm_meltw_ternary_shape &ternaryShape,
+                            FILE *outfile = stderr);
 static void printXsmmStruct(const libxsmm_gemm_batch_reduce_config &brgemmShape,
                             FILE *outfile = stderr);
 
@@ -57,6 +64,66 @@ static bool hasImplicitComputeDtypeUnary(const libxsmm_meltw_unary_type dtype) {
   }
 }
 
+// Count dispatch calls when TPP_XSMM_DISPATCH_STATS is set, to check that
+// dispatches are not executed in hot loops. The total is printed at exit.
+static std::atomic<int64_t> *getDispatchCounter() {
+  static std::atomic<int64_t> *counter = []() -> std::atomic<int64_t> * {
+    const char *env = getenv("TPP_XSMM_DISPATCH_STATS");
+    if (!env || atoi(env) == 0)
+      return nullptr;
+    atexit([] {
+      fprintf(stderr, "XSMM dispatch: %" PRId64 " calls\n",
+              getDispatchCounter()->load());
+    });
+    return new std::atomic<int64_t>(0);
+  }();
+  return counter;
+}
+
+static void countDispatch() {
+  if (std::atomic<int64_t> *counter = getDispatchCounter())
+    counter->fetch_add(1, std::memory_order_relaxed);
+}
+
+// Per-thread, direct-mapped table of the kernels dispatched so far, keyed by
+// the exact dispatch arguments. LIBXSMM hashes a descriptor and locks its
+// shared registry on every dispatch; a hit here costs one probe and no
+// synchronization, so threads re-dispatching the same kernels do not contend.
+struct LocalKernelEntry {
+  int64_t fields[XsmmKernelKey::kMaxFields];
+  void *kernel;
+};
+static constexpr unsigned kNumLocalKernels = 64;
+static thread_local LocalKernelEntry localKernels[kNumLocalKernels];
+
+static LocalKernelEntry &getLocalKernelEntry(const XsmmKernelKey &key) {
+  return localKernels[key.hash() % kNumLocalKernels];
+}
+
+// Return the kernel already dispatched for `key`, first from the per-thread
+// table and then from the persistent cache, or nullptr if it must be JIT-ed.
+static void *lookupKernel(const XsmmKernelKey &key) {
+  LocalKernelEntry &entry = getLocalKernelEntry(key);
+  if (entry.kernel &&
+      memcmp(entry.fields, key.fields, sizeof(key.fields)) == 0)
+    return entry.kernel;
+
+  void *kernel = xsmmKernelCacheLookup(key);
+  if (kernel) {
+    memcpy(entry.fields, key.fields, sizeof(key.fields));
+    entry.kernel = kernel;
+  }
+  return kernel;
+}
+
+// Record a kernel freshly generated by LIBXSMM.
+static void recordKernel(const XsmmKernelKey &key, const void *kernel) {
+  LocalKernelEntry &entry = getLocalKernelEntry(key);
+  memcpy(entry.fields, key.fields, sizeof(key.fields));
+  entry.kernel = const_cast<void *>(kernel);
+  xsmmKernelCacheInsert(key, kernel);
+}
+
 namespace {
 // Although, definition of this struct should match with the definition used in
 // MemrefToLLVM pass.
@@ -78,12 +145,54 @@ void *get_base_ptr(const libxsmm_datatype dType, void *alignedPtr,
   } else if (dType == LIBXSMM_DATATYPE_BF16) {
     bf16 *base_ptr = (bf16 *)alignedPtr + offset;
     return (void *)base_ptr;
+  } else if (dType == LIBXSMM_DATATYPE_I8) {
+    int8_t *base_ptr = (int8_t *)alignedPtr + offset;
+    return (void *)base_ptr;
+  } else if (dType == LIBXSMM_DATATYPE_I32) {
+    int32_t *base_ptr = (int32_t *)alignedPtr + offset;
+    return (void *)base_ptr;
   }
   fprintf(stderr, "Unhandled data type in get_data_pointer_from_memref_desc:%d",
           dType);
   return nullptr;
 }
 
+// The xsmm dialect passes its data type values through unchanged.
+static_assert(LIBXSMM_DATATYPE_I8 == 12, "xsmm::DataType::I8 mismatch");
+static_assert(LIBXSMM_DATATYPE_I32 == 7, "xsmm::DataType::I32 mismatch");
+static_assert(LIBXSMM_MELTW_TYPE_TERNARY_MULADD == 1,
+              "xsmm::TernaryKind::MULADD mismatch");
+static_assert(LIBXSMM_MELTW_TYPE_UNARY_TANH == 7,
+              "xsmm::UnaryKind::TANH mismatch");
+static_assert(LIBXSMM_MELTW_TYPE_UNARY_SIGMOID == 9,
+              "xsmm::UnaryKind::SIGMOID mismatch");
+static_assert(LIBXSMM_MELTW_TYPE_UNARY_GELU == 11,
+              "xsmm::UnaryKind::GELU mismatch");
+static_assert(LIBXSMM_MELTW_TYPE_UNARY_EXP == 17,
+              "xsmm::UnaryKind::EXP mismatch");
+static_assert(LIBXSMM_MELTW_FLAG_TERNARY_BCAST_COL_IN_1 == 16 &&
+                  LIBXSMM_MELTW_FLAG_TERNARY_BCAST_COL_IN_2 == 32,
+              "xsmm::TernaryFlags mismatch");
+
+// Gemm-like kernels on i8 inputs accumulate and write the output in i32.
+libxsmm_datatype get_gemm_out_type(const libxsmm_datatype dType) {
+  return dType == LIBXSMM_DATATYPE_I8 ? LIBXSMM_DATATYPE_I32 : dType;
+}
+
+// Byte strides between consecutive A and B blocks of a stride-based brgemm.
+// TODO: move stride computation to dispatch
+// operation as in: https://github.com/plaidml/plaidml/pull/1983
+void get_brgemm_strides(const libxsmm_datatype dType, int64_t m, int64_t n,
+                        int64_t k, int64_t lda, int64_t ldb,
+                        const libxsmm_gemm_flags flags,
+                        libxsmm_blasint &stride_a, libxsmm_blasint &stride_b) {
+  auto typeSize = LIBXSMM_TYPESIZE(dType);
+  // The flags are already in LIBXSMM col-major order: TRANS_A applies to our
+  // B, stored as NxK blocks, and TRANS_B to our A, stored as KxM blocks.
+  stride_a = lda * ((flags & LIBXSMM_GEMM_FLAG_TRANS_B) ? k : m) * typeSize;
+  stride_b = ldb * ((flags & LIBXSMM_GEMM_FLAG_TRANS_A) ? n : k) * typeSize;
+}
+
 } // namespace
 
 extern "C" void xsmm_gemm_invoke(const libxsmm_datatype dType, int64_t addr,
@@ -96,16 +205,20 @@ extern "C" void xsmm_gemm_invoke(const libxsmm_datatype dType, int64_t addr,
   // LIBXSMM col-major change A with B.
   gemm_param.a.primary = get_base_ptr(dType, alignedPtrB, offsetB);
   gemm_param.b.primary = get_base_ptr(dType, alignedPtrA, offsetA);
-  gemm_param.c.primary = get_base_ptr(dType, alignedPtrC, offsetC);
+  gemm_param.c.primary =
+      get_base_ptr(get_gemm_out_type(dType), alignedPtrC, offsetC);
 
   sgemm.gemm = reinterpret_cast<libxsmm_gemmfunction>(addr);
   sgemm.gemm(&gemm_param);
 }
 
-extern "C" int64_t xsmm_gemm_dispatch(const libxsmm_datatype dtype, int64_t m,
-                                      int64_t n, int64_t k, int64_t lda,
-                                      int64_t ldb, int64_t ldc,
-                                      const libxsmm_gemm_flags flags) {
+// Dispatch a GEMM kernel. With `prefetchFlags` the kernel also issues
+// software prefetches for the addresses passed in the quaternary fields of
+// the A and B arguments.
+static int64_t dispatchGemm(const libxsmm_datatype dtype, int64_t m, int64_t n,
+                            int64_t k, int64_t lda, int64_t ldb, int64_t ldc,
+                            const libxsmm_gemm_flags flags,
+                            libxsmm_bitfield prefetchFlags) {
   // std::cout << "lda: " << lda << "\n";
   // std::cout << "ldb: " << ldb << "\n";
   // std::cout << "ldc: " << ldc << "\n";
@@ -114,13 +227,19 @@ extern "C" int64_t xsmm_gemm_dispatch(const libxsmm_datatype dtype, int64_t m,
   // std::cout << "n: " << n << "\n";
   // std::cout << "k: " << k << "\n";
 
+  countDispatch();
+  XsmmKernelKey key(XsmmKernelKind::GEMM, {dtype, m, n, k, lda, ldb, ldc,
+                                           flags, prefetchFlags});
+  if (void *cached = lookupKernel(key))
+    return reinterpret_cast<int64_t>(cached);
+
   libxsmm_blasint m_int = m;
   libxsmm_blasint n_int = n;
   libxsmm_blasint k_int = k;
 
   libxsmm_gemm_shape l_shape;
   libxsmm_bitfield l_flags = flags;
-  libxsmm_bitfield l_prefetch_flags = 0;
+  libxsmm_bitfield l_prefetch_flags = prefetchFlags;
 
   // See:
   // https://stackoverflow.com/questions/56043539/cublassgemm-row-major-multiplication
@@ -133,43 +252,87 @@ extern "C" int64_t xsmm_gemm_dispatch(const libxsmm_datatype dtype, int64_t m,
   l_shape.ldc = ldc;
   l_shape.a_in_type = dtype;
   l_shape.b_in_type = dtype;
-  l_shape.out_type = dtype;
+  l_shape.out_type = get_gemm_out_type(dtype);
   // Retarget computation type from bf16 to f32 due to missing hardware support.
-  l_shape.comp_type =
-      dtype == LIBXSMM_DATATYPE_BF16 ? LIBXSMM_DATATYPE_F32 : dtype;
+  l_shape.comp_type = dtype == LIBXSMM_DATATYPE_BF16
+                          ? LIBXSMM_DATATYPE_F32
+                          : get_gemm_out_type(dtype);
 
   auto sgemm = libxsmm_dispatch_gemm_v2(l_shape, l_flags, l_prefetch_flags);
+  // Prefetching is a hint, fall back to the plain kernel if the target cannot
+  // generate it.
+  if (!sgemm && l_prefetch_flags)
+    sgemm = libxsmm_dispatch_gemm_v2(l_shape, l_flags, 0);
   if (!sgemm) {
     fprintf(stderr, "failed to generate matmul func\n");
     fprintf(stderr, "dtype: %u\n", dtype);
     printXsmmStruct(l_shape);
     exit(-1);
   }
+  recordKernel(key, reinterpret_cast<const void *>(sgemm));
 
   return reinterpret_cast<int64_t>(sgemm);
 }
 
-extern "C" int64_t
-xsmm_unary_dispatch(const libxsmm_meltw_unary_type op_type,
-                    const libxsmm_datatype dtype, int64_t m, int64_t n,
-                    int64_t ldi, int64_t ldo,
-                    const libxsmm_meltw_unary_flags unary_flags) {
-  // std::cout << "ldi: " << ldi << "\n";
-  // std::cout << "ldo: " << ldo << "\n";
-  // std::cout << "m: " << m << "\n";
-  // std::cout << "n: " << n << "\n";
-  // std::cout << "type: " << type << "\n";
-  // std::cout << "bcast_type: " << bcast_type << "\n";
+extern "C" int64_t xsmm_gemm_dispatch(const libxsmm_datatype dtype, int64_t m,
+                                      int64_t n, int64_t k, int64_t lda,
+                                      int64_t ldb, int64_t ldc,
+                                      const libxsmm_gemm_flags flags) {
+  return dispatchGemm(dtype, m, n, k, lda, ldb, ldc, flags,
+                      LIBXSMM_GEMM_PREFETCH_NONE);
+}
+
+extern "C" int64_t xsmm_gemm_prefetch_dispatch(const libxsmm_datatype dtype,
+                                               int64_t m, int64_t n, int64_t k,
+                                               int64_t lda, int64_t ldb,
+                                               int64_t ldc,
+                                               const libxsmm_gemm_flags flags) {
+  return dispatchGemm(dtype, m, n, k, lda, ldb, ldc, flags,
+                      LIBXSMM_GEMM_PREFETCH_AL2BL2_VIA_C);
+}
+
+extern "C" void xsmm_gemm_prefetch_invoke(
+    const libxsmm_datatype dType, int64_t addr, void *alignedPtrA,
+    int64_t offsetA, void *alignedPtrB, int64_t offsetB, void *alignedPtrC,
+    int64_t offsetC, void *alignedPtrNextA, int64_t offsetNextA,
+    void *alignedPtrNextB, int64_t offsetNextB) {
+  libxsmm_xmmfunction sgemm;
+  libxsmm_gemm_param gemm_param;
+
+  // LIBXSMM col-major change A with B.
+  gemm_param.a.primary = get_base_ptr(dType, alignedPtrB, offsetB);
+  gemm_param.b.primary = get_base_ptr(dType, alignedPtrA, offsetA);
+  gemm_param.c.primary =
+      get_base_ptr(get_gemm_out_type(dType), alignedPtrC, offsetC);
+  gemm_param.a.quaternary = get_base_ptr(dType, alignedPtrNextB, offsetNextB);
+  gemm_param.b.quaternary = get_base_ptr(dType, alignedPtrNextA, offsetNextA);
+
+  sgemm.gemm = reinterpret_cast<libxsmm_gemmfunction>(addr);
+  sgemm.gemm(&gemm_param);
+}
+
+static int64_t dispatchUnary(const libxsmm_meltw_unary_type op_type,
+                             const libxsmm_datatype dtype,
+                             const libxsmm_datatype in_dtype, int64_t m,
+                             int64_t n, int64_t ldi, int64_t ldo,
+                             const libxsmm_meltw_unary_flags unary_flags) {
+  countDispatch();
+  XsmmKernelKey key(XsmmKernelKind::UNARY,
+                    {op_type, dtype, m, n, ldi, ldo, unary_flags, in_dtype});
+  if (void *cached = lookupKernel(key))
+    return reinterpret_cast<int64_t>(cached);
 
   libxsmm_meltw_unary_shape unary_shape;
   // Row major to col major swap m with n.
   unary_shape.m = static_cast<libxsmm_blasint>(n);
   unary_shape.n = static_cast<libxsmm_blasint>(m);
-  unary_shape.in0_type = dtype;
+  unary_shape.in0_type = in_dtype;
   // Retarget computation type from bf16 to f32 due to missing hardware support.
-  // Copy and Zero should remain in BF16 to avoid useless up/down casts
+  // Copy and Zero should remain in BF16 to avoid useless up/down casts.
+  // Conversions go through f32.
   auto force_fp32 = (dtype == LIBXSMM_DATATYPE_BF16 &&
-                     !hasImplicitComputeDtypeUnary(op_type));
+                     !hasImplicitComputeDtypeUnary(op_type)) ||
+                    in_dtype != dtype;
   unary_shape.comp_type = force_fp32 ? LIBXSMM_DATATYPE_F32 : dtype;
   unary_shape.out_type = dtype;
   unary_shape.ldi = static_cast<libxsmm_blasint>(ldi);
@@ -184,15 +347,41 @@ xsmm_unary_dispatch(const libxsmm_meltw_unary_type op_type,
     printXsmmStruct(unary_shape);
     exit(-1);
   }
+  recordKernel(key, reinterpret_cast<const void *>(kernel));
 
   return reinterpret_cast<int64_t>(kernel);
 }
 
+extern "C" int64_t
+xsmm_unary_dispatch(const libxsmm_meltw_unary_type op_type,
+                    const libxsmm_datatype dtype, int64_t m, int64_t n,
+                    int64_t ldi, int64_t ldo,
+                    const libxsmm_meltw_unary_flags unary_flags) {
+  return dispatchUnary(op_type, dtype, dtype, m, n, ldi, ldo, unary_flags);
+}
+
+// Unary kernel reading `in_dtype` and writing `dtype`, for example an identity
+// converting i32 to f32.
+extern "C" int64_t
+xsmm_unary_convert_dispatch(const libxsmm_meltw_unary_type op_type,
+                            const libxsmm_datatype dtype,
+                            const libxsmm_datatype in_dtype, int64_t m,
+                            int64_t n, int64_t ldi, int64_t ldo,
+                            const libxsmm_meltw_unary_flags unary_flags) {
+  return dispatchUnary(op_type, dtype, in_dtype, m, n, ldi, ldo, unary_flags);
+}
+
 extern "C" int64_t
 xsmm_binary_dispatch(const libxsmm_meltw_binary_type op_type,
                      const libxsmm_datatype dtype, int64_t m, int64_t n,
                      int64_t ldiLhs, int64_t ldiRhs, int64_t ldo,
                      const libxsmm_meltw_binary_flags flags) {
+  countDispatch();
+  XsmmKernelKey key(XsmmKernelKind::BINARY,
+                    {op_type, dtype, m, n, ldiLhs, ldiRhs, ldo, flags});
+  if (void *cached = lookupKernel(key))
+    return reinterpret_cast<int64_t>(cached);
+
   libxsmm_meltw_binary_shape binary_shape;
   // Row major to col major swap m with n.
   binary_shape.m = static_cast<libxsmm_blasint>(n);
@@ -216,6 +405,7 @@ xsmm_binary_dispatch(const libxsmm_meltw_binary_type op_type,
     printXsmmStruct(binary_shape);
     exit(-1);
   }
+  recordKernel(key, reinterpret_cast<const void *>(kernel));
 
   return reinterpret_cast<int64_t>(kernel);
 }
@@ -233,6 +423,21 @@ extern "C" void xsmm_unary_invoke(const libxsmm_datatype dType, int64_t addr,
   kernel(&param);
 }
 
+extern "C" void xsmm_unary_convert_invoke(const libxsmm_datatype dType,
+                                          const libxsmm_datatype inDType,
+                                          int64_t addr, void *alignedPtrIn,
+                                          int64_t offsetIn, void *alignedPtrOut,
+                                          int64_t offsetOut) {
+  libxsmm_meltw_unary_param param;
+
+  param.in.primary = get_base_ptr(inDType, alignedPtrIn, offsetIn);
+  param.out.primary = get_base_ptr(dType, alignedPtrOut, offsetOut);
+
+  libxsmm_meltwfunction_unary kernel =
+      reinterpret_cast<libxsmm_meltwfunction_unary>(addr);
+  kernel(&param);
+}
+
 extern "C" void xsmm_binary_invoke(const libxsmm_datatype dType, int64_t addr,
                                    void *alignedPtrLhs, int64_t offsetLhs,
                                    void *alignedPtrRhs, int64_t offsetRhs,
@@ -248,6 +453,64 @@ extern "C" void xsmm_binary_invoke(const libxsmm_datatype dType, int64_t addr,
   kernel(&param);
 }
 
+extern "C" int64_t
+xsmm_ternary_dispatch(const libxsmm_meltw_ternary_type op_type,
+                      const libxsmm_datatype dtype, int64_t m, int64_t n,
+                      int64_t ldi0, int64_t ldi1, int64_t ldi2, int64_t ldo,
+                      const libxsmm_meltw_ternary_flags flags) {
+  countDispatch();
+  XsmmKernelKey key(XsmmKernelKind::TERNARY,
+                    {op_type, dtype, m, n, ldi0, ldi1, ldi2, ldo, flags});
+  if (void *cached = lookupKernel(key))
+    return reinterpret_cast<int64_t>(cached);
+
+  libxsmm_meltw_ternary_shape ternary_shape;
+  // Row major to col major swap m with n.
+  ternary_shape.m = static_cast<libxsmm_blasint>(n);
+  ternary_shape.n = static_cast<libxsmm_blasint>(m);
+  ternary_shape.in0_type = dtype;
+  ternary_shape.in1_type = dtype;
+  ternary_shape.in2_type = dtype;
+  // Retarget computation type from bf16 to f32 due to missing hardware support.
+  ternary_shape.comp_type =
+      dtype == LIBXSMM_DATATYPE_BF16 ? LIBXSMM_DATATYPE_F32 : dtype;
+  ternary_shape.out_type = dtype;
+  ternary_shape.ldi = static_cast<libxsmm_blasint>(ldi0);
+  ternary_shape.ldi2 = static_cast<libxsmm_blasint>(ldi1);
+  ternary_shape.ldi3 = static_cast<libxsmm_blasint>(ldi2);
+  ternary_shape.ldo = static_cast<libxsmm_blasint>(ldo);
+
+  libxsmm_meltwfunction_ternary kernel =
+      libxsmm_dispatch_meltw_ternary_v2(op_type, ternary_shape, flags);
+  if (!kernel) {
+    fprintf(stderr, "failed to generate ternary func\n");
+    fprintf(stderr, "op_type: %u\n", op_type);
+    fprintf(stderr, "flags: %u\n", flags);
+    printXsmmStruct(ternary_shape);
+    exit(-1);
+  }
+  recordKernel(key, reinterpret_cast<const void *>(kernel));
+
+  return reinterpret_cast<int64_t>(kernel);
+}
+
+extern "C" void xsmm_ternary_invoke(const libxsmm_datatype dType, int64_t addr,
+                                    void *alignedPtrIn0, int64_t offsetIn0,
+                                    void *alignedPtrIn1, int64_t offsetIn1,
+                                    void *alignedPtrIn2, int64_t offsetIn2,
+                                    void *alignedPtrOut, int64_t offsetOut) {
+  libxsmm_meltw_ternary_param param;
+
+  param.in0.primary = get_base_ptr(dType, alignedPtrIn0, offsetIn0);
+  param.in1.primary = get_base_ptr(dType, alignedPtrIn1, offsetIn1);
+  param.in2.primary = get_base_ptr(dType, alignedPtrIn2, offsetIn2);
+  param.out.primary = get_base_ptr(dType, alignedPtrOut, offsetOut);
+
+  libxsmm_meltwfunction_ternary kernel =
+      reinterpret_cast<libxsmm_meltwfunction_ternary>(addr);
+  kernel(&param);
+}
+
 extern "C" void xsmm_unary_scalar_invoke(const libxsmm_datatype dType,
                                          int64_t addr, float input,
                                          void *alignedOut, int64_t offsetOut) {
@@ -274,16 +537,22 @@ extern "C" void xsmm_brgemm_invoke(const libxsmm_datatype dType, int64_t addr,
   // LIBXSMM col-major change A with B.
   gemm_param.a.primary = get_base_ptr(dType, alignedPtrB, offsetB);
   gemm_param.b.primary = get_base_ptr(dType, alignedPtrA, offsetA);
-  gemm_param.c.primary = get_base_ptr(dType, alignedPtrC, offsetC);
+  gemm_param.c.primary =
+      get_base_ptr(get_gemm_out_type(dType), alignedPtrC, offsetC);
 
   sgemm.gemm = reinterpret_cast<libxsmm_gemmfunction>(addr);
   sgemm.gemm(&gemm_param);
 }
 
-extern "C" int64_t xsmm_brgemm_dispatch(const libxsmm_datatype dtype, int64_t m,
-                                        int64_t n, int64_t k, int64_t lda,
-                                        int64_t ldb, int64_t ldc,
-                                        const libxsmm_gemm_flags flags) {
+// Dispatch a BRGEMM kernel. `brType` selects how the batch of A and B blocks
+// is passed at invocation: a fixed stride (derived from the shape), an array of
+// byte offsets from the base pointers or an array of addresses. See
+// `dispatchGemm` for `prefetchFlags`.
+static int64_t dispatchBrgemm(const libxsmm_datatype dtype, int64_t m,
+                              int64_t n, int64_t k, int64_t lda, int64_t ldb,
+                              int64_t ldc, const libxsmm_gemm_flags flags,
+                              libxsmm_bitfield prefetchFlags,
+                              libxsmm_gemm_batch_reduce_type brType) {
   // std::cout << "lda: " << lda << "\n";
   // std::cout << "lbd: " << ldb << "\n";
   // std::cout << "ldc: " << ldc << "\n";
@@ -291,21 +560,24 @@ extern "C" int64_t xsmm_brgemm_dispatch(const libxsmm_datatype dtype, int64_t m,
   // std::cout << "n: " << n << "\n";
   // std::cout << "k: " << k << "\n";
 
+  countDispatch();
+  XsmmKernelKey key(XsmmKernelKind::BRGEMM, {dtype, m, n, k, lda, ldb, ldc,
+                                             flags, prefetchFlags, brType});
+  if (void *cached = lookupKernel(key))
+    return reinterpret_cast<int64_t>(cached);
+
   libxsmm_blasint lda_int = lda;
   libxsmm_blasint ldb_int = ldb;
   libxsmm_blasint ldc_int = ldc;
   libxsmm_blasint m_int = m;
   libxsmm_blasint n_int = n;
   libxsmm_blasint k_int = k;
-  // TODO: move stride computation to dispatch
-  // operation as in: https://github.com/plaidml/plaidml/pull/1983
-  auto typeSize = dtype == LIBXSMM_DATATYPE_F32 ? sizeof(float) : sizeof(bf16);
-  libxsmm_blasint stride_a = lda * m * typeSize;
-  libxsmm_blasint stride_b = ldb * k * typeSize;
+  libxsmm_blasint stride_a, stride_b;
+  get_brgemm_strides(dtype, m, n, k, lda, ldb, flags, stride_a, stride_b);
 
   libxsmm_gemm_shape l_shape;
   libxsmm_bitfield l_flags = flags;
-  libxsmm_bitfield l_prefetch_flags = 0;
+  libxsmm_bitfield l_prefetch_flags = prefetchFlags;
   libxsmm_gemm_batch_reduce_config l_brconfig;
 
   l_shape.m = n_int;
@@ -316,17 +588,22 @@ extern "C" int64_t xsmm_brgemm_dispatch(const libxsmm_datatype dtype, int64_t m,
   l_shape.ldc = ldc_int;
   l_shape.a_in_type = dtype;
   l_shape.b_in_type = dtype;
-  l_shape.out_type = dtype;
+  l_shape.out_type = get_gemm_out_type(dtype);
   // Retarget computation type from bf16 to f32 due to missing hardware support.
-  l_shape.comp_type =
-      dtype == LIBXSMM_DATATYPE_BF16 ? LIBXSMM_DATATYPE_F32 : dtype;
-  l_brconfig.br_type = LIBXSMM_GEMM_BATCH_REDUCE_STRIDE;
-  l_brconfig.br_stride_a_hint = stride_b;
-  l_brconfig.br_stride_b_hint = stride_a;
+  l_shape.comp_type = dtype == LIBXSMM_DATATYPE_BF16
+                          ? LIBXSMM_DATATYPE_F32
+                          : get_gemm_out_type(dtype);
+  l_brconfig.br_type = brType;
+  l_brconfig.br_stride_a_hint =
+      brType == LIBXSMM_GEMM_BATCH_REDUCE_STRIDE ? stride_b : 0;
+  l_brconfig.br_stride_b_hint =
+      brType == LIBXSMM_GEMM_BATCH_REDUCE_STRIDE ? stride_a : 0;
   l_brconfig.br_unroll_hint = 0;
 
   auto sgemm = libxsmm_dispatch_brgemm_v2(l_shape, l_flags, l_prefetch_flags,
                                           l_brconfig);
+  if (!sgemm && l_prefetch_flags)
+    sgemm = libxsmm_dispatch_brgemm_v2(l_shape, l_flags, 0, l_brconfig);
   if (!sgemm) {
     fprintf(stderr, "failed to generate brgemm func\n");
     fprintf(stderr, "dtype: %u\n", dtype);
@@ -334,10 +611,113 @@ extern "C" int64_t xsmm_brgemm_dispatch(const libxsmm_datatype dtype, int64_t m,
     printXsmmStruct(l_brconfig);
     exit(-1);
   }
+  recordKernel(key, reinterpret_cast<const void *>(sgemm));
 
   return reinterpret_cast<int64_t>(sgemm);
 }
 
+extern "C" int64_t xsmm_brgemm_dispatch(const libxsmm_datatype dtype, int64_t m,
+                                        int64_t n, int64_t k, int64_t lda,
+                                        int64_t ldb, int64_t ldc,
+                                        const libxsmm_gemm_flags flags) {
+  return dispatchBrgemm(dtype, m, n, k, lda, ldb, ldc, flags,
+                        LIBXSMM_GEMM_PREFETCH_NONE,
+                        LIBXSMM_GEMM_BATCH_REDUCE_STRIDE);
+}
+
+extern "C" int64_t xsmm_brgemm_prefetch_dispatch(
+    const libxsmm_datatype dtype, int64_t m, int64_t n, int64_t k, int64_t lda,
+    int64_t ldb, int64_t ldc, const libxsmm_gemm_flags flags) {
+  return dispatchBrgemm(dtype, m, n, k, lda, ldb, ldc, flags,
+                        LIBXSMM_GEMM_PREFETCH_AL2BL2_VIA_C,
+                        LIBXSMM_GEMM_BATCH_REDUCE_STRIDE);
+}
+
+extern "C" void xsmm_brgemm_prefetch_invoke(
+    const libxsmm_datatype dType, int64_t addr, void *alignedPtrA,
+    int64_t offsetA, void *alignedPtrB, int64_t offsetB, void *alignedPtrC,
+    int64_t offsetC, void *alignedPtrNextA, int64_t offsetNextA,
+    void *alignedPtrNextB, int64_t offsetNextB, int64_t numBatches) {
+  libxsmm_xmmfunction sgemm;
+  libxsmm_gemm_param gemm_param;
+
+  unsigned long long numBatchesVar = numBatches;
+  gemm_param.op.tertiary = (void *)&numBatchesVar;
+
+  // LIBXSMM col-major change A with B.
+  gemm_param.a.primary = get_base_ptr(dType, alignedPtrB, offsetB);
+  gemm_param.b.primary = get_base_ptr(dType, alignedPtrA, offsetA);
+  gemm_param.c.primary =
+      get_base_ptr(get_gemm_out_type(dType), alignedPtrC, offsetC);
+  gemm_param.a.quaternary = get_base_ptr(dType, alignedPtrNextB, offsetNextB);
+  gemm_param.b.quaternary = get_base_ptr(dType, alignedPtrNextA, offsetNextA);
+
+  sgemm.gemm = reinterpret_cast<libxsmm_gemmfunction>(addr);
+  sgemm.gemm(&gemm_param);
+}
+
+extern "C" int64_t xsmm_brgemm_offs_dispatch(
+    const libxsmm_datatype dtype, int64_t m, int64_t n, int64_t k, int64_t lda,
+    int64_t ldb, int64_t ldc, const libxsmm_gemm_flags flags) {
+  return dispatchBrgemm(dtype, m, n, k, lda, ldb, ldc, flags,
+                        LIBXSMM_GEMM_PREFETCH_NONE,
+                        LIBXSMM_GEMM_BATCH_REDUCE_OFFSET);
+}
+
+// The offsets of the blocks of A and B are in bytes from the respective base
+// pointers, one per batch.
+extern "C" void xsmm_brgemm_offs_invoke(
+    const libxsmm_datatype dType, int64_t addr, void *alignedPtrA,
+    int64_t offsetA, void *alignedPtrB, int64_t offsetB, void *alignedPtrC,
+    int64_t offsetC, void *alignedPtrOffsA, int64_t offsetOffsA,
+    void *alignedPtrOffsB, int64_t offsetOffsB, int64_t numBatches) {
+  libxsmm_xmmfunction sgemm;
+  libxsmm_gemm_param gemm_param;
+
+  unsigned long long numBatchesVar = numBatches;
+  gemm_param.op.tertiary = (void *)&numBatchesVar;
+
+  // LIBXSMM col-major change A with B.
+  gemm_param.a.primary = get_base_ptr(dType, alignedPtrB, offsetB);
+  gemm_param.a.secondary = (unsigned long long *)alignedPtrOffsB + offsetOffsB;
+  gemm_param.b.primary = get_base_ptr(dType, alignedPtrA, offsetA);
+  gemm_param.b.secondary = (unsigned long long *)alignedPtrOffsA + offsetOffsA;
+  gemm_param.c.primary =
+      get_base_ptr(get_gemm_out_type(dType), alignedPtrC, offsetC);
+
+  sgemm.gemm = reinterpret_cast<libxsmm_gemmfunction>(addr);
+  sgemm.gemm(&gemm_param);
+}
+
+extern "C" int64_t xsmm_brgemm_addr_dispatch(
+    const libxsmm_datatype dtype, int64_t m, int64_t n, int64_t k, int64_t lda,
+    int64_t ldb, int64_t ldc, const libxsmm_gemm_flags flags) {
+  return dispatchBrgemm(dtype, m, n, k, lda, ldb, ldc, flags,
+                        LIBXSMM_GEMM_PREFETCH_NONE,
+                        LIBXSMM_GEMM_BATCH_REDUCE_ADDRESS);
+}
+
+// The blocks of A and B are passed as arrays holding one address per batch.
+extern "C" void xsmm_brgemm_addr_invoke(
+    const libxsmm_datatype dType, int64_t addr, void *alignedPtrAddrsA,
+    int64_t offsetAddrsA, void *alignedPtrAddrsB, int64_t offsetAddrsB,
+    void *alignedPtrC, int64_t offsetC, int64_t numBatches) {
+  libxsmm_xmmfunction sgemm;
+  libxsmm_gemm_param gemm_param;
+
+  unsigned long long numBatchesVar = numBatches;
+  gemm_param.op.tertiary = (void *)&numBatchesVar;
+
+  // LIBXSMM col-major change A with B.
+  gemm_param.a.primary = (void **)alignedPtrAddrsB + offsetAddrsB;
+  gemm_param.b.primary = (void **)alignedPtrAddrsA + offsetAddrsA;
+  gemm_param.c.primary =
+      get_base_ptr(get_gemm_out_type(dType), alignedPtrC, offsetC);
+
+  sgemm.gemm = reinterpret_cast<libxsmm_gemmfunction>(addr);
+  sgemm.gemm(&gemm_param);
+}
+
 extern "C" void xsmm_fused_brgemm_invoke(const libxsmm_datatype dType,
                                          int64_t addr, void *alignedPtrA,
                                          int64_t offsetA, void *alignedPtrB,
@@ -375,18 +755,22 @@ xsmm_fused_brgemm_dispatch(const libxsmm_datatype data_type, int64_t m,
   // std::cout << "n: " << n << "\n";
   // std::cout << "k: " << k << "\n";
 
+  countDispatch();
+  XsmmKernelKey key(XsmmKernelKind::FUSED_BRGEMM,
+                    {data_type, m, n, k, lda, ldb, ldc, gemm_flags,
+                     unary_flags, unary_op_type, binary_flags, binary_op_type});
+  if (void *cached = lookupKernel(key))
+    return reinterpret_cast<int64_t>(cached);
+
   libxsmm_blasint lda_int = lda;
   libxsmm_blasint ldb_int = ldb;
   libxsmm_blasint ldc_int = ldc;
   libxsmm_blasint m_int = m;
   libxsmm_blasint n_int = n;
   libxsmm_blasint k_int = k;
-  // TODO: move stride computation to dispatch
-  // operation as in: https://github.com/plaidml/plaidml/pull/1983
-  auto typeSize =
-      data_type == LIBXSMM_DATATYPE_F32 ? sizeof(float) : sizeof(bf16);
-  libxsmm_blasint stride_a = lda * m * typeSize;
-  libxsmm_blasint stride_b = ldb * k * typeSize;
+  libxsmm_blasint stride_a, stride_b;
+  get_brgemm_strides(data_type, m, n, k, lda, ldb, gemm_flags, stride_a,
+                     stride_b);
 
   libxsmm_gemm_shape l_shape;
   libxsmm_bitfield l_flags = gemm_flags;
@@ -434,6 +818,7 @@ xsmm_fused_brgemm_dispatch(const libxsmm_datatype data_type, int64_t m,
     printXsmmStruct(l_brconfig);
     exit(-1);
   }
+  recordKernel(key, reinterpret_cast<const void *>(sgemm));
 
   return reinterpret_cast<int64_t>(sgemm);
 }
@@ -654,6 +1039,21 @@ static void printXsmmStruct(const libxsmm_meltw_binary_shape &binaryShape,
   fprintf(outfile, "ldo: %d\n", binaryShape.ldo);
 }
 
+static void printXsmmStruct(const libxsmm_meltw_ternary_shape &ternaryShape,
+                            FILE *outfile) {
+  fprintf(outfile, "M: %d\n", ternaryShape.m);
+  fprintf(outfile, "N: %d\n", ternaryShape.n);
+  fprintf(outfile, "in0_type: %d\n", ternaryShape.in0_type);
+  fprintf(outfile, "in1_type: %d\n", ternaryShape.in1_type);
+  fprintf(outfile, "in2_type: %d\n", ternaryShape.in2_type);
+  fprintf(outfile, "comp_type: %d\n", ternaryShape.comp_type);
+  fprintf(outfile, "out_type: %d\n", ternaryShape.out_type);
+  fprintf(outfile, "ldi: %d\n", ternaryShape.ldi);
+  fprintf(outfile, "ldi2: %d\n", ternaryShape.ldi2);
+  fprintf(outfile, "ldi3: %d\n", ternaryShape.ldi3);
+  fprintf(outfile, "ldo: %d\n", ternaryShape.ldo);
+}
+
 static void
 printXsmmStruct(const libxsmm_gemm_batch_reduce_config &brgemmConfig,
                 FILE *outfile) {
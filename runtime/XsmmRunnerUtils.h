@@ -27,14 +27,39 @@ extern "C" MLIR_RUNNERUTILS_EXPORT int64_t xsmm_unary_dispatch(
     const libxsmm_meltw_unary_type, const libxsmm_datatype, int64_t, int64_t,
     int64_t, int64_t, const libxsmm_meltw_unary_flags);
 
+extern "C" MLIR_RUNNERUTILS_EXPORT int64_t xsmm_unary_convert_dispatch(
+    const libxsmm_meltw_unary_type, const libxsmm_datatype,
+    const libxsmm_datatype, int64_t, int64_t, int64_t, int64_t,
+    const libxsmm_meltw_unary_flags);
+
 extern "C" MLIR_RUNNERUTILS_EXPORT int64_t xsmm_binary_dispatch(
     const libxsmm_meltw_binary_type, const libxsmm_datatype, int64_t, int64_t,
     int64_t, int64_t, int64_t, const libxsmm_meltw_binary_flags);
 
+extern "C" MLIR_RUNNERUTILS_EXPORT int64_t xsmm_ternary_dispatch(
+    const libxsmm_meltw_ternary_type, const libxsmm_datatype, int64_t, int64_t,
+    int64_t, int64_t, int64_t, int64_t, const libxsmm_meltw_ternary_flags);
+
 extern "C" MLIR_RUNNERUTILS_EXPORT int64_t
 xsmm_brgemm_dispatch(const libxsmm_datatype, int64_t, int64_t, int64_t, int64_t,
                      int64_t, int64_t, const libxsmm_gemm_flags);
 
+extern "C" MLIR_RUNNERUTILS_EXPORT int64_t xsmm_gemm_prefetch_dispatch(
+    const libxsmm_datatype, int64_t, int64_t, int64_t, int64_t, int64_t,
+    int64_t, const libxsmm_gemm_flags);
+
+extern "C" MLIR_RUNNERUTILS_EXPORT int64_t xsmm_brgemm_prefetch_dispatch(
+    const libxsmm_datatype, int64_t, int64_t, int64_t, int64_t, int64_t,
+    int64_t, const libxsmm_gemm_flags);
+
+extern "C" MLIR_RUNNERUTILS_EXPORT int64_t xsmm_brgemm_offs_dispatch(
+    const libxsmm_datatype, int64_t, int64_t, int64_t, int64_t, int64_t,
+    int64_t, const libxsmm_gemm_flags);
+
+extern "C" MLIR_RUNNERUTILS_EXPORT int64_t xsmm_brgemm_addr_dispatch(
+    const libxsmm_datatype, int64_t, int64_t, int64_t, int64_t, int64_t,
+    int64_t, const libxsmm_gemm_flags);
+
 extern "C" MLIR_RUNNERUTILS_EXPORT int64_t xsmm_fused_brgemm_dispatch(
     const libxsmm_datatype data_type, int64_t m, int64_t n, int64_t k,
     int64_t lda, int64_t ldb, int64_t ldc, const libxsmm_gemm_flags gemm_flags,
@@ -53,6 +78,11 @@ xsmm_unary_invoke(const libxsmm_datatype dType, int64_t addr,
                   void *alignedPtrIn, int64_t offsetIn, void *alignedPtrOut,
                   int64_t offsetOut);
 
+extern "C" MLIR_RUNNERUTILS_EXPORT void xsmm_unary_convert_invoke(
+    const libxsmm_datatype dType, const libxsmm_datatype inDType, int64_t addr,
+    void *alignedPtrIn, int64_t offsetIn, void *alignedPtrOut,
+    int64_t offsetOut);
+
 extern "C" MLIR_RUNNERUTILS_EXPORT void
 xsmm_unary_scalar_invoke(const libxsmm_datatype, int64_t addr, float scalar,
                          void *alignedPtrOut, int64_t offsetOut);
@@ -62,12 +92,41 @@ xsmm_binary_invoke(const libxsmm_datatype dType, int64_t addr,
                    void *alignedPtrLhs, int64_t offsetLhs, void *alignedPtrRhs,
                    int64_t offsetRhs, void *alignedPtrOut, int64_t offsetOut);
 
+extern "C" MLIR_RUNNERUTILS_EXPORT void xsmm_ternary_invoke(
+    const libxsmm_datatype dType, int64_t addr, void *alignedPtrIn0,
+    int64_t offsetIn0, void *alignedPtrIn1, int64_t offsetIn1,
+    void *alignedPtrIn2, int64_t offsetIn2, void *alignedPtrOut,
+    int64_t offsetOut);
+
 extern "C" MLIR_RUNNERUTILS_EXPORT void
 xsmm_brgemm_invoke(const libxsmm_datatype dType, int64_t addr,
                    void *alignedPtrA, int64_t offsetA, void *alignedPtrB,
                    int64_t offsetB, void *alignedPtrC, int64_t offsetC,
                    int64_t numBatches);
 
+extern "C" MLIR_RUNNERUTILS_EXPORT void xsmm_gemm_prefetch_invoke(
+    const libxsmm_datatype dType, int64_t addr, void *alignedPtrA,
+    int64_t offsetA, void *alignedPtrB, int64_t offsetB, void *alignedPtrC,
+    int64_t offsetC, void *alignedPtrNextA, int64_t offsetNextA,
+    void *alignedPtrNextB, int64_t offsetNextB);
+
+extern "C" MLIR_RUNNERUTILS_EXPORT void xsmm_brgemm_prefetch_invoke(
+    const libxsmm_datatype dType, int64_t addr, void *alignedPtrA,
+    int64_t offsetA, void *alignedPtrB, int64_t offsetB, void *alignedPtrC,
+    int64_t offsetC, void *alignedPtrNextA, int64_t offsetNextA,
+    void *alignedPtrNextB, int64_t offsetNextB, int64_t numBatches);
+
+extern "C" MLIR_RUNNERUTILS_EXPORT void xsmm_brgemm_offs_invoke(
+    const libxsmm_datatype dType, int64_t addr, void *alignedPtrA,
+    int64_t offsetA, void *alignedPtrB, int64_t offsetB, void *alignedPtrC,
+    int64_t offsetC, void *alignedPtrOffsA, int64_t offsetOffsA,
+    void *alignedPtrOffsB, int64_t offsetOffsB, int64_t numBatches);
+
+extern "C" MLIR_RUNNERUTILS_EXPORT void xsmm_brgemm_addr_invoke(
+    const libxsmm_datatype dType, int64_t addr, void *alignedPtrAddrsA,
+    int64_t offsetAddrsA, void *alignedPtrAddrsB, int64_t offsetAddrsB,
+    void *alignedPtrC, int64_t offsetC, int64_t numBatches);
+
 extern "C" MLIR_RUNNERUTILS_EXPORT void xsmm_fused_brgemm_invoke(
     const libxsmm_datatype dType, int64_t addr, void *alignedPtrA,
     int64_t offsetA, void *alignedPtrB, int64_t offsetB, void *alignedPtrC,
@@ -0,0 +1,66 @@
+// RUN: tpp-opt %s -split-input-file -convert-linalg-to-tpp | FileCheck %s
+
+#map = affine_map<(d0, d1) -> (d0, d1)>
+#map1 = affine_map<(d0, d1) -> (d1)>
+
+func.func @dequantize(%arg0: tensor<32x64xi32>, %scale: tensor<64xf32>,
+                      %bias: tensor<64xf32>, %arg1: tensor<32x64xf32>) -> tensor<32x64xf32> {
+  %0 = linalg.generic {indexing_maps = [#map, #map1, #map1, #map], iterator_types = ["parallel", "parallel"]} ins(%arg0, %scale, %bias : tensor<32x64xi32>, tensor<64xf32>, tensor<64xf32>) outs(%arg1 : tensor<32x64xf32>) {
+    ^bb0(%in: i32, %s: f32, %b: f32, %out: f32):
+      %1 = arith.sitofp %in : i32 to f32
+      %2 = arith.mulf %1, %s : f32
+      %3 = arith.addf %2, %b : f32
+      linalg.yield %3 : f32
+  } -> tensor<32x64xf32>
+  return %0 : tensor<32x64xf32>
+}
+
+// CHECK-LABEL: func.func @dequantize
+// CHECK-SAME:  %[[ARG0:.+]]: tensor<32x64xi32>, %[[SCALE:.+]]: tensor<64xf32>, %[[BIAS:.+]]: tensor<64xf32>
+// CHECK: %{{.+}} = tpp.dequantize (%[[ARG0]] : tensor<32x64xi32>, %[[SCALE]] : tensor<64xf32>, %[[BIAS]] : tensor<64xf32>) -> (tensor<32x64xf32>)
+// CHECK-NOT: linalg.generic
+
+// -----
+
+#map = affine_map<(d0, d1) -> (d0, d1)>
+#map1 = affine_map<(d0, d1) -> (d1)>
+
+func.func @dequantize_relu(%arg0: tensor<32x64xi32>, %scale: tensor<64xbf16>,
+                           %bias: tensor<64xbf16>, %arg1: tensor<32x64xbf16>) -> tensor<32x64xbf16> {
+  %c0 = arith.constant 0.0 : bf16
+  %0 = linalg.generic {indexing_maps = [#map, #map1, #map1, #map], iterator_types = ["parallel", "parallel"]} ins(%arg0, %scale, %bias : tensor<32x64xi32>, tensor<64xbf16>, tensor<64xbf16>) outs(%arg1 : tensor<32x64xbf16>) {
+    ^bb0(%in: i32, %s: bf16, %b: bf16, %out: bf16):
+      %1 = arith.sitofp %in : i32 to bf16
+      %2 = arith.mulf %1, %s : bf16
+      %3 = arith.addf %2, %b : bf16
+      %4 = arith.maxf %3, %c0 : bf16
+      linalg.yield %4 : bf16
+  } -> tensor<32x64xbf16>
+  return %0 : tensor<32x64xbf16>
+}
+
+// CHECK-LABEL: func.func @dequantize_relu
+// CHECK: tpp.dequantize
+// CHECK-SAME: {relu}
+// CHECK-NOT: linalg.generic
+
+// -----
+
+#map = affine_map<(d0, d1) -> (d0, d1)>
+
+// The scale varies per element, not per column: not a dequantization.
+func.func @dequantize_full_scale(%arg0: tensor<32x64xi32>, %scale: tensor<32x64xf32>,
+                                 %bias: tensor<32x64xf32>, %arg1: tensor<32x64xf32>) -> tensor<32x64xf32> {
+  %0 = linalg.generic {indexing_maps = [#map, #map, #map, #map], iterator_types = ["parallel", "parallel"]} ins(%arg0, %scale, %bias : tensor<32x64xi32>, tensor<32x64xf32>, tensor<32x64xf32>) outs(%arg1 : tensor<32x64xf32>) {
+    ^bb0(%in: i32, %s: f32, %b: f32, %out: f32):
+      %1 = arith.sitofp %in : i32 to f32
+      %2 = arith.mulf %1, %s : f32
+      %3 = arith.addf %2, %b : f32
+      linalg.yield %3 : f32
+  } -> tensor<32x64xf32>
+  return %0 : tensor<32x64xf32>
+}
+
+// CHECK-LABEL: func.func @dequantize_full_scale
+// CHECK-NOT: tpp.dequantize
+// CHECK: linalg.generic
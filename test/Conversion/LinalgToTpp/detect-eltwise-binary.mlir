@@ -0,0 +1,94 @@
+// RUN: tpp-opt %s -split-input-file -convert-linalg-to-tpp | FileCheck %s
+
+#map = affine_map<(d0, d1) -> (d0, d1)>
+
+func.func @mul(%arg0: tensor<32x64xf32>, %arg1: tensor<32x64xf32>) -> tensor<32x64xf32> {
+  %0 = linalg.generic {indexing_maps = [#map, #map], iterator_types = ["parallel", "parallel"]} ins(%arg0 : tensor<32x64xf32>) outs(%arg1 : tensor<32x64xf32>) {
+    ^bb0(%in: f32, %out: f32):
+      %1 = arith.mulf %in, %out : f32
+      linalg.yield %1 : f32
+  } -> tensor<32x64xf32>
+  return %0 : tensor<32x64xf32>
+}
+
+// CHECK-LABEL: func.func @mul
+// CHECK-SAME: %[[ARG0:.+]]: tensor<32x64xf32>, %[[ARG1:.+]]: tensor<32x64xf32>
+// CHECK: tpp.mul (%[[ARG0]] : tensor<32x64xf32>, %[[ARG1]] : tensor<32x64xf32>) -> (tensor<32x64xf32>)
+// CHECK-NOT: linalg.generic
+
+// -----
+
+#map = affine_map<(d0, d1) -> (d0, d1)>
+
+// The order of the operands is kept.
+func.func @sub(%arg0: tensor<32x64xf32>, %arg1: tensor<32x64xf32>) -> tensor<32x64xf32> {
+  %0 = linalg.generic {indexing_maps = [#map, #map], iterator_types = ["parallel", "parallel"]} ins(%arg0 : tensor<32x64xf32>) outs(%arg1 : tensor<32x64xf32>) {
+    ^bb0(%in: f32, %out: f32):
+      %1 = arith.subf %out, %in : f32
+      linalg.yield %1 : f32
+  } -> tensor<32x64xf32>
+  return %0 : tensor<32x64xf32>
+}
+
+// CHECK-LABEL: func.func @sub
+// CHECK-SAME: %[[ARG0:.+]]: tensor<32x64xf32>, %[[ARG1:.+]]: tensor<32x64xf32>
+// CHECK: tpp.sub (%[[ARG1]] : tensor<32x64xf32>, %[[ARG0]] : tensor<32x64xf32>) -> (tensor<32x64xf32>)
+// CHECK-NOT: linalg.generic
+
+// -----
+
+#map = affine_map<(d0, d1) -> (d0, d1)>
+#map1 = affine_map<(d0, d1) -> (d0, 0)>
+
+func.func @div_bcast(%arg0: tensor<32x64xf32>, %arg1: tensor<32x1xf32>,
+                     %arg2: tensor<32x64xf32>) -> tensor<32x64xf32> {
+  %0 = linalg.generic {indexing_maps = [#map, #map1, #map], iterator_types = ["parallel", "parallel"]} ins(%arg0, %arg1 : tensor<32x64xf32>, tensor<32x1xf32>) outs(%arg2 : tensor<32x64xf32>) {
+    ^bb0(%in: f32, %in_1: f32, %out: f32):
+      %1 = arith.divf %in, %in_1 : f32
+      linalg.yield %1 : f32
+  } -> tensor<32x64xf32>
+  return %0 : tensor<32x64xf32>
+}
+
+// CHECK-LABEL: func.func @div_bcast
+// CHECK-SAME: %[[ARG0:.+]]: tensor<32x64xf32>, %[[ARG1:.+]]: tensor<32x1xf32>, %[[ARG2:.+]]: tensor<32x64xf32>
+// CHECK: tpp.div (%[[ARG0]] : tensor<32x64xf32>, %[[ARG1]] : tensor<32x1xf32>) -> (tensor<32x64xf32>)
+// CHECK-NOT: linalg.generic
+
+// -----
+
+#map = affine_map<(d0, d1) -> (d0, d1)>
+
+func.func @max(%arg0: tensor<32x64xf32>, %arg1: tensor<32x64xf32>,
+               %arg2: tensor<32x64xf32>) -> tensor<32x64xf32> {
+  %0 = linalg.generic {indexing_maps = [#map, #map, #map], iterator_types = ["parallel", "parallel"]} ins(%arg0, %arg1 : tensor<32x64xf32>, tensor<32x64xf32>) outs(%arg2 : tensor<32x64xf32>) {
+    ^bb0(%in: f32, %in_1: f32, %out: f32):
+      %1 = arith.maxf %in, %in_1 : f32
+      linalg.yield %1 : f32
+  } -> tensor<32x64xf32>
+  return %0 : tensor<32x64xf32>
+}
+
+// CHECK-LABEL: func.func @max
+// CHECK-SAME: %[[ARG0:.+]]: tensor<32x64xf32>, %[[ARG1:.+]]: tensor<32x64xf32>, %[[ARG2:.+]]: tensor<32x64xf32>
+// CHECK: tpp.max (%[[ARG0]] : tensor<32x64xf32>, %[[ARG1]] : tensor<32x64xf32>) -> (tensor<32x64xf32>)
+// CHECK-NOT: linalg.generic
+
+// -----
+
+#map = affine_map<(d0, d1) -> (d0, d1)>
+
+// A max against zero is still a relu.
+func.func @max_zero(%arg0: tensor<32x64xf32>, %arg1: tensor<32x64xf32>) -> tensor<32x64xf32> {
+  %cst = arith.constant 0.0 : f32
+  %0 = linalg.generic {indexing_maps = [#map, #map], iterator_types = ["parallel", "parallel"]} ins(%arg0 : tensor<32x64xf32>) outs(%arg1 : tensor<32x64xf32>) {
+    ^bb0(%in: f32, %out: f32):
+      %1 = arith.maxf %in, %cst : f32
+      linalg.yield %1 : f32
+  } -> tensor<32x64xf32>
+  return %0 : tensor<32x64xf32>
+}
+
+// CHECK-LABEL: func.func @max_zero
+// CHECK: tpp.relu
+// CHECK-NOT: tpp.max
@@ -0,0 +1,127 @@
+// RUN: tpp-opt %s -split-input-file -convert-linalg-to-tpp | FileCheck %s
+
+#map = affine_map<(d0, d1) -> (d0, d1)>
+
+func.func @gelu(%arg0: tensor<32x64xf32>, %arg1: tensor<32x64xf32>) -> tensor<32x64xf32> {
+  %half = arith.constant 0.5 : f32
+  %one = arith.constant 1.0 : f32
+  %rsqrt2 = arith.constant 0.707106769 : f32
+  %0 = linalg.generic {indexing_maps = [#map, #map], iterator_types = ["parallel", "parallel"]} ins(%arg0 : tensor<32x64xf32>) outs(%arg1 : tensor<32x64xf32>) {
+    ^bb0(%in: f32, %out: f32):
+      %1 = arith.mulf %in, %rsqrt2 : f32
+      %2 = math.erf %1 : f32
+      %3 = arith.addf %2, %one : f32
+      %4 = arith.mulf %in, %3 : f32
+      %5 = arith.mulf %4, %half : f32
+      linalg.yield %5 : f32
+  } -> tensor<32x64xf32>
+  return %0 : tensor<32x64xf32>
+}
+
+// CHECK-LABEL: func.func @gelu
+// CHECK-SAME: %[[ARG0:.+]]: tensor<32x64xf32>, %[[ARG1:.+]]: tensor<32x64xf32>
+// CHECK: tpp.gelu (%[[ARG0]] : tensor<32x64xf32>) -> (tensor<32x64xf32>)
+// CHECK-NOT: linalg.generic
+
+// -----
+
+#map = affine_map<(d0, d1) -> (d0, d1)>
+
+// Same as above, with a different association and a division.
+func.func @gelu_div(%arg0: tensor<32x64xf32>, %arg1: tensor<32x64xf32>) -> tensor<32x64xf32> {
+  %half = arith.constant 0.5 : f32
+  %one = arith.constant 1.0 : f32
+  %sqrt2 = arith.constant 1.41421354 : f32
+  %0 = linalg.generic {indexing_maps = [#map, #map], iterator_types = ["parallel", "parallel"]} ins(%arg0 : tensor<32x64xf32>) outs(%arg1 : tensor<32x64xf32>) {
+    ^bb0(%in: f32, %out: f32):
+      %1 = arith.divf %in, %sqrt2 : f32
+      %2 = math.erf %1 : f32
+      %3 = arith.addf %one, %2 : f32
+      %4 = arith.mulf %half, %in : f32
+      %5 = arith.mulf %4, %3 : f32
+      linalg.yield %5 : f32
+  } -> tensor<32x64xf32>
+  return %0 : tensor<32x64xf32>
+}
+
+// CHECK-LABEL: func.func @gelu_div
+// CHECK: tpp.gelu
+
+// -----
+
+#map = affine_map<(d0, d1) -> (d0, d1)>
+
+// Not a gelu, the erf argument is not scaled by 1/sqrt(2).
+func.func @not_gelu(%arg0: tensor<32x64xf32>, %arg1: tensor<32x64xf32>) -> tensor<32x64xf32> {
+  %half = arith.constant 0.5 : f32
+  %one = arith.constant 1.0 : f32
+  %0 = linalg.generic {indexing_maps = [#map, #map], iterator_types = ["parallel", "parallel"]} ins(%arg0 : tensor<32x64xf32>) outs(%arg1 : tensor<32x64xf32>) {
+    ^bb0(%in: f32, %out: f32):
+      %2 = math.erf %in : f32
+      %3 = arith.addf %2, %one : f32
+      %4 = arith.mulf %in, %3 : f32
+      %5 = arith.mulf %4, %half : f32
+      linalg.yield %5 : f32
+  } -> tensor<32x64xf32>
+  return %0 : tensor<32x64xf32>
+}
+
+// CHECK-LABEL: func.func @not_gelu
+// CHECK-NOT: tpp.gelu
+// CHECK: linalg.generic
+
+// -----
+
+#map = affine_map<(d0, d1) -> (d0, d1)>
+
+func.func @tanh(%arg0: tensor<32x64xf32>) -> tensor<32x64xf32> {
+  %0 = linalg.generic {indexing_maps = [#map], iterator_types = ["parallel", "parallel"]} outs(%arg0 : tensor<32x64xf32>) {
+    ^bb0(%out: f32):
+      %1 = math.tanh %out : f32
+      linalg.yield %1 : f32
+  } -> tensor<32x64xf32>
+  return %0 : tensor<32x64xf32>
+}
+
+// CHECK-LABEL: func.func @tanh
+// CHECK-SAME: %[[ARG0:.+]]: tensor<32x64xf32>
+// CHECK: tpp.tanh (%[[ARG0]] : tensor<32x64xf32>) -> (tensor<32x64xf32>)
+
+// -----
+
+#map = affine_map<(d0, d1) -> (d0, d1)>
+
+func.func @sigmoid(%arg0: tensor<32x64xf32>, %arg1: tensor<32x64xf32>) -> tensor<32x64xf32> {
+  %one = arith.constant 1.0 : f32
+  %0 = linalg.generic {indexing_maps = [#map, #map], iterator_types = ["parallel", "parallel"]} ins(%arg0 : tensor<32x64xf32>) outs(%arg1 : tensor<32x64xf32>) {
+    ^bb0(%in: f32, %out: f32):
+      %1 = arith.negf %in : f32
+      %2 = math.exp %1 : f32
+      %3 = arith.addf %2, %one : f32
+      %4 = arith.divf %one, %3 : f32
+      linalg.yield %4 : f32
+  } -> tensor<32x64xf32>
+  return %0 : tensor<32x64xf32>
+}
+
+// CHECK-LABEL: func.func @sigmoid
+// CHECK-SAME: %[[ARG0:.+]]: tensor<32x64xf32>, %[[ARG1:.+]]: tensor<32x64xf32>
+// CHECK: tpp.sigmoid (%[[ARG0]] : tensor<32x64xf32>) -> (tensor<32x64xf32>)
+
+// -----
+
+#map = affine_map<(d0, d1) -> (d0, d1)>
+#map1 = affine_map<(d0, d1) -> (d1)>
+
+func.func @exp_bcast(%arg0: tensor<64xf32>, %arg1: tensor<32x64xf32>) -> tensor<32x64xf32> {
+  %0 = linalg.generic {indexing_maps = [#map1, #map], iterator_types = ["parallel", "parallel"]} ins(%arg0 : tensor<64xf32>) outs(%arg1 : tensor<32x64xf32>) {
+    ^bb0(%in: f32, %out: f32):
+      %1 = math.exp %in : f32
+      linalg.yield %1 : f32
+  } -> tensor<32x64xf32>
+  return %0 : tensor<32x64xf32>
+}
+
+// CHECK-LABEL: func.func @exp_bcast
+// CHECK-SAME: %[[ARG0:.+]]: tensor<64xf32>, %[[ARG1:.+]]: tensor<32x64xf32>
+// CHECK: tpp.exp (%[[ARG0]] : tensor<64xf32>) -> (tensor<32x64xf32>)
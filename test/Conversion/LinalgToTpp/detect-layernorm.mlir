@@ -0,0 +1,152 @@
+// RUN: tpp-opt %s -split-input-file -convert-normalization-to-tpp | FileCheck %s
+
+#map = affine_map<(d0, d1) -> (d0, d1)>
+#map1 = affine_map<(d0, d1) -> (d0, 0)>
+#map2 = affine_map<(d0, d1) -> (d1)>
+
+func.func @layernorm(%arg0: tensor<32x64xf32>, %gamma: tensor<64xf32>,
+                     %beta: tensor<64xf32>, %arg1: tensor<32x64xf32>) -> tensor<32x64xf32> {
+  %cst = arith.constant 0.0 : f32
+  %n = arith.constant 64.0 : f32
+  %eps = arith.constant 1.0e-05 : f32
+  %0 = tensor.empty() : tensor<32x1xf32>
+  %1 = linalg.fill ins(%cst : f32) outs(%0 : tensor<32x1xf32>) -> tensor<32x1xf32>
+  %2 = tensor.empty() : tensor<32x64xf32>
+  // mean = sum(x) / N
+  %sum = linalg.generic {indexing_maps = [#map, #map1], iterator_types = ["parallel", "reduction"]} ins(%arg0 : tensor<32x64xf32>) outs(%1 : tensor<32x1xf32>) {
+    ^bb0(%in: f32, %out: f32):
+      %r = arith.addf %in, %out : f32
+      linalg.yield %r : f32
+  } -> tensor<32x1xf32>
+  %mean = linalg.generic {indexing_maps = [#map, #map], iterator_types = ["parallel", "parallel"]} ins(%sum : tensor<32x1xf32>) outs(%0 : tensor<32x1xf32>) {
+    ^bb0(%in: f32, %out: f32):
+      %r = arith.divf %in, %n : f32
+      linalg.yield %r : f32
+  } -> tensor<32x1xf32>
+  // c = x - mean
+  %c = linalg.generic {indexing_maps = [#map, #map1, #map], iterator_types = ["parallel", "parallel"]} ins(%arg0, %mean : tensor<32x64xf32>, tensor<32x1xf32>) outs(%2 : tensor<32x64xf32>) {
+    ^bb0(%in: f32, %in_0: f32, %out: f32):
+      %r = arith.subf %in, %in_0 : f32
+      linalg.yield %r : f32
+  } -> tensor<32x64xf32>
+  // var = sum(c * c) / N
+  %sq = linalg.generic {indexing_maps = [#map, #map], iterator_types = ["parallel", "parallel"]} ins(%c : tensor<32x64xf32>) outs(%2 : tensor<32x64xf32>) {
+    ^bb0(%in: f32, %out: f32):
+      %r = arith.mulf %in, %in : f32
+      linalg.yield %r : f32
+  } -> tensor<32x64xf32>
+  %sqsum = linalg.generic {indexing_maps = [#map, #map1], iterator_types = ["parallel", "reduction"]} ins(%sq : tensor<32x64xf32>) outs(%1 : tensor<32x1xf32>) {
+    ^bb0(%in: f32, %out: f32):
+      %r = arith.addf %in, %out : f32
+      linalg.yield %r : f32
+  } -> tensor<32x1xf32>
+  %var = linalg.generic {indexing_maps = [#map, #map], iterator_types = ["parallel", "parallel"]} ins(%sqsum : tensor<32x1xf32>) outs(%0 : tensor<32x1xf32>) {
+    ^bb0(%in: f32, %out: f32):
+      %r = arith.divf %in, %n : f32
+      linalg.yield %r : f32
+  } -> tensor<32x1xf32>
+  // rstd = rsqrt(var + eps)
+  %rstd = linalg.generic {indexing_maps = [#map, #map], iterator_types = ["parallel", "parallel"]} ins(%var : tensor<32x1xf32>) outs(%0 : tensor<32x1xf32>) {
+    ^bb0(%in: f32, %out: f32):
+      %a = arith.addf %in, %eps : f32
+      %r = math.rsqrt %a : f32
+      linalg.yield %r : f32
+  } -> tensor<32x1xf32>
+  // y = c * rstd * gamma + beta
+  %norm = linalg.generic {indexing_maps = [#map, #map1, #map], iterator_types = ["parallel", "parallel"]} ins(%c, %rstd : tensor<32x64xf32>, tensor<32x1xf32>) outs(%2 : tensor<32x64xf32>) {
+    ^bb0(%in: f32, %in_0: f32, %out: f32):
+      %r = arith.mulf %in, %in_0 : f32
+      linalg.yield %r : f32
+  } -> tensor<32x64xf32>
+  %scaled = linalg.generic {indexing_maps = [#map, #map2, #map], iterator_types = ["parallel", "parallel"]} ins(%norm, %gamma : tensor<32x64xf32>, tensor<64xf32>) outs(%2 : tensor<32x64xf32>) {
+    ^bb0(%in: f32, %in_0: f32, %out: f32):
+      %r = arith.mulf %in, %in_0 : f32
+      linalg.yield %r : f32
+  } -> tensor<32x64xf32>
+  %res = linalg.generic {indexing_maps = [#map2, #map, #map], iterator_types = ["parallel", "parallel"]} ins(%beta, %scaled : tensor<64xf32>, tensor<32x64xf32>) outs(%arg1 : tensor<32x64xf32>) {
+    ^bb0(%in: f32, %in_0: f32, %out: f32):
+      %r = arith.addf %in, %in_0 : f32
+      linalg.yield %r : f32
+  } -> tensor<32x64xf32>
+  return %res : tensor<32x64xf32>
+}
+
+// CHECK-LABEL: func.func @layernorm
+// CHECK-SAME: %[[ARG0:[^:]+]]: tensor<32x64xf32>, %[[GAMMA:[^:]+]]: tensor<64xf32>, %[[BETA:[^:]+]]: tensor<64xf32>
+// CHECK-NOT: linalg.generic
+// CHECK: %[[NORM:.+]] = tpp.layernorm (%[[ARG0]] : tensor<32x64xf32>, %[[GAMMA]] : tensor<64xf32>, %[[BETA]] : tensor<64xf32>) -> (tensor<32x64xf32>) {epsilon = 9.99999974E-6 : f32}
+// CHECK-NOT: linalg.generic
+// CHECK: return %[[NORM]]
+
+// -----
+
+#map = affine_map<(d0, d1) -> (d0, d1)>
+#map1 = affine_map<(d0, d1) -> (d0, 0)>
+#map2 = affine_map<(d0, d1) -> (d1)>
+
+// The variance is not computed around the mean: not a layer norm.
+func.func @not_layernorm(%arg0: tensor<32x64xf32>, %gamma: tensor<64xf32>,
+                         %beta: tensor<64xf32>, %arg1: tensor<32x64xf32>) -> tensor<32x64xf32> {
+  %cst = arith.constant 0.0 : f32
+  %n = arith.constant 64.0 : f32
+  %eps = arith.constant 1.0e-05 : f32
+  %0 = tensor.empty() : tensor<32x1xf32>
+  %1 = linalg.fill ins(%cst : f32) outs(%0 : tensor<32x1xf32>) -> tensor<32x1xf32>
+  %2 = tensor.empty() : tensor<32x64xf32>
+  %sum = linalg.generic {indexing_maps = [#map, #map1], iterator_types = ["parallel", "reduction"]} ins(%arg0 : tensor<32x64xf32>) outs(%1 : tensor<32x1xf32>) {
+    ^bb0(%in: f32, %out: f32):
+      %r = arith.addf %in, %out : f32
+      linalg.yield %r : f32
+  } -> tensor<32x1xf32>
+  %mean = linalg.generic {indexing_maps = [#map, #map], iterator_types = ["parallel", "parallel"]} ins(%sum : tensor<32x1xf32>) outs(%0 : tensor<32x1xf32>) {
+    ^bb0(%in: f32, %out: f32):
+      %r = arith.divf %in, %n : f32
+      linalg.yield %r : f32
+  } -> tensor<32x1xf32>
+  %c = linalg.generic {indexing_maps = [#map, #map1, #map], iterator_types = ["parallel", "parallel"]} ins(%arg0, %mean : tensor<32x64xf32>, tensor<32x1xf32>) outs(%2 : tensor<32x64xf32>) {
+    ^bb0(%in: f32, %in_0: f32, %out: f32):
+      %r = arith.subf %in, %in_0 : f32
+      linalg.yield %r : f32
+  } -> tensor<32x64xf32>
+  %sq = linalg.generic {indexing_maps = [#map, #map], iterator_types = ["parallel", "parallel"]} ins(%arg0 : tensor<32x64xf32>) outs(%2 : tensor<32x64xf32>) {
+    ^bb0(%in: f32, %out: f32):
+      %r = arith.mulf %in, %in : f32
+      linalg.yield %r : f32
+  } -> tensor<32x64xf32>
+  %sqsum = linalg.generic {indexing_maps = [#map, #map1], iterator_types = ["parallel", "reduction"]} ins(%sq : tensor<32x64xf32>) outs(%1 : tensor<32x1xf32>) {
+    ^bb0(%in: f32, %out: f32):
+      %r = arith.addf %in, %out : f32
+      linalg.yield %r : f32
+  } -> tensor<32x1xf32>
+  %var = linalg.generic {indexing_maps = [#map, #map], iterator_types = ["parallel", "parallel"]} ins(%sqsum : tensor<32x1xf32>) outs(%0 : tensor<32x1xf32>) {
+    ^bb0(%in: f32, %out: f32):
+      %r = arith.divf %in, %n : f32
+      linalg.yield %r : f32
+  } -> tensor<32x1xf32>
+  %rstd = linalg.generic {indexing_maps = [#map, #map], iterator_types = ["parallel", "parallel"]} ins(%var : tensor<32x1xf32>) outs(%0 : tensor<32x1xf32>) {
+    ^bb0(%in: f32, %out: f32):
+      %a = arith.addf %in, %eps : f32
+      %r = math.rsqrt %a : f32
+      linalg.yield %r : f32
+  } -> tensor<32x1xf32>
+  %norm = linalg.generic {indexing_maps = [#map, #map1, #map], iterator_types = ["parallel", "parallel"]} ins(%c, %rstd : tensor<32x64xf32>, tensor<32x1xf32>) outs(%2 : tensor<32x64xf32>) {
+    ^bb0(%in: f32, %in_0: f32, %out: f32):
+      %r = arith.mulf %in, %in_0 : f32
+      linalg.yield %r : f32
+  } -> tensor<32x64xf32>
+  %scaled = linalg.generic {indexing_maps = [#map, #map2, #map], iterator_types = ["parallel", "parallel"]} ins(%norm, %gamma : tensor<32x64xf32>, tensor<64xf32>) outs(%2 : tensor<32x64xf32>) {
+    ^bb0(%in: f32, %in_0: f32, %out: f32):
+      %r = arith.mulf %in, %in_0 : f32
+      linalg.yield %r : f32
+  } -> tensor<32x64xf32>
+  %res = linalg.generic {indexing_maps = [#map2, #map, #map], iterator_types = ["parallel", "parallel"]} ins(%beta, %scaled : tensor<64xf32>, tensor<32x64xf32>) outs(%arg1 : tensor<32x64xf32>) {
+    ^bb0(%in: f32, %in_0: f32, %out: f32):
+      %r = arith.addf %in, %in_0 : f32
+      linalg.yield %r : f32
+  } -> tensor<32x64xf32>
+  return %res : tensor<32x64xf32>
+}
+
+// CHECK-LABEL: func.func @not_layernorm
+// CHECK-NOT: tpp.layernorm
+// CHECK: linalg.generic
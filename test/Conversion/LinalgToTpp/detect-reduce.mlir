@@ -0,0 +1,122 @@
+// RUN: tpp-opt %s -split-input-file -convert-linalg-to-tpp | FileCheck %s
+
+#map = affine_map<(d0, d1) -> (d0, d1)>
+#map1 = affine_map<(d0, d1) -> (d0, 0)>
+
+func.func @reduce_add_rows(%arg0: tensor<32x64xf32>) -> tensor<32x1xf32> {
+  %cst = arith.constant 0.0 : f32
+  %0 = tensor.empty() : tensor<32x1xf32>
+  %1 = linalg.fill ins(%cst : f32) outs(%0 : tensor<32x1xf32>) -> tensor<32x1xf32>
+  %2 = linalg.generic {indexing_maps = [#map, #map1], iterator_types = ["parallel", "reduction"]} ins(%arg0 : tensor<32x64xf32>) outs(%1 : tensor<32x1xf32>) {
+    ^bb0(%in: f32, %out: f32):
+      %3 = arith.addf %in, %out : f32
+      linalg.yield %3 : f32
+  } -> tensor<32x1xf32>
+  return %2 : tensor<32x1xf32>
+}
+
+// CHECK-LABEL: func.func @reduce_add_rows
+// CHECK-SAME: %[[ARG0:.+]]: tensor<32x64xf32>
+// CHECK: %[[RED:.+]] = tpp.reduce_add (%[[ARG0]] : tensor<32x64xf32>) -> (tensor<32x1xf32>)
+// CHECK-NOT: tpp.add
+// CHECK: return %[[RED]]
+
+// -----
+
+func.func @reduce_add_cols(%arg0: tensor<32x64xf32>) -> tensor<64xf32> {
+  %cst = arith.constant 0.0 : f32
+  %0 = tensor.empty() : tensor<64xf32>
+  %1 = linalg.fill ins(%cst : f32) outs(%0 : tensor<64xf32>) -> tensor<64xf32>
+  %2 = linalg.reduce ins(%arg0 : tensor<32x64xf32>) outs(%1 : tensor<64xf32>) dimensions = [0]
+    (%in: f32, %out: f32) {
+      %3 = arith.addf %out, %in : f32
+      linalg.yield %3 : f32
+    }
+  return %2 : tensor<64xf32>
+}
+
+// CHECK-LABEL: func.func @reduce_add_cols
+// CHECK-SAME: %[[ARG0:.+]]: tensor<32x64xf32>
+// CHECK: %[[RED:.+]] = tpp.reduce_add (%[[ARG0]] : tensor<32x64xf32>) -> (tensor<1x64xf32>)
+// CHECK: %[[COLLAPSE:.+]] = tensor.collapse_shape %[[RED]] {{\[}}[0, 1]] : tensor<1x64xf32> into tensor<64xf32>
+// CHECK: return %[[COLLAPSE]]
+
+// -----
+
+func.func @reduce_max_rows(%arg0: tensor<32x64xf32>) -> tensor<32xf32> {
+  %cst = arith.constant 0xFF800000 : f32
+  %0 = tensor.empty() : tensor<32xf32>
+  %1 = linalg.fill ins(%cst : f32) outs(%0 : tensor<32xf32>) -> tensor<32xf32>
+  %2 = linalg.reduce ins(%arg0 : tensor<32x64xf32>) outs(%1 : tensor<32xf32>) dimensions = [1]
+    (%in: f32, %out: f32) {
+      %3 = arith.maxf %in, %out : f32
+      linalg.yield %3 : f32
+    }
+  return %2 : tensor<32xf32>
+}
+
+// CHECK-LABEL: func.func @reduce_max_rows
+// CHECK-SAME: %[[ARG0:.+]]: tensor<32x64xf32>
+// CHECK: %[[RED:.+]] = tpp.reduce_max (%[[ARG0]] : tensor<32x64xf32>) -> (tensor<32x1xf32>)
+// CHECK-NOT: tpp.max
+// CHECK: %[[COLLAPSE:.+]] = tensor.collapse_shape %[[RED]] {{\[}}[0, 1]] : tensor<32x1xf32> into tensor<32xf32>
+// CHECK: return %[[COLLAPSE]]
+
+// -----
+
+#map = affine_map<(d0, d1) -> (d0, d1)>
+#map1 = affine_map<(d0, d1) -> (0, d1)>
+
+// Tpp reductions overwrite their output: accumulate into the init explicitly.
+func.func @reduce_max_cols_init(%arg0: tensor<32x64xf32>, %arg1: tensor<1x64xf32>) -> tensor<1x64xf32> {
+  %0 = linalg.generic {indexing_maps = [#map, #map1], iterator_types = ["reduction", "parallel"]} ins(%arg0 : tensor<32x64xf32>) outs(%arg1 : tensor<1x64xf32>) {
+    ^bb0(%in: f32, %out: f32):
+      %1 = arith.maxf %in, %out : f32
+      linalg.yield %1 : f32
+  } -> tensor<1x64xf32>
+  return %0 : tensor<1x64xf32>
+}
+
+// CHECK-LABEL: func.func @reduce_max_cols_init
+// CHECK-SAME: %[[ARG0:.+]]: tensor<32x64xf32>, %[[ARG1:.+]]: tensor<1x64xf32>
+// CHECK: %[[RED:.+]] = tpp.reduce_max (%[[ARG0]] : tensor<32x64xf32>) -> (tensor<1x64xf32>)
+// CHECK: %[[MAX:.+]] = tpp.max (%[[RED]] : tensor<1x64xf32>, %[[ARG1]] : tensor<1x64xf32>) -> (tensor<1x64xf32>)
+// CHECK: return %[[MAX]]
+
+// -----
+
+func.func @reduce_add_init_1d(%arg0: tensor<32x64xf32>, %arg1: tensor<32xf32>) -> tensor<32xf32> {
+  %0 = linalg.reduce ins(%arg0 : tensor<32x64xf32>) outs(%arg1 : tensor<32xf32>) dimensions = [1]
+    (%in: f32, %out: f32) {
+      %1 = arith.addf %in, %out : f32
+      linalg.yield %1 : f32
+    }
+  return %0 : tensor<32xf32>
+}
+
+// CHECK-LABEL: func.func @reduce_add_init_1d
+// CHECK-SAME: %[[ARG0:.+]]: tensor<32x64xf32>, %[[ARG1:.+]]: tensor<32xf32>
+// CHECK: %[[RED:.+]] = tpp.reduce_add (%[[ARG0]] : tensor<32x64xf32>) -> (tensor<32x1xf32>)
+// CHECK: %[[EXPAND:.+]] = tensor.expand_shape %[[ARG1]] {{\[}}[0, 1]] : tensor<32xf32> into tensor<32x1xf32>
+// CHECK: %[[ADD:.+]] = tpp.add (%[[RED]] : tensor<32x1xf32>, %[[EXPAND]] : tensor<32x1xf32>) -> (tensor<32x1xf32>)
+// CHECK: %[[COLLAPSE:.+]] = tensor.collapse_shape %[[ADD]] {{\[}}[0, 1]] : tensor<32x1xf32> into tensor<32xf32>
+// CHECK: return %[[COLLAPSE]]
+
+// -----
+
+#map = affine_map<(d0, d1) -> (d0, d1)>
+#map1 = affine_map<(d0, d1) -> (d0, 0)>
+
+// There is no tpp product reduction.
+func.func @reduce_mul(%arg0: tensor<32x64xf32>, %arg1: tensor<32x1xf32>) -> tensor<32x1xf32> {
+  %0 = linalg.generic {indexing_maps = [#map, #map1], iterator_types = ["parallel", "reduction"]} ins(%arg0 : tensor<32x64xf32>) outs(%arg1 : tensor<32x1xf32>) {
+    ^bb0(%in: f32, %out: f32):
+      %1 = arith.mulf %in, %out : f32
+      linalg.yield %1 : f32
+  } -> tensor<32x1xf32>
+  return %0 : tensor<32x1xf32>
+}
+
+// CHECK-LABEL: func.func @reduce_mul
+// CHECK-NOT: tpp.reduce
+// CHECK: linalg.generic
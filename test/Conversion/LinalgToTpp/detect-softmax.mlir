@@ -0,0 +1,121 @@
+// RUN: tpp-opt %s -split-input-file -convert-normalization-to-tpp | FileCheck %s
+
+#map = affine_map<(d0, d1) -> (d0, d1)>
+#map1 = affine_map<(d0, d1) -> (d0, 0)>
+
+// Softmax as emitted by mlir-gen.
+func.func @softmax(%arg0: tensor<32x64xf32>, %arg1: tensor<32x64xf32>) -> tensor<32x64xf32> {
+  %cst = arith.constant 0.0 : f32
+  %0 = tensor.empty() : tensor<32x64xf32>
+  %1 = linalg.generic {indexing_maps = [#map, #map], iterator_types = ["parallel", "parallel"]} ins(%arg0 : tensor<32x64xf32>) outs(%0 : tensor<32x64xf32>) {
+    ^bb0(%in: f32, %out: f32):
+      %9 = math.exp %in : f32
+      linalg.yield %9 : f32
+  } -> tensor<32x64xf32>
+  %2 = tensor.empty() : tensor<32x1xf32>
+  %3 = linalg.fill ins(%cst : f32) outs(%2 : tensor<32x1xf32>) -> tensor<32x1xf32>
+  %4 = linalg.generic {indexing_maps = [#map, #map1], iterator_types = ["parallel", "reduction"]} ins(%1 : tensor<32x64xf32>) outs(%3 : tensor<32x1xf32>) {
+    ^bb0(%in: f32, %out: f32):
+      %9 = arith.addf %in, %out : f32
+      linalg.yield %9 : f32
+  } -> tensor<32x1xf32>
+  %5 = tensor.empty() : tensor<32x64xf32>
+  %6 = linalg.generic {indexing_maps = [#map1, #map], iterator_types = ["parallel", "parallel"]} ins(%4 : tensor<32x1xf32>) outs(%5 : tensor<32x64xf32>) {
+    ^bb0(%in: f32, %out: f32):
+      linalg.yield %in : f32
+  } -> tensor<32x64xf32>
+  %7 = linalg.generic {indexing_maps = [#map, #map, #map], iterator_types = ["parallel", "parallel"]} ins(%1, %6 : tensor<32x64xf32>, tensor<32x64xf32>) outs(%arg1 : tensor<32x64xf32>) {
+    ^bb0(%in: f32, %in_0: f32, %out: f32):
+      %9 = arith.divf %in, %in_0 : f32
+      linalg.yield %9 : f32
+  } -> tensor<32x64xf32>
+  return %7 : tensor<32x64xf32>
+}
+
+// CHECK-LABEL: func.func @softmax
+// CHECK-SAME: %[[ARG0:.+]]: tensor<32x64xf32>, %[[ARG1:.+]]: tensor<32x64xf32>
+// CHECK-NOT: linalg.generic
+// CHECK: %[[SOFTMAX:.+]] = tpp.softmax (%[[ARG0]] : tensor<32x64xf32>) -> (tensor<32x64xf32>)
+// CHECK-NOT: linalg.generic
+// CHECK: return %[[SOFTMAX]]
+
+// -----
+
+#map = affine_map<(d0, d1) -> (d0, d1)>
+#map1 = affine_map<(d0, d1) -> (d0, 0)>
+
+// Softmax stabilized by the row maximum, divided by the Mx1 sums directly.
+func.func @softmax_max(%arg0: tensor<32x64xf32>, %arg1: tensor<32x64xf32>) -> tensor<32x64xf32> {
+  %cst = arith.constant 0.0 : f32
+  %cst_0 = arith.constant 0xFF800000 : f32
+  %0 = tensor.empty() : tensor<32x1xf32>
+  %1 = linalg.fill ins(%cst_0 : f32) outs(%0 : tensor<32x1xf32>) -> tensor<32x1xf32>
+  %2 = linalg.generic {indexing_maps = [#map, #map1], iterator_types = ["parallel", "reduction"]} ins(%arg0 : tensor<32x64xf32>) outs(%1 : tensor<32x1xf32>) {
+    ^bb0(%in: f32, %out: f32):
+      %9 = arith.maxf %in, %out : f32
+      linalg.yield %9 : f32
+  } -> tensor<32x1xf32>
+  %3 = tensor.empty() : tensor<32x64xf32>
+  %4 = linalg.generic {indexing_maps = [#map, #map1, #map], iterator_types = ["parallel", "parallel"]} ins(%arg0, %2 : tensor<32x64xf32>, tensor<32x1xf32>) outs(%3 : tensor<32x64xf32>) {
+    ^bb0(%in: f32, %in_1: f32, %out: f32):
+      %9 = arith.subf %in, %in_1 : f32
+      linalg.yield %9 : f32
+  } -> tensor<32x64xf32>
+  %5 = linalg.generic {indexing_maps = [#map, #map], iterator_types = ["parallel", "parallel"]} ins(%4 : tensor<32x64xf32>) outs(%3 : tensor<32x64xf32>) {
+    ^bb0(%in: f32, %out: f32):
+      %9 = math.exp %in : f32
+      linalg.yield %9 : f32
+  } -> tensor<32x64xf32>
+  %6 = linalg.fill ins(%cst : f32) outs(%0 : tensor<32x1xf32>) -> tensor<32x1xf32>
+  %7 = linalg.generic {indexing_maps = [#map, #map1], iterator_types = ["parallel", "reduction"]} ins(%5 : tensor<32x64xf32>) outs(%6 : tensor<32x1xf32>) {
+    ^bb0(%in: f32, %out: f32):
+      %9 = arith.addf %in, %out : f32
+      linalg.yield %9 : f32
+  } -> tensor<32x1xf32>
+  %8 = linalg.generic {indexing_maps = [#map, #map1, #map], iterator_types = ["parallel", "parallel"]} ins(%5, %7 : tensor<32x64xf32>, tensor<32x1xf32>) outs(%arg1 : tensor<32x64xf32>) {
+    ^bb0(%in: f32, %in_1: f32, %out: f32):
+      %9 = arith.divf %in, %in_1 : f32
+      linalg.yield %9 : f32
+  } -> tensor<32x64xf32>
+  return %8 : tensor<32x64xf32>
+}
+
+// CHECK-LABEL: func.func @softmax_max
+// CHECK-SAME: %[[ARG0:.+]]: tensor<32x64xf32>, %[[ARG1:.+]]: tensor<32x64xf32>
+// CHECK-NOT: linalg.generic
+// CHECK: %[[SOFTMAX:.+]] = tpp.softmax (%[[ARG0]] : tensor<32x64xf32>) -> (tensor<32x64xf32>)
+// CHECK-NOT: linalg.generic
+// CHECK: return %[[SOFTMAX]]
+
+// -----
+
+#map = affine_map<(d0, d1) -> (d0, d1)>
+#map1 = affine_map<(d0, d1) -> (d0, 0)>
+
+// The sums start from a non-zero value: not a softmax.
+func.func @not_softmax(%arg0: tensor<32x64xf32>, %arg1: tensor<32x64xf32>) -> tensor<32x64xf32> {
+  %cst = arith.constant 1.0 : f32
+  %0 = tensor.empty() : tensor<32x64xf32>
+  %1 = linalg.generic {indexing_maps = [#map, #map], iterator_types = ["parallel", "parallel"]} ins(%arg0 : tensor<32x64xf32>) outs(%0 : tensor<32x64xf32>) {
+    ^bb0(%in: f32, %out: f32):
+      %9 = math.exp %in : f32
+      linalg.yield %9 : f32
+  } -> tensor<32x64xf32>
+  %2 = tensor.empty() : tensor<32x1xf32>
+  %3 = linalg.fill ins(%cst : f32) outs(%2 : tensor<32x1xf32>) -> tensor<32x1xf32>
+  %4 = linalg.generic {indexing_maps = [#map, #map1], iterator_types = ["parallel", "reduction"]} ins(%1 : tensor<32x64xf32>) outs(%3 : tensor<32x1xf32>) {
+    ^bb0(%in: f32, %out: f32):
+      %9 = arith.addf %in, %out : f32
+      linalg.yield %9 : f32
+  } -> tensor<32x1xf32>
+  %7 = linalg.generic {indexing_maps = [#map, #map1, #map], iterator_types = ["parallel", "parallel"]} ins(%1, %4 : tensor<32x64xf32>, tensor<32x1xf32>) outs(%arg1 : tensor<32x64xf32>) {
+    ^bb0(%in: f32, %in_0: f32, %out: f32):
+      %9 = arith.divf %in, %in_0 : f32
+      linalg.yield %9 : f32
+  } -> tensor<32x64xf32>
+  return %7 : tensor<32x64xf32>
+}
+
+// CHECK-LABEL: func.func @not_softmax
+// CHECK-NOT: tpp.softmax
+// CHECK: linalg.generic
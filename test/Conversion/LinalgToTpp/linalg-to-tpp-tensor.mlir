@@ -863,3 +863,58 @@ func.func @linalg_zero_gemm_fused_bias_relu_no_chain(%arg0: tensor<128x256xf32>,
   return %1 : tensor<128x512xf32>
 }
 
+
+// -----
+
+func.func @gemm_dynamic_rows(%arg0: tensor<?x9xf32>, %arg1: tensor<9x8xf32>,
+                             %arg2: tensor<?x8xf32>) -> tensor<?x8xf32> {
+  %0 = linalg.matmul ins(%arg0, %arg1: tensor<?x9xf32>, tensor<9x8xf32>)
+                     outs(%arg2: tensor<?x8xf32>) -> tensor<?x8xf32>
+  return %0 : tensor<?x8xf32>
+}
+
+// CHECK-LABEL: gemm_dynamic_rows
+// CHECK-SAME: %[[ARG0:.+]]: tensor<?x9xf32>, %[[ARG1:.+]]: tensor<9x8xf32>, %[[ARG2:.+]]: tensor<?x8xf32>
+// CHECK: %{{.+}} = tpp.gemm
+// CHECK-SAME: (%[[ARG0]] : tensor<?x9xf32>, %[[ARG1]] : tensor<9x8xf32>, %[[ARG2]] : tensor<?x8xf32>)
+// CHECK-SAME:  -> (tensor<?x8xf32>)
+
+// -----
+
+// The innermost dimensions must be static.
+func.func @gemm_dynamic_cols(%arg0: tensor<8x?xf32>, %arg1: tensor<?x8xf32>,
+                             %arg2: tensor<8x8xf32>) -> tensor<8x8xf32> {
+  %0 = linalg.matmul ins(%arg0, %arg1: tensor<8x?xf32>, tensor<?x8xf32>)
+                     outs(%arg2: tensor<8x8xf32>) -> tensor<8x8xf32>
+  return %0 : tensor<8x8xf32>
+}
+
+// CHECK-LABEL: gemm_dynamic_cols
+// CHECK-NOT: tpp.gemm
+// CHECK: linalg.matmul
+
+// -----
+
+#map = affine_map<(d0, d1, d2) -> (d0, d2)>
+#map1 = affine_map<(d0, d1, d2) -> (d1, d2)>
+#map2 = affine_map<(d0, d1, d2) -> (d0, d1)>
+
+func.func @matmul_transpose_b_mapping(%arg0: tensor<8x9xf32>, %arg1: tensor<8x9xf32>,
+                                      %arg2: tensor<8x8xf32>) -> tensor<8x8xf32> {
+  %0 = linalg.generic {
+    indexing_maps = [#map, #map1, #map2],
+    iterator_types = ["parallel", "parallel", "reduction"]}
+    ins(%arg0, %arg1 : tensor<8x9xf32>, tensor<8x9xf32>) outs(%arg2 : tensor<8x8xf32>) {
+    ^bb0(%in: f32, %in_2: f32, %out: f32):
+      %1 = arith.mulf %in, %in_2 : f32
+      %2 = arith.addf %out, %1 : f32
+      linalg.yield %2 : f32
+  } -> tensor<8x8xf32>
+  return %0 : tensor<8x8xf32>
+}
+
+// CHECK-LABEL: matmul_transpose_b_mapping
+// CHECK-SAME: %[[ARG0:.+]]: tensor<8x9xf32>, %[[ARG1:.+]]: tensor<8x9xf32>, %[[ARG2:.+]]: tensor<8x8xf32>
+// CHECK: %{{.+}} = tpp.gemm
+// CHECK-SAME: (%[[ARG0]] : tensor<8x9xf32>, %[[ARG1]] : tensor<8x9xf32>, %[[ARG2]] : tensor<8x8xf32>)
+// CHECK-SAME:  -> (tensor<8x8xf32>) {transpose_b}
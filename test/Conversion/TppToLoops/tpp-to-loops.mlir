@@ -234,6 +234,26 @@ func.func @gemm_to_loops(%arg0: memref<8x9xf32>, %arg1: memref<9x10xf32>, %arg2:
 
 // -----
 
+func.func @gemm_transpose_b_to_loops(%arg0: memref<8x9xf32>, %arg1: memref<10x9xf32>, %arg2: memref<8x10xf32>) {
+  tpp.gemm ins(%arg0 : memref<8x9xf32>, %arg1 : memref<10x9xf32>, %arg2: memref<8x10xf32>)
+           outs(%arg2: memref<8x10xf32>) {transpose_b}
+  return
+}
+
+// CHECK: func.func @gemm_transpose_b_to_loops(
+// CHECK-SAME:  %[[ARG0:.+]]: memref<8x9xf32>, %[[ARG1:.+]]: memref<10x9xf32>, %[[ARG2:.+]]: memref<8x10xf32>) {
+// CHECK: scf.for %[[i:.*]] = %{{.+}} to %{{.+}} step %{{.+}} {
+// CHECK:   scf.for %[[j:.*]] = %{{.+}} to %{{.+}} step %{{.+}} {
+// CHECK:     scf.for %[[k:.*]] = %{{.+}} to %{{.+}} step %{{.+}} {
+// CHECK:       %[[load0:.*]] = memref.load %[[ARG0]][%[[i]], %[[k]]] : memref<8x9xf32>
+// CHECK:       %[[load1:.*]] = memref.load %[[ARG1]][%[[j]], %[[k]]] : memref<10x9xf32>
+// CHECK:       %[[load2:.*]] = memref.load %[[ARG2]][%[[i]], %[[j]]] : memref<8x10xf32>
+// CHECK:       %[[mul:.*]] = arith.mulf %[[load0]], %[[load1]] : f32
+// CHECK:       %[[add:.*]] = arith.addf %[[load2]], %[[mul]] : f32
+// CHECK:       memref.store %[[add]], %[[ARG2]][%[[i]], %[[j]]] : memref<8x10xf32>
+
+// -----
+
 func.func @fused_brgemm_to_loops(%arg0 : memref<2x3x4xf32>, %arg1 : memref<2x4x3xf32>,
                                  %arg2 : memref<3x3xf32>, %arg3 : memref<3x3xf32>) {
   tpp.fused_brgemm [unary = relu, binary = add]
@@ -278,3 +298,281 @@ func.func @fused_brgemm_to_loops(%arg0 : memref<2x3x4xf32>, %arg1 : memref<2x4x3
 // CHECK:     %[[reluVal:.*]] = memref.load %[[ARG2]][%[[i]], %[[j]]] : memref<3x3xf32>
 // CHECK:     %[[reluRes:.*]] = arith.maxf %[[reluVal]], %[[zeroF32]] : f32
 // CHECK:     memref.store %[[reluRes]], %[[ARG2]][%[[i]], %[[j]]] : memref<3x3xf32>
+
+// -----
+
+// CHECK: func.func @gelu_to_loops(
+// CHECK-SAME:  %[[ARG0:.+]]: memref<3x3xf32>, %[[ARG1:.+]]: memref<3x3xf32>)
+func.func @gelu_to_loops(%arg0: memref<3x3xf32>, %arg1: memref<3x3xf32>) {
+  // CHECK: scf.for %[[i:.*]] =
+  // CHECK:   scf.for %[[j:.*]] =
+  // CHECK:     %[[load:.*]] = memref.load %[[ARG0]][%[[i]], %[[j]]] : memref<3x3xf32>
+  // CHECK:     %[[scaled:.*]] = arith.mulf %[[load]], %{{.+}} : f32
+  // CHECK:     %[[erf:.*]] = math.erf %[[scaled]] : f32
+  // CHECK:     %[[erfPlusOne:.*]] = arith.addf %[[erf]], %{{.+}} : f32
+  // CHECK:     %[[halfX:.*]] = arith.mulf %[[load]], %{{.+}} : f32
+  // CHECK:     %[[gelu:.*]] = arith.mulf %[[halfX]], %[[erfPlusOne]] : f32
+  // CHECK:     memref.store %[[gelu]], %[[ARG1]][%[[i]], %[[j]]] : memref<3x3xf32>
+  tpp.gelu ins(%arg0: memref<3x3xf32>) outs(%arg1: memref<3x3xf32>)
+  return
+}
+
+// -----
+
+// CHECK: func.func @sigmoid_to_loops(
+// CHECK-SAME:  %[[ARG0:.+]]: memref<3x3xf32>) {
+func.func @sigmoid_to_loops(%arg0: memref<3x3xf32>) {
+  // CHECK: scf.for %[[i:.*]] =
+  // CHECK:   scf.for %[[j:.*]] =
+  // CHECK:     %[[load:.*]] = memref.load %[[ARG0]][%[[i]], %[[j]]] : memref<3x3xf32>
+  // CHECK:     %[[neg:.*]] = arith.negf %[[load]] : f32
+  // CHECK:     %[[exp:.*]] = math.exp %[[neg]] : f32
+  // CHECK:     %[[den:.*]] = arith.addf %[[exp]], %{{.+}} : f32
+  // CHECK:     %[[sigmoid:.*]] = arith.divf %{{.+}}, %[[den]] : f32
+  // CHECK:     memref.store %[[sigmoid]], %[[ARG0]][%[[i]], %[[j]]] : memref<3x3xf32>
+  tpp.sigmoid ins(%arg0: memref<3x3xf32>) outs(%arg0: memref<3x3xf32>)
+  return
+}
+
+// -----
+
+// CHECK: func.func @tanh_exp_to_loops(
+// CHECK-SAME:  %[[ARG0:.+]]: memref<3x3xf32>) {
+func.func @tanh_exp_to_loops(%arg0: memref<3x3xf32>) {
+  // CHECK: %[[load:.*]] = memref.load %[[ARG0]]
+  // CHECK: %[[tanh:.*]] = math.tanh %[[load]] : f32
+  // CHECK: memref.store %[[tanh]], %[[ARG0]]
+  tpp.tanh ins(%arg0: memref<3x3xf32>) outs(%arg0: memref<3x3xf32>)
+  // CHECK: %[[load1:.*]] = memref.load %[[ARG0]]
+  // CHECK: %[[exp:.*]] = math.exp %[[load1]] : f32
+  // CHECK: memref.store %[[exp]], %[[ARG0]]
+  tpp.exp ins(%arg0: memref<3x3xf32>) outs(%arg0: memref<3x3xf32>)
+  return
+}
+
+// -----
+
+// CHECK: func.func @binary_to_loops(
+// CHECK-SAME:  %[[ARG0:.+]]: memref<3x3xf32>, %[[ARG1:.+]]: memref<3x3xf32>) {
+func.func @binary_to_loops(%arg0: memref<3x3xf32>, %arg1: memref<3x3xf32>) {
+  // CHECK: %[[lhs:.*]] = memref.load %[[ARG0]]
+  // CHECK: %[[rhs:.*]] = memref.load %[[ARG1]]
+  // CHECK: %[[mul:.*]] = arith.mulf %[[lhs]], %[[rhs]] : f32
+  // CHECK: memref.store %[[mul]], %[[ARG1]]
+  tpp.mul ins(%arg0: memref<3x3xf32>, %arg1: memref<3x3xf32>) outs(%arg1: memref<3x3xf32>)
+  // CHECK: %[[lhs1:.*]] = memref.load %[[ARG0]]
+  // CHECK: %[[rhs1:.*]] = memref.load %[[ARG1]]
+  // CHECK: %[[sub:.*]] = arith.subf %[[lhs1]], %[[rhs1]] : f32
+  // CHECK: memref.store %[[sub]], %[[ARG1]]
+  tpp.sub ins(%arg0: memref<3x3xf32>, %arg1: memref<3x3xf32>) outs(%arg1: memref<3x3xf32>)
+  // CHECK: %[[lhs2:.*]] = memref.load %[[ARG1]]
+  // CHECK: %[[rhs2:.*]] = memref.load %[[ARG0]]
+  // CHECK: %[[div:.*]] = arith.divf %[[lhs2]], %[[rhs2]] : f32
+  // CHECK: memref.store %[[div]], %[[ARG1]]
+  tpp.div ins(%arg1: memref<3x3xf32>, %arg0: memref<3x3xf32>) outs(%arg1: memref<3x3xf32>)
+  // CHECK: %[[lhs3:.*]] = memref.load %[[ARG0]]
+  // CHECK: %[[rhs3:.*]] = memref.load %[[ARG1]]
+  // CHECK: %[[max:.*]] = arith.maxf %[[lhs3]], %[[rhs3]] : f32
+  // CHECK: memref.store %[[max]], %[[ARG1]]
+  tpp.max ins(%arg0: memref<3x3xf32>, %arg1: memref<3x3xf32>) outs(%arg1: memref<3x3xf32>)
+  return
+}
+
+// -----
+
+// CHECK: func.func @binary_bcast_to_loops(
+// CHECK-SAME:  %[[ARG0:.+]]: memref<3x1xf32>, %[[ARG1:.+]]: memref<3xf32>, %[[ARG2:.+]]: memref<3x3xf32>) {
+func.func @binary_bcast_to_loops(%arg0: memref<3x1xf32>, %arg1: memref<3xf32>, %arg2: memref<3x3xf32>) {
+  // CHECK-DAG: %[[ub:.*]] = arith.constant 3 : index
+  // CHECK-DAG: %[[lb:.*]] = arith.constant 0 : index
+  // CHECK-DAG: %[[step:.*]] = arith.constant 1 : index
+  // CHECK: scf.for %[[i:.*]] = %[[lb]] to %[[ub]] step %[[step]] {
+  // CHECK:   scf.for %[[j:.*]] = %[[lb]] to %[[ub]] step %[[step]] {
+  // CHECK:     %[[lhs:.*]] = memref.load %[[ARG0]][%[[i]], %[[lb]]] : memref<3x1xf32>
+  // CHECK:     %[[rhs:.*]] = memref.load %[[ARG1]][%[[j]]] : memref<3xf32>
+  // CHECK:     %[[sub:.*]] = arith.subf %[[lhs]], %[[rhs]] : f32
+  // CHECK:     memref.store %[[sub]], %[[ARG2]][%[[i]], %[[j]]] : memref<3x3xf32>
+  tpp.sub ins(%arg0: memref<3x1xf32>, %arg1: memref<3xf32>) outs(%arg2: memref<3x3xf32>)
+  return
+}
+
+// -----
+
+// A size-1 operand of rank 1 is indexed at zero, not by the innermost iv.
+// CHECK: func.func @binary_bcast_scalar_memref_to_loops(
+// CHECK-SAME:  %[[ARG0:.+]]: memref<3x3xf32>, %[[ARG1:.+]]: memref<1xf32>, %[[ARG2:.+]]: memref<3x3xf32>) {
+func.func @binary_bcast_scalar_memref_to_loops(%arg0: memref<3x3xf32>, %arg1: memref<1xf32>, %arg2: memref<3x3xf32>) {
+  // CHECK-DAG: %[[ub:.*]] = arith.constant 3 : index
+  // CHECK-DAG: %[[lb:.*]] = arith.constant 0 : index
+  // CHECK-DAG: %[[step:.*]] = arith.constant 1 : index
+  // CHECK: scf.for %[[i:.*]] = %[[lb]] to %[[ub]] step %[[step]] {
+  // CHECK:   scf.for %[[j:.*]] = %[[lb]] to %[[ub]] step %[[step]] {
+  // CHECK:     %[[lhs:.*]] = memref.load %[[ARG0]][%[[i]], %[[j]]] : memref<3x3xf32>
+  // CHECK:     %[[rhs:.*]] = memref.load %[[ARG1]][%[[lb]]] : memref<1xf32>
+  // CHECK:     %[[add:.*]] = arith.addf %[[lhs]], %[[rhs]] : f32
+  // CHECK:     memref.store %[[add]], %[[ARG2]][%[[i]], %[[j]]] : memref<3x3xf32>
+  tpp.add ins(%arg0: memref<3x3xf32>, %arg1: memref<1xf32>) outs(%arg2: memref<3x3xf32>)
+  return
+}
+
+// -----
+
+// CHECK: func.func @reduce_add_to_loops(
+// CHECK-SAME:  %[[ARG0:.+]]: memref<3x4xf32>, %[[ARG1:.+]]: memref<3x1xf32>) {
+func.func @reduce_add_to_loops(%arg0: memref<3x4xf32>, %arg1: memref<3x1xf32>) {
+  // CHECK-DAG: %[[lb:.*]] = arith.constant 0 : index
+  // CHECK-DAG: %[[step:.*]] = arith.constant 1 : index
+  // CHECK-DAG: %[[ub:.*]] = arith.constant 3 : index
+  // CHECK-DAG: %[[red:.*]] = arith.constant 4 : index
+  // CHECK-DAG: %[[zero:.*]] = arith.constant 0.000000e+00 : f32
+  // CHECK: scf.for %[[i:.*]] = %[[lb]] to %[[ub]] step %[[step]] {
+  // CHECK:   %[[sum:.*]] = scf.for %[[j:.*]] = %[[lb]] to %[[red]] step %[[step]] iter_args(%[[acc:.*]] = %[[zero]]) -> (f32) {
+  // CHECK:     %[[val:.*]] = memref.load %[[ARG0]][%[[i]], %[[j]]] : memref<3x4xf32>
+  // CHECK:     %[[add:.*]] = arith.addf %[[acc]], %[[val]] : f32
+  // CHECK:     scf.yield %[[add]] : f32
+  // CHECK:   memref.store %[[sum]], %[[ARG1]][%[[i]], %[[lb]]] : memref<3x1xf32>
+  tpp.reduce_add ins(%arg0: memref<3x4xf32>) outs(%arg1: memref<3x1xf32>)
+  return
+}
+
+// -----
+
+// CHECK: func.func @reduce_max_to_loops(
+// CHECK-SAME:  %[[ARG0:.+]]: memref<3x4xf32>, %[[ARG1:.+]]: memref<1x4xf32>) {
+func.func @reduce_max_to_loops(%arg0: memref<3x4xf32>, %arg1: memref<1x4xf32>) {
+  // CHECK-DAG: %[[lb:.*]] = arith.constant 0 : index
+  // CHECK-DAG: %[[step:.*]] = arith.constant 1 : index
+  // CHECK-DAG: %[[ub:.*]] = arith.constant 4 : index
+  // CHECK-DAG: %[[red:.*]] = arith.constant 3 : index
+  // CHECK-DAG: %[[ninf:.*]] = arith.constant 0xFF800000 : f32
+  // CHECK: scf.for %[[j:.*]] = %[[lb]] to %[[ub]] step %[[step]] {
+  // CHECK:   %[[res:.*]] = scf.for %[[i:.*]] = %[[lb]] to %[[red]] step %[[step]] iter_args(%[[acc:.*]] = %[[ninf]]) -> (f32) {
+  // CHECK:     %[[val:.*]] = memref.load %[[ARG0]][%[[i]], %[[j]]] : memref<3x4xf32>
+  // CHECK:     %[[max:.*]] = arith.maxf %[[acc]], %[[val]] : f32
+  // CHECK:     scf.yield %[[max]] : f32
+  // CHECK:   memref.store %[[res]], %[[ARG1]][%[[lb]], %[[j]]] : memref<1x4xf32>
+  tpp.reduce_max ins(%arg0: memref<3x4xf32>) outs(%arg1: memref<1x4xf32>)
+  return
+}
+
+// -----
+
+// CHECK: func.func @softmax_to_loops(
+// CHECK-SAME:  %[[ARG0:.+]]: memref<3x4xf32>, %[[ARG1:.+]]: memref<3x4xf32>) {
+func.func @softmax_to_loops(%arg0: memref<3x4xf32>, %arg1: memref<3x4xf32>) {
+  // CHECK-DAG: %[[lb:.*]] = arith.constant 0 : index
+  // CHECK-DAG: %[[step:.*]] = arith.constant 1 : index
+  // CHECK-DAG: %[[ub:.*]] = arith.constant 3 : index
+  // CHECK-DAG: %[[cols:.*]] = arith.constant 4 : index
+  // CHECK-DAG: %[[ninf:.*]] = arith.constant 0xFF800000 : f32
+  // CHECK-DAG: %[[zero:.*]] = arith.constant 0.000000e+00 : f32
+  // CHECK: scf.for %[[i:.*]] = %[[lb]] to %[[ub]] step %[[step]] {
+  // CHECK:   %[[max:.*]] = scf.for %[[j:.*]] = %[[lb]] to %[[cols]] step %[[step]] iter_args(%[[acc:.*]] = %[[ninf]]) -> (f32) {
+  // CHECK:     %[[val:.*]] = memref.load %[[ARG0]][%[[i]], %[[j]]] : memref<3x4xf32>
+  // CHECK:     %[[newmax:.*]] = arith.maxf %[[acc]], %[[val]] : f32
+  // CHECK:     scf.yield %[[newmax]] : f32
+  // CHECK:   %[[sum:.*]] = scf.for %[[k:.*]] = %[[lb]] to %[[cols]] step %[[step]] iter_args(%[[sacc:.*]] = %[[zero]]) -> (f32) {
+  // CHECK:     %[[x:.*]] = memref.load %[[ARG0]][%[[i]], %[[k]]] : memref<3x4xf32>
+  // CHECK:     %[[shifted:.*]] = arith.subf %[[x]], %[[max]] : f32
+  // CHECK:     %[[exp:.*]] = math.exp %[[shifted]] : f32
+  // CHECK:     memref.store %[[exp]], %[[ARG1]][%[[i]], %[[k]]] : memref<3x4xf32>
+  // CHECK:     %[[newsum:.*]] = arith.addf %[[sacc]], %[[exp]] : f32
+  // CHECK:     scf.yield %[[newsum]] : f32
+  // CHECK:   scf.for %[[l:.*]] = %[[lb]] to %[[cols]] step %[[step]] {
+  // CHECK:     %[[e:.*]] = memref.load %[[ARG1]][%[[i]], %[[l]]] : memref<3x4xf32>
+  // CHECK:     %[[div:.*]] = arith.divf %[[e]], %[[sum]] : f32
+  // CHECK:     memref.store %[[div]], %[[ARG1]][%[[i]], %[[l]]] : memref<3x4xf32>
+  tpp.softmax ins(%arg0: memref<3x4xf32>) outs(%arg1: memref<3x4xf32>)
+  return
+}
+
+// -----
+
+// CHECK: func.func @layernorm_to_loops(
+// CHECK-SAME:  %[[ARG0:.+]]: memref<3x4xf32>, %[[ARG1:.+]]: memref<4xf32>,
+// CHECK-SAME:  %[[ARG2:.+]]: memref<4xf32>, %[[ARG3:.+]]: memref<3x4xf32>) {
+func.func @layernorm_to_loops(%arg0: memref<3x4xf32>, %arg1: memref<4xf32>,
+                              %arg2: memref<4xf32>, %arg3: memref<3x4xf32>) {
+  // CHECK-DAG: %[[lb:.*]] = arith.constant 0 : index
+  // CHECK-DAG: %[[step:.*]] = arith.constant 1 : index
+  // CHECK-DAG: %[[ub:.*]] = arith.constant 3 : index
+  // CHECK-DAG: %[[cols:.*]] = arith.constant 4 : index
+  // CHECK-DAG: %[[zero:.*]] = arith.constant 0.000000e+00 : f32
+  // CHECK-DAG: %[[inv:.*]] = arith.constant 2.500000e-01 : f32
+  // CHECK-DAG: %[[eps:.*]] = arith.constant 9.99999974E-6 : f32
+  // CHECK: scf.for %[[i:.*]] = %[[lb]] to %[[ub]] step %[[step]] {
+  // CHECK:   %[[sum:.*]] = scf.for %[[j:.*]] = %[[lb]] to %[[cols]] step %[[step]] iter_args(%[[acc:.*]] = %[[zero]]) -> (f32) {
+  // CHECK:     %[[x:.*]] = memref.load %[[ARG0]][%[[i]], %[[j]]] : memref<3x4xf32>
+  // CHECK:     %[[newsum:.*]] = arith.addf %[[acc]], %[[x]] : f32
+  // CHECK:     scf.yield %[[newsum]] : f32
+  // CHECK:   %[[mean:.*]] = arith.mulf %[[sum]], %[[inv]] : f32
+  // CHECK:   %[[sqsum:.*]] = scf.for %[[k:.*]] = %[[lb]] to %[[cols]] step %[[step]] iter_args(%[[sacc:.*]] = %[[zero]]) -> (f32) {
+  // CHECK:     %[[y:.*]] = memref.load %[[ARG0]][%[[i]], %[[k]]] : memref<3x4xf32>
+  // CHECK:     %[[c:.*]] = arith.subf %[[y]], %[[mean]] : f32
+  // CHECK:     %[[sq:.*]] = arith.mulf %[[c]], %[[c]] : f32
+  // CHECK:     %[[newsq:.*]] = arith.addf %[[sacc]], %[[sq]] : f32
+  // CHECK:     scf.yield %[[newsq]] : f32
+  // CHECK:   %[[var:.*]] = arith.mulf %[[sqsum]], %[[inv]] : f32
+  // CHECK:   %[[shifted:.*]] = arith.addf %[[var]], %[[eps]] : f32
+  // CHECK:   %[[rstd:.*]] = math.rsqrt %[[shifted]] : f32
+  // CHECK:   scf.for %[[l:.*]] = %[[lb]] to %[[cols]] step %[[step]] {
+  // CHECK:     %[[z:.*]] = memref.load %[[ARG0]][%[[i]], %[[l]]] : memref<3x4xf32>
+  // CHECK:     %[[zc:.*]] = arith.subf %[[z]], %[[mean]] : f32
+  // CHECK:     %[[norm:.*]] = arith.mulf %[[zc]], %[[rstd]] : f32
+  // CHECK:     %[[gamma:.*]] = memref.load %[[ARG1]][%[[l]]] : memref<4xf32>
+  // CHECK:     %[[scaled:.*]] = arith.mulf %[[norm]], %[[gamma]] : f32
+  // CHECK:     %[[beta:.*]] = memref.load %[[ARG2]][%[[l]]] : memref<4xf32>
+  // CHECK:     %[[res:.*]] = arith.addf %[[scaled]], %[[beta]] : f32
+  // CHECK:     memref.store %[[res]], %[[ARG3]][%[[i]], %[[l]]] : memref<3x4xf32>
+  tpp.layernorm ins(%arg0: memref<3x4xf32>, %arg1: memref<4xf32>, %arg2: memref<4xf32>)
+                outs(%arg3: memref<3x4xf32>) {epsilon = 1.0e-05 : f32}
+  return
+}
+
+// -----
+
+func.func @gemm_i8_to_loops(%arg0: memref<3x4xi8>, %arg1: memref<4x3xi8>, %arg2: memref<3x3xi32>) {
+  tpp.gemm ins(%arg0: memref<3x4xi8>, %arg1: memref<4x3xi8>, %arg2: memref<3x3xi32>)
+           outs(%arg2: memref<3x3xi32>)
+  return
+}
+
+// CHECK: func.func @gemm_i8_to_loops(
+// CHECK-SAME:  %[[ARG0:.+]]: memref<3x4xi8>,
+// CHECK-SAME:  %[[ARG1:.+]]: memref<4x3xi8>,
+// CHECK-SAME:  %[[ARG2:.+]]: memref<3x3xi32>) {
+// CHECK: %[[ma:.*]] = memref.load %[[ARG0]][%{{.+}}, %{{.+}}] : memref<3x4xi8>
+// CHECK: %[[mb:.*]] = memref.load %[[ARG1]][%{{.+}}, %{{.+}}] : memref<4x3xi8>
+// CHECK: %[[mc:.*]] = memref.load %[[ARG2]][%{{.+}}, %{{.+}}] : memref<3x3xi32>
+// CHECK: %[[ea:.*]] = arith.extsi %[[ma]] : i8 to i32
+// CHECK: %[[eb:.*]] = arith.extsi %[[mb]] : i8 to i32
+// CHECK: %[[mul:.*]] = arith.muli %[[ea]], %[[eb]] : i32
+// CHECK: %[[add:.*]] = arith.addi %[[mc]], %[[mul]] : i32
+// CHECK: memref.store %[[add]], %[[ARG2]][%{{.+}}, %{{.+}}] : memref<3x3xi32>
+
+// -----
+
+// CHECK: func.func @dequantize_to_loops(
+// CHECK-SAME:  %[[ARG0:.+]]: memref<3x4xi32>, %[[ARG1:.+]]: memref<4xf32>,
+// CHECK-SAME:  %[[ARG2:.+]]: memref<4xf32>, %[[ARG3:.+]]: memref<3x4xf32>) {
+func.func @dequantize_to_loops(%arg0: memref<3x4xi32>, %arg1: memref<4xf32>,
+                               %arg2: memref<4xf32>, %arg3: memref<3x4xf32>) {
+  // CHECK-DAG: %[[lb:.*]] = arith.constant 0 : index
+  // CHECK-DAG: %[[step:.*]] = arith.constant 1 : index
+  // CHECK-DAG: %[[ub:.*]] = arith.constant 3 : index
+  // CHECK-DAG: %[[cols:.*]] = arith.constant 4 : index
+  // CHECK-DAG: %[[zero:.*]] = arith.constant 0.000000e+00 : f32
+  // CHECK: scf.for %[[i:.*]] = %[[lb]] to %[[ub]] step %[[step]] {
+  // CHECK:   scf.for %[[j:.*]] = %[[lb]] to %[[cols]] step %[[step]] {
+  // CHECK:     %[[acc:.*]] = memref.load %[[ARG0]][%[[i]], %[[j]]] : memref<3x4xi32>
+  // CHECK:     %[[conv:.*]] = arith.sitofp %[[acc]] : i32 to f32
+  // CHECK:     %[[scale:.*]] = memref.load %[[ARG1]][%[[j]]] : memref<4xf32>
+  // CHECK:     %[[mul:.*]] = arith.mulf %[[conv]], %[[scale]] : f32
+  // CHECK:     %[[bias:.*]] = memref.load %[[ARG2]][%[[j]]] : memref<4xf32>
+  // CHECK:     %[[add:.*]] = arith.addf %[[mul]], %[[bias]] : f32
+  // CHECK:     %[[relu:.*]] = arith.maxf %[[add]], %[[zero]] : f32
+  // CHECK:     memref.store %[[relu]], %[[ARG3]][%[[i]], %[[j]]] : memref<3x4xf32>
+  tpp.dequantize ins(%arg0: memref<3x4xi32>, %arg1: memref<4xf32>, %arg2: memref<4xf32>)
+                 outs(%arg3: memref<3x4xf32>) {relu}
+  return
+}
@@ -30,6 +30,21 @@ func.func @vnni_brgemm_to_xsmm(%arg0 : memref<4x256x512xbf16>, %arg1 : memref<4x
 
 // -----
 
+// CHECK-LABEL: @vnni_i8_brgemm_to_xsmm
+// CHECK-SAME:  %[[ARG0:.+]]: memref<4x32x64xi8>, %[[ARG1:.+]]: memref<4x16x32x4xi8>,
+// CHECK-SAME:  %[[ARG2:.+]]: memref<32x32xi32>
+func.func @vnni_i8_brgemm_to_xsmm(%arg0 : memref<4x32x64xi8>, %arg1 : memref<4x16x32x4xi8>,
+                                  %arg2 : memref<32x32xi32>) {
+  // CHECK: %[[BATCH:.+]] = arith.constant 4 : i64
+  // CHECK-NEXT: %[[DISPATCH:.+]] = xsmm.brgemm.dispatch [32, 32, 64, 64, 32, 32] flags = (vnni_b) data_type = i8
+  // CHECK-NEXT: xsmm.brgemm(data_type = i8, %[[DISPATCH]], %[[ARG0]], %[[ARG1]], %[[ARG2]], %[[BATCH]])
+  tpp.brgemm ins(%arg0 : memref<4x32x64xi8>, %arg1 : memref<4x16x32x4xi8>, %arg2 : memref<32x32xi32>)
+             outs(%arg2 : memref<32x32xi32>)
+  return
+}
+
+// -----
+
 func.func @brgemm_fused(%arg0: memref<3x5x4xf32>, %arg1: memref<3x4x5xf32>,
                         %arg2: memref<5x5xf32>, %arg3: memref<5x5xf32>) {
   tpp.fused_brgemm [unary = none, binary = none] 
@@ -82,3 +97,37 @@ func.func @brgemm_fused(%arg0 : memref<5x2x2xf32>, %arg1 : memref<5x2x2xf32>,
 // CHECK: xsmm.brgemm.dispatch [2, 2, 2, 2, 2, 2]
 // CHECK: xsmm.binary.dispatch add [2, 2, 2, 2, 2]
 // CHECK: xsmm.unary.dispatch relu [2, 2, 2, 2]
+
+// -----
+
+// The blocks of A are not densely packed, use the offset-based brgemm.
+// CHECK-LABEL: @strided_brgemm_to_xsmm(
+// CHECK-SAME:  %[[ARG0:.+]]: memref<4x5x4xf32, strided<[40, 4, 1]>>, %[[ARG1:.+]]: memref<4x4x5xf32>,
+// CHECK-SAME:  %[[ARG2:.+]]: memref<5x5xf32>)
+func.func @strided_brgemm_to_xsmm(%arg0: memref<4x5x4xf32, strided<[40, 4, 1]>>,
+                                  %arg1: memref<4x4x5xf32>, %arg2: memref<5x5xf32>) {
+  // CHECK-DAG: %[[C0:.+]] = arith.constant 0 : index
+  // CHECK-DAG: %[[C1:.+]] = arith.constant 1 : index
+  // CHECK-DAG: %[[C4:.+]] = arith.constant 4 : index
+  // CHECK-DAG: %[[C80:.+]] = arith.constant 80 : index
+  // CHECK-DAG: %[[C160:.+]] = arith.constant 160 : index
+  // CHECK-DAG: %[[BATCH:.+]] = arith.constant 4 : i64
+  // The offsets are filled by a loop. They are built at the start of the
+  // block, so the ones of B come first.
+  // CHECK: %[[OFFS_B:.+]] = memref.alloca() : memref<4xi64>
+  // CHECK: scf.for %[[I:.+]] = %[[C0]] to %[[C4]] step %[[C1]] {
+  // CHECK:   %[[OFF_B:.+]] = arith.muli %[[I]], %[[C80]] : index
+  // CHECK:   %[[OFF_B_I64:.+]] = arith.index_cast %[[OFF_B]] : index to i64
+  // CHECK:   memref.store %[[OFF_B_I64]], %[[OFFS_B]][%[[I]]] : memref<4xi64>
+  // CHECK: %[[OFFS_A:.+]] = memref.alloca() : memref<4xi64>
+  // CHECK: scf.for %[[J:.+]] = %[[C0]] to %[[C4]] step %[[C1]] {
+  // CHECK:   %[[OFF_A:.+]] = arith.muli %[[J]], %[[C160]] : index
+  // CHECK:   %[[OFF_A_I64:.+]] = arith.index_cast %[[OFF_A]] : index to i64
+  // CHECK:   memref.store %[[OFF_A_I64]], %[[OFFS_A]][%[[J]]] : memref<4xi64>
+  // CHECK: %[[DISPATCH:.+]] = xsmm.brgemm_offs.dispatch [5, 5, 4, 4, 5, 5] flags = (none) data_type = f32
+  // CHECK-NEXT: xsmm.brgemm_offs(data_type = f32, %[[DISPATCH]], %[[ARG0]], %[[ARG1]], %[[ARG2]], %[[OFFS_A]], %[[OFFS_B]], %[[BATCH]])
+  tpp.brgemm ins(%arg0: memref<4x5x4xf32, strided<[40, 4, 1]>>, %arg1: memref<4x4x5xf32>,
+                 %arg2: memref<5x5xf32>)
+             outs(%arg2: memref<5x5xf32>)
+  return
+}
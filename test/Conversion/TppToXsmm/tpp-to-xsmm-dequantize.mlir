@@ -0,0 +1,34 @@
+// RUN: tpp-opt %s -convert-tpp-to-xsmm -split-input-file | FileCheck %s
+
+// CHECK-LABEL: @dequantize_to_xsmm(
+// CHECK-SAME:  %[[ARG0:.+]]: memref<4x8xi32>, %[[ARG1:.+]]: memref<1x8xf32>,
+// CHECK-SAME:  %[[ARG2:.+]]: memref<1x8xf32>, %[[ARG3:.+]]: memref<4x8xf32>)
+func.func @dequantize_to_xsmm(%arg0: memref<4x8xi32>, %arg1: memref<1x8xf32>,
+                              %arg2: memref<1x8xf32>, %arg3: memref<4x8xf32>) {
+  // CHECK-NOT: scf.for
+  // CHECK: %[[CONV:.+]] = xsmm.unary.dispatch identity [4, 8, 8, 8] flags = (none) data_type = f32 input_data_type = i32
+  // CHECK-NEXT: xsmm.unary identity(data_type = f32, %[[CONV]], %[[ARG0]], %[[ARG3]])
+  // CHECK: %[[FMA:.+]] = xsmm.ternary.dispatch muladd [4, 8, 8, 8, 8, 8] flags = (bcast_col_in1, bcast_col_in2) data_type = f32
+  // CHECK-NEXT: xsmm.ternary muladd(data_type = f32, %[[FMA]], %[[ARG3]], %[[ARG1]], %[[ARG2]], %[[ARG3]])
+  // CHECK: %[[RELU:.+]] = xsmm.unary.dispatch relu [4, 8, 8, 8] flags = (none) data_type = f32
+  // CHECK-NEXT: xsmm.unary relu(data_type = f32, %[[RELU]], %[[ARG3]], %[[ARG3]])
+  tpp.dequantize ins(%arg0: memref<4x8xi32>, %arg1: memref<1x8xf32>, %arg2: memref<1x8xf32>)
+                 outs(%arg3: memref<4x8xf32>) {relu}
+  return
+}
+
+// -----
+
+// CHECK-LABEL: @dequantize_to_xsmm_no_relu(
+// CHECK-SAME:  %[[ARG0:.+]]: memref<4x8xi32>, %[[ARG1:.+]]: memref<8xf32>,
+// CHECK-SAME:  %[[ARG2:.+]]: memref<8xf32>, %[[ARG3:.+]]: memref<4x8xf32>)
+func.func @dequantize_to_xsmm_no_relu(%arg0: memref<4x8xi32>, %arg1: memref<8xf32>,
+                                      %arg2: memref<8xf32>, %arg3: memref<4x8xf32>) {
+  // CHECK: xsmm.unary identity
+  // CHECK: %[[FMA:.+]] = xsmm.ternary.dispatch muladd [4, 8, 8, 8, 8, 8] flags = (bcast_col_in1, bcast_col_in2) data_type = f32
+  // CHECK-NEXT: xsmm.ternary muladd(data_type = f32, %[[FMA]], %[[ARG3]], %[[ARG1]], %[[ARG2]], %[[ARG3]])
+  // CHECK-NOT: relu
+  tpp.dequantize ins(%arg0: memref<4x8xi32>, %arg1: memref<8xf32>, %arg2: memref<8xf32>)
+                 outs(%arg3: memref<4x8xf32>)
+  return
+}
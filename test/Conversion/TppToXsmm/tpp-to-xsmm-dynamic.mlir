@@ -0,0 +1,43 @@
+// RUN: tpp-opt %s -convert-tpp-to-xsmm -split-input-file | FileCheck %s
+
+// CHECK-LABEL: @gemm_dynamic_rows(
+// CHECK-SAME: %[[ARG0:.+]]: memref<?x64xf32>, %[[ARG1:.+]]: memref<64x32xf32>, %[[ARG2:.+]]: memref<?x32xf32>)
+func.func @gemm_dynamic_rows(%arg0: memref<?x64xf32>, %arg1: memref<64x32xf32>, %arg2: memref<?x32xf32>) {
+  // CHECK: %[[C0:.+]] = arith.constant 0 : index
+  // CHECK: %[[DIM:.+]] = memref.dim %[[ARG2]], %[[C0]] : memref<?x32xf32>
+  // CHECK: %[[M:.+]] = arith.index_cast %[[DIM]] : index to i64
+  // CHECK: %[[DISPATCH:.+]] = xsmm.gemm.dispatch [%[[M]], 32, 64, 64, 32, 32] flags = (none) data_type = f32
+  // CHECK-NEXT: xsmm.gemm(data_type = f32, %[[DISPATCH]], %[[ARG0]], %[[ARG1]], %[[ARG2]])
+  tpp.gemm ins(%arg0: memref<?x64xf32>, %arg1: memref<64x32xf32>, %arg2: memref<?x32xf32>)
+           outs(%arg2: memref<?x32xf32>)
+  return
+}
+
+// -----
+
+// CHECK-LABEL: @brgemm_dynamic_batch(
+// CHECK-SAME: %[[ARG0:.+]]: memref<?x32x32xf32>, %[[ARG1:.+]]: memref<?x32x32xf32>, %[[ARG2:.+]]: memref<32x32xf32>)
+func.func @brgemm_dynamic_batch(%arg0: memref<?x32x32xf32>, %arg1: memref<?x32x32xf32>,
+                                %arg2: memref<32x32xf32>) {
+  // CHECK: %[[DISPATCH:.+]] = xsmm.brgemm.dispatch [32, 32, 32, 32, 32, 32] flags = (none) data_type = f32
+  // CHECK: %[[C0:.+]] = arith.constant 0 : index
+  // CHECK: %[[DIM:.+]] = memref.dim %[[ARG1]], %[[C0]] : memref<?x32x32xf32>
+  // CHECK: %[[BATCH:.+]] = arith.index_cast %[[DIM]] : index to i64
+  // CHECK-NEXT: xsmm.brgemm(data_type = f32, %[[DISPATCH]], %[[ARG0]], %[[ARG1]], %[[ARG2]], %[[BATCH]])
+  tpp.brgemm ins(%arg0: memref<?x32x32xf32>, %arg1: memref<?x32x32xf32>, %arg2: memref<32x32xf32>)
+             outs(%arg2: memref<32x32xf32>)
+  return
+}
+
+// -----
+
+// CHECK-LABEL: @relu_dynamic_rows(
+// CHECK-SAME: %[[ARG0:.+]]: memref<?x32xf32>)
+func.func @relu_dynamic_rows(%arg0: memref<?x32xf32>) {
+  // CHECK: %[[DIM:.+]] = memref.dim %[[ARG0]], %{{.+}} : memref<?x32xf32>
+  // CHECK: %[[M:.+]] = arith.index_cast %[[DIM]] : index to i64
+  // CHECK: %[[DISPATCH:.+]] = xsmm.unary.dispatch relu [%[[M]], 32, 32, 32] flags = (none) data_type = f32
+  // CHECK-NEXT: xsmm.unary relu(data_type = f32, %[[DISPATCH]], %[[ARG0]], %[[ARG0]])
+  tpp.relu ins(%arg0: memref<?x32xf32>) outs(%arg0: memref<?x32xf32>)
+  return
+}
@@ -0,0 +1,55 @@
+// RUN: tpp-opt %s -convert-tpp-to-xsmm -split-input-file | FileCheck %s
+
+// CHECK-LABEL: func.func @mul_to_xsmm
+func.func @mul_to_xsmm(%arg0: memref<3x4xf32>, %arg1: memref<3x4xf32>, %arg2: memref<3x4xf32>) {
+  // CHECK: %[[DISPATCH:.+]] = xsmm.binary.dispatch mul [3, 4, 4, 4, 4] flags = (none) data_type = f32
+  // CHECK-NEXT: xsmm.binary mul(data_type = f32, %[[DISPATCH]], %{{.+}}, %{{.+}}, %{{.+}}) : (i64, memref<3x4xf32>, memref<3x4xf32>, memref<3x4xf32>) -> ()
+  tpp.mul ins(%arg0: memref<3x4xf32>, %arg1: memref<3x4xf32>) outs(%arg2: memref<3x4xf32>)
+  return
+}
+
+// -----
+
+// CHECK-LABEL: func.func @sub_to_xsmm
+func.func @sub_to_xsmm(%arg0: memref<3x4xf32>, %arg1: memref<3x4xf32>, %arg2: memref<3x4xf32>) {
+  // CHECK: %[[DISPATCH:.+]] = xsmm.binary.dispatch sub [3, 4, 4, 4, 4] flags = (none) data_type = f32
+  // CHECK-NEXT: xsmm.binary sub(data_type = f32, %[[DISPATCH]], %{{.+}}, %{{.+}}, %{{.+}}) : (i64, memref<3x4xf32>, memref<3x4xf32>, memref<3x4xf32>) -> ()
+  tpp.sub ins(%arg0: memref<3x4xf32>, %arg1: memref<3x4xf32>) outs(%arg2: memref<3x4xf32>)
+  return
+}
+
+// -----
+
+// CHECK-LABEL: func.func @div_to_xsmm
+func.func @div_to_xsmm(%arg0: memref<3x4xf32>, %arg1: memref<3x4xf32>, %arg2: memref<3x4xf32>) {
+  // CHECK: %[[DISPATCH:.+]] = xsmm.binary.dispatch div [3, 4, 4, 4, 4] flags = (none) data_type = f32
+  // CHECK-NEXT: xsmm.binary div(data_type = f32, %[[DISPATCH]], %{{.+}}, %{{.+}}, %{{.+}}) : (i64, memref<3x4xf32>, memref<3x4xf32>, memref<3x4xf32>) -> ()
+  tpp.div ins(%arg0: memref<3x4xf32>, %arg1: memref<3x4xf32>) outs(%arg2: memref<3x4xf32>)
+  return
+}
+
+// -----
+
+// CHECK-LABEL: func.func @max_to_xsmm
+func.func @max_to_xsmm(%arg0: memref<3x4xf32>, %arg1: memref<3x4xf32>, %arg2: memref<3x4xf32>) {
+  // CHECK: %[[DISPATCH:.+]] = xsmm.binary.dispatch max [3, 4, 4, 4, 4] flags = (none) data_type = f32
+  // CHECK-NEXT: xsmm.binary max(data_type = f32, %[[DISPATCH]], %{{.+}}, %{{.+}}, %{{.+}}) : (i64, memref<3x4xf32>, memref<3x4xf32>, memref<3x4xf32>) -> ()
+  tpp.max ins(%arg0: memref<3x4xf32>, %arg1: memref<3x4xf32>) outs(%arg2: memref<3x4xf32>)
+  return
+}
+
+// -----
+
+// CHECK-LABEL: func.func @binary_to_xsmm_bcast
+func.func @binary_to_xsmm_bcast(%arg0: memref<5x1xf32>, %arg1: memref<1x5xf32>,
+                                %arg2: memref<1xf32>, %arg3: memref<5x5xf32>) {
+  tpp.mul ins(%arg3: memref<5x5xf32>, %arg0: memref<5x1xf32>) outs(%arg3: memref<5x5xf32>)
+  // CHECK: %{{.+}} = xsmm.binary.dispatch mul [5, 5, 5, 1, 5] flags = (bcast_row_in1) data_type = f32
+  tpp.sub ins(%arg1: memref<1x5xf32>, %arg3: memref<5x5xf32>) outs(%arg3: memref<5x5xf32>)
+  // CHECK: %{{.+}} = xsmm.binary.dispatch sub [5, 5, 5, 5, 5] flags = (bcast_col_in0) data_type = f32
+  tpp.div ins(%arg3: memref<5x5xf32>, %arg2: memref<1xf32>) outs(%arg3: memref<5x5xf32>)
+  // CHECK: %{{.+}} = xsmm.binary.dispatch div [5, 5, 5, 1, 5] flags = (bcast_scalar_in1) data_type = f32
+  tpp.max ins(%arg0: memref<5x1xf32>, %arg3: memref<5x5xf32>) outs(%arg3: memref<5x5xf32>)
+  // CHECK: %{{.+}} = xsmm.binary.dispatch max [5, 5, 1, 5, 5] flags = (bcast_row_in0) data_type = f32
+  return
+}
@@ -0,0 +1,77 @@
+// RUN: tpp-opt %s -convert-tpp-to-xsmm -split-input-file | FileCheck %s
+
+// CHECK-LABEL: @gelu_to_xsmm(
+// CHECK-SAME:  %[[ARG0:.+]]: memref<5x6xf32>, %[[ARG1:.+]]: memref<5x6xf32>)
+func.func @gelu_to_xsmm(%arg0: memref<5x6xf32>, %arg1: memref<5x6xf32>) {
+  // CHECK: %[[DISPATCH:.+]] = xsmm.unary.dispatch gelu [5, 6, 6, 6] flags = (none) data_type = f32
+  // CHECK-NEXT: xsmm.unary gelu(data_type = f32, %[[DISPATCH]], %[[ARG0]], %[[ARG1]])
+  tpp.gelu ins(%arg0: memref<5x6xf32>) outs(%arg1: memref<5x6xf32>)
+  return
+}
+
+// -----
+
+// CHECK-LABEL: @tanh_to_xsmm(
+// CHECK-SAME:  %[[ARG0:.+]]: memref<5x6xf32>)
+func.func @tanh_to_xsmm(%arg0: memref<5x6xf32>) {
+  // CHECK: %[[DISPATCH:.+]] = xsmm.unary.dispatch tanh [5, 6, 6, 6] flags = (none) data_type = f32
+  // CHECK-NEXT: xsmm.unary tanh(data_type = f32, %[[DISPATCH]], %[[ARG0]], %[[ARG0]])
+  tpp.tanh ins(%arg0: memref<5x6xf32>) outs(%arg0: memref<5x6xf32>)
+  return
+}
+
+// -----
+
+// CHECK-LABEL: @sigmoid_to_xsmm(
+// CHECK-SAME:  %[[ARG0:.+]]: memref<5x6xbf16>)
+func.func @sigmoid_to_xsmm(%arg0: memref<5x6xbf16>) {
+  // CHECK: %[[DISPATCH:.+]] = xsmm.unary.dispatch sigmoid [5, 6, 6, 6] flags = (none) data_type = bf16
+  // CHECK-NEXT: xsmm.unary sigmoid(data_type = bf16, %[[DISPATCH]], %[[ARG0]], %[[ARG0]])
+  tpp.sigmoid ins(%arg0: memref<5x6xbf16>) outs(%arg0: memref<5x6xbf16>)
+  return
+}
+
+// -----
+
+// CHECK-LABEL: @exp_to_xsmm(
+// CHECK-SAME:  %[[ARG0:.+]]: memref<6xf32>, %[[ARG1:.+]]: memref<5x6xf32>)
+func.func @exp_to_xsmm(%arg0: memref<6xf32>, %arg1: memref<5x6xf32>) {
+  // CHECK: %[[DISPATCH:.+]] = xsmm.unary.dispatch exp [5, 6, 6, 6] flags = (bcast_col) data_type = f32
+  // CHECK-NEXT: xsmm.unary exp(data_type = f32, %[[DISPATCH]], %[[ARG0]], %[[ARG1]])
+  tpp.exp ins(%arg0: memref<6xf32>) outs(%arg1: memref<5x6xf32>)
+  return
+}
+
+// -----
+
+func.func @brgemm_fused_gelu(%arg0: memref<3x5x4xf32>, %arg1: memref<3x4x5xf32>,
+                             %arg2: memref<5x5xf32>, %arg3: memref<1x5xf32>) {
+  tpp.fused_brgemm [unary = gelu, binary = add]
+                  ins(%arg0: memref<3x5x4xf32>, %arg1: memref<3x4x5xf32>,
+                       %arg2: memref<5x5xf32>, %arg3: memref<1x5xf32>)
+                  outs(%arg2: memref<5x5xf32>)
+  return
+}
+
+// CHECK-LABEL: brgemm_fused_gelu
+// CHECK-SAME:  %[[ARG0:.+]]: memref<3x5x4xf32>, %[[ARG1:.+]]: memref<3x4x5xf32>,
+// CHECK-SAME:  %[[ARG2:.+]]: memref<5x5xf32>, %[[ARG3:.+]]: memref<1x5xf32>
+// CHECK: %[[C3:.+]] = arith.constant 3 : i64
+// CHECK: %[[DIS:.+]] = xsmm.fused_brgemm.dispatch [5, 5, 4, 4, 5, 5]
+// CHECK-SAME:  [add,gelu]  flags = (none)  binary_flags = (bcast_col_in0)  unary_flags = (none) data_type = f32
+// CHECK: xsmm.fused_brgemm(data_type = f32, %[[DIS]], %[[ARG0]], %[[ARG1]], %[[ARG2]], %[[ARG3]], %[[C3]])
+
+// -----
+
+func.func @brgemm_fused_sigmoid(%arg0: memref<3x5x4xf32>, %arg1: memref<3x4x5xf32>,
+                                %arg2: memref<5x5xf32>) {
+  tpp.fused_brgemm [unary = sigmoid, binary = none]
+                  ins(%arg0: memref<3x5x4xf32>, %arg1: memref<3x4x5xf32>,
+                       %arg2: memref<5x5xf32>, %arg2: memref<5x5xf32>)
+                  outs(%arg2: memref<5x5xf32>)
+  return
+}
+
+// CHECK-LABEL: brgemm_fused_sigmoid
+// CHECK: xsmm.fused_brgemm.dispatch [5, 5, 4, 4, 5, 5] [none,sigmoid]
+// CHECK: xsmm.fused_brgemm(data_type = f32
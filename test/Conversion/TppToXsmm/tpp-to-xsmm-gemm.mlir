@@ -22,3 +22,96 @@ func.func @vnni_gemm_to_xsmm(%arg0: memref<128x1024xbf16>, %arg1: memref<512x204
            outs(%arg2: memref<128x2048xbf16>)
   return
 }
+
+// -----
+
+// i8 inputs accumulate in i32, the dispatch is keyed on the input type.
+// CHECK-LABEL: @i8_gemm_to_xsmm(
+// CHECK-SAME: %[[ARG0:.+]]: memref<4x8xi8>, %[[ARG1:.+]]: memref<8x4xi8>, %[[ARG2:.+]]: memref<4x4xi32>
+func.func @i8_gemm_to_xsmm(%arg0: memref<4x8xi8>, %arg1: memref<8x4xi8>,
+                           %arg2: memref<4x4xi32>) {
+  // CHECK: %[[DISPATCH:.+]] = xsmm.gemm.dispatch [4, 4, 8, 8, 4, 4] flags = (none) data_type = i8
+  // CHECK-NEXT: xsmm.gemm(data_type = i8, %[[DISPATCH]], %[[ARG0]], %[[ARG1]], %[[ARG2]])
+  tpp.gemm ins(%arg0: memref<4x8xi8>, %arg1: memref<8x4xi8>, %arg2: memref<4x4xi32>)
+           outs(%arg2: memref<4x4xi32>)
+  return
+}
+
+// -----
+
+// i8 is packed by 4 on K in VNNI layout.
+// CHECK-LABEL: @vnni_i8_gemm_to_xsmm(
+// CHECK-SAME: %[[ARG0:.+]]: memref<32x32xi8>, %[[ARG1:.+]]: memref<8x64x4xi8>, %[[ARG2:.+]]: memref<32x64xi32>
+func.func @vnni_i8_gemm_to_xsmm(%arg0: memref<32x32xi8>, %arg1: memref<8x64x4xi8>,
+                                %arg2: memref<32x64xi32>) {
+  // CHECK: %[[DISPATCH:.+]] = xsmm.gemm.dispatch [32, 64, 32, 32, 64, 64] flags = (vnni_b) data_type = i8
+  // CHECK-NEXT: xsmm.gemm(data_type = i8, %[[DISPATCH]], %[[ARG0]], %[[ARG1]], %[[ARG2]])
+  tpp.gemm ins(%arg0: memref<32x32xi8>, %arg1: memref<8x64x4xi8>, %arg2: memref<32x64xi32>)
+           outs(%arg2: memref<32x64xi32>)
+  return
+}
+
+// -----
+
+// Gemms accumulating into the same output map to one address-based brgemm.
+// CHECK-LABEL: @gemm_chain_to_xsmm(
+// CHECK-SAME: %[[ARG0:.+]]: memref<4x8xf32>, %[[ARG1:.+]]: memref<8x4xf32>, %[[ARG2:.+]]: memref<4x8xf32>,
+// CHECK-SAME: %[[ARG3:.+]]: memref<8x4xf32>, %[[ARG4:.+]]: memref<4x4xf32>
+func.func @gemm_chain_to_xsmm(%arg0: memref<4x8xf32>, %arg1: memref<8x4xf32>,
+                              %arg2: memref<4x8xf32>, %arg3: memref<8x4xf32>,
+                              %arg4: memref<4x4xf32>) {
+  // CHECK: memref.alloca() : memref<2xi64>
+  // CHECK: memref.alloca() : memref<2xi64>
+  // CHECK: memref.extract_aligned_pointer_as_index %[[ARG0]]
+  // CHECK: memref.store %{{.+}}, %[[ADDRS_A:.+]][%{{.+}}] : memref<2xi64>
+  // CHECK: memref.extract_aligned_pointer_as_index %[[ARG2]]
+  // CHECK: memref.store %{{.+}}, %[[ADDRS_A]][%{{.+}}] : memref<2xi64>
+  // CHECK: memref.extract_aligned_pointer_as_index %[[ARG1]]
+  // CHECK: memref.store %{{.+}}, %[[ADDRS_B:.+]][%{{.+}}] : memref<2xi64>
+  // CHECK: memref.extract_aligned_pointer_as_index %[[ARG3]]
+  // CHECK: memref.store %{{.+}}, %[[ADDRS_B]][%{{.+}}] : memref<2xi64>
+  // CHECK: %[[DISPATCH:.+]] = xsmm.brgemm_addr.dispatch [4, 4, 8, 8, 4, 4] flags = (none) data_type = f32
+  // CHECK-NEXT: xsmm.brgemm_addr(data_type = f32, %[[DISPATCH]], %[[ADDRS_A]], %[[ADDRS_B]], %[[ARG4]], %{{.+}})
+  // CHECK-NOT: xsmm.gemm
+  tpp.gemm ins(%arg0: memref<4x8xf32>, %arg1: memref<8x4xf32>, %arg4: memref<4x4xf32>)
+           outs(%arg4: memref<4x4xf32>)
+  tpp.gemm ins(%arg2: memref<4x8xf32>, %arg3: memref<8x4xf32>, %arg4: memref<4x4xf32>)
+           outs(%arg4: memref<4x4xf32>)
+  return
+}
+
+// -----
+
+// With square B tiles a transposed and a plain gemm have the same types, but
+// need different kernels: they are not chained.
+// CHECK-LABEL: @gemm_chain_mixed_transpose_b(
+// CHECK-SAME: %[[ARG0:.+]]: memref<4x4xf32>, %[[ARG1:.+]]: memref<4x4xf32>, %[[ARG2:.+]]: memref<4x4xf32>,
+// CHECK-SAME: %[[ARG3:.+]]: memref<4x4xf32>, %[[ARG4:.+]]: memref<4x4xf32>
+func.func @gemm_chain_mixed_transpose_b(%arg0: memref<4x4xf32>, %arg1: memref<4x4xf32>,
+                                        %arg2: memref<4x4xf32>, %arg3: memref<4x4xf32>,
+                                        %arg4: memref<4x4xf32>) {
+  // CHECK-NOT: xsmm.brgemm_addr
+  // CHECK: %[[DISPATCH:.+]] = xsmm.gemm.dispatch [4, 4, 4, 4, 4, 4] flags = (trans_b) data_type = f32
+  // CHECK-NEXT: xsmm.gemm(data_type = f32, %[[DISPATCH]], %[[ARG0]], %[[ARG1]], %[[ARG4]])
+  // CHECK: %[[DISPATCH1:.+]] = xsmm.gemm.dispatch [4, 4, 4, 4, 4, 4] flags = (none) data_type = f32
+  // CHECK-NEXT: xsmm.gemm(data_type = f32, %[[DISPATCH1]], %[[ARG2]], %[[ARG3]], %[[ARG4]])
+  // CHECK-NOT: xsmm.brgemm_addr
+  tpp.gemm ins(%arg0: memref<4x4xf32>, %arg1: memref<4x4xf32>, %arg4: memref<4x4xf32>)
+           outs(%arg4: memref<4x4xf32>) {transpose_b}
+  tpp.gemm ins(%arg2: memref<4x4xf32>, %arg3: memref<4x4xf32>, %arg4: memref<4x4xf32>)
+           outs(%arg4: memref<4x4xf32>)
+  return
+}
+
+// -----
+
+// CHECK-LABEL: @gemm_transpose_b_to_xsmm(
+// CHECK-SAME: %[[ARG0:.+]]: memref<4x8xf32>, %[[ARG1:.+]]: memref<2x8xf32>, %[[ARG2:.+]]: memref<4x2xf32>)
+func.func @gemm_transpose_b_to_xsmm(%arg0: memref<4x8xf32>, %arg1: memref<2x8xf32>,
+                                    %arg2: memref<4x2xf32>) {
+  // CHECK: %[[DISPATCH:.+]] = xsmm.gemm.dispatch [4, 2, 8, 8, 8, 2] flags = (trans_b) data_type = f32
+  // CHECK-NEXT: xsmm.gemm(data_type = f32, %[[DISPATCH]], %[[ARG0]], %[[ARG1]], %[[ARG2]])
+  tpp.gemm ins(%arg0: memref<4x8xf32>, %arg1: memref<2x8xf32>, %arg2: memref<4x2xf32>)
+           outs(%arg2: memref<4x2xf32>) {transpose_b}
+  return
+}
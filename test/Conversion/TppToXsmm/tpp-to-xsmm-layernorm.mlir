@@ -0,0 +1,130 @@
+// RUN: tpp-opt %s -convert-tpp-to-xsmm -split-input-file | FileCheck %s
+
+// CHECK-LABEL: @layernorm_to_xsmm(
+// CHECK-SAME:  %[[ARG0:.+]]: memref<4x8xf32>, %[[ARG1:.+]]: memref<1x8xf32>,
+// CHECK-SAME:  %[[ARG2:.+]]: memref<1x8xf32>, %[[ARG3:.+]]: memref<4x8xf32>)
+func.func @layernorm_to_xsmm(%arg0: memref<4x8xf32>, %arg1: memref<1x8xf32>,
+                             %arg2: memref<1x8xf32>, %arg3: memref<4x8xf32>) {
+  // CHECK-DAG: %[[MEAN:.+]] = memref.alloca() : memref<4x1xf32>
+  // CHECK-DAG: %[[RSTD:.+]] = memref.alloca() : memref<4x1xf32>
+  // CHECK-DAG: %[[SQUARED:.+]] = memref.alloca() : memref<4x8xf32>
+  // CHECK: %[[SUM:.+]] = xsmm.unary.dispatch reduce_x_op_add [4, 8, 8, 8] flags = (reduce_rows) data_type = f32
+  // CHECK-NEXT: xsmm.unary reduce_x_op_add(data_type = f32, %[[SUM]], %[[ARG0]], %[[MEAN]])
+  // CHECK: scf.for
+  // CHECK:   arith.mulf
+  // CHECK: %[[SUB:.+]] = xsmm.binary.dispatch sub [4, 8, 8, 1, 8] flags = (bcast_row_in1) data_type = f32
+  // CHECK-NEXT: xsmm.binary sub(data_type = f32, %[[SUB]], %[[ARG0]], %[[MEAN]], %[[ARG3]])
+  // CHECK: %[[SQ:.+]] = xsmm.binary.dispatch mul [4, 8, 8, 8, 8] flags = (none) data_type = f32
+  // CHECK-NEXT: xsmm.binary mul(data_type = f32, %[[SQ]], %[[ARG3]], %[[ARG3]], %[[SQUARED]])
+  // CHECK: %[[SQSUM:.+]] = xsmm.unary.dispatch reduce_x_op_add [4, 8, 8, 8] flags = (reduce_rows) data_type = f32
+  // CHECK-NEXT: xsmm.unary reduce_x_op_add(data_type = f32, %[[SQSUM]], %[[SQUARED]], %[[RSTD]])
+  // CHECK: scf.for
+  // CHECK:   arith.mulf
+  // CHECK:   arith.addf
+  // CHECK:   math.rsqrt
+  // CHECK: %[[SCALE:.+]] = xsmm.binary.dispatch mul [4, 8, 8, 1, 8] flags = (bcast_row_in1) data_type = f32
+  // CHECK-NEXT: xsmm.binary mul(data_type = f32, %[[SCALE]], %[[ARG3]], %[[RSTD]], %[[ARG3]])
+  // CHECK: %[[GAMMA:.+]] = xsmm.binary.dispatch mul {{.+}} flags = (bcast_col_in1) data_type = f32
+  // CHECK-NEXT: xsmm.binary mul(data_type = f32, %[[GAMMA]], %[[ARG3]], %[[ARG1]], %[[ARG3]])
+  // CHECK: %[[BETA:.+]] = xsmm.binary.dispatch add {{.+}} flags = (bcast_col_in1) data_type = f32
+  // CHECK-NEXT: xsmm.binary add(data_type = f32, %[[BETA]], %[[ARG3]], %[[ARG2]], %[[ARG3]])
+  tpp.layernorm ins(%arg0: memref<4x8xf32>, %arg1: memref<1x8xf32>, %arg2: memref<1x8xf32>)
+                outs(%arg3: memref<4x8xf32>) {epsilon = 1.0e-05 : f32}
+  return
+}
+
+// -----
+
+// 8 rows of 1024 f32 fill the L1 budget: the kernels run on blocks of 8 rows,
+// in parallel, and the scratch buffers of each block hold a single block.
+// CHECK-LABEL: @layernorm_row_blocks(
+// CHECK-SAME:  %[[ARG0:.+]]: memref<64x1024xf32>, %[[ARG1:.+]]: memref<1x1024xf32>,
+// CHECK-SAME:  %[[ARG2:.+]]: memref<1x1024xf32>, %[[ARG3:.+]]: memref<64x1024xf32>)
+func.func @layernorm_row_blocks(%arg0: memref<64x1024xf32>,
+                                %arg1: memref<1x1024xf32>,
+                                %arg2: memref<1x1024xf32>,
+                                %arg3: memref<64x1024xf32>) {
+  // CHECK-DAG: %[[C0:.+]] = arith.constant 0 : index
+  // CHECK-DAG: %[[C8:.+]] = arith.constant 8 : index
+  // CHECK-DAG: %[[C64:.+]] = arith.constant 64 : index
+  // CHECK: scf.parallel (%[[I:.+]]) = (%[[C0]]) to (%[[C64]]) step (%[[C8]])
+  // CHECK-DAG: %[[MEAN:.+]] = memref.alloca() : memref<8x1xf32>
+  // CHECK-DAG: %[[RSTD:.+]] = memref.alloca() : memref<8x1xf32>
+  // CHECK-DAG: %[[SQUARED:.+]] = memref.alloca() : memref<8x1024xf32>
+  // CHECK-DAG: %[[IN:.+]] = memref.subview %[[ARG0]][%[[I]], 0] [8, 1024] [1, 1]
+  // CHECK-DAG: %[[OUT:.+]] = memref.subview %[[ARG3]][%[[I]], 0] [8, 1024] [1, 1]
+  // CHECK: %[[SUM:.+]] = xsmm.unary.dispatch reduce_x_op_add [8, 1024, 1024, 1024] flags = (reduce_rows) data_type = f32
+  // CHECK-NEXT: xsmm.unary reduce_x_op_add(data_type = f32, %[[SUM]], %[[IN]], %[[MEAN]])
+  // CHECK: scf.for
+  // CHECK:   arith.mulf
+  // CHECK: %[[SUB:.+]] = xsmm.binary.dispatch sub [8, 1024, 1024, 1, 1024] flags = (bcast_row_in1) data_type = f32
+  // CHECK-NEXT: xsmm.binary sub(data_type = f32, %[[SUB]], %[[IN]], %[[MEAN]], %[[OUT]])
+  // CHECK: %[[SQ:.+]] = xsmm.binary.dispatch mul [8, 1024, 1024, 1024, 1024] flags = (none) data_type = f32
+  // CHECK-NEXT: xsmm.binary mul(data_type = f32, %[[SQ]], %[[OUT]], %[[OUT]], %[[SQUARED]])
+  // CHECK: %[[SQSUM:.+]] = xsmm.unary.dispatch reduce_x_op_add [8, 1024, 1024, 1024] flags = (reduce_rows) data_type = f32
+  // CHECK-NEXT: xsmm.unary reduce_x_op_add(data_type = f32, %[[SQSUM]], %[[SQUARED]], %[[RSTD]])
+  // CHECK: scf.for
+  // CHECK:   math.rsqrt
+  // CHECK: %[[SCALE:.+]] = xsmm.binary.dispatch mul [8, 1024, 1024, 1, 1024] flags = (bcast_row_in1) data_type = f32
+  // CHECK-NEXT: xsmm.binary mul(data_type = f32, %[[SCALE]], %[[OUT]], %[[RSTD]], %[[OUT]])
+  // CHECK: %[[GAMMA:.+]] = xsmm.binary.dispatch mul {{.+}} flags = (bcast_col_in1) data_type = f32
+  // CHECK-NEXT: xsmm.binary mul(data_type = f32, %[[GAMMA]], %[[OUT]], %[[ARG1]], %[[OUT]])
+  // CHECK: %[[BETA:.+]] = xsmm.binary.dispatch add {{.+}} flags = (bcast_col_in1) data_type = f32
+  // CHECK-NEXT: xsmm.binary add(data_type = f32, %[[BETA]], %[[OUT]], %[[ARG2]], %[[OUT]])
+  tpp.layernorm ins(%arg0: memref<64x1024xf32>, %arg1: memref<1x1024xf32>, %arg2: memref<1x1024xf32>)
+                outs(%arg3: memref<64x1024xf32>) {epsilon = 1.0e-05 : f32}
+  return
+}
+
+// -----
+
+// A dynamic number of rows is processed one row at a time.
+// CHECK-LABEL: @layernorm_dynamic_rows(
+// CHECK-SAME:  %[[ARG0:.+]]: memref<?x8xf32>
+func.func @layernorm_dynamic_rows(%arg0: memref<?x8xf32>,
+                                  %arg1: memref<1x8xf32>,
+                                  %arg2: memref<1x8xf32>,
+                                  %arg3: memref<?x8xf32>) {
+  // CHECK: scf.parallel (%[[I:.+]]) =
+  // CHECK-DAG: %[[MEAN:.+]] = memref.alloca() : memref<1x1xf32>
+  // CHECK-DAG: %[[RSTD:.+]] = memref.alloca() : memref<1x1xf32>
+  // CHECK-DAG: %[[SQUARED:.+]] = memref.alloca() : memref<1x8xf32>
+  // CHECK-DAG: %[[IN:.+]] = memref.subview %[[ARG0]][%[[I]], 0] [1, 8] [1, 1]
+  // CHECK: %[[SUM:.+]] = xsmm.unary.dispatch reduce_x_op_add [1, 8, 8, 8] flags = (reduce_rows) data_type = f32
+  // CHECK-NEXT: xsmm.unary reduce_x_op_add(data_type = f32, %[[SUM]], %[[IN]], %[[MEAN]])
+  tpp.layernorm ins(%arg0: memref<?x8xf32>, %arg1: memref<1x8xf32>, %arg2: memref<1x8xf32>)
+                outs(%arg3: memref<?x8xf32>) {epsilon = 1.0e-05 : f32}
+  return
+}
+
+// -----
+
+// Each iteration of an enclosing scf.parallel gets its own scratch buffers.
+// CHECK-LABEL: @layernorm_in_parallel(
+// CHECK-SAME:  %[[ARG0:.+]]: memref<2x4x8xf32>
+func.func @layernorm_in_parallel(%arg0: memref<2x4x8xf32>,
+                                 %arg1: memref<1x8xf32>,
+                                 %arg2: memref<1x8xf32>,
+                                 %arg3: memref<2x4x8xf32>) {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c2 = arith.constant 2 : index
+  // CHECK: scf.parallel (%[[I:.+]]) =
+  // CHECK-DAG: %[[MEAN:.+]] = memref.alloca() : memref<4x1xf32>
+  // CHECK-DAG: %[[RSTD:.+]] = memref.alloca() : memref<4x1xf32>
+  // CHECK-DAG: %[[SQUARED:.+]] = memref.alloca() : memref<4x8xf32>
+  // CHECK-DAG: %[[IN:.+]] = memref.subview %[[ARG0]][%[[I]], 0, 0] [1, 4, 8] [1, 1, 1]
+  // CHECK: %[[SUM:.+]] = xsmm.unary.dispatch reduce_x_op_add [4, 8, 8, 8] flags = (reduce_rows) data_type = f32
+  // CHECK-NEXT: xsmm.unary reduce_x_op_add(data_type = f32, %[[SUM]], %[[IN]], %[[MEAN]])
+  scf.parallel (%i) = (%c0) to (%c2) step (%c1) {
+    %in = memref.subview %arg0[%i, 0, 0] [1, 4, 8] [1, 1, 1]
+      : memref<2x4x8xf32> to memref<4x8xf32, strided<[8, 1], offset: ?>>
+    %out = memref.subview %arg3[%i, 0, 0] [1, 4, 8] [1, 1, 1]
+      : memref<2x4x8xf32> to memref<4x8xf32, strided<[8, 1], offset: ?>>
+    tpp.layernorm ins(%in: memref<4x8xf32, strided<[8, 1], offset: ?>>,
+                      %arg1: memref<1x8xf32>, %arg2: memref<1x8xf32>)
+                  outs(%out: memref<4x8xf32, strided<[8, 1], offset: ?>>)
+                  {epsilon = 1.0e-05 : f32}
+  }
+  return
+}
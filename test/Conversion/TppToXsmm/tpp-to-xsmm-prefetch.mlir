@@ -0,0 +1,96 @@
+// RUN: tpp-opt %s -convert-tpp-to-xsmm="prefetch=true" -split-input-file | FileCheck %s
+
+// CHECK-LABEL: @brgemm_prefetch_parallel(
+// CHECK-SAME:  %[[ARG0:.+]]: memref<4x8x32x32xf32>, %[[ARG1:.+]]: memref<16x8x32x32xf32>,
+// CHECK-SAME:  %[[ARG2:.+]]: memref<4x16x32x32xf32>)
+func.func @brgemm_prefetch_parallel(%arg0: memref<4x8x32x32xf32>,
+                                    %arg1: memref<16x8x32x32xf32>,
+                                    %arg2: memref<4x16x32x32xf32>) {
+  // CHECK-DAG: %[[C1:.+]] = arith.constant 1 : index
+  // CHECK-DAG: %[[C16:.+]] = arith.constant 16 : index
+  // CHECK-DAG: %[[BATCH:.+]] = arith.constant 8 : i64
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c4 = arith.constant 4 : index
+  %c16 = arith.constant 16 : index
+  // CHECK: scf.parallel (%[[I:.+]], %[[J:.+]]) =
+  scf.parallel (%i, %j) = (%c0, %c0) to (%c4, %c16) step (%c1, %c1) {
+    // CHECK: %[[A:.+]] = memref.subview %[[ARG0]][%[[I]], 0, 0, 0]
+    %a = memref.subview %arg0[%i, 0, 0, 0] [1, 8, 32, 32] [1, 1, 1, 1]
+      : memref<4x8x32x32xf32> to memref<8x32x32xf32, strided<[1024, 32, 1], offset: ?>>
+    // CHECK: %[[B:.+]] = memref.subview %[[ARG1]][%[[J]], 0, 0, 0]
+    %b = memref.subview %arg1[%j, 0, 0, 0] [1, 8, 32, 32] [1, 1, 1, 1]
+      : memref<16x8x32x32xf32> to memref<8x32x32xf32, strided<[1024, 32, 1], offset: ?>>
+    // CHECK: %[[C:.+]] = memref.subview %[[ARG2]][%[[I]], %[[J]], 0, 0]
+    %c = memref.subview %arg2[%i, %j, 0, 0] [1, 1, 32, 32] [1, 1, 1, 1]
+      : memref<4x16x32x32xf32> to memref<32x32xf32, strided<[32, 1], offset: ?>>
+    // CHECK: %[[NEXT:.+]] = arith.addi %[[J]], %[[C1]] : index
+    // CHECK-NEXT: %[[IN_BOUNDS:.+]] = arith.cmpi slt, %[[NEXT]], %[[C16]] : index
+    // CHECK-NEXT: %[[NEXT_J:.+]] = arith.select %[[IN_BOUNDS]], %[[NEXT]], %[[J]] : index
+    // CHECK-NEXT: %[[NEXT_B:.+]] = memref.subview %[[ARG1]][%[[NEXT_J]], 0, 0, 0]
+    // CHECK-NEXT: %[[DISPATCH:.+]] = xsmm.brgemm_prefetch.dispatch [32, 32, 32, 32, 32, 32] flags = (none) data_type = f32
+    // CHECK-NEXT: xsmm.brgemm_prefetch(data_type = f32, %[[DISPATCH]], %[[A]], %[[B]], %[[C]], %[[A]], %[[NEXT_B]], %[[BATCH]])
+    tpp.brgemm ins(%a : memref<8x32x32xf32, strided<[1024, 32, 1], offset: ?>>,
+                   %b : memref<8x32x32xf32, strided<[1024, 32, 1], offset: ?>>,
+                   %c : memref<32x32xf32, strided<[32, 1], offset: ?>>)
+               outs(%c : memref<32x32xf32, strided<[32, 1], offset: ?>>)
+    scf.yield
+  }
+  return
+}
+
+// -----
+
+#map = affine_map<(d0) -> (d0 * 32)>
+
+// CHECK: #[[MAP:.+]] = affine_map<(d0) -> (d0 * 32)>
+
+// CHECK-LABEL: @gemm_prefetch_for(
+// CHECK-SAME:  %[[ARG0:.+]]: memref<128x64xf32>, %[[ARG1:.+]]: memref<64x32xf32>,
+// CHECK-SAME:  %[[ARG2:.+]]: memref<128x32xf32>)
+func.func @gemm_prefetch_for(%arg0: memref<128x64xf32>, %arg1: memref<64x32xf32>,
+                             %arg2: memref<128x32xf32>) {
+  // CHECK-DAG: %[[C1:.+]] = arith.constant 1 : index
+  // CHECK-DAG: %[[C4:.+]] = arith.constant 4 : index
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c4 = arith.constant 4 : index
+  // CHECK: scf.for %[[I:.+]] = %{{.+}} to %[[C4]] step %[[C1]]
+  scf.for %i = %c0 to %c4 step %c1 {
+    // CHECK: %[[OFF:.+]] = affine.apply #[[MAP]](%[[I]])
+    %off = affine.apply #map(%i)
+    // CHECK: %[[A:.+]] = memref.subview %[[ARG0]][%[[OFF]], 0]
+    %a = memref.subview %arg0[%off, 0] [32, 64] [1, 1]
+      : memref<128x64xf32> to memref<32x64xf32, strided<[64, 1], offset: ?>>
+    // CHECK: %[[C:.+]] = memref.subview %[[ARG2]][%[[OFF]], 0]
+    %c = memref.subview %arg2[%off, 0] [32, 32] [1, 1]
+      : memref<128x32xf32> to memref<32x32xf32, strided<[32, 1], offset: ?>>
+    // CHECK: %[[NEXT:.+]] = arith.addi %[[I]], %[[C1]] : index
+    // CHECK-NEXT: %[[IN_BOUNDS:.+]] = arith.cmpi slt, %[[NEXT]], %[[C4]] : index
+    // CHECK-NEXT: %[[NEXT_I:.+]] = arith.select %[[IN_BOUNDS]], %[[NEXT]], %[[I]] : index
+    // CHECK-NEXT: %[[NEXT_OFF:.+]] = affine.apply #[[MAP]](%[[NEXT_I]])
+    // CHECK-NEXT: %[[NEXT_A:.+]] = memref.subview %[[ARG0]][%[[NEXT_OFF]], 0]
+    // CHECK-NEXT: %[[DISPATCH:.+]] = xsmm.gemm_prefetch.dispatch [32, 32, 64, 64, 32, 32] flags = (none) data_type = f32
+    // CHECK-NEXT: xsmm.gemm_prefetch(data_type = f32, %[[DISPATCH]], %[[A]], %[[ARG1]], %[[C]], %[[NEXT_A]], %[[ARG1]])
+    tpp.gemm ins(%a : memref<32x64xf32, strided<[64, 1], offset: ?>>,
+                 %arg1 : memref<64x32xf32>,
+                 %c : memref<32x32xf32, strided<[32, 1], offset: ?>>)
+             outs(%c : memref<32x32xf32, strided<[32, 1], offset: ?>>)
+  }
+  return
+}
+
+// -----
+
+// Operands do not change across iterations, nothing to prefetch.
+// CHECK-LABEL: @gemm_no_prefetch
+func.func @gemm_no_prefetch(%arg0: memref<32x64xf32>, %arg1: memref<64x32xf32>,
+                            %arg2: memref<32x32xf32>) {
+  // CHECK-NOT: prefetch
+  // CHECK: xsmm.gemm.dispatch
+  // CHECK: xsmm.gemm(
+  tpp.gemm ins(%arg0 : memref<32x64xf32>, %arg1 : memref<64x32xf32>,
+               %arg2 : memref<32x32xf32>)
+           outs(%arg2 : memref<32x32xf32>)
+  return
+}
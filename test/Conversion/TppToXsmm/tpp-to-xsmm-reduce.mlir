@@ -0,0 +1,56 @@
+// RUN: tpp-opt %s -convert-tpp-to-xsmm -split-input-file | FileCheck %s
+
+// CHECK-LABEL: @reduce_add_rows_to_xsmm(
+// CHECK-SAME:  %[[ARG0:.+]]: memref<4x8xf32>, %[[ARG1:.+]]: memref<4x1xf32>)
+func.func @reduce_add_rows_to_xsmm(%arg0: memref<4x8xf32>, %arg1: memref<4x1xf32>) {
+  // CHECK: %[[DISPATCH:.+]] = xsmm.unary.dispatch reduce_x_op_add [4, 8, 8, 8] flags = (reduce_rows) data_type = f32
+  // CHECK-NEXT: xsmm.unary reduce_x_op_add(data_type = f32, %[[DISPATCH]], %[[ARG0]], %[[ARG1]])
+  tpp.reduce_add ins(%arg0: memref<4x8xf32>) outs(%arg1: memref<4x1xf32>)
+  return
+}
+
+// -----
+
+// CHECK-LABEL: @reduce_add_cols_to_xsmm(
+// CHECK-SAME:  %[[ARG0:.+]]: memref<4x8xf32>, %[[ARG1:.+]]: memref<1x8xf32>)
+func.func @reduce_add_cols_to_xsmm(%arg0: memref<4x8xf32>, %arg1: memref<1x8xf32>) {
+  // CHECK: %[[DISPATCH:.+]] = xsmm.unary.dispatch reduce_x_op_add [4, 8, 8, 8] flags = (reduce_cols) data_type = f32
+  // CHECK-NEXT: xsmm.unary reduce_x_op_add(data_type = f32, %[[DISPATCH]], %[[ARG0]], %[[ARG1]])
+  tpp.reduce_add ins(%arg0: memref<4x8xf32>) outs(%arg1: memref<1x8xf32>)
+  return
+}
+
+// -----
+
+// CHECK-LABEL: @reduce_max_rows_to_xsmm(
+// CHECK-SAME:  %[[ARG0:.+]]: memref<4x8xbf16>, %[[ARG1:.+]]: memref<4x1xbf16>)
+func.func @reduce_max_rows_to_xsmm(%arg0: memref<4x8xbf16>, %arg1: memref<4x1xbf16>) {
+  // CHECK: %[[DISPATCH:.+]] = xsmm.unary.dispatch reduce_x_op_max [4, 8, 8, 8] flags = (reduce_rows) data_type = bf16
+  // CHECK-NEXT: xsmm.unary reduce_x_op_max(data_type = bf16, %[[DISPATCH]], %[[ARG0]], %[[ARG1]])
+  tpp.reduce_max ins(%arg0: memref<4x8xbf16>) outs(%arg1: memref<4x1xbf16>)
+  return
+}
+
+// -----
+
+// CHECK-LABEL: @reduce_max_strided_input_to_xsmm(
+// CHECK-SAME:  %[[ARG0:.+]]: memref<4x8xf32, strided<[16, 1], offset: ?>>, %[[ARG1:.+]]: memref<1x8xf32>)
+func.func @reduce_max_strided_input_to_xsmm(%arg0: memref<4x8xf32, strided<[16, 1], offset: ?>>,
+                                            %arg1: memref<1x8xf32>) {
+  // CHECK: %[[DISPATCH:.+]] = xsmm.unary.dispatch reduce_x_op_max [4, 8, 16, 8] flags = (reduce_cols) data_type = f32
+  // CHECK-NEXT: xsmm.unary reduce_x_op_max(data_type = f32, %[[DISPATCH]], %[[ARG0]], %[[ARG1]])
+  tpp.reduce_max ins(%arg0: memref<4x8xf32, strided<[16, 1], offset: ?>>) outs(%arg1: memref<1x8xf32>)
+  return
+}
+
+// -----
+
+// The reduced values of each row are not contiguous in the output.
+// CHECK-LABEL: @reduce_add_strided_output(
+func.func @reduce_add_strided_output(%arg0: memref<4x8xf32>,
+                                     %arg1: memref<4x1xf32, strided<[8, 1], offset: ?>>) {
+  // CHECK-NOT: xsmm.unary.dispatch
+  // CHECK: tpp.reduce_add
+  tpp.reduce_add ins(%arg0: memref<4x8xf32>) outs(%arg1: memref<4x1xf32, strided<[8, 1], offset: ?>>)
+  return
+}
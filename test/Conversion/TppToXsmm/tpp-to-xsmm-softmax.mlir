@@ -0,0 +1,67 @@
+// RUN: tpp-opt %s -convert-tpp-to-xsmm -split-input-file | FileCheck %s
+
+// CHECK-LABEL: @softmax_to_xsmm(
+// CHECK-SAME:  %[[ARG0:.+]]: memref<4x8xf32>, %[[ARG1:.+]]: memref<4x8xf32>)
+func.func @softmax_to_xsmm(%arg0: memref<4x8xf32>, %arg1: memref<4x8xf32>) {
+  // CHECK: %[[ROWS:.+]] = memref.alloca() : memref<4x1xf32>
+  // CHECK: %[[MAX:.+]] = xsmm.unary.dispatch reduce_x_op_max [4, 8, 8, 8] flags = (reduce_rows) data_type = f32
+  // CHECK-NEXT: xsmm.unary reduce_x_op_max(data_type = f32, %[[MAX]], %[[ARG0]], %[[ROWS]])
+  // CHECK: %[[SUB:.+]] = xsmm.binary.dispatch sub [4, 8, 8, 1, 8] flags = (bcast_row_in1) data_type = f32
+  // CHECK-NEXT: xsmm.binary sub(data_type = f32, %[[SUB]], %[[ARG0]], %[[ROWS]], %[[ARG1]])
+  // CHECK: %[[EXP:.+]] = xsmm.unary.dispatch exp [4, 8, 8, 8] flags = (none) data_type = f32
+  // CHECK-NEXT: xsmm.unary exp(data_type = f32, %[[EXP]], %[[ARG1]], %[[ARG1]])
+  // CHECK: %[[SUM:.+]] = xsmm.unary.dispatch reduce_x_op_add [4, 8, 8, 8] flags = (reduce_rows) data_type = f32
+  // CHECK-NEXT: xsmm.unary reduce_x_op_add(data_type = f32, %[[SUM]], %[[ARG1]], %[[ROWS]])
+  // CHECK: %[[DIV:.+]] = xsmm.binary.dispatch div [4, 8, 8, 1, 8] flags = (bcast_row_in1) data_type = f32
+  // CHECK-NEXT: xsmm.binary div(data_type = f32, %[[DIV]], %[[ARG1]], %[[ROWS]], %[[ARG1]])
+  tpp.softmax ins(%arg0: memref<4x8xf32>) outs(%arg1: memref<4x8xf32>)
+  return
+}
+
+// -----
+
+// 8 rows of 1024 f32 fill the L1 budget: the kernels run on blocks of 8 rows,
+// in parallel, each with its own scratch buffer.
+// CHECK-LABEL: @softmax_row_blocks(
+// CHECK-SAME:  %[[ARG0:.+]]: memref<64x1024xf32>, %[[ARG1:.+]]: memref<64x1024xf32>)
+func.func @softmax_row_blocks(%arg0: memref<64x1024xf32>,
+                              %arg1: memref<64x1024xf32>) {
+  // CHECK-DAG: %[[C0:.+]] = arith.constant 0 : index
+  // CHECK-DAG: %[[C8:.+]] = arith.constant 8 : index
+  // CHECK-DAG: %[[C64:.+]] = arith.constant 64 : index
+  // CHECK: scf.parallel (%[[I:.+]]) = (%[[C0]]) to (%[[C64]]) step (%[[C8]])
+  // CHECK-DAG: %[[ROWS:.+]] = memref.alloca() : memref<8x1xf32>
+  // CHECK-DAG: %[[IN:.+]] = memref.subview %[[ARG0]][%[[I]], 0] [8, 1024] [1, 1]
+  // CHECK-DAG: %[[OUT:.+]] = memref.subview %[[ARG1]][%[[I]], 0] [8, 1024] [1, 1]
+  // CHECK: %[[MAX:.+]] = xsmm.unary.dispatch reduce_x_op_max [8, 1024, 1024, 1024] flags = (reduce_rows) data_type = f32
+  // CHECK-NEXT: xsmm.unary reduce_x_op_max(data_type = f32, %[[MAX]], %[[IN]], %[[ROWS]])
+  // CHECK: %[[SUB:.+]] = xsmm.binary.dispatch sub [8, 1024, 1024, 1, 1024] flags = (bcast_row_in1) data_type = f32
+  // CHECK-NEXT: xsmm.binary sub(data_type = f32, %[[SUB]], %[[IN]], %[[ROWS]], %[[OUT]])
+  // CHECK: %[[EXP:.+]] = xsmm.unary.dispatch exp [8, 1024, 1024, 1024] flags = (none) data_type = f32
+  // CHECK-NEXT: xsmm.unary exp(data_type = f32, %[[EXP]], %[[OUT]], %[[OUT]])
+  // CHECK: %[[SUM:.+]] = xsmm.unary.dispatch reduce_x_op_add [8, 1024, 1024, 1024] flags = (reduce_rows) data_type = f32
+  // CHECK-NEXT: xsmm.unary reduce_x_op_add(data_type = f32, %[[SUM]], %[[OUT]], %[[ROWS]])
+  // CHECK: %[[DIV:.+]] = xsmm.binary.dispatch div [8, 1024, 1024, 1, 1024] flags = (bcast_row_in1) data_type = f32
+  // CHECK-NEXT: xsmm.binary div(data_type = f32, %[[DIV]], %[[OUT]], %[[ROWS]], %[[OUT]])
+  tpp.softmax ins(%arg0: memref<64x1024xf32>) outs(%arg1: memref<64x1024xf32>)
+  return
+}
+
+// -----
+
+// A dynamic number of rows is processed one row at a time.
+// CHECK-LABEL: @softmax_dynamic_rows(
+// CHECK-SAME:  %[[ARG0:.+]]: memref<?x8xf32>, %[[ARG1:.+]]: memref<?x8xf32>)
+func.func @softmax_dynamic_rows(%arg0: memref<?x8xf32>,
+                                %arg1: memref<?x8xf32>) {
+  // CHECK-DAG: %[[C0:.+]] = arith.constant 0 : index
+  // CHECK-DAG: %[[C1:.+]] = arith.constant 1 : index
+  // CHECK-DAG: %[[DIM:.+]] = memref.dim %[[ARG1]], %[[C0]]
+  // CHECK: scf.parallel (%[[I:.+]]) = (%[[C0]]) to (%[[DIM]]) step (%[[C1]])
+  // CHECK-DAG: %[[ROWS:.+]] = memref.alloca() : memref<1x1xf32>
+  // CHECK-DAG: %[[IN:.+]] = memref.subview %[[ARG0]][%[[I]], 0] [1, 8] [1, 1]
+  // CHECK: %[[MAX:.+]] = xsmm.unary.dispatch reduce_x_op_max [1, 8, 8, 8] flags = (reduce_rows) data_type = f32
+  // CHECK-NEXT: xsmm.unary reduce_x_op_max(data_type = f32, %[[MAX]], %[[IN]], %[[ROWS]])
+  tpp.softmax ins(%arg0: memref<?x8xf32>) outs(%arg1: memref<?x8xf32>)
+  return
+}
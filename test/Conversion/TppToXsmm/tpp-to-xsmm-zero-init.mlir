@@ -0,0 +1,142 @@
+// RUN: tpp-opt %s -convert-tpp-to-xsmm -split-input-file | FileCheck %s
+// RUN: tpp-opt %s -convert-tpp-to-xsmm="fold-zero-init=false" -split-input-file | FileCheck %s -check-prefix=NOFOLD
+
+// CHECK-LABEL: @zero_gemm(
+// CHECK-SAME: %[[ARG0:.+]]: memref<4x8xf32>, %[[ARG1:.+]]: memref<8x4xf32>, %[[ARG2:.+]]: memref<4x4xf32>)
+// NOFOLD-LABEL: @zero_gemm(
+func.func @zero_gemm(%arg0: memref<4x8xf32>, %arg1: memref<8x4xf32>, %arg2: memref<4x4xf32>) {
+  // CHECK-NOT: xsmm.unary zero
+  // CHECK: %[[DISPATCH:.+]] = xsmm.gemm.dispatch [4, 4, 8, 8, 4, 4] flags = (beta_0) data_type = f32
+  // CHECK-NEXT: xsmm.gemm(data_type = f32, %[[DISPATCH]], %[[ARG0]], %[[ARG1]], %[[ARG2]])
+  // NOFOLD: xsmm.unary zero
+  // NOFOLD: xsmm.gemm.dispatch [4, 4, 8, 8, 4, 4] flags = (none) data_type = f32
+  tpp.zero ins(%arg2: memref<4x4xf32>) outs(%arg2: memref<4x4xf32>)
+  tpp.gemm ins(%arg0: memref<4x8xf32>, %arg1: memref<8x4xf32>, %arg2: memref<4x4xf32>)
+           outs(%arg2: memref<4x4xf32>)
+  return
+}
+
+// -----
+
+// CHECK-LABEL: @zero_brgemm_vnni(
+// CHECK-SAME: %[[ARG0:.+]]: memref<4x32x32xbf16>, %[[ARG1:.+]]: memref<4x16x32x2xbf16>, %[[ARG2:.+]]: memref<32x32xbf16>)
+func.func @zero_brgemm_vnni(%arg0: memref<4x32x32xbf16>, %arg1: memref<4x16x32x2xbf16>,
+                            %arg2: memref<32x32xbf16>) {
+  // CHECK-NOT: xsmm.unary zero
+  // CHECK: %[[DISPATCH:.+]] = xsmm.brgemm.dispatch [32, 32, 32, 32, 32, 32] flags = (vnni_b, beta_0) data_type = bf16
+  // CHECK: xsmm.brgemm(data_type = bf16, %[[DISPATCH]], %[[ARG0]], %[[ARG1]], %[[ARG2]], %{{.+}})
+  tpp.zero ins(%arg2: memref<32x32xbf16>) outs(%arg2: memref<32x32xbf16>)
+  tpp.brgemm ins(%arg0: memref<4x32x32xbf16>, %arg1: memref<4x16x32x2xbf16>, %arg2: memref<32x32xbf16>)
+             outs(%arg2: memref<32x32xbf16>)
+  return
+}
+
+// -----
+
+// The zero must not fold if the output is read before the gemm.
+// CHECK-LABEL: @zero_read_before_gemm(
+func.func @zero_read_before_gemm(%arg0: memref<4x8xf32>, %arg1: memref<8x4xf32>,
+                                 %arg2: memref<4x4xf32>, %arg3: memref<4x4xf32>) {
+  // CHECK: xsmm.unary zero
+  // CHECK: xsmm.unary identity
+  // CHECK: xsmm.gemm.dispatch [4, 4, 8, 8, 4, 4] flags = (none) data_type = f32
+  tpp.zero ins(%arg2: memref<4x4xf32>) outs(%arg2: memref<4x4xf32>)
+  tpp.identity ins(%arg2: memref<4x4xf32>) outs(%arg3: memref<4x4xf32>)
+  tpp.gemm ins(%arg0: memref<4x8xf32>, %arg1: memref<8x4xf32>, %arg2: memref<4x4xf32>)
+           outs(%arg2: memref<4x4xf32>)
+  return
+}
+
+// -----
+
+// A zero hoisted out of the loop computing the output tile by tile.
+// CHECK-LABEL: @hoisted_zero_brgemm(
+func.func @hoisted_zero_brgemm(%arg0: memref<4x8x32x32xf32>, %arg1: memref<16x8x32x32xf32>,
+                               %arg2: memref<4x16x32x32xf32>) {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c4 = arith.constant 4 : index
+  %c16 = arith.constant 16 : index
+  // CHECK-NOT: xsmm.unary zero
+  // CHECK: scf.parallel
+  // CHECK: xsmm.brgemm.dispatch [32, 32, 32, 32, 32, 32] flags = (beta_0) data_type = f32
+  tpp.zero ins(%arg2: memref<4x16x32x32xf32>) outs(%arg2: memref<4x16x32x32xf32>)
+  scf.parallel (%i, %j) = (%c0, %c0) to (%c4, %c16) step (%c1, %c1) {
+    %a = memref.subview %arg0[%i, 0, 0, 0] [1, 8, 32, 32] [1, 1, 1, 1]
+      : memref<4x8x32x32xf32> to memref<8x32x32xf32, strided<[1024, 32, 1], offset: ?>>
+    %b = memref.subview %arg1[%j, 0, 0, 0] [1, 8, 32, 32] [1, 1, 1, 1]
+      : memref<16x8x32x32xf32> to memref<8x32x32xf32, strided<[1024, 32, 1], offset: ?>>
+    %c = memref.subview %arg2[%i, %j, 0, 0] [1, 1, 32, 32] [1, 1, 1, 1]
+      : memref<4x16x32x32xf32> to memref<32x32xf32, strided<[32, 1], offset: ?>>
+    tpp.brgemm ins(%a : memref<8x32x32xf32, strided<[1024, 32, 1], offset: ?>>,
+                   %b : memref<8x32x32xf32, strided<[1024, 32, 1], offset: ?>>,
+                   %c : memref<32x32xf32, strided<[32, 1], offset: ?>>)
+               outs(%c : memref<32x32xf32, strided<[32, 1], offset: ?>>)
+    scf.yield
+  }
+  return
+}
+
+// -----
+
+// The tiles do not cover the whole output: only the first rows are computed.
+// CHECK-LABEL: @hoisted_zero_partial_cover(
+func.func @hoisted_zero_partial_cover(%arg0: memref<4x8x32x32xf32>, %arg1: memref<16x8x32x32xf32>,
+                                      %arg2: memref<4x16x32x32xf32>) {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c2 = arith.constant 2 : index
+  %c16 = arith.constant 16 : index
+  // CHECK: xsmm.unary zero
+  // CHECK: scf.parallel
+  // CHECK: xsmm.brgemm.dispatch [32, 32, 32, 32, 32, 32] flags = (none) data_type = f32
+  tpp.zero ins(%arg2: memref<4x16x32x32xf32>) outs(%arg2: memref<4x16x32x32xf32>)
+  scf.parallel (%i, %j) = (%c0, %c0) to (%c2, %c16) step (%c1, %c1) {
+    %a = memref.subview %arg0[%i, 0, 0, 0] [1, 8, 32, 32] [1, 1, 1, 1]
+      : memref<4x8x32x32xf32> to memref<8x32x32xf32, strided<[1024, 32, 1], offset: ?>>
+    %b = memref.subview %arg1[%j, 0, 0, 0] [1, 8, 32, 32] [1, 1, 1, 1]
+      : memref<16x8x32x32xf32> to memref<8x32x32xf32, strided<[1024, 32, 1], offset: ?>>
+    %c = memref.subview %arg2[%i, %j, 0, 0] [1, 1, 32, 32] [1, 1, 1, 1]
+      : memref<4x16x32x32xf32> to memref<32x32xf32, strided<[32, 1], offset: ?>>
+    tpp.brgemm ins(%a : memref<8x32x32xf32, strided<[1024, 32, 1], offset: ?>>,
+                   %b : memref<8x32x32xf32, strided<[1024, 32, 1], offset: ?>>,
+                   %c : memref<32x32xf32, strided<[32, 1], offset: ?>>)
+               outs(%c : memref<32x32xf32, strided<[32, 1], offset: ?>>)
+    scf.yield
+  }
+  return
+}
+
+// -----
+
+// Each tile accumulates over the inner loop: only the first iteration could
+// skip reading the output.
+// CHECK-LABEL: @hoisted_zero_reduction_loop(
+func.func @hoisted_zero_reduction_loop(%arg0: memref<4x8x32x32xf32>, %arg1: memref<16x8x32x32xf32>,
+                                       %arg2: memref<4x16x32x32xf32>) {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c4 = arith.constant 4 : index
+  %c8 = arith.constant 8 : index
+  %c16 = arith.constant 16 : index
+  // CHECK: xsmm.unary zero
+  // CHECK: scf.parallel
+  // CHECK: xsmm.gemm.dispatch [32, 32, 32, 32, 32, 32] flags = (none) data_type = f32
+  tpp.zero ins(%arg2: memref<4x16x32x32xf32>) outs(%arg2: memref<4x16x32x32xf32>)
+  scf.parallel (%i, %j) = (%c0, %c0) to (%c4, %c16) step (%c1, %c1) {
+    %c = memref.subview %arg2[%i, %j, 0, 0] [1, 1, 32, 32] [1, 1, 1, 1]
+      : memref<4x16x32x32xf32> to memref<32x32xf32, strided<[32, 1], offset: ?>>
+    scf.for %k = %c0 to %c8 step %c1 {
+      %a = memref.subview %arg0[%i, %k, 0, 0] [1, 1, 32, 32] [1, 1, 1, 1]
+        : memref<4x8x32x32xf32> to memref<32x32xf32, strided<[32, 1], offset: ?>>
+      %b = memref.subview %arg1[%j, %k, 0, 0] [1, 1, 32, 32] [1, 1, 1, 1]
+        : memref<16x8x32x32xf32> to memref<32x32xf32, strided<[32, 1], offset: ?>>
+      tpp.gemm ins(%a : memref<32x32xf32, strided<[32, 1], offset: ?>>,
+                   %b : memref<32x32xf32, strided<[32, 1], offset: ?>>,
+                   %c : memref<32x32xf32, strided<[32, 1], offset: ?>>)
+               outs(%c : memref<32x32xf32, strided<[32, 1], offset: ?>>)
+    }
+    scf.yield
+  }
+  return
+}
@@ -0,0 +1,60 @@
+// RUN: tpp-opt %s -convert-xsmm-to-func="global-dispatch-handles=true" | FileCheck %s
+
+// CHECK-DAG: memref.global "private" @__xsmm_gemm_dispatch_handle : memref<i64> = dense<0>
+// CHECK-DAG: memref.global "private" @__xsmm_gemm_dispatch_handle_0 : memref<i64> = dense<0>
+// CHECK-DAG: memref.global "private" @__xsmm_unary_dispatch_handle : memref<i64> = dense<0>
+// CHECK-NOT: memref.global
+
+// CHECK-LABEL: func.func @first_gemm
+func.func @first_gemm() -> i64 {
+  %0 = xsmm.gemm.dispatch [1, 2, 3, 4, 5, 6] flags = (none) data_type = f32
+  return %0 : i64
+}
+
+// CHECK-DAG: %[[C0:.+]] = arith.constant 0 : i64
+// CHECK: %[[G:.+]] = memref.get_global @__xsmm_gemm_dispatch_handle : memref<i64>
+// CHECK: %[[GI:.+]] = memref.extract_aligned_pointer_as_index %[[G]] : memref<i64> -> index
+// CHECK: %[[GI64:.+]] = arith.index_cast %[[GI]] : index to i64
+// CHECK: %[[GP:.+]] = llvm.inttoptr %[[GI64]] : i64 to !llvm.ptr<i64>
+// CHECK: %[[H:.+]] = llvm.load %[[GP]] atomic acquire
+// CHECK: %[[UNINIT:.+]] = arith.cmpi eq, %[[H]], %[[C0]] : i64
+// CHECK: %[[R:.+]] = scf.if %[[UNINIT]] -> (i64) {
+// CHECK:   %[[D:.+]] = call @xsmm_gemm_dispatch(
+// CHECK:   %{{.+}} = memref.atomic_rmw assign %[[D]], %[[G]][] : (i64, memref<i64>) -> i64
+// CHECK:   scf.yield %[[D]] : i64
+// CHECK: } else {
+// CHECK:   scf.yield %[[H]] : i64
+// CHECK: }
+// CHECK: return %[[R]] : i64
+
+// CHECK-LABEL: func.func @second_gemm
+func.func @second_gemm() -> i64 {
+  %0 = xsmm.gemm.dispatch [1, 2, 3, 4, 5, 6] flags = (none) data_type = f32
+  return %0 : i64
+}
+
+// CHECK: memref.get_global @__xsmm_gemm_dispatch_handle : memref<i64>
+// CHECK: scf.if
+// CHECK:   call @xsmm_gemm_dispatch(
+
+// A gemm with other sizes gets its own, uniqued, handle.
+// CHECK-LABEL: func.func @distinct_gemm
+func.func @distinct_gemm() -> i64 {
+  %0 = xsmm.gemm.dispatch [2, 2, 2, 2, 2, 2] flags = (none) data_type = f32
+  return %0 : i64
+}
+
+// CHECK: memref.get_global @__xsmm_gemm_dispatch_handle_0 : memref<i64>
+// CHECK: llvm.load %{{.+}} atomic acquire
+// CHECK: scf.if
+// CHECK:   call @xsmm_gemm_dispatch(
+
+// CHECK-LABEL: func.func @unary
+func.func @unary() -> i64 {
+  %0 = xsmm.unary.dispatch relu [5, 6, 5, 6] flags = (none) data_type = f32
+  return %0 : i64
+}
+
+// CHECK: memref.get_global @__xsmm_unary_dispatch_handle : memref<i64>
+// CHECK: scf.if
+// CHECK:   call @xsmm_unary_dispatch(
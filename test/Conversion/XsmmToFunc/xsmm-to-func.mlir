@@ -117,6 +117,25 @@ func.func @dispatch_gemm() -> i64 {
 
 // -----
 
+// CHECK-LABEL: dispatch_gemm_i8
+func.func @dispatch_gemm_i8() -> i64 {
+  %0 = xsmm.gemm.dispatch [1, 2, 3, 4, 5, 6] flags = (vnni_b) data_type = i8
+  return %0 : i64
+}
+
+// CHECK-DAG: %[[C1:.+]] = arith.constant 1 : i64
+// CHECK-DAG: %[[C2:.+]] = arith.constant 2 : i64
+// CHECK-DAG: %[[C3:.+]] = arith.constant 3 : i64
+// CHECK-DAG: %[[C4:.+]] = arith.constant 4 : i64
+// CHECK-DAG: %[[C5:.+]] = arith.constant 5 : i64
+// CHECK-DAG: %[[C6:.+]] = arith.constant 6 : i64
+// i8 is LIBXSMM_DATATYPE_I8 (see enum for DataType)
+// CHECK-DAG: %[[C12:.+]] = arith.constant 12 : i64
+// CHECK-DAG: %[[C2048:.+]] = arith.constant 2048 : i64
+// CHECK: call @xsmm_gemm_dispatch(%[[C12]], %[[C1]], %[[C2]], %[[C3]], %[[C4]], %[[C5]], %[[C6]], %[[C2048]])
+
+// -----
+
 func.func @invoke_brgemm(%arg0: memref<2x5x4xf32>, %arg1: memref<2x4x5xf32>,
                            %arg2: memref<4x4xf32>) -> memref<4x4xf32> {
   %0 = xsmm.brgemm.dispatch [5, 5, 4, 4, 5, 5] flags = (none) data_type = f32
@@ -287,3 +306,170 @@ func.func @multiple_gemm_flags_fused_brgemm() -> i64 {
 // CHECK-DAG: %[[C4:.+]] = arith.constant 4 : i64
 // CHECK-DAG: %[[C1:.+]] = arith.constant 1 : i64
 // CHECK: %{{.+}} = call @xsmm_fused_brgemm_dispatch(%[[C2]], %[[C13]], %[[C13]], %[[C13]], %[[C13]], %[[C13]], %[[C13]], %[[C14336]], %[[C0]], %[[C0]], %[[C4]], %[[C1]])
+
+// -----
+
+// CHECK-LABEL: dispatch_brgemm_prefetch
+func.func @dispatch_brgemm_prefetch() -> i64 {
+  %0 = xsmm.brgemm_prefetch.dispatch [5, 5, 4, 4, 5, 5] flags = (none) data_type = f32
+  return %0 : i64
+}
+
+// CHECK-DAG: %[[C1:.+]] = arith.constant 1 : i64
+// CHECK-DAG: %[[C5:.+]] = arith.constant 5 : i64
+// CHECK-DAG: %[[C4:.+]] = arith.constant 4 : i64
+// CHECK-DAG: %[[C0:.+]] = arith.constant 0 : i64
+// CHECK: call @xsmm_brgemm_prefetch_dispatch(%[[C1]], %[[C5]], %[[C5]], %[[C4]], %[[C4]], %[[C5]], %[[C5]], %[[C0]])
+
+// -----
+
+func.func @invoke_gemm_prefetch(%arg0: memref<4x4xf32>, %arg1: memref<4x4xf32>,
+                                %arg2: memref<4x4xf32>, %arg3: memref<4x4xf32>,
+                                %arg4: memref<4x4xf32>) {
+  %0 = xsmm.gemm_prefetch.dispatch [4, 4, 4, 4, 4, 4] flags = (none) data_type = f32
+  xsmm.gemm_prefetch(data_type = f32, %0, %arg0, %arg1, %arg2, %arg3, %arg4)
+    : (i64, memref<4x4xf32>, memref<4x4xf32>, memref<4x4xf32>, memref<4x4xf32>, memref<4x4xf32>) -> ()
+  return
+}
+
+// CHECK-LABEL: invoke_gemm_prefetch
+// CHECK-SAME: %[[ARG0:.+]]: memref<4x4xf32>, %[[ARG1:.+]]: memref<4x4xf32>, %[[ARG2:.+]]: memref<4x4xf32>, %[[ARG3:.+]]: memref<4x4xf32>, %[[ARG4:.+]]: memref<4x4xf32>
+// CHECK: %[[C0:.+]] = arith.constant 0 : index
+// CHECK-DAG: %[[C1:.+]] = arith.constant 1 : i64
+// CHECK: %[[ADDR:.+]] = call @xsmm_gemm_prefetch_dispatch
+// CHECK: memref.extract_aligned_pointer_as_index %[[ARG0]]
+// CHECK: %[[LLVM_PTR:.+]] = llvm.inttoptr
+// CHECK: memref.extract_aligned_pointer_as_index %[[ARG1]]
+// CHECK: %[[LLVM_PTR1:.+]] = llvm.inttoptr
+// CHECK: memref.extract_aligned_pointer_as_index %[[ARG2]]
+// CHECK: %[[LLVM_PTR2:.+]] = llvm.inttoptr
+// CHECK: memref.extract_aligned_pointer_as_index %[[ARG3]]
+// CHECK: %[[LLVM_PTR3:.+]] = llvm.inttoptr
+// CHECK: memref.extract_aligned_pointer_as_index %[[ARG4]]
+// CHECK: %[[LLVM_PTR4:.+]] = llvm.inttoptr
+// CHECK: call @xsmm_gemm_prefetch_invoke(%[[C1]], %[[ADDR]], %[[LLVM_PTR]], %[[C0]], %[[LLVM_PTR1]], %[[C0]], %[[LLVM_PTR2]], %[[C0]], %[[LLVM_PTR3]], %[[C0]], %[[LLVM_PTR4]], %[[C0]])
+
+// -----
+
+func.func @invoke_brgemm_offs(%arg0: memref<2x5x4xf32>, %arg1: memref<2x4x5xf32>,
+                              %arg2: memref<5x5xf32>, %arg3: memref<2xi64>,
+                              %arg4: memref<2xi64>) {
+  %0 = xsmm.brgemm_offs.dispatch [5, 5, 4, 4, 5, 5] flags = (none) data_type = f32
+  %c2_i64 = arith.constant 2 : i64
+  xsmm.brgemm_offs(data_type = f32, %0, %arg0, %arg1, %arg2, %arg3, %arg4, %c2_i64)
+    : (i64, memref<2x5x4xf32>, memref<2x4x5xf32>, memref<5x5xf32>, memref<2xi64>, memref<2xi64>, i64) -> ()
+  return
+}
+
+// CHECK-LABEL: invoke_brgemm_offs
+// CHECK-SAME: %[[ARG0:.+]]: memref<2x5x4xf32>, %[[ARG1:.+]]: memref<2x4x5xf32>, %[[ARG2:.+]]: memref<5x5xf32>, %[[ARG3:.+]]: memref<2xi64>, %[[ARG4:.+]]: memref<2xi64>
+// CHECK: %[[ADDR:.+]] = call @xsmm_brgemm_offs_dispatch
+// CHECK: memref.extract_aligned_pointer_as_index %[[ARG3]]
+// CHECK: %[[OFFS_A:.+]] = llvm.inttoptr %{{.+}} : i64 to !llvm.ptr<i64>
+// CHECK: memref.extract_aligned_pointer_as_index %[[ARG4]]
+// CHECK: %[[OFFS_B:.+]] = llvm.inttoptr %{{.+}} : i64 to !llvm.ptr<i64>
+// CHECK: call @xsmm_brgemm_offs_invoke(%{{.+}}, %[[ADDR]], %{{.+}}, %{{.+}}, %{{.+}}, %{{.+}}, %{{.+}}, %{{.+}}, %[[OFFS_A]], %{{.+}}, %[[OFFS_B]], %{{.+}}, %{{.+}})
+
+// -----
+
+// CHECK-LABEL: dispatch_gemm_dynamic
+// CHECK-SAME: %[[M:.+]]: i64
+func.func @dispatch_gemm_dynamic(%m: i64) -> i64 {
+  %0 = xsmm.gemm.dispatch [%m, 2, 3, 4, 5, 6] flags = (none) data_type = f32
+  return %0 : i64
+}
+
+// CHECK-DAG: %[[C1:.+]] = arith.constant 1 : i64
+// CHECK-DAG: %[[C2:.+]] = arith.constant 2 : i64
+// CHECK-DAG: %[[C3:.+]] = arith.constant 3 : i64
+// CHECK-DAG: %[[C4:.+]] = arith.constant 4 : i64
+// CHECK-DAG: %[[C5:.+]] = arith.constant 5 : i64
+// CHECK-DAG: %[[C6:.+]] = arith.constant 6 : i64
+// CHECK-DAG: %[[C0:.+]] = arith.constant 0 : i64
+// CHECK: call @xsmm_gemm_dispatch(%[[C1]], %[[M]], %[[C2]], %[[C3]], %[[C4]], %[[C5]], %[[C6]], %[[C0]])
+
+// -----
+
+// CHECK-LABEL: dispatch_gemm_trans_b
+func.func @dispatch_gemm_trans_b() -> i64 {
+  %0 = xsmm.gemm.dispatch [10, 20, 30, 40, 50, 60] flags = (trans_b, beta_0) data_type = f32
+  return %0 : i64
+}
+
+// CHECK-DAG: %[[C1:.+]] = arith.constant 1 : i64
+// CHECK-DAG: %[[C10:.+]] = arith.constant 10 : i64
+// CHECK-DAG: %[[C20:.+]] = arith.constant 20 : i64
+// CHECK-DAG: %[[C30:.+]] = arith.constant 30 : i64
+// CHECK-DAG: %[[C40:.+]] = arith.constant 40 : i64
+// CHECK-DAG: %[[C50:.+]] = arith.constant 50 : i64
+// CHECK-DAG: %[[C60:.+]] = arith.constant 60 : i64
+// LIBXSMM is col-major check we swap the flag for A and B (see enum for GemmFlags)
+// CHECK-DAG: %[[C5:.+]] = arith.constant 5 : i64
+// CHECK: call @xsmm_gemm_dispatch(%[[C1]], %[[C10]], %[[C20]], %[[C30]], %[[C40]], %[[C50]], %[[C60]], %[[C5]])
+
+// -----
+
+// CHECK-LABEL: dispatch_unary_convert
+func.func @dispatch_unary_convert() -> i64 {
+  %0 = xsmm.unary.dispatch identity [4, 8, 8, 8] flags = (none) data_type = f32 input_data_type = i32
+  return %0 : i64
+}
+
+// CHECK-DAG: %[[C1:.+]] = arith.constant 1 : i64
+// i32 is LIBXSMM_DATATYPE_I32 (see enum for DataType)
+// CHECK-DAG: %[[C7:.+]] = arith.constant 7 : i64
+// CHECK-DAG: %[[C4:.+]] = arith.constant 4 : i64
+// CHECK-DAG: %[[C8:.+]] = arith.constant 8 : i64
+// CHECK-DAG: %[[C0:.+]] = arith.constant 0 : i64
+// CHECK: call @xsmm_unary_convert_dispatch(%[[C1]], %[[C1]], %[[C7]], %[[C4]], %[[C8]], %[[C8]], %[[C8]], %[[C0]])
+
+// -----
+
+// CHECK-LABEL: dispatch_ternary
+func.func @dispatch_ternary() -> i64 {
+  %0 = xsmm.ternary.dispatch muladd [4, 8, 8, 8, 8, 8] flags = (bcast_col_in1, bcast_col_in2) data_type = f32
+  return %0 : i64
+}
+
+// CHECK-DAG: %[[C1:.+]] = arith.constant 1 : i64
+// CHECK-DAG: %[[C4:.+]] = arith.constant 4 : i64
+// CHECK-DAG: %[[C8:.+]] = arith.constant 8 : i64
+// Or between 16 and 32 (see enum for TernaryFlags)
+// CHECK-DAG: %[[C48:.+]] = arith.constant 48 : i64
+// CHECK: call @xsmm_ternary_dispatch(%[[C1]], %[[C1]], %[[C4]], %[[C8]], %[[C8]], %[[C8]], %[[C8]], %[[C8]], %[[C48]])
+
+// -----
+
+func.func @invoke_dequantize(%arg0: memref<4x8xi32>, %arg1: memref<1x8xf32>,
+                             %arg2: memref<1x8xf32>, %arg3: memref<4x8xf32>) {
+  %0 = xsmm.unary.dispatch identity [4, 8, 8, 8] flags = (none) data_type = f32 input_data_type = i32
+  xsmm.unary identity(data_type = f32, %0, %arg0, %arg3)
+    : (i64, memref<4x8xi32>, memref<4x8xf32>) -> ()
+  %1 = xsmm.ternary.dispatch muladd [4, 8, 8, 8, 8, 8] flags = (bcast_col_in1, bcast_col_in2) data_type = f32
+  xsmm.ternary muladd(data_type = f32, %1, %arg3, %arg1, %arg2, %arg3)
+    : (i64, memref<4x8xf32>, memref<1x8xf32>, memref<1x8xf32>, memref<4x8xf32>) -> ()
+  %2 = xsmm.unary.dispatch relu [4, 8, 8, 8] flags = (none) data_type = f32
+  xsmm.unary relu(data_type = f32, %2, %arg3, %arg3)
+    : (i64, memref<4x8xf32>, memref<4x8xf32>) -> ()
+  return
+}
+
+// The converting identity has its own entry point: its input pointer is not
+// of the output type.
+// CHECK-LABEL: invoke_dequantize
+// CHECK-SAME: %[[ARG0:.+]]: memref<4x8xi32>, %[[ARG1:.+]]: memref<1x8xf32>, %[[ARG2:.+]]: memref<1x8xf32>, %[[ARG3:.+]]: memref<4x8xf32>
+// CHECK-DAG: %[[C0:.+]] = arith.constant 0 : index
+// CHECK-DAG: %[[C1:.+]] = arith.constant 1 : i64
+// CHECK-DAG: %[[C7:.+]] = arith.constant 7 : i64
+// CHECK: %[[CONV:.+]] = call @xsmm_unary_convert_dispatch
+// CHECK: %[[PTR:.+]] = memref.extract_aligned_pointer_as_index %[[ARG0]]
+// CHECK-NEXT: %[[PTR_CST:.+]] = arith.index_cast %[[PTR]] : index to i64
+// CHECK-NEXT: %[[LLVM_PTR:.+]] = llvm.inttoptr %[[PTR_CST]] : i64 to !llvm.ptr<i32>
+// CHECK: %[[PTR1:.+]] = memref.extract_aligned_pointer_as_index %[[ARG3]]
+// CHECK-NEXT: %[[PTR_CST1:.+]] = arith.index_cast %[[PTR1]] : index to i64
+// CHECK-NEXT: %[[LLVM_PTR1:.+]] = llvm.inttoptr %[[PTR_CST1]] : i64 to !llvm.ptr<f32>
+// CHECK: call @xsmm_unary_convert_invoke(%[[C1]], %[[C7]], %[[CONV]], %[[LLVM_PTR]], %[[C0]], %[[LLVM_PTR1]], %[[C0]])
+// CHECK: %[[FMA:.+]] = call @xsmm_ternary_dispatch
+// CHECK: call @xsmm_ternary_invoke(%[[C1]], %[[FMA]], {{.+}}) : (i64, i64, !llvm.ptr<f32>, index, !llvm.ptr<f32>, index, !llvm.ptr<f32>, index, !llvm.ptr<f32>, index) -> ()
+// CHECK: %[[RELU:.+]] = call @xsmm_unary_dispatch
+// CHECK: call @xsmm_unary_invoke(%[[C1]], %[[RELU]], {{.+}}) : (i64, i64, !llvm.ptr<f32>, index, !llvm.ptr<f32>, index) -> ()
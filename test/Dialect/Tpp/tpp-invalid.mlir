@@ -338,7 +338,7 @@ func.func @unary_invalid_operands(%arg0: tensor<2x2xf32>) -> tensor<2x2xf32> {
 func.func @vnni_gemm_b_operand_wrong_type(%arg0: tensor<32x32xf32>,        
                                           %arg1: tensor<16x32x2xf32>,
                                           %arg2: tensor<32x32xf32>) -> tensor<32x32xf32> {
-  // expected-error @below {{operand 1 invalid element type for VNNI layout expect bf16, but got: 'f32'}}
+  // expected-error @below {{operand 1 invalid element type for VNNI layout expect bf16 or i8, but got: 'f32'}}
   %0 = tpp.gemm (%arg0: tensor<32x32xf32>, %arg1: tensor<16x32x2xf32>,
                  %arg2: tensor<32x32xf32>) -> tensor<32x32xf32>
   return %0: tensor<32x32xf32>
@@ -401,3 +401,103 @@ func.func @fused_brgemm_scalar_bias(%arg0: tensor<3x32x32xf32>, %arg1: tensor<3x
                          %arg2: tensor<32x32xf32>, %bias: f32) -> tensor<32x32xf32>
   return %0: tensor<32x32xf32>
 }
+
+// -----
+
+func.func @tpp_reduce_add_invalid(%arg0: memref<4x8xf32>, %arg1: memref<4x8xf32>) {
+  // expected-error @below {{expects a Mx1 or 1xN output for a MxN input}}
+  tpp.reduce_add ins(%arg0: memref<4x8xf32>) outs(%arg1: memref<4x8xf32>)
+  return
+}
+
+// -----
+
+func.func @tpp_softmax_invalid(%arg0: memref<4x8xf32>, %arg1: memref<4x1xf32>) {
+  // expected-error @below {{expects the output to have the shape of the input}}
+  tpp.softmax ins(%arg0: memref<4x8xf32>) outs(%arg1: memref<4x1xf32>)
+  return
+}
+
+// -----
+
+func.func @tpp_layernorm_invalid(%arg0: memref<4x8xf32>, %arg1: memref<4xf32>,
+                                 %arg2: memref<4x8xf32>) {
+  // expected-error @below {{expects gamma and beta to be N or 1xN for a MxN input}}
+  tpp.layernorm ins(%arg0: memref<4x8xf32>, %arg1: memref<4xf32>, %arg1: memref<4xf32>)
+                outs(%arg2: memref<4x8xf32>) {epsilon = 1.0e-05 : f32}
+  return
+}
+
+// -----
+
+func.func @tpp_gemm_invalid_transpose_b(%arg0: memref<4x8xf32>,
+                                        %arg1: memref<8x2xf32>,
+                                        %arg2: memref<4x2xf32>) -> memref<4x2xf32> {
+  // expected-error @below {{operand 1 fails to verify expected transposed shape}}
+  tpp.gemm ins(%arg0: memref<4x8xf32>, %arg1: memref<8x2xf32>, %arg2: memref<4x2xf32>)
+           outs(%arg2: memref<4x2xf32>) {transpose_b}
+  return %arg2: memref<4x2xf32>
+}
+
+// -----
+
+func.func @tpp_gemm_invalid_i8_output(%arg0: memref<4x8xi8>, %arg1: memref<8x4xi8>,
+                                      %arg2: memref<4x4xi8>) {
+  // expected-error @below {{expects i8 inputs and i32 output for integer types}}
+  tpp.gemm ins(%arg0: memref<4x8xi8>, %arg1: memref<8x4xi8>, %arg2: memref<4x4xi8>)
+           outs(%arg2: memref<4x4xi8>)
+  return
+}
+
+// -----
+
+func.func @tpp_dequantize_invalid_acc(%arg0: memref<4x8xf32>, %arg1: memref<8xf32>,
+                                      %arg2: memref<4x8xf32>) {
+  // expected-error @below {{expects a 2d i32 accumulator}}
+  tpp.dequantize ins(%arg0: memref<4x8xf32>, %arg1: memref<8xf32>, %arg1: memref<8xf32>)
+                 outs(%arg2: memref<4x8xf32>)
+  return
+}
+
+// -----
+
+func.func @tpp_dequantize_invalid_scale(%arg0: memref<4x8xi32>, %arg1: memref<4xf32>,
+                                        %arg2: memref<4x8xf32>) {
+  // expected-error @below {{expects scale and bias to be N or 1xN for a MxN accumulator}}
+  tpp.dequantize ins(%arg0: memref<4x8xi32>, %arg1: memref<4xf32>, %arg1: memref<4xf32>)
+                 outs(%arg2: memref<4x8xf32>)
+  return
+}
+
+// -----
+
+func.func @tpp_dequantize_invalid_scale_type(%arg0: memref<4x8xi32>, %arg1: memref<8xf32>,
+                                             %arg2: memref<4x8xbf16>) {
+  // expected-error @below {{expects scale and bias to have the element type of the output}}
+  tpp.dequantize ins(%arg0: memref<4x8xi32>, %arg1: memref<8xf32>, %arg1: memref<8xf32>)
+                 outs(%arg2: memref<4x8xbf16>)
+  return
+}
+
+// -----
+
+// i8 is packed by 4 on K.
+func.func @vnni2_gemm_i8(%arg0: tensor<32x32xi8>,
+                         %arg1: tensor<16x32x2xi8>,
+                         %arg2: tensor<32x32xi32>) -> tensor<32x32xi32> {
+  // expected-error @below {{operand 1 invalid VNNI layout expect inner dims to be 2 or 4, but got: 2}}
+  %0 = tpp.gemm (%arg0: tensor<32x32xi8>, %arg1: tensor<16x32x2xi8>,
+                 %arg2: tensor<32x32xi32>) -> tensor<32x32xi32>
+  return %0: tensor<32x32xi32>
+}
+
+// -----
+
+func.func @vnni4_brgemm_i8_wrong_shape(%arg0: tensor<3x32x32xi8>,
+                                       %arg1: tensor<3x16x32x4xi8>,
+                                       %arg2: tensor<32x32xi32>) -> tensor<32x32xi32> {
+  // expected-error @below {{operand 1 fails to verify expected shape}}
+  %0 = tpp.brgemm (%arg0: tensor<3x32x32xi8>, %arg1: tensor<3x16x32x4xi8>,
+                   %arg2: tensor<32x32xi32>) -> tensor<32x32xi32>
+  return %0: tensor<32x32xi32>
+}
@@ -20,13 +20,54 @@ func.func @tpp_dialect(%arg0: memref<2x2xf32>,
   // CHECK: tpp.relu
   tpp.relu ins(%arg5: memref<1x2xf32>) outs(%arg6: memref<1x2xf32>)
 
+  // CHECK: tpp.gelu
+  tpp.gelu ins(%arg0: memref<2x2xf32>) outs(%arg2: memref<2x2xf32>)
+
+  // CHECK: tpp.tanh
+  tpp.tanh ins(%arg0: memref<2x2xf32>) outs(%arg0: memref<2x2xf32>)
+
+  // CHECK: tpp.sigmoid
+  tpp.sigmoid ins(%arg5: memref<1x2xf32>) outs(%arg2: memref<2x2xf32>)
+
+  // CHECK: tpp.exp
+  tpp.exp ins(%arg0: memref<2x2xf32>) outs(%arg2: memref<2x2xf32>)
+
   // CHECK: tpp.add
   tpp.add ins(%arg5: memref<1x2xf32>, %arg5: memref<1x2xf32>) outs(%arg6: memref<1x2xf32>)
 
+  // CHECK: tpp.mul
+  tpp.mul ins(%arg0: memref<2x2xf32>, %arg5: memref<1x2xf32>) outs(%arg2: memref<2x2xf32>)
+
+  // CHECK: tpp.sub
+  tpp.sub ins(%arg5: memref<1x2xf32>, %arg0: memref<2x2xf32>) outs(%arg0: memref<2x2xf32>)
+
+  // CHECK: tpp.div
+  tpp.div ins(%arg0: memref<2x2xf32>, %arg0: memref<2x2xf32>) outs(%arg2: memref<2x2xf32>)
+
+  // CHECK: tpp.max
+  tpp.max ins(%arg5: memref<1x2xf32>, %arg5: memref<1x2xf32>) outs(%arg6: memref<1x2xf32>)
+
+  // CHECK: tpp.reduce_add
+  tpp.reduce_add ins(%arg0: memref<2x2xf32>) outs(%arg5: memref<1x2xf32>)
+
+  // CHECK: tpp.reduce_max
+  tpp.reduce_max ins(%arg0: memref<2x2xf32>) outs(%arg5: memref<1x2xf32>)
+
+  // CHECK: tpp.softmax
+  tpp.softmax ins(%arg0: memref<2x2xf32>) outs(%arg2: memref<2x2xf32>)
+
+  // CHECK: tpp.layernorm
+  tpp.layernorm ins(%arg0: memref<2x2xf32>, %arg5: memref<1x2xf32>, %arg6: memref<1x2xf32>)
+                outs(%arg2: memref<2x2xf32>) {epsilon = 1.0e-05 : f32}
+
   // CHECK: tpp.gemm
   tpp.gemm ins(%arg0: memref<2x2xf32>, %arg1: memref<2x2xf32>, %arg2: memref<2x2xf32>)
            outs(%arg2: memref<2x2xf32>)
 
+  // CHECK: tpp.gemm {{.+}} {transpose_b}
+  tpp.gemm ins(%arg0: memref<2x2xf32>, %arg1: memref<2x2xf32>, %arg2: memref<2x2xf32>)
+           outs(%arg2: memref<2x2xf32>) {transpose_b}
+
   // CHECK: tpp.zero
   tpp.zero ins(%arg1: memref<2x2xf32>) outs(%arg1: memref<2x2xf32>)
 
@@ -115,3 +156,20 @@ func.func @fused_brgemm(%arg0: memref<3x32x32xf32>, %arg1: memref<3x32x32xf32>,
                        %arg2: memref<32x32xf32>, %arg3: memref<32x32xf32>) outs(%arg3: memref<32x32xf32>)
   return
 }
+
+// CHECK-LABEL: func.func @gemm_i8
+func.func @gemm_i8(%arg0: memref<4x8xi8>, %arg1: memref<8x4xi8>, %arg2: memref<4x4xi32>) {
+  // CHECK: tpp.gemm
+  tpp.gemm ins(%arg0: memref<4x8xi8>, %arg1: memref<8x4xi8>, %arg2: memref<4x4xi32>)
+           outs(%arg2: memref<4x4xi32>)
+  return
+}
+
+// CHECK-LABEL: func.func @dequantize
+func.func @dequantize(%arg0: memref<4x8xi32>, %arg1: memref<8xf32>,
+                      %arg2: memref<1x8xf32>, %arg3: memref<4x8xf32>) {
+  // CHECK: tpp.dequantize
+  tpp.dequantize ins(%arg0: memref<4x8xi32>, %arg1: memref<8xf32>, %arg2: memref<1x8xf32>)
+                 outs(%arg3: memref<4x8xf32>) {relu}
+  return
+}
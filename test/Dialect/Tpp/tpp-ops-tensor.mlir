@@ -15,6 +15,43 @@ func.func @tpp_dialect(%arg0: tensor<5x4xf32>, %arg1: tensor<4x5xf32>,
                    %2: tensor<5x5xf32>) -> tensor<5x5xf32>
   // CHECK: tpp.relu
   %4 = tpp.relu (%3: tensor<5x5xf32>) -> tensor<5x5xf32>
+
+  // CHECK: tpp.gelu
+  %g = tpp.gelu (%3: tensor<5x5xf32>) -> tensor<5x5xf32>
+
+  // CHECK: tpp.tanh
+  %t = tpp.tanh (%g: tensor<5x5xf32>) -> tensor<5x5xf32>
+
+  // CHECK: tpp.sigmoid
+  %s = tpp.sigmoid (%t: tensor<5x5xf32>) -> tensor<5x5xf32>
+
+  // CHECK: tpp.exp
+  %e = tpp.exp (%s: tensor<5x5xf32>) -> tensor<5x5xf32>
+
+  // CHECK: tpp.mul
+  %m = tpp.mul (%e: tensor<5x5xf32>, %g: tensor<5x5xf32>) -> tensor<5x5xf32>
+
+  // CHECK: tpp.sub
+  %d = tpp.sub (%m: tensor<5x5xf32>, %t: tensor<5x5xf32>) -> tensor<5x5xf32>
+
+  // CHECK: tpp.div
+  %q = tpp.div (%d: tensor<5x5xf32>, %s: tensor<5x5xf32>) -> tensor<5x5xf32>
+
+  // CHECK: tpp.max
+  %x = tpp.max (%q: tensor<5x5xf32>, %e: tensor<5x5xf32>) -> tensor<5x5xf32>
+
+  // CHECK: tpp.reduce_add
+  %ra = tpp.reduce_add (%x: tensor<5x5xf32>) -> tensor<5x1xf32>
+
+  // CHECK: tpp.reduce_max
+  %rm = tpp.reduce_max (%x: tensor<5x5xf32>) -> tensor<1x5xf32>
+
+  // CHECK: tpp.softmax
+  %sm = tpp.softmax (%x: tensor<5x5xf32>) -> tensor<5x5xf32>
+
+  // CHECK: tpp.layernorm
+  %ln = tpp.layernorm (%x: tensor<5x5xf32>, %rm: tensor<1x5xf32>, %rm: tensor<1x5xf32>)
+                      -> tensor<5x5xf32> {epsilon = 1.0e-05 : f32}
   
   // CHECK: tpp.zero
   %5 = tpp.zero (%4: tensor<5x5xf32>) -> tensor<5x5xf32> 
@@ -48,6 +85,26 @@ func.func @vnni_gemm_b_operand(%arg0: tensor<32x32xbf16>,
   return %0: tensor<32x32xbf16>
 }
 
+// CHECK-LABEL: func.func @vnni4_gemm_i8
+func.func @vnni4_gemm_i8(%arg0: tensor<32x32xi8>,
+                         %arg1: tensor<8x32x4xi8>,
+                         %arg2: tensor<32x32xi32>) -> tensor<32x32xi32> {
+  // CHECK: tpp.gemm
+  %0 = tpp.gemm (%arg0: tensor<32x32xi8>, %arg1: tensor<8x32x4xi8>,
+                 %arg2: tensor<32x32xi32>) -> tensor<32x32xi32>
+  return %0: tensor<32x32xi32>
+}
+
+// CHECK-LABEL: func.func @vnni4_brgemm_i8
+func.func @vnni4_brgemm_i8(%arg0: tensor<3x32x32xi8>,
+                           %arg1: tensor<3x8x32x4xi8>,
+                           %arg2: tensor<32x32xi32>) -> tensor<32x32xi32> {
+  // CHECK: tpp.brgemm
+  %0 = tpp.brgemm (%arg0: tensor<3x32x32xi8>, %arg1: tensor<3x8x32x4xi8>,
+                   %arg2: tensor<32x32xi32>) -> tensor<32x32xi32>
+  return %0: tensor<32x32xi32>
+}
+
 // CHECK-LABEL: func.func @fused_brgemm
 func.func @fused_brgemm(%arg0: tensor<3x32x32xf32>, %arg1: tensor<3x32x32xf32>, %arg2: tensor<32x32xf32>,
                         %bias: tensor<32x32xf32>) -> tensor<32x32xf32> {
@@ -67,3 +124,12 @@ func.func @fused_brgemm_with_1d_bias(%arg0: tensor<3x32x32xf32>, %arg1: tensor<3
                          %arg2: tensor<32x32xf32>, %bias: tensor<32xf32>) -> tensor<32x32xf32>
   return %0: tensor<32x32xf32>
 }
+
+// CHECK-LABEL: func.func @dequantize
+func.func @dequantize(%arg0: tensor<4x8xi32>, %arg1: tensor<8xbf16>,
+                      %arg2: tensor<8xbf16>) -> tensor<4x8xbf16> {
+  // CHECK: tpp.dequantize
+  %0 = tpp.dequantize (%arg0: tensor<4x8xi32>, %arg1: tensor<8xbf16>,
+                       %arg2: tensor<8xbf16>) -> tensor<4x8xbf16>
+  return %0: tensor<4x8xbf16>
+}
@@ -65,7 +65,7 @@ func.func @gemm_dispatch() -> i64 {
 
 // CHECK-LABEL: func.func @gemm_dispatch
 func.func @gemm_dispatch() -> i64 {
-  // expected-error@+1 {{failed to satisfy constraint: i64 dense array attribute whose value is non-negative}}
+  // expected-error@+1 {{expect non-negative inputs}}
   %0 = xsmm.gemm.dispatch [-3, 2, 1, 3, 2] flags = (none) data_type = f32
   return %0 : i64
 }
@@ -137,7 +137,7 @@ func.func @brgemm_dispatch() -> i64 {
 
 // CHECK-LABEL: func.func @brgemm_dispatch
 func.func @brgemm_dispatch() -> i64 {
-  // expected-error@+1 {{failed to satisfy constraint: i64 dense array attribute whose value is non-negative}}
+  // expected-error@+1 {{expect non-negative inputs}}
   %0 = xsmm.brgemm.dispatch [3, 2, -1, 3, 2] flags = (none) data_type = f32
   return %0 : i64
 }
@@ -146,7 +146,7 @@ func.func @brgemm_dispatch() -> i64 {
 
 // CHECK-LABEL: func.func @unary_dispatch
 func.func @unary_dispatch() -> i64 {
-  // expected-error@+1 {{failed to satisfy constraint: i64 dense array attribute whose value is non-negative}}
+  // expected-error@+1 {{expect non-negative inputs}}
   %0 = xsmm.unary.dispatch relu [3, 2, 1, -3] flags = (none) data_type = f32
   return %0 : i64
 }
@@ -164,7 +164,7 @@ func.func @unary_dispatch() -> i64 {
 
 // CHECK-LABEL: func.func @binary_dispatch
 func.func @binary_dispatch() -> i64 {
-  // expected-error@+1 {{failed to satisfy constraint: i64 dense array attribute whose value is non-negative}}
+  // expected-error@+1 {{expect non-negative inputs}}
   %0 = xsmm.binary.dispatch add [3, 2, 1, 3, -2] flags = (none) data_type = f32
   return %0 : i64
 }
@@ -182,7 +182,7 @@ func.func @binary_dispatch() -> i64 {
 
 // CHECK-LABEL: func.func @ternary_dispatch
 func.func @ternary_dispatch() -> i64 {
-  // expected-error@+1 {{failed to satisfy constraint: i64 dense array attribute whose value is non-negative}}
+  // expected-error@+1 {{expect non-negative inputs}}
   %0 = xsmm.ternary.dispatch none [3, 2, 1, 3, -2] flags = (none) data_type = f32
   return %0 : i64
 }
@@ -255,3 +255,36 @@ func.func @fused_brgemm_none_kind_with_flags() -> i64 {
     flags = (vnni_a) binary_flags = (none) unary_flags = (bcast_scalar) data_type = bf16
   return %0 : i64
 }
+
+// -----
+
+func.func @gemm_dispatch_trans_and_vnni() -> i64 {
+  // expected-error@+1 {{transposed operand cannot be in VNNI layout}}
+  %0 = xsmm.gemm.dispatch [3, 2, 1, 3, 2, 1] flags = (trans_b, vnni_b) data_type = bf16
+  return %0 : i64
+}
+
+// -----
+
+func.func @fused_brgemm_dispatch_i8() -> i64 {
+  // expected-error@+1 {{i8 is not supported}}
+  %0 = xsmm.fused_brgemm.dispatch [3, 2, 4, 4, 2, 2] [add, relu]
+    flags = (none) binary_flags = (none) unary_flags = (none) data_type = i8
+  return %0 : i64
+}
+
+// -----
+
+func.func @unary_dispatch_convert_relu() -> i64 {
+  // expected-error@+1 {{expect identity to convert the input type}}
+  %0 = xsmm.unary.dispatch relu [3, 2, 1, 3] flags = (none) data_type = f32 input_data_type = i32
+  return %0 : i64
+}
+
+// -----
+
+func.func @ternary_dispatch_flags() -> i64 {
+  // expected-error@+1 {{'none' flags conflicts with others}}
+  %0 = xsmm.ternary.dispatch muladd [3, 2, 3, 1, 1, 3] flags = (none, bcast_col_in1) data_type = f32
+  return %0 : i64
+}
@@ -42,6 +42,10 @@ func.func @xsmm_dialect(%arg0: memref<2x2xf32>,
   %8 = xsmm.brgemm.dispatch [3, 2, 1, 3, 2, 1] flags = (beta_0) data_type = f32
   // CHECK-NEXT: xsmm.brgemm.dispatch
   %9 = xsmm.brgemm.dispatch [3, 2, 1, 3, 2, 1] flags = (none) data_type = f32
+  // CHECK-NEXT: xsmm.gemm.dispatch {{.*}} data_type = i8
+  %i8gemm = xsmm.gemm.dispatch [3, 2, 4, 4, 2, 2] flags = (vnni_b) data_type = i8
+  // CHECK-NEXT: xsmm.brgemm.dispatch {{.*}} data_type = i8
+  %i8brgemm = xsmm.brgemm.dispatch [3, 2, 4, 4, 2, 2] flags = (beta_0) data_type = i8
   // CHECK: xsmm.gemm.dispatch {{.*}} {myAttr = "myattr"}
   %10 = xsmm.gemm.dispatch [3, 2, 1, 3, 2, 1] flags = (none) data_type = f32 {myAttr = "myattr"}
 
@@ -55,5 +59,57 @@ func.func @xsmm_dialect(%arg0: memref<2x2xf32>,
   // CHECK: xsmm.unary zero
   xsmm.unary zero(data_type = f32, %11, %arg0, %arg0) : (i64, memref<2x2xf32>, memref<2x2xf32>) -> ()
 
+  // CHECK: xsmm.gemm_prefetch.dispatch
+  %13 = xsmm.gemm_prefetch.dispatch [3, 2, 1, 3, 2, 1] flags = (beta_0) data_type = f32
+  // CHECK-NEXT: xsmm.brgemm_prefetch.dispatch
+  %14 = xsmm.brgemm_prefetch.dispatch [3, 2, 1, 3, 2, 1] flags = (vnni_b) data_type = bf16
+
+  // CHECK: xsmm.gemm_prefetch
+  xsmm.gemm_prefetch (data_type = f32, %13, %arg0, %arg1, %arg2, %arg0, %arg1)
+    : (i64, memref<2x2xf32>, memref<2x2xf32>, memref<2x2xf32>, memref<2x2xf32>, memref<2x2xf32>) -> ()
+
+  // CHECK: xsmm.brgemm_offs.dispatch
+  %15 = xsmm.brgemm_offs.dispatch [3, 2, 1, 3, 2, 1] flags = (none) data_type = f32
+  // CHECK-NEXT: xsmm.brgemm_addr.dispatch
+  %16 = xsmm.brgemm_addr.dispatch [3, 2, 1, 3, 2, 1] flags = (beta_0) data_type = f32
+
+  // CHECK: xsmm.brgemm_addr
+  %addrs = memref.alloca() : memref<2xi64>
+  %c2_i64 = arith.constant 2 : i64
+  xsmm.brgemm_addr (data_type = f32, %16, %addrs, %addrs, %arg2, %c2_i64)
+    : (i64, memref<2xi64>, memref<2xi64>, memref<2x2xf32>, i64) -> ()
+
+  // CHECK: xsmm.unary.dispatch identity [2, 2, 2, 2] flags = (none) data_type = f32 input_data_type = i32
+  %17 = xsmm.unary.dispatch identity [2, 2, 2, 2] flags = (none) data_type = f32 input_data_type = i32
+  // CHECK: xsmm.unary identity
+  %acc = memref.alloca() : memref<2x2xi32>
+  xsmm.unary identity(data_type = f32, %17, %acc, %arg0)
+    : (i64, memref<2x2xi32>, memref<2x2xf32>) -> ()
+
+  // CHECK: xsmm.ternary.dispatch muladd [2, 2, 2, 2, 2, 2] flags = (bcast_col_in1, bcast_col_in2) data_type = f32
+  %18 = xsmm.ternary.dispatch muladd [2, 2, 2, 2, 2, 2]
+    flags = (bcast_col_in1, bcast_col_in2) data_type = f32
+  // CHECK: xsmm.ternary muladd
+  %vec = memref.alloca() : memref<1x2xf32>
+  xsmm.ternary muladd(data_type = f32, %18, %arg0, %vec, %vec, %arg0)
+    : (i64, memref<2x2xf32>, memref<1x2xf32>, memref<1x2xf32>, memref<2x2xf32>) -> ()
+
+  return
+}
+
+// CHECK-LABEL: @xsmm_dynamic_dispatch
+// CHECK-SAME: %[[M:.+]]: i64
+func.func @xsmm_dynamic_dispatch(%m: i64) {
+  // CHECK: xsmm.gemm.dispatch [%[[M]], 64, 32, 32, 64, 64] flags = (none) data_type = f32
+  %0 = xsmm.gemm.dispatch [%m, 64, 32, 32, 64, 64] flags = (none) data_type = f32
+  // CHECK: xsmm.brgemm.dispatch [%[[M]], 32, 32, 32, 32, 32] flags = (none) data_type = f32
+  %1 = xsmm.brgemm.dispatch [%m, 32, 32, 32, 32, 32] flags = (none) data_type = f32
+  // CHECK: xsmm.unary.dispatch relu [%[[M]], 64, 64, 64] flags = (none) data_type = f32
+  %2 = xsmm.unary.dispatch relu [%m, 64, 64, 64] flags = (none) data_type = f32
+  // CHECK: xsmm.binary.dispatch add [%[[M]], 64, 64, 64, 64] flags = (none) data_type = f32
+  %3 = xsmm.binary.dispatch add [%m, 64, 64, 64, 64] flags = (none) data_type = f32
+  // CHECK: xsmm.fused_brgemm.dispatch [%[[M]], 32, 32, 32, 32, 32] [add, relu]
+  %4 = xsmm.fused_brgemm.dispatch [%m, 32, 32, 32, 32, 32] [add, relu]
+    flags = (beta_0) binary_flags = (bcast_col_in0) unary_flags = (none) data_type = f32
   return
 }
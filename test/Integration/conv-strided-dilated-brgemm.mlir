@@ -0,0 +1,117 @@
+// RUN: tpp-opt %s -pack-conv2DNhwcHwcf="block-factors=2,2" \
+// RUN:  -rewrite-conv-to-matmul-or-brgemm="enable-brgemm=true" | \
+// RUN: FileCheck %s -check-prefix=IR
+
+// RUN: tpp-opt %s -pack-conv2DNhwcHwcf="block-factors=2,2" \
+// RUN:  -rewrite-conv-to-matmul-or-brgemm="enable-brgemm=true" | \
+// RUN: tpp-run -print \
+// RUN:  -e entry -entry-point-result=void | \
+// RUN: FileCheck %s
+
+// RUN: tpp-run %s -print \
+// RUN:  -e entry -entry-point-result=void | \
+// RUN: FileCheck %s
+
+// RUN: tpp-run %s -linalg-to-loops -print \
+// RUN:  -e entry -entry-point-result=void | \
+// RUN: FileCheck %s
+
+// Strided convolution: the image is read with a stride of 2 on W.
+func.func @conv_strided(%img: tensor<1x9x9x4xf32>, %filter: tensor<3x3x4x4xf32>, %out: tensor<1x4x4x4xf32>) -> tensor<1x4x4x4xf32> {
+  // IR-LABEL: @conv_strided
+  // IR: linalg.batch_reduce_matmul
+  %0 = linalg.conv_2d_nhwc_hwcf {dilations = dense<1> : tensor<2xi64>, strides = dense<2> : tensor<2xi64>}
+    ins(%img, %filter: tensor<1x9x9x4xf32>, tensor<3x3x4x4xf32>) outs(%out: tensor<1x4x4x4xf32>) -> tensor<1x4x4x4xf32>
+  return %0: tensor<1x4x4x4xf32>
+}
+
+// Dilated convolution: the filter taps are 2 pixels apart.
+func.func @conv_dilated(%img: tensor<1x8x8x4xf32>, %filter: tensor<3x3x4x4xf32>, %out: tensor<1x4x4x4xf32>) -> tensor<1x4x4x4xf32> {
+  // IR-LABEL: @conv_dilated
+  // IR: linalg.batch_reduce_matmul
+  %0 = linalg.conv_2d_nhwc_hwcf {dilations = dense<2> : tensor<2xi64>, strides = dense<1> : tensor<2xi64>}
+    ins(%img, %filter: tensor<1x8x8x4xf32>, tensor<3x3x4x4xf32>) outs(%out: tensor<1x4x4x4xf32>) -> tensor<1x4x4x4xf32>
+  return %0: tensor<1x4x4x4xf32>
+}
+
+// Image where each pixel holds its W coordinate.
+func.func private @generate_image(%init: tensor<1x?x?x4xf32>) -> tensor<1x?x?x4xf32> {
+  %img = linalg.generic {
+      indexing_maps = [affine_map<(d0, d1, d2, d3) -> (d0, d1, d2, d3)>],
+      iterator_types = ["parallel", "parallel", "parallel", "parallel"]}
+      outs(%init : tensor<1x?x?x4xf32>) {
+    ^bb0(%b0 : f32):
+      %w = linalg.index 2 : index
+      %w_i32 = arith.index_cast %w : index to i32
+      %w_val = arith.sitofp %w_i32 : i32 to f32
+      linalg.yield %w_val : f32
+  } -> tensor<1x?x?x4xf32>
+  return %img : tensor<1x?x?x4xf32>
+}
+
+func.func @entry() {
+  %c0 = arith.constant 0 : index
+  %d1 = arith.constant -1.0 : f32
+  %filter = arith.constant dense<1.0> : tensor<3x3x4x4xf32>
+  %out = arith.constant dense<0.0> : tensor<1x4x4x4xf32>
+
+  %c9 = arith.constant 9 : index
+  %img_init = tensor.empty(%c9, %c9) : tensor<1x?x?x4xf32>
+  %img_dyn = call @generate_image(%img_init) : (tensor<1x?x?x4xf32>) -> tensor<1x?x?x4xf32>
+  %img = tensor.cast %img_dyn : tensor<1x?x?x4xf32> to tensor<1x9x9x4xf32>
+  %result = call @conv_strided(%img, %filter, %out)
+    : (tensor<1x9x9x4xf32>, tensor<3x3x4x4xf32>, tensor<1x4x4x4xf32>) -> tensor<1x4x4x4xf32>
+  %v0 = vector.transfer_read %result[%c0, %c0, %c0, %c0], %d1 : tensor<1x4x4x4xf32>, vector<1x4x4x4xf32>
+
+  // out[q] = C * R * sum_s(2 * q + s) = 12 * (6 * q + 3)
+  //
+  // CHECK:     ( ( ( ( 36, 36, 36, 36 ),
+  // CHECK-SAME:    ( 108, 108, 108, 108 ),
+  // CHECK-SAME:    ( 180, 180, 180, 180 ),
+  // CHECK-SAME:    ( 252, 252, 252, 252 ) ),
+  // CHECK-SAME:  ( ( 36, 36, 36, 36 ),
+  // CHECK-SAME:    ( 108, 108, 108, 108 ),
+  // CHECK-SAME:    ( 180, 180, 180, 180 ),
+  // CHECK-SAME:    ( 252, 252, 252, 252 ) ),
+  // CHECK-SAME:  ( ( 36, 36, 36, 36 ),
+  // CHECK-SAME:    ( 108, 108, 108, 108 ),
+  // CHECK-SAME:    ( 180, 180, 180, 180 ),
+  // CHECK-SAME:    ( 252, 252, 252, 252 ) ),
+  // CHECK-SAME:  ( ( 36, 36, 36, 36 ),
+  // CHECK-SAME:    ( 108, 108, 108, 108 ),
+  // CHECK-SAME:    ( 180, 180, 180, 180 ),
+  // CHECK-SAME:    ( 252, 252, 252, 252 ) ) ) )
+  //
+  vector.print %v0 : vector<1x4x4x4xf32>
+
+  %c8 = arith.constant 8 : index
+  %img_init1 = tensor.empty(%c8, %c8) : tensor<1x?x?x4xf32>
+  %img_dyn1 = call @generate_image(%img_init1) : (tensor<1x?x?x4xf32>) -> tensor<1x?x?x4xf32>
+  %img1 = tensor.cast %img_dyn1 : tensor<1x?x?x4xf32> to tensor<1x8x8x4xf32>
+  %result1 = call @conv_dilated(%img1, %filter, %out)
+    : (tensor<1x8x8x4xf32>, tensor<3x3x4x4xf32>, tensor<1x4x4x4xf32>) -> tensor<1x4x4x4xf32>
+  %v1 = vector.transfer_read %result1[%c0, %c0, %c0, %c0], %d1 : tensor<1x4x4x4xf32>, vector<1x4x4x4xf32>
+
+  // out[q] = C * R * sum_s(q + 2 * s) = 12 * (3 * q + 6)
+  //
+  // CHECK:     ( ( ( ( 72, 72, 72, 72 ),
+  // CHECK-SAME:    ( 108, 108, 108, 108 ),
+  // CHECK-SAME:    ( 144, 144, 144, 144 ),
+  // CHECK-SAME:    ( 180, 180, 180, 180 ) ),
+  // CHECK-SAME:  ( ( 72, 72, 72, 72 ),
+  // CHECK-SAME:    ( 108, 108, 108, 108 ),
+  // CHECK-SAME:    ( 144, 144, 144, 144 ),
+  // CHECK-SAME:    ( 180, 180, 180, 180 ) ),
+  // CHECK-SAME:  ( ( 72, 72, 72, 72 ),
+  // CHECK-SAME:    ( 108, 108, 108, 108 ),
+  // CHECK-SAME:    ( 144, 144, 144, 144 ),
+  // CHECK-SAME:    ( 180, 180, 180, 180 ) ),
+  // CHECK-SAME:  ( ( 72, 72, 72, 72 ),
+  // CHECK-SAME:    ( 108, 108, 108, 108 ),
+  // CHECK-SAME:    ( 144, 144, 144, 144 ),
+  // CHECK-SAME:    ( 180, 180, 180, 180 ) ) ) )
+  //
+  vector.print %v1 : vector<1x4x4x4xf32>
+
+  return
+}
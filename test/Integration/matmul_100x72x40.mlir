@@ -0,0 +1,12 @@
+// RUN: tpp-run %s \
+// RUN:  -e entry -entry-point-result=void -print | \
+// RUN: FileCheck %s
+
+// Dimensions not multiple of the blocking factors: the remainders are peeled.
+func.func @entry(%A: tensor<100x40xf32>, %B: tensor<40x72xf32>,
+                  %C: tensor<100x72xf32>) -> tensor<100x72xf32> {
+  %D = linalg.matmul ins(%A, %B: tensor<100x40xf32>, tensor<40x72xf32>) outs(%C: tensor<100x72xf32>) -> tensor<100x72xf32>
+  return %D : tensor<100x72xf32>
+}
+
+// CHECK-COUNT-100: ( 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41, 41 )
@@ -0,0 +1,39 @@
+// Quantized (int8) versions (only unpacked for now)
+
+// Generated IR
+// RUN: mlir-gen --kernel=fc --seed=0 --float-width=32 --quant-width=8 --mini-batch=128 --layers=2304,768 2>&1 | FileCheck %s --check-prefix=IR
+
+// Constant values
+// RUN: mlir-gen --kernel=mlp --quant-width=8 --mini-batch=10 --layers=10,10,10 | tpp-run -e entry -entry-point-result=void -print | FileCheck %s --check-prefix=CONSTANT-MLP
+// RUN: mlir-gen --kernel=mlp --quant-width=8 --mini-batch=10 --layers=10,10,10 | tpp-run -e entry -entry-point-result=void -print --tpp-to-loops | FileCheck %s --check-prefix=CONSTANT-MLP
+// RUN: mlir-gen --kernel=mlp --quant-width=8 --mini-batch=10 --layers=10,10 | tpp-run -e entry -entry-point-result=void -print | FileCheck %s --check-prefix=CONSTANT-MATMUL
+
+// Kernel - fc
+// RUN: mlir-gen --kernel=fc --quant-width=8 --float-width=32 --mini-batch=10 --layers=10,10 | tpp-run -e entry -entry-point-result=void -print | FileCheck %s --check-prefix=GEN-FC
+// RUN: mlir-gen --kernel=fc --quant-width=8 --float-width=32 --mini-batch=10 --layers=10,10 | tpp-run -e entry -entry-point-result=void -print --tpp-to-loops | FileCheck %s --check-prefix=GEN-FC
+
+// Random values (can't check the output, so just check that it runs)
+// RUN: mlir-gen --kernel=mlp --seed=123 --quant-width=8 --mini-batch=10 --layers=10,10,10 | tpp-run -e entry -entry-point-result=void -n 10 | FileCheck %s --check-prefix=PERF
+// RUN: mlir-gen --kernel=mlp --seed=123 --quant-width=8 --mini-batch=10 --layers=10,10,10 --softmax | tpp-run -e entry -entry-point-result=void -n 10 | FileCheck %s --check-prefix=PERF
+
+// IR:     func.func @entry(%arg0: tensor<128x2304xi8>, %arg1: tensor<2304x768xi8>, %arg2: tensor<768xf32>, %arg3: tensor<128x768xf32>) -> tensor<128x768xf32>
+// IR:     linalg.generic {{.*}}iterator_types = ["parallel", "parallel", "reduction"]
+// IR:         arith.extsi {{.*}} : i8 to i32
+// IR:         arith.extsi {{.*}} : i8 to i32
+// IR:         arith.muli
+// IR:         arith.addi
+// IR:     linalg.generic {{.*}}iterator_types = ["parallel", "parallel"]
+// IR:         arith.sitofp {{.*}} : i32 to f32
+// IR:         arith.mulf
+// IR:         arith.addf
+// IR:         arith.maxf
+
+// All ones: the hidden layer gives 10 * 1 * 1 + 1 = 11, saturated to 11 in
+// i8, and the output layer 11 * 10 * 1 + 1 = 111.
+// CONSTANT-MLP: ( 111, 111, 111, 111, 111, 111, 111, 111, 111, 111 )
+
+// CONSTANT-MATMUL: ( 11, 11, 11, 11, 11, 11, 11, 11, 11, 11 )
+
+// GEN-FC: ( 11, 11, 11, 11, 11, 11, 11, 11, 11, 11 )
+
+// PERF:    ( {{[0-9]+}}{{.?}}{{[0-9e-]+}}, {{[0-9]+}}{{.?}}{{[0-9e-]+}} )
@@ -0,0 +1,23 @@
+// RUN: rm -f %t.json
+// RUN: tpp-run %s -e entry -entry-point-result=void -print \
+// RUN:  --autotune --tuning-db=%t.json 2>%t.log | FileCheck %s
+// RUN: FileCheck %s -check-prefix=LOG < %t.log
+// RUN: FileCheck %s -check-prefix=DB < %t.json
+// RUN: tpp-run %s -e entry -entry-point-result=void -print \
+// RUN:  -def-tuning-db=%t.json | FileCheck %s
+
+func.func @entry(%A: tensor<64x128xf32>, %B: tensor<128x64xf32>,
+                  %C: tensor<64x64xf32>) -> tensor<64x64xf32> {
+  %D = linalg.matmul ins(%A, %B: tensor<64x128xf32>, tensor<128x64xf32>)
+                     outs(%C: tensor<64x64xf32>) -> tensor<64x64xf32>
+  return %D : tensor<64x64xf32>
+}
+
+// The kernel runs with the best configuration and gives the same result.
+// CHECK-COUNT-64: ( 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129 )
+
+// LOG: autotune: default pipeline time=
+// LOG: autotune: linalg.matmul f32 64x64x128: block-factors=[{{[0-9]+}}, {{[0-9]+}}, {{[0-9]+}}] tile-sizes=[{{.*}}] time=
+
+// DB: "linalg.matmul f32 64x64x128": {
+// DB-NEXT: "block-factors": [
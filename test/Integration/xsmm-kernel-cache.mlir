@@ -0,0 +1,23 @@
+// RUN: rm -rf %t && mkdir -p %t
+// RUN: env TPP_XSMM_CACHE_DIR=%t TPP_XSMM_CACHE_VERBOSE=1 \
+// RUN:  tpp-run %s -e entry -entry-point-result=void -print 2>%t.cold.log | \
+// RUN: FileCheck %s
+// RUN: FileCheck %s -check-prefix=COLD < %t.cold.log
+// RUN: env TPP_XSMM_CACHE_DIR=%t TPP_XSMM_CACHE_VERBOSE=1 \
+// RUN:  tpp-run %s -e entry -entry-point-result=void -print 2>%t.warm.log | \
+// RUN: FileCheck %s
+// RUN: FileCheck %s -check-prefix=WARM < %t.warm.log
+
+func.func @entry(%A: tensor<64x128xf32>, %B: tensor<128x64xf32>,
+                  %C: tensor<64x64xf32>) -> tensor<64x64xf32> {
+  %D = linalg.matmul ins(%A, %B: tensor<64x128xf32>, tensor<128x64xf32>)
+                     outs(%C: tensor<64x64xf32>) -> tensor<64x64xf32>
+  return %D : tensor<64x64xf32>
+}
+
+// The kernels mapped from the cache give the same result as the JIT-ed ones.
+// CHECK-COUNT-64: ( 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129, 129 )
+
+// The cold run generates the kernels, the warm run maps all of them back.
+// COLD: XSMM kernel cache: 0 hits, {{[1-9][0-9]*}} misses
+// WARM: XSMM kernel cache: {{[1-9][0-9]*}} hits, 0 misses
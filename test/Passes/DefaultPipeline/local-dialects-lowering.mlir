@@ -69,3 +69,30 @@ func.func @xsmm_dialect(%arg0: memref<32x256xf32>, %arg1: memref<1x8x32x32xf32>)
 // CHECK-NOT: xsmm.ternary.dispatch
 // CHECK-DAG: {{[\w]*\.?}}call
 // CHECK-DAG: {{[\w]*\.?}}call
+
+// -----
+
+func.func @xsmm_dispatch_in_parallel(%arg0: memref<8x3x3xf32>, %arg1: i1) {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c8 = arith.constant 8 : index
+  scf.parallel (%i) = (%c0) to (%c8) step (%c1) {
+    %subview = memref.subview %arg0[%i, 0, 0] [1, 3, 3] [1, 1, 1]
+      : memref<8x3x3xf32> to memref<3x3xf32, strided<[3, 1], offset: ?>>
+    scf.if %arg1 {
+      %0 = xsmm.unary.dispatch relu [3, 3, 3, 3] flags = (none) data_type = f32
+      xsmm.unary relu(data_type = f32, %0, %subview, %subview)
+        : (i64, memref<3x3xf32, strided<[3, 1], offset: ?>>,
+           memref<3x3xf32, strided<[3, 1], offset: ?>>) -> ()
+    }
+    scf.yield
+  }
+  return
+}
+
+// CHECK-LABEL: func.func @xsmm_dispatch_in_parallel(
+// CHECK: %[[DISPATCH:.+]] = {{[\w]*\.?}}call @xsmm_unary_dispatch
+// CHECK: scf.parallel
+// CHECK-NOT: call @xsmm_unary_dispatch
+// CHECK: scf.if
+// CHECK: {{[\w]*\.?}}call @xsmm_unary_invoke({{.*}}%[[DISPATCH]]
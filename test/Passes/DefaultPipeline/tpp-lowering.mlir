@@ -12,9 +12,8 @@ func.func @tpp_ops(%arg0: memref<3x5x4xf32>, %arg1: memref<3x4x5xf32>, %arg2: me
 
 // XSMM-LABEL: func.func @tpp_ops(
 // XSMM-NOT: tpp.brgemm
-// XSMM: xsmm.brgemm
 // XSMM-NOT: tpp.relu
-// XSMM: xsmm.unary relu
+// XSMM: xsmm.fused_brgemm
 // XSMM-NOT: tpp.gemm
 // XSMM: xsmm.gemm
 
@@ -0,0 +1,17 @@
+// RUN: tpp-opt -pack-vnni %s | FileCheck %s
+
+// i8 brgemms accumulate in i32 and pack B by 4 on K (VNNI4).
+
+func.func @brgemm(%arg0: tensor<32x4x8xi8>, %arg1: tensor<32x8x4xi8>,
+                  %arg2: tensor<4x4xi32>) -> tensor<4x4xi32> {
+  %0 = linalg.batch_reduce_matmul ins(%arg0, %arg1: tensor<32x4x8xi8>, tensor<32x8x4xi8>)
+                                  outs(%arg2: tensor<4x4xi32>) -> tensor<4x4xi32>
+  return %0: tensor<4x4xi32>
+}
+
+// CHECK-LABEL: brgemm
+// CHECK-SAME: %[[ARG0:.+]]: tensor<32x4x8xi8>, %[[ARG1:.+]]: tensor<32x8x4xi8>, %[[ARG2:.+]]: tensor<4x4xi32>
+// CHECK: %[[EMPTY:.+]] = tensor.empty() : tensor<32x2x4x4xi8>
+// CHECK: %[[PACK:.+]] = tensor.pack %[[ARG1]]
+// CHECK-SAME:  inner_dims_pos = [1] inner_tiles = [4] into %[[EMPTY]] : tensor<32x8x4xi8> -> tensor<32x2x4x4xi8>
+// CHECK: tpp.brgemm (%[[ARG0]] : tensor<32x4x8xi8>, %[[PACK]] : tensor<32x2x4x4xi8>, %[[ARG2]] : tensor<4x4xi32>) -> (tensor<4x4xi32>)
@@ -0,0 +1,29 @@
+// RUN: tpp-opt %s -pack-matmul="block-factors=32,32,32" -pack-vnni -rewrite-to-brgemm -canonicalize | FileCheck %s
+
+// i8 matmuls accumulate in i32 and pack B by 4 on K (VNNI4).
+
+!A_tensor_t = tensor<256x512xi8>
+!B_tensor_t = tensor<512x1024xi8>
+!C_tensor_t = tensor<256x1024xi32>
+
+func.func @matmul_static(
+    %A : !A_tensor_t, %B : !B_tensor_t, %C : !C_tensor_t) -> !C_tensor_t {
+   %matmul = linalg.matmul ins(%A, %B : !A_tensor_t, !B_tensor_t)
+                           outs(%C: !C_tensor_t) -> !C_tensor_t
+   return %matmul : !C_tensor_t
+}
+
+// CHECK-LABEL: matmul_static
+// CHECK-SAME:  %[[ARG0:.+]]: tensor<256x512xi8>,
+// CHECK-SAME:  %[[ARG1:.+]]: tensor<512x1024xi8>,
+// CHECK-SAME:  %[[ARG2:.+]]: tensor<256x1024xi32>
+// CHECK: %[[EMPTY_ARG1:.+]] = tensor.empty() : tensor<32x16x32x32xi8>
+// CHECK: %[[PACKED_ARG1:.+]] = tensor.pack %[[ARG1]]
+// CHECK-SAME:  outer_dims_perm = [1, 0] inner_dims_pos = [0, 1] inner_tiles = [32, 32]
+// CHECK-SAME:  into %[[EMPTY_ARG1]] : tensor<512x1024xi8> -> tensor<32x16x32x32xi8>
+// CHECK: %[[EMPTY_VNNI:.+]] = tensor.empty() : tensor<32x16x8x32x4xi8>
+// CHECK: %[[PACKED_VNNI_ARG1:.+]] = tensor.pack %[[PACKED_ARG1]]
+// CHECK-SAME:  inner_dims_pos = [2] inner_tiles = [4]
+// CHECK-SAME:  into %[[EMPTY_VNNI]] : tensor<32x16x32x32xi8> -> tensor<32x16x8x32x4xi8>
+// CHECK: %{{.+}} = scf.forall
+// CHECK: %{{.+}} = tpp.brgemm (%{{.+}} : tensor<16x32x32xi8>, %{{.+}} : tensor<16x8x32x4xi8>, %{{.+}} : tensor<32x32xi32>) -> (tensor<32x32xi32>)
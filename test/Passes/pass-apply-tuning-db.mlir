@@ -0,0 +1,47 @@
+// RUN: echo '{"test-cpu": {"linalg.matmul f32 128x256x512": {"block-factors": [64, 32, 128], "tile-sizes": [2, 1], "time": 1.0e-3}}}' > %t.json
+// RUN: tpp-opt %s -apply-tuning-db="db=%t.json cpu=test-cpu" -split-input-file | FileCheck %s
+// RUN: tpp-opt %s -apply-tuning-db="db=%t.json cpu=test-cpu" -pack-matmul="block-factors=32,32,32" -split-input-file | FileCheck %s -check-prefix=PACK
+
+func.func @matmul_tuned(%arg0: tensor<128x512xf32>, %arg1: tensor<512x256xf32>,
+                        %arg2: tensor<128x256xf32>) -> tensor<128x256xf32> {
+  %0 = linalg.matmul ins(%arg0, %arg1: tensor<128x512xf32>, tensor<512x256xf32>)
+                     outs(%arg2: tensor<128x256xf32>) -> tensor<128x256xf32>
+  return %0 : tensor<128x256xf32>
+}
+
+// CHECK-LABEL: func.func @matmul_tuned(
+// CHECK: linalg.matmul {tpp.block_factors = array<i64: 64, 32, 128>, tpp.tile_sizes = array<i64: 2, 1>}
+
+// PACK-LABEL: func.func @matmul_tuned(
+// PACK: tensor.pack %{{.+}} inner_dims_pos = [0, 1] inner_tiles = [64, 128]
+// PACK-SAME:  : tensor<128x512xf32> -> tensor<2x4x64x128xf32>
+// PACK: linalg.generic
+// PACK-SAME:  tpp.tile_sizes = array<i64: 2, 1>
+
+// -----
+
+// Not in the database: left untouched.
+func.func @matmul_not_tuned(%arg0: tensor<64x64xf32>, %arg1: tensor<64x64xf32>,
+                            %arg2: tensor<64x64xf32>) -> tensor<64x64xf32> {
+  %0 = linalg.matmul ins(%arg0, %arg1: tensor<64x64xf32>, tensor<64x64xf32>)
+                     outs(%arg2: tensor<64x64xf32>) -> tensor<64x64xf32>
+  return %0 : tensor<64x64xf32>
+}
+
+// CHECK-LABEL: func.func @matmul_not_tuned(
+// CHECK: linalg.matmul ins
+
+// -----
+
+// An existing override wins over the database.
+func.func @matmul_override(%arg0: tensor<128x512xf32>, %arg1: tensor<512x256xf32>,
+                           %arg2: tensor<128x256xf32>) -> tensor<128x256xf32> {
+  %0 = linalg.matmul {tpp.block_factors = array<i64: 32, 32, 32>}
+                     ins(%arg0, %arg1: tensor<128x512xf32>, tensor<512x256xf32>)
+                     outs(%arg2: tensor<128x256xf32>) -> tensor<128x256xf32>
+  return %0 : tensor<128x256xf32>
+}
+
+// CHECK-LABEL: func.func @matmul_override(
+// CHECK: linalg.matmul {tpp.block_factors = array<i64: 32, 32, 32>}
+// CHECK-NOT: tpp.tile_sizes
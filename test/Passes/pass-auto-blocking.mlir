@@ -0,0 +1,88 @@
+// RUN: tpp-opt %s -pack-matmul="block-factors=32,32,32 auto-block=true num-threads=1" -pack-conv2DNhwcHwcf="auto-block=true num-threads=1" -split-input-file | FileCheck %s
+// RUN: tpp-opt %s -pack-matmul="auto-block=true num-threads=56" -split-input-file | FileCheck %s -check-prefix=THREADS
+
+// The [i x j] block is the largest that keeps the A and B panels in L2, k is
+// the largest block with A and B in L1.
+func.func @matmul_f32(%arg0: tensor<1024x1024xf32>, %arg1: tensor<1024x2560xf32>,
+                      %arg2: tensor<1024x2560xf32>) -> tensor<1024x2560xf32> {
+  %0 = linalg.matmul ins(%arg0, %arg1: tensor<1024x1024xf32>, tensor<1024x2560xf32>)
+                     outs(%arg2: tensor<1024x2560xf32>) -> tensor<1024x2560xf32>
+  return %0 : tensor<1024x2560xf32>
+}
+
+// CHECK-LABEL: func.func @matmul_f32(
+// CHECK: tensor.pack %{{.+}} inner_dims_pos = [0, 1] inner_tiles = [64, 32]
+// CHECK-SAME:  : tensor<1024x1024xf32> -> tensor<16x32x64x32xf32>
+// CHECK: tensor.pack %{{.+}} outer_dims_perm = [1, 0] inner_dims_pos = [0, 1] inner_tiles = [32, 128]
+// CHECK-SAME:  : tensor<1024x2560xf32> -> tensor<20x32x32x128xf32>
+// CHECK: tensor.pack %{{.+}} inner_dims_pos = [0, 1] inner_tiles = [64, 128]
+// CHECK-SAME:  : tensor<1024x2560xf32> -> tensor<16x20x64x128xf32>
+
+// THREADS-LABEL: func.func @matmul_f32(
+// THREADS: tensor.pack %{{.+}} inner_dims_pos = [0, 1] inner_tiles = [64, 32]
+// THREADS-SAME:  : tensor<1024x1024xf32> -> tensor<16x32x64x32xf32>
+
+// -----
+
+// bf16 halves the footprint: larger blocks fit and the k block is a multiple
+// of the VNNI factor.
+func.func @matmul_bf16(%arg0: tensor<1024x1024xbf16>, %arg1: tensor<1024x2560xbf16>,
+                       %arg2: tensor<1024x2560xbf16>) -> tensor<1024x2560xbf16> {
+  %0 = linalg.matmul ins(%arg0, %arg1: tensor<1024x1024xbf16>, tensor<1024x2560xbf16>)
+                     outs(%arg2: tensor<1024x2560xbf16>) -> tensor<1024x2560xbf16>
+  return %0 : tensor<1024x2560xbf16>
+}
+
+// CHECK-LABEL: func.func @matmul_bf16(
+// CHECK: tensor.pack %{{.+}} inner_dims_pos = [0, 1] inner_tiles = [128, 64]
+// CHECK-SAME:  : tensor<1024x1024xbf16> -> tensor<8x16x128x64xbf16>
+// CHECK: tensor.pack %{{.+}} outer_dims_perm = [1, 0] inner_dims_pos = [0, 1] inner_tiles = [64, 128]
+// CHECK-SAME:  : tensor<1024x2560xbf16> -> tensor<20x16x64x128xbf16>
+
+// -----
+
+// With many threads smaller blocks keep all of them busy.
+func.func @matmul_small_m(%arg0: tensor<128x3072xf32>, %arg1: tensor<3072x768xf32>,
+                          %arg2: tensor<128x768xf32>) -> tensor<128x768xf32> {
+  %0 = linalg.matmul ins(%arg0, %arg1: tensor<128x3072xf32>, tensor<3072x768xf32>)
+                     outs(%arg2: tensor<128x768xf32>) -> tensor<128x768xf32>
+  return %0 : tensor<128x768xf32>
+}
+
+// THREADS-LABEL: func.func @matmul_small_m(
+// THREADS: tensor.pack %{{.+}} inner_dims_pos = [0, 1] inner_tiles = [32, 128]
+// THREADS-SAME:  : tensor<128x3072xf32> -> tensor<4x24x32x128xf32>
+// THREADS: tensor.pack %{{.+}} outer_dims_perm = [1, 0] inner_dims_pos = [0, 1] inner_tiles = [128, 32]
+// THREADS-SAME:  : tensor<3072x768xf32> -> tensor<24x24x128x32xf32>
+
+// -----
+
+// The per-op attribute takes precedence over the cost model.
+func.func @matmul_override(%arg0: tensor<128x128xf32>, %arg1: tensor<128x128xf32>,
+                           %arg2: tensor<128x128xf32>) -> tensor<128x128xf32> {
+  %0 = linalg.matmul {tpp.block_factors = array<i64: 16, 64, 8>}
+                     ins(%arg0, %arg1: tensor<128x128xf32>, tensor<128x128xf32>)
+                     outs(%arg2: tensor<128x128xf32>) -> tensor<128x128xf32>
+  return %0 : tensor<128x128xf32>
+}
+
+// CHECK-LABEL: func.func @matmul_override(
+// CHECK: tensor.pack %{{.+}} inner_dims_pos = [0, 1] inner_tiles = [16, 8]
+// CHECK-SAME:  : tensor<128x128xf32> -> tensor<8x16x16x8xf32>
+// CHECK: tensor.pack %{{.+}} outer_dims_perm = [1, 0] inner_dims_pos = [0, 1] inner_tiles = [8, 64]
+// CHECK-SAME:  : tensor<128x128xf32> -> tensor<2x16x8x64xf32>
+
+// -----
+
+func.func @conv_2d_nhwc_hwcf(%arg0: tensor<1x56x56x64xf32>, %arg1: tensor<3x3x64x64xf32>,
+                             %arg2: tensor<1x54x54x64xf32>) -> tensor<1x54x54x64xf32> {
+  %0 = linalg.conv_2d_nhwc_hwcf ins(%arg0, %arg1 : tensor<1x56x56x64xf32>, tensor<3x3x64x64xf32>)
+                                outs(%arg2: tensor<1x54x54x64xf32>) -> tensor<1x54x54x64xf32>
+  return %0 : tensor<1x54x54x64xf32>
+}
+
+// CHECK-LABEL: func.func @conv_2d_nhwc_hwcf(
+// CHECK: tensor.pack %{{.+}} outer_dims_perm = [0, 3, 1, 2] inner_dims_pos = [3] inner_tiles = [64]
+// CHECK-SAME:  : tensor<1x56x56x64xf32> -> tensor<1x1x56x56x64xf32>
+// CHECK: tensor.pack %{{.+}} outer_dims_perm = [3, 2, 0, 1] inner_dims_pos = [2, 3] inner_tiles = [64, 64]
+// CHECK-SAME:  : tensor<3x3x64x64xf32> -> tensor<1x1x3x3x64x64xf32>
@@ -29,3 +29,175 @@ func.func @fused_brgemm_test1(%arg0: tensor<4x32x32xf32>, %arg1: tensor<4x32x32x
 // CHECK-SAME: %[[ARG2:.+]]: tensor<32x32xf32>, %[[ARG3:.+]]: tensor<32x32xf32>
 // CHECK: {{.+}} = tpp.fused_brgemm [unary = relu, binary = add]
 // CHECK-SAME: (%[[ARG0]] : tensor<4x32x32xf32>, %[[ARG1]] : tensor<4x32x32xf32>, %[[ARG2]] : tensor<32x32xf32>, %[[ARG3]] : tensor<32x32xf32>) -> (tensor<32x32xf32>)
+
+// -----
+
+func.func @fused_gemm_bias_relu(%arg0: tensor<32x64xf32>, %arg1: tensor<64x32xf32>, %arg2: tensor<32x32xf32>,
+                                %arg3: tensor<32xf32>) -> tensor<32x32xf32> {
+  %0 = tpp.gemm (%arg0: tensor<32x64xf32>, %arg1: tensor<64x32xf32>, %arg2: tensor<32x32xf32>) -> tensor<32x32xf32>
+  %1 = tpp.add (%0: tensor<32x32xf32>, %arg3: tensor<32xf32>) -> tensor<32x32xf32>
+  %2 = tpp.relu (%1: tensor<32x32xf32>) -> tensor<32x32xf32>
+  return %2 : tensor<32x32xf32>
+}
+
+// CHECK-LABEL: fused_gemm_bias_relu
+// CHECK-SAME: %[[ARG0:.+]]: tensor<32x64xf32>, %[[ARG1:.+]]: tensor<64x32xf32>,
+// CHECK-SAME: %[[ARG2:.+]]: tensor<32x32xf32>, %[[ARG3:.+]]: tensor<32xf32>
+// CHECK-DAG: %[[A:.+]] = tensor.expand_shape %[[ARG0]] {{\[}}[0, 1], [2]] : tensor<32x64xf32> into tensor<1x32x64xf32>
+// CHECK-DAG: %[[B:.+]] = tensor.expand_shape %[[ARG1]] {{\[}}[0, 1], [2]] : tensor<64x32xf32> into tensor<1x64x32xf32>
+// CHECK: {{.+}} = tpp.fused_brgemm [unary = relu, binary = add]
+// CHECK-SAME: (%[[A]] : tensor<1x32x64xf32>, %[[B]] : tensor<1x64x32xf32>, %[[ARG2]] : tensor<32x32xf32>, %[[ARG3]] : tensor<32xf32>) -> (tensor<32x32xf32>)
+// CHECK-NOT: tpp.gemm
+// CHECK-NOT: tpp.add
+// CHECK-NOT: tpp.relu
+
+// -----
+
+func.func @fused_brgemm_bias(%arg0: tensor<4x32x32xf32>, %arg1: tensor<4x32x32xf32>, %arg2: tensor<32x32xf32>,
+                             %arg3: tensor<1x32xf32>) -> tensor<32x32xf32> {
+  %0 = tpp.brgemm (%arg0: tensor<4x32x32xf32>, %arg1: tensor<4x32x32xf32>, %arg2: tensor<32x32xf32>) -> tensor<32x32xf32>
+  %1 = tpp.add (%arg3: tensor<1x32xf32>, %0: tensor<32x32xf32>) -> tensor<32x32xf32>
+  return %1 : tensor<32x32xf32>
+}
+
+// CHECK-LABEL: fused_brgemm_bias
+// CHECK-SAME: %[[ARG0:.+]]: tensor<4x32x32xf32>, %[[ARG1:.+]]: tensor<4x32x32xf32>,
+// CHECK-SAME: %[[ARG2:.+]]: tensor<32x32xf32>, %[[ARG3:.+]]: tensor<1x32xf32>
+// CHECK: {{.+}} = tpp.fused_brgemm [unary = none, binary = add]
+// CHECK-SAME: (%[[ARG0]] : tensor<4x32x32xf32>, %[[ARG1]] : tensor<4x32x32xf32>, %[[ARG2]] : tensor<32x32xf32>, %[[ARG3]] : tensor<1x32xf32>) -> (tensor<32x32xf32>)
+
+// -----
+
+func.func @fused_brgemm_relu(%arg0: tensor<4x32x32xf32>, %arg1: tensor<4x32x32xf32>,
+                             %arg2: tensor<32x32xf32>) -> tensor<32x32xf32> {
+  %0 = tpp.brgemm (%arg0: tensor<4x32x32xf32>, %arg1: tensor<4x32x32xf32>, %arg2: tensor<32x32xf32>) -> tensor<32x32xf32>
+  %1 = tpp.relu (%0: tensor<32x32xf32>) -> tensor<32x32xf32>
+  return %1 : tensor<32x32xf32>
+}
+
+// CHECK-LABEL: fused_brgemm_relu
+// CHECK-SAME: %[[ARG0:.+]]: tensor<4x32x32xf32>, %[[ARG1:.+]]: tensor<4x32x32xf32>, %[[ARG2:.+]]: tensor<32x32xf32>
+// CHECK: {{.+}} = tpp.fused_brgemm [unary = relu, binary = none]
+// CHECK-SAME: (%[[ARG0]] : tensor<4x32x32xf32>, %[[ARG1]] : tensor<4x32x32xf32>, %[[ARG2]] : tensor<32x32xf32>, %[[ARG2]] : tensor<32x32xf32>) -> (tensor<32x32xf32>)
+
+// -----
+
+// The gemm result has another user, fusing would recompute it.
+func.func @brgemm_multiple_uses(%arg0: tensor<4x32x32xf32>, %arg1: tensor<4x32x32xf32>, %arg2: tensor<32x32xf32>,
+                                %arg3: tensor<32x32xf32>) -> (tensor<32x32xf32>, tensor<32x32xf32>) {
+  %0 = tpp.brgemm (%arg0: tensor<4x32x32xf32>, %arg1: tensor<4x32x32xf32>, %arg2: tensor<32x32xf32>) -> tensor<32x32xf32>
+  %1 = tpp.add (%0: tensor<32x32xf32>, %arg3: tensor<32x32xf32>) -> tensor<32x32xf32>
+  return %0, %1 : tensor<32x32xf32>, tensor<32x32xf32>
+}
+
+// CHECK-LABEL: brgemm_multiple_uses
+// CHECK-NOT: tpp.fused_brgemm
+// CHECK: tpp.brgemm
+// CHECK: tpp.add
+
+// -----
+
+func.func @fused_gemm_bias_relu_memref(%arg0: memref<32x64xf32>, %arg1: memref<64x32xf32>, %arg2: memref<32x32xf32>,
+                                       %arg3: memref<32xf32>) {
+  tpp.gemm ins(%arg0: memref<32x64xf32>, %arg1: memref<64x32xf32>, %arg2: memref<32x32xf32>)
+           outs(%arg2: memref<32x32xf32>)
+  tpp.add ins(%arg3: memref<32xf32>, %arg2: memref<32x32xf32>) outs(%arg2: memref<32x32xf32>)
+  tpp.relu ins(%arg2: memref<32x32xf32>) outs(%arg2: memref<32x32xf32>)
+  return
+}
+
+// CHECK-LABEL: fused_gemm_bias_relu_memref
+// CHECK-SAME: %[[ARG0:.+]]: memref<32x64xf32>, %[[ARG1:.+]]: memref<64x32xf32>,
+// CHECK-SAME: %[[ARG2:.+]]: memref<32x32xf32>, %[[ARG3:.+]]: memref<32xf32>
+// CHECK-DAG: %[[A:.+]] = memref.expand_shape %[[ARG0]] {{\[}}[0, 1], [2]] : memref<32x64xf32> into memref<1x32x64xf32>
+// CHECK-DAG: %[[B:.+]] = memref.expand_shape %[[ARG1]] {{\[}}[0, 1], [2]] : memref<64x32xf32> into memref<1x64x32xf32>
+// CHECK: tpp.fused_brgemm [unary = relu, binary = add]
+// CHECK-SAME: ins(%[[A]] : memref<1x32x64xf32>, %[[B]] : memref<1x64x32xf32>, %[[ARG2]] : memref<32x32xf32>, %[[ARG3]] : memref<32xf32>)
+// CHECK-SAME: outs(%[[ARG2]] : memref<32x32xf32>)
+// CHECK-NOT: tpp.gemm
+// CHECK-NOT: tpp.add
+// CHECK-NOT: tpp.relu
+
+// -----
+
+func.func @fused_brgemm_relu_memref(%arg0: memref<4x32x32xf32>, %arg1: memref<4x32x32xf32>,
+                                    %arg2: memref<32x32xf32>) {
+  tpp.brgemm ins(%arg0: memref<4x32x32xf32>, %arg1: memref<4x32x32xf32>, %arg2: memref<32x32xf32>)
+             outs(%arg2: memref<32x32xf32>)
+  tpp.relu ins(%arg2: memref<32x32xf32>) outs(%arg2: memref<32x32xf32>)
+  return
+}
+
+// CHECK-LABEL: fused_brgemm_relu_memref
+// CHECK-SAME: %[[ARG0:.+]]: memref<4x32x32xf32>, %[[ARG1:.+]]: memref<4x32x32xf32>, %[[ARG2:.+]]: memref<32x32xf32>
+// CHECK: tpp.fused_brgemm [unary = relu, binary = none]
+// CHECK-SAME: ins(%[[ARG0]] : memref<4x32x32xf32>, %[[ARG1]] : memref<4x32x32xf32>, %[[ARG2]] : memref<32x32xf32>, %[[ARG2]] : memref<32x32xf32>)
+// CHECK-SAME: outs(%[[ARG2]] : memref<32x32xf32>)
+
+// -----
+
+// The relu does not update the brgemm output in place.
+func.func @brgemm_relu_not_in_place(%arg0: memref<4x32x32xf32>, %arg1: memref<4x32x32xf32>,
+                                    %arg2: memref<32x32xf32>, %arg3: memref<32x32xf32>) {
+  tpp.brgemm ins(%arg0: memref<4x32x32xf32>, %arg1: memref<4x32x32xf32>, %arg2: memref<32x32xf32>)
+             outs(%arg2: memref<32x32xf32>)
+  tpp.relu ins(%arg2: memref<32x32xf32>) outs(%arg3: memref<32x32xf32>)
+  return
+}
+
+// CHECK-LABEL: brgemm_relu_not_in_place
+// CHECK-NOT: tpp.fused_brgemm
+// CHECK: tpp.brgemm
+// CHECK: tpp.relu
+
+// -----
+
+// The output is read in between, the relu cannot be moved into the brgemm.
+func.func @brgemm_relu_interleaved(%arg0: memref<4x32x32xf32>, %arg1: memref<4x32x32xf32>,
+                                   %arg2: memref<32x32xf32>, %arg3: memref<32x32xf32>) {
+  tpp.brgemm ins(%arg0: memref<4x32x32xf32>, %arg1: memref<4x32x32xf32>, %arg2: memref<32x32xf32>)
+             outs(%arg2: memref<32x32xf32>)
+  tpp.identity ins(%arg2: memref<32x32xf32>) outs(%arg3: memref<32x32xf32>)
+  tpp.relu ins(%arg2: memref<32x32xf32>) outs(%arg2: memref<32x32xf32>)
+  return
+}
+
+// CHECK-LABEL: brgemm_relu_interleaved
+// CHECK-NOT: tpp.fused_brgemm
+// CHECK: tpp.brgemm
+// CHECK: tpp.identity
+// CHECK: tpp.relu
+
+// -----
+
+func.func @fused_gemm_bias_gelu(%arg0: tensor<32x64xf32>, %arg1: tensor<64x32xf32>, %arg2: tensor<32x32xf32>,
+                                %arg3: tensor<32xf32>) -> tensor<32x32xf32> {
+  %0 = tpp.gemm (%arg0: tensor<32x64xf32>, %arg1: tensor<64x32xf32>, %arg2: tensor<32x32xf32>) -> tensor<32x32xf32>
+  %1 = tpp.add (%0: tensor<32x32xf32>, %arg3: tensor<32xf32>) -> tensor<32x32xf32>
+  %2 = tpp.gelu (%1: tensor<32x32xf32>) -> tensor<32x32xf32>
+  return %2 : tensor<32x32xf32>
+}
+
+// CHECK-LABEL: fused_gemm_bias_gelu
+// CHECK: tpp.fused_brgemm [unary = gelu, binary = add]
+// CHECK-NOT: tpp.gelu
+
+// -----
+
+func.func @fused_brgemm_unary_memref(%arg0: memref<4x32x32xf32>, %arg1: memref<4x32x32xf32>,
+                                     %arg2: memref<32x32xf32>, %arg3: memref<32x32xf32>) {
+  tpp.brgemm ins(%arg0: memref<4x32x32xf32>, %arg1: memref<4x32x32xf32>, %arg2: memref<32x32xf32>)
+             outs(%arg2: memref<32x32xf32>)
+  tpp.sigmoid ins(%arg2: memref<32x32xf32>) outs(%arg2: memref<32x32xf32>)
+  tpp.brgemm ins(%arg0: memref<4x32x32xf32>, %arg1: memref<4x32x32xf32>, %arg3: memref<32x32xf32>)
+             outs(%arg3: memref<32x32xf32>)
+  tpp.tanh ins(%arg3: memref<32x32xf32>) outs(%arg3: memref<32x32xf32>)
+  // Only one unary op fits in the epilogue.
+  tpp.exp ins(%arg3: memref<32x32xf32>) outs(%arg3: memref<32x32xf32>)
+  return
+}
+
+// CHECK-LABEL: fused_brgemm_unary_memref
+// CHECK: tpp.fused_brgemm [unary = sigmoid, binary = none]
+// CHECK: tpp.fused_brgemm [unary = tanh, binary = none]
+// CHECK: tpp.exp
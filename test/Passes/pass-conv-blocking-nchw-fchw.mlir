@@ -41,3 +41,20 @@ func.func @conv_2d_nchw_fchw(%i: tensor<14x14x28x28xf32>, %f: tensor<16x14x1x1xf
 // CHECK: %{{.+}} = linalg.conv_2d_nchw_fchw
 // CHECK-SAME:  ins(%[[ARG0]], %[[ARG1]]
 // CHECK-SAME:  outs(%[[ARG2]]
+
+// -----
+
+func.func @conv_2d_nchw_fchw_strided_dilated(%i: tensor<1x64x17x17xf32>, %f: tensor<64x64x3x3xf32>,
+                %o: tensor<1x64x7x7xf32>) -> tensor<1x64x7x7xf32> {
+  %0 = linalg.conv_2d_nchw_fchw {dilations = dense<2> : tensor<2xi64>, strides = dense<2> : tensor<2xi64>}
+    ins(%i, %f: tensor<1x64x17x17xf32>, tensor<64x64x3x3xf32>) outs(%o: tensor<1x64x7x7xf32>) -> tensor<1x64x7x7xf32>
+  return %0: tensor<1x64x7x7xf32>
+}
+
+// CHECK-DAG: #[[MAP0:.+]] = affine_map<(d0, d1, d2, d3, d4, d5, d6, d7, d8) -> (d0, d5, d2 * 2 + d6 * 2, d3 * 2 + d7 * 2, d8)>
+// CHECK-DAG: #[[MAP1:.+]] = affine_map<(d0, d1, d2, d3, d4, d5, d6, d7, d8) -> (d1, d5, d6, d7, d8, d4)>
+// CHECK-DAG: #[[MAP2:.+]] = affine_map<(d0, d1, d2, d3, d4, d5, d6, d7, d8) -> (d0, d1, d2, d3, d4)>
+
+// CHECK: func.func @conv_2d_nchw_fchw_strided_dilated(
+// CHECK: %{{.+}} = linalg.generic {indexing_maps = [#[[MAP0]], #[[MAP1]], #[[MAP2]]]
+// CHECK-SAME:  ins(%{{.+}}, %{{.+}} : tensor<1x2x17x17x32xf32>, tensor<2x2x3x3x32x32xf32>) outs(%{{.+}} : tensor<1x2x7x7x32xf32>)
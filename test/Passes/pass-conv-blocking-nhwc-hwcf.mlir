@@ -95,3 +95,28 @@ func.func @conv_2d_nhwc_hwcf(%i: tensor<1x230x230x3xf32>, %f: tensor<7x7x3x64xf3
 // CHECK: %{{.+}} = linalg.conv_2d_nhwc_hwcf
 // CHECK-SAME:  ins(%[[ARG0]], %[[ARG1]] : tensor<1x230x230x3xf32>, tensor<7x7x3x64xf32>)
 // CHECK-SAME:  outs(%[[ARG2]] : tensor<1x112x112x64xf32>)
+
+// -----
+
+// Zero padding on H and W is moved after packing: the unpadded image is packed.
+func.func @conv_2d_nhwc_hwcf_padded(%arg0: tensor<1x56x56x64xf32>, %arg1: tensor<3x3x64x64xf32>, %arg2: tensor<1x56x56x64xf32>) -> tensor<1x56x56x64xf32> {
+  %cst = arith.constant 0.0 : f32
+  %padded = tensor.pad %arg0 low[0, 1, 1, 0] high[0, 1, 1, 0] {
+  ^bb0(%arg3: index, %arg4: index, %arg5: index, %arg6: index):
+    tensor.yield %cst : f32
+  } : tensor<1x56x56x64xf32> to tensor<1x58x58x64xf32>
+  %1 = linalg.conv_2d_nhwc_hwcf {dilations = dense<1> : tensor<2xi64>,
+                                 strides = dense<1> : tensor<2xi64>}
+    ins(%padded, %arg1 : tensor<1x58x58x64xf32>, tensor<3x3x64x64xf32>)
+    outs(%arg2: tensor<1x56x56x64xf32>) -> tensor<1x56x56x64xf32>
+  return %1 : tensor<1x56x56x64xf32>
+}
+
+// CHECK: func.func @conv_2d_nhwc_hwcf_padded(
+// CHECK-SAME: %[[ARG0:.+]]: tensor<1x56x56x64xf32>,
+// CHECK: %[[PACK0:.+]] = tensor.pack %[[ARG0]]
+// CHECK-SAME:  : tensor<1x56x56x64xf32> -> tensor<1x2x56x56x32xf32>
+// CHECK: %[[PAD:.+]] = tensor.pad %[[PACK0]] low[0, 0, 1, 1, 0] high[0, 0, 1, 1, 0]
+// CHECK: tensor<1x2x56x56x32xf32> to tensor<1x2x58x58x32xf32>
+// CHECK: linalg.generic
+// CHECK-SAME:  ins(%[[PAD]], %{{.+}} : tensor<1x2x58x58x32xf32>, tensor<2x2x3x3x32x32xf32>)
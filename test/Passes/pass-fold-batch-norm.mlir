@@ -0,0 +1,168 @@
+// RUN: tpp-opt %s -fold-batch-norm -canonicalize -split-input-file | FileCheck %s
+
+#map = affine_map<(d0, d1) -> (d0, d1)>
+#map1 = affine_map<(d0, d1) -> (d1)>
+
+func.func @matmul_scale_shift(%arg0: tensor<4x2xf32>) -> tensor<4x2xf32> {
+  %weights = arith.constant dense<[[1.0, 2.0], [3.0, 4.0]]> : tensor<2x2xf32>
+  %scale = arith.constant dense<[2.0, 0.5]> : tensor<2xf32>
+  %shift = arith.constant dense<[1.0, -1.0]> : tensor<2xf32>
+  %cst = arith.constant 0.0 : f32
+  %0 = tensor.empty() : tensor<4x2xf32>
+  %1 = linalg.fill ins(%cst : f32) outs(%0 : tensor<4x2xf32>) -> tensor<4x2xf32>
+  %2 = linalg.matmul ins(%arg0, %weights : tensor<4x2xf32>, tensor<2x2xf32>) outs(%1 : tensor<4x2xf32>) -> tensor<4x2xf32>
+  %3 = linalg.generic {indexing_maps = [#map, #map1, #map1, #map], iterator_types = ["parallel", "parallel"]} ins(%2, %scale, %shift : tensor<4x2xf32>, tensor<2xf32>, tensor<2xf32>) outs(%0 : tensor<4x2xf32>) {
+    ^bb0(%in: f32, %s: f32, %b: f32, %out: f32):
+      %4 = arith.mulf %in, %s : f32
+      %5 = arith.addf %4, %b : f32
+      linalg.yield %5 : f32
+  } -> tensor<4x2xf32>
+  return %3 : tensor<4x2xf32>
+}
+
+// CHECK-DAG: #[[MAP:.+]] = affine_map<(d0, d1) -> (d1)>
+// CHECK-DAG: #[[MAP1:.+]] = affine_map<(d0, d1) -> (d0, d1)>
+// CHECK-LABEL: func.func @matmul_scale_shift(
+// CHECK-SAME:  %[[ARG0:.+]]: tensor<4x2xf32>)
+// CHECK-DAG: %[[WEIGHTS:.+]] = arith.constant dense<{{\[\[}}2.000000e+00, 1.000000e+00], [6.000000e+00, 2.000000e+00]]> : tensor<2x2xf32>
+// CHECK-DAG: %[[BIAS:.+]] = arith.constant dense<[1.000000e+00, -1.000000e+00]> : tensor<2xf32>
+// CHECK: %[[EMPTY:.+]] = tensor.empty() : tensor<4x2xf32>
+// CHECK: %[[INIT:.+]] = linalg.generic
+// CHECK-SAME:  indexing_maps = [#[[MAP]], #[[MAP1]]]
+// CHECK-SAME:  ins(%[[BIAS]] : tensor<2xf32>) outs(%[[EMPTY]] : tensor<4x2xf32>)
+// CHECK: %[[MM:.+]] = linalg.matmul ins(%[[ARG0]], %[[WEIGHTS]] : tensor<4x2xf32>, tensor<2x2xf32>)
+// CHECK-SAME:  outs(%[[INIT]] : tensor<4x2xf32>)
+// CHECK-NOT: linalg.generic
+// CHECK: return %[[MM]]
+
+// -----
+
+#map = affine_map<(d0, d1, d2, d3) -> (d3)>
+#map1 = affine_map<(d0, d1, d2, d3) -> (d0, d1, d2, d3)>
+
+// Batch-norm with constant statistics after a convolution with bias:
+// (x - mean) / sqrt(var + eps) * gamma + beta.
+func.func @conv_batch_norm(%arg0: tensor<1x4x4x2xf32>) -> tensor<1x4x4x2xf32> {
+  %filter = arith.constant dense<[[[[1.0, 2.0], [3.0, 4.0]]]]> : tensor<1x1x2x2xf32>
+  %bias = arith.constant dense<1.0> : tensor<2xf32>
+  %mean = arith.constant dense<[1.0, 0.0]> : tensor<2xf32>
+  %var = arith.constant dense<[3.0, 0.0]> : tensor<2xf32>
+  %gamma = arith.constant dense<[4.0, 1.0]> : tensor<2xf32>
+  %beta = arith.constant dense<[0.0, 2.0]> : tensor<2xf32>
+  %eps = arith.constant 1.0 : f32
+  %0 = tensor.empty() : tensor<1x4x4x2xf32>
+  %1 = linalg.generic {indexing_maps = [#map, #map1], iterator_types = ["parallel", "parallel", "parallel", "parallel"]} ins(%bias : tensor<2xf32>) outs(%0 : tensor<1x4x4x2xf32>) {
+    ^bb0(%in: f32, %out: f32):
+      linalg.yield %in : f32
+  } -> tensor<1x4x4x2xf32>
+  %2 = linalg.conv_2d_nhwc_hwcf {dilations = dense<1> : tensor<2xi64>, strides = dense<1> : tensor<2xi64>} ins(%arg0, %filter : tensor<1x4x4x2xf32>, tensor<1x1x2x2xf32>) outs(%1 : tensor<1x4x4x2xf32>) -> tensor<1x4x4x2xf32>
+  %3 = linalg.generic {indexing_maps = [#map1, #map, #map, #map, #map, #map1], iterator_types = ["parallel", "parallel", "parallel", "parallel"]} ins(%2, %mean, %var, %gamma, %beta : tensor<1x4x4x2xf32>, tensor<2xf32>, tensor<2xf32>, tensor<2xf32>, tensor<2xf32>) outs(%0 : tensor<1x4x4x2xf32>) {
+    ^bb0(%in: f32, %m: f32, %v: f32, %g: f32, %b: f32, %out: f32):
+      %4 = arith.subf %in, %m : f32
+      %5 = arith.addf %v, %eps : f32
+      %6 = math.sqrt %5 : f32
+      %7 = arith.divf %4, %6 : f32
+      %8 = arith.mulf %7, %g : f32
+      %9 = arith.addf %8, %b : f32
+      linalg.yield %9 : f32
+  } -> tensor<1x4x4x2xf32>
+  return %3 : tensor<1x4x4x2xf32>
+}
+
+// CHECK-LABEL: func.func @conv_batch_norm(
+// CHECK-SAME:  %[[ARG0:.+]]: tensor<1x4x4x2xf32>)
+// CHECK-DAG: %[[FILTER:.+]] = arith.constant dense<{{\[\[\[\[}}2.000000e+00, 2.000000e+00], [6.000000e+00, 4.000000e+00]]]]> : tensor<1x1x2x2xf32>
+// CHECK-DAG: %[[BIAS:.+]] = arith.constant dense<[0.000000e+00, 3.000000e+00]> : tensor<2xf32>
+// CHECK: %[[INIT:.+]] = linalg.generic
+// CHECK-SAME:  ins(%[[BIAS]] : tensor<2xf32>)
+// CHECK: %[[CONV:.+]] = linalg.conv_2d_nhwc_hwcf
+// CHECK-SAME:  ins(%[[ARG0]], %[[FILTER]] : tensor<1x4x4x2xf32>, tensor<1x1x2x2xf32>)
+// CHECK-SAME:  outs(%[[INIT]] : tensor<1x4x4x2xf32>)
+// CHECK-NOT: linalg.generic
+// CHECK: return %[[CONV]]
+
+// -----
+
+#map = affine_map<(d0, d1) -> (d0, d1)>
+#map1 = affine_map<(d0, d1) -> (d1)>
+
+// Weights are not constant: nothing to fold.
+func.func @non_constant_weights(%arg0: tensor<4x2xf32>, %arg1: tensor<2x2xf32>) -> tensor<4x2xf32> {
+  %scale = arith.constant dense<[2.0, 0.5]> : tensor<2xf32>
+  %cst = arith.constant 0.0 : f32
+  %0 = tensor.empty() : tensor<4x2xf32>
+  %1 = linalg.fill ins(%cst : f32) outs(%0 : tensor<4x2xf32>) -> tensor<4x2xf32>
+  %2 = linalg.matmul ins(%arg0, %arg1 : tensor<4x2xf32>, tensor<2x2xf32>) outs(%1 : tensor<4x2xf32>) -> tensor<4x2xf32>
+  %3 = linalg.generic {indexing_maps = [#map, #map1, #map], iterator_types = ["parallel", "parallel"]} ins(%2, %scale : tensor<4x2xf32>, tensor<2xf32>) outs(%0 : tensor<4x2xf32>) {
+    ^bb0(%in: f32, %s: f32, %out: f32):
+      %4 = arith.mulf %in, %s : f32
+      linalg.yield %4 : f32
+  } -> tensor<4x2xf32>
+  return %3 : tensor<4x2xf32>
+}
+
+// CHECK-LABEL: func.func @non_constant_weights(
+// CHECK: linalg.matmul
+// CHECK: linalg.generic
+// CHECK: arith.mulf
+
+// -----
+
+#map = affine_map<(d0, d1) -> (d0, d1)>
+
+// The scale depends on the row, not on the output channel.
+func.func @not_per_channel(%arg0: tensor<4x2xf32>, %arg1: tensor<4x2xf32>) -> tensor<4x2xf32> {
+  %weights = arith.constant dense<[[1.0, 2.0], [3.0, 4.0]]> : tensor<2x2xf32>
+  %cst = arith.constant 0.0 : f32
+  %0 = tensor.empty() : tensor<4x2xf32>
+  %1 = linalg.fill ins(%cst : f32) outs(%0 : tensor<4x2xf32>) -> tensor<4x2xf32>
+  %2 = linalg.matmul ins(%arg0, %weights : tensor<4x2xf32>, tensor<2x2xf32>) outs(%1 : tensor<4x2xf32>) -> tensor<4x2xf32>
+  %3 = linalg.generic {indexing_maps = [#map, #map, #map], iterator_types = ["parallel", "parallel"]} ins(%2, %arg1 : tensor<4x2xf32>, tensor<4x2xf32>) outs(%0 : tensor<4x2xf32>) {
+    ^bb0(%in: f32, %s: f32, %out: f32):
+      %4 = arith.mulf %in, %s : f32
+      linalg.yield %4 : f32
+  } -> tensor<4x2xf32>
+  return %3 : tensor<4x2xf32>
+}
+
+// CHECK-LABEL: func.func @not_per_channel(
+// CHECK: linalg.matmul
+// CHECK: linalg.generic
+// CHECK: arith.mulf
+
+// -----
+
+#map = affine_map<(d0, d1) -> (d0, d1)>
+#map1 = affine_map<(d0, d1) -> (d1)>
+
+// A dynamic batch: the new init takes its size from the original one.
+func.func @matmul_scale_shift_dynamic_batch(%arg0: tensor<?x2xf32>) -> tensor<?x2xf32> {
+  %c0 = arith.constant 0 : index
+  %weights = arith.constant dense<[[1.0, 2.0], [3.0, 4.0]]> : tensor<2x2xf32>
+  %scale = arith.constant dense<[2.0, 0.5]> : tensor<2xf32>
+  %shift = arith.constant dense<[1.0, -1.0]> : tensor<2xf32>
+  %cst = arith.constant 0.0 : f32
+  %dim = tensor.dim %arg0, %c0 : tensor<?x2xf32>
+  %0 = tensor.empty(%dim) : tensor<?x2xf32>
+  %1 = linalg.fill ins(%cst : f32) outs(%0 : tensor<?x2xf32>) -> tensor<?x2xf32>
+  %2 = linalg.matmul ins(%arg0, %weights : tensor<?x2xf32>, tensor<2x2xf32>) outs(%1 : tensor<?x2xf32>) -> tensor<?x2xf32>
+  %3 = linalg.generic {indexing_maps = [#map, #map1, #map1, #map], iterator_types = ["parallel", "parallel"]} ins(%2, %scale, %shift : tensor<?x2xf32>, tensor<2xf32>, tensor<2xf32>) outs(%0 : tensor<?x2xf32>) {
+    ^bb0(%in: f32, %s: f32, %b: f32, %out: f32):
+      %4 = arith.mulf %in, %s : f32
+      %5 = arith.addf %4, %b : f32
+      linalg.yield %5 : f32
+  } -> tensor<?x2xf32>
+  return %3 : tensor<?x2xf32>
+}
+
+// CHECK-LABEL: func.func @matmul_scale_shift_dynamic_batch(
+// CHECK-SAME:  %[[ARG0:.+]]: tensor<?x2xf32>)
+// CHECK-DAG: %[[C0:.+]] = arith.constant 0 : index
+// CHECK-DAG: %[[BIAS:.+]] = arith.constant dense<[1.000000e+00, -1.000000e+00]> : tensor<2xf32>
+// CHECK: %[[DIM:.+]] = tensor.dim %[[ARG0]], %[[C0]] : tensor<?x2xf32>
+// CHECK: %[[EMPTY:.+]] = tensor.empty(%[[DIM]]) : tensor<?x2xf32>
+// CHECK: %[[INIT:.+]] = linalg.generic
+// CHECK-SAME:  ins(%[[BIAS]] : tensor<2xf32>) outs(%[[EMPTY]] : tensor<?x2xf32>)
+// CHECK: %[[MM:.+]] = linalg.matmul
+// CHECK-SAME:  outs(%[[INIT]] : tensor<?x2xf32>)
+// CHECK: return %[[MM]]
@@ -166,3 +166,31 @@ func.func @batch_matmul_invalid_tiles(%arg0: tensor<5x5x5xf32>, %arg1: tensor<5x
                            outs(%0 : tensor<5x5x5xf32>) -> tensor<5x5x5xf32>
   return %1 : tensor<5x5x5xf32>
 }
+
+// -----
+
+// Dynamic rows are blocked with static blocks, the number of blocks is
+// computed at runtime and the last block is padded.
+func.func @block_linalg_matmul_dynamic_rows(
+  %arg0: tensor<?x64xf32>, %arg1: tensor<64x64xf32>, %arg2: tensor<?x64xf32>)
+    -> tensor<?x64xf32> {
+  %0 = linalg.matmul  ins(%arg0, %arg1: tensor<?x64xf32>, tensor<64x64xf32>)
+                     outs(%arg2: tensor<?x64xf32>)
+    -> tensor<?x64xf32>
+  return %0 : tensor<?x64xf32>
+}
+
+// CHECK-LABEL: func @block_linalg_matmul_dynamic_rows(
+// CHECK-SAME:    %[[ARG0:[0-9a-z]+]]: tensor<?x64xf32>
+// CHECK-SAME:    %[[ARG1:[0-9a-z]+]]: tensor<64x64xf32>
+// CHECK-SAME:    %[[ARG2:[0-9a-z]+]]: tensor<?x64xf32>) -> tensor<?x64xf32> {
+// CHECK: %[[BUF0:.+]] = tensor.empty(%{{.+}}) : tensor<?x2x32x32xf32>
+// CHECK: %[[PAD0:.+]] = arith.constant 0.000000e+00 : f32
+// CHECK: %[[PACK0:.+]] = tensor.pack %[[ARG0]] padding_value(%[[PAD0]] : f32) inner_dims_pos = [0, 1] inner_tiles = [32, 32] into %[[BUF0]] : tensor<?x64xf32> -> tensor<?x2x32x32xf32>
+// CHECK: %[[BUF1:.*]] = tensor.empty() : tensor<2x2x32x32xf32>
+// CHECK: %[[PACK1:.+]] = tensor.pack %[[ARG1]] outer_dims_perm = [1, 0] inner_dims_pos = [0, 1] inner_tiles = [32, 32] into %[[BUF1]] : tensor<64x64xf32> -> tensor<2x2x32x32xf32>
+// CHECK: %[[BUF2:.+]] = tensor.empty(%{{.+}}) : tensor<?x2x32x32xf32>
+// CHECK: %[[PACK2:.+]] = tensor.pack %[[ARG2]] padding_value(%{{.+}} : f32) inner_dims_pos = [0, 1] inner_tiles = [32, 32] into %[[BUF2]] : tensor<?x64xf32> -> tensor<?x2x32x32xf32>
+// CHECK: %[[VAL:.+]] = linalg.generic {{.+}} ins(%[[PACK0]], %[[PACK1]] : tensor<?x2x32x32xf32>, tensor<2x2x32x32xf32>) outs(%[[PACK2]] : tensor<?x2x32x32xf32>)
+// CHECK: %[[OUT:.+]] = tensor.unpack %[[VAL]] inner_dims_pos = [0, 1] inner_tiles = [32, 32] into %[[ARG2]] : tensor<?x2x32x32xf32> -> tensor<?x64xf32>
+// CHECK: return %[[OUT]] : tensor<?x64xf32>
@@ -0,0 +1,67 @@
+// RUN: tpp-opt %s -pack-matmul="block-factors=32,32,32" -split-input-file | FileCheck %s
+// RUN: tpp-opt %s -pack-matmul="block-factors=32,32,32 peel-remainders=false" -split-input-file | FileCheck %s -check-prefix=NOPEEL
+
+// The 96x64x32 part with full blocks is packed, the remainders on k, j and i
+// are smaller matmuls.
+func.func @matmul_remainders(%arg0: tensor<100x40xf32>, %arg1: tensor<40x72xf32>,
+                             %arg2: tensor<100x72xf32>) -> tensor<100x72xf32> {
+  %0 = linalg.matmul ins(%arg0, %arg1: tensor<100x40xf32>, tensor<40x72xf32>)
+                     outs(%arg2: tensor<100x72xf32>) -> tensor<100x72xf32>
+  return %0 : tensor<100x72xf32>
+}
+
+// CHECK-LABEL: func.func @matmul_remainders(
+// CHECK-SAME:  %[[ARG0:[0-9a-z]+]]: tensor<100x40xf32>,
+// CHECK-SAME:  %[[ARG1:[0-9a-z]+]]: tensor<40x72xf32>,
+// CHECK-SAME:  %[[ARG2:[0-9a-z]+]]: tensor<100x72xf32>)
+// CHECK: %[[MAIN_C:.+]] = tensor.extract_slice %[[ARG2]][0, 0] [96, 64] [1, 1]
+// CHECK: %[[MAIN_A:.+]] = tensor.extract_slice %[[ARG0]][0, 0] [96, 32] [1, 1]
+// CHECK: %[[MAIN_B:.+]] = tensor.extract_slice %[[ARG1]][0, 0] [32, 64] [1, 1]
+// CHECK: tensor.pack %[[MAIN_A]] {{.+}} : tensor<96x32xf32> -> tensor<3x1x32x32xf32>
+// CHECK: tensor.pack %[[MAIN_B]] {{.+}} : tensor<32x64xf32> -> tensor<2x1x32x32xf32>
+// CHECK: tensor.pack %[[MAIN_C]] {{.+}} : tensor<96x64xf32> -> tensor<3x2x32x32xf32>
+// CHECK: %[[GEN:.+]] = linalg.generic
+// CHECK: %[[MAIN:.+]] = tensor.unpack %[[GEN]] {{.+}} into %[[MAIN_C]]
+// CHECK: %[[REM_K_A:.+]] = tensor.extract_slice %[[ARG0]][0, 32] [96, 8] [1, 1]
+// CHECK: %[[REM_K_B:.+]] = tensor.extract_slice %[[ARG1]][32, 0] [8, 64] [1, 1]
+// CHECK: %[[REM_K:.+]] = linalg.matmul {tpp.tile_sizes = array<i64: 32, 32>}
+// CHECK-SAME:  ins(%[[REM_K_A]], %[[REM_K_B]] : tensor<96x8xf32>, tensor<8x64xf32>)
+// CHECK-SAME:  outs(%[[MAIN]] : tensor<96x64xf32>)
+// CHECK: %[[INS_MAIN:.+]] = tensor.insert_slice %[[REM_K]] into %[[ARG2]][0, 0] [96, 64] [1, 1]
+// CHECK: %[[REM_J_A:.+]] = tensor.extract_slice %[[ARG0]][0, 0] [96, 40] [1, 1]
+// CHECK: %[[REM_J_B:.+]] = tensor.extract_slice %[[ARG1]][0, 64] [40, 8] [1, 1]
+// CHECK: %[[REM_J_C:.+]] = tensor.extract_slice %[[ARG2]][0, 64] [96, 8] [1, 1]
+// CHECK: %[[REM_J:.+]] = linalg.matmul {tpp.tile_sizes = array<i64: 32, 0>}
+// CHECK-SAME:  ins(%[[REM_J_A]], %[[REM_J_B]] : tensor<96x40xf32>, tensor<40x8xf32>)
+// CHECK-SAME:  outs(%[[REM_J_C]] : tensor<96x8xf32>)
+// CHECK: %[[INS_J:.+]] = tensor.insert_slice %[[REM_J]] into %[[INS_MAIN]][0, 64] [96, 8] [1, 1]
+// CHECK: %[[REM_I_A:.+]] = tensor.extract_slice %[[ARG0]][96, 0] [4, 40] [1, 1]
+// CHECK: %[[REM_I_C:.+]] = tensor.extract_slice %[[ARG2]][96, 0] [4, 72] [1, 1]
+// CHECK: %[[REM_I:.+]] = linalg.matmul
+// CHECK-SAME:  ins(%[[REM_I_A]], %[[ARG1]] : tensor<4x40xf32>, tensor<40x72xf32>)
+// CHECK-SAME:  outs(%[[REM_I_C]] : tensor<4x72xf32>)
+// CHECK: %[[INS_I:.+]] = tensor.insert_slice %[[REM_I]] into %[[INS_J]][96, 0] [4, 72] [1, 1]
+// CHECK: return %[[INS_I]]
+
+// NOPEEL-LABEL: func.func @matmul_remainders(
+// NOPEEL-NOT: tensor.pack
+// NOPEEL: linalg.matmul
+// NOPEEL-NOT: tensor.pack
+
+// -----
+
+// Only the rows need peeling; the remainder still has full tiles on j.
+func.func @matmul_row_remainder(%arg0: tensor<100x64xf32>, %arg1: tensor<64x64xf32>,
+                                %arg2: tensor<100x64xf32>) -> tensor<100x64xf32> {
+  %0 = linalg.matmul ins(%arg0, %arg1: tensor<100x64xf32>, tensor<64x64xf32>)
+                     outs(%arg2: tensor<100x64xf32>) -> tensor<100x64xf32>
+  return %0 : tensor<100x64xf32>
+}
+
+// CHECK-LABEL: func.func @matmul_row_remainder(
+// CHECK: tensor.pack {{.+}} : tensor<96x64xf32> -> tensor<3x2x32x32xf32>
+// CHECK: linalg.generic
+// CHECK: tensor.unpack
+// CHECK: %[[REM_I:.+]] = linalg.matmul {tpp.tile_sizes = array<i64: 0, 32>}
+// CHECK-SAME:  -> tensor<4x64xf32>
+// CHECK: tensor.insert_slice %[[REM_I]] into %{{.+}}[96, 0] [4, 64] [1, 1]
@@ -87,3 +87,124 @@ func.func @batch_matmul_rewrite(%arg0: tensor<?x?x?xf32>,
 // CHECK-SAME:  : tensor<?x?x?xf32> to tensor<?x?xf32>
 // CHECK: %{{.+}} = linalg.matmul ins(%[[SLICE]], %[[SLICE1]] : tensor<?x?xf32>, tensor<?x?xf32>) 
 // CHECK-SAME:  outs(%[[SLICE2]] : tensor<?x?xf32>) -> tensor<?x?xf32>
+
+// -----
+
+func.func @batch_matmul_tile_m(%arg0: tensor<16x128x64xf32>, %arg1: tensor<16x64x128xf32>,
+                               %arg2: tensor<16x128x128xf32>) -> tensor<16x128x128xf32> {
+  %0 = linalg.batch_matmul ins(%arg0, %arg1 : tensor<16x128x64xf32>, tensor<16x64x128xf32>)
+                           outs(%arg2 : tensor<16x128x128xf32>) -> tensor<16x128x128xf32>
+  return %0 : tensor<16x128x128xf32>
+}
+
+// CHECK-LABEL: batch_matmul_tile_m
+// CHECK-SAME: %[[ARG0:.+]]: tensor<16x128x64xf32>, %[[ARG1:.+]]: tensor<16x64x128xf32>, %[[ARG2:.+]]: tensor<16x128x128xf32>
+// CHECK-DAG: %[[C0:.+]] = arith.constant 0 : index
+// CHECK-DAG: %[[C1:.+]] = arith.constant 1 : index
+// CHECK-DAG: %[[C16:.+]] = arith.constant 16 : index
+// CHECK-DAG: %[[C32:.+]] = arith.constant 32 : index
+// CHECK-DAG: %[[C128:.+]] = arith.constant 128 : index
+// CHECK: %{{.+}} = scf.forall (%[[B:.+]], %[[I:.+]]) = (%[[C0]], %[[C0]]) to (%[[C16]], %[[C128]]) step (%[[C1]], %[[C32]])
+// CHECK-SAME:  shared_outs(%[[OUT:.+]] = %[[ARG2]]) -> (tensor<16x128x128xf32>) {
+// CHECK: %[[SLICE:.+]] = tensor.extract_slice %[[ARG0]][%[[B]], %[[I]], 0] [1, 32, 64] [1, 1, 1]
+// CHECK-SAME:  : tensor<16x128x64xf32> to tensor<32x64xf32>
+// CHECK: %[[SLICE1:.+]] = tensor.extract_slice %[[ARG1]][%[[B]], 0, 0] [1, 64, 128] [1, 1, 1]
+// CHECK-SAME:  : tensor<16x64x128xf32> to tensor<64x128xf32>
+// CHECK: %[[SLICE2:.+]] = tensor.extract_slice %[[OUT]][%[[B]], %[[I]], 0] [1, 32, 128] [1, 1, 1]
+// CHECK-SAME:  : tensor<16x128x128xf32> to tensor<32x128xf32>
+// CHECK: %{{.+}} = linalg.matmul ins(%[[SLICE]], %[[SLICE1]] : tensor<32x64xf32>, tensor<64x128xf32>)
+// CHECK-SAME:  outs(%[[SLICE2]] : tensor<32x128xf32>) -> tensor<32x128xf32>
+
+// -----
+
+// B is shared by all the heads: pack them along M into a single matmul.
+func.func @batch_matmul_broadcast_b(%arg0: tensor<4x64x32xf32>, %arg1: tensor<32x64xf32>,
+                                    %arg2: tensor<4x64x64xf32>) -> tensor<4x64x64xf32> {
+  %0 = tensor.empty() : tensor<4x32x64xf32>
+  %1 = linalg.broadcast ins(%arg1 : tensor<32x64xf32>)
+                        outs(%0 : tensor<4x32x64xf32>) dimensions = [0]
+  %2 = linalg.batch_matmul ins(%arg0, %1 : tensor<4x64x32xf32>, tensor<4x32x64xf32>)
+                           outs(%arg2 : tensor<4x64x64xf32>) -> tensor<4x64x64xf32>
+  return %2 : tensor<4x64x64xf32>
+}
+
+// CHECK-LABEL: batch_matmul_broadcast_b
+// CHECK-SAME: %[[ARG0:.+]]: tensor<4x64x32xf32>, %[[ARG1:.+]]: tensor<32x64xf32>, %[[ARG2:.+]]: tensor<4x64x64xf32>
+// CHECK-DAG: %[[C0:.+]] = arith.constant 0 : index
+// CHECK-DAG: %[[C32:.+]] = arith.constant 32 : index
+// CHECK-DAG: %[[C256:.+]] = arith.constant 256 : index
+// CHECK-NOT: linalg.broadcast
+// CHECK: %[[LHS:.+]] = tensor.collapse_shape %[[ARG0]] {{\[}}[0, 1], [2]] : tensor<4x64x32xf32> into tensor<256x32xf32>
+// CHECK: %[[INIT:.+]] = tensor.collapse_shape %[[ARG2]] {{\[}}[0, 1], [2]] : tensor<4x64x64xf32> into tensor<256x64xf32>
+// CHECK: %[[LOOP:.+]] = scf.forall (%[[I:.+]]) = (%[[C0]]) to (%[[C256]]) step (%[[C32]])
+// CHECK-SAME:  shared_outs(%[[OUT:.+]] = %[[INIT]]) -> (tensor<256x64xf32>) {
+// CHECK: %[[SLICE:.+]] = tensor.extract_slice %[[LHS]][%[[I]], 0] [32, 32] [1, 1]
+// CHECK-SAME:  : tensor<256x32xf32> to tensor<32x32xf32>
+// CHECK: %[[SLICE1:.+]] = tensor.extract_slice %[[OUT]][%[[I]], 0] [32, 64] [1, 1]
+// CHECK-SAME:  : tensor<256x64xf32> to tensor<32x64xf32>
+// CHECK: %{{.+}} = linalg.matmul ins(%[[SLICE]], %[[ARG1]] : tensor<32x32xf32>, tensor<32x64xf32>)
+// CHECK-SAME:  outs(%[[SLICE1]] : tensor<32x64xf32>) -> tensor<32x64xf32>
+// CHECK: tensor.expand_shape %[[LOOP]] {{\[}}[0, 1], [2]] : tensor<256x64xf32> into tensor<4x64x64xf32>
+
+// -----
+
+// The packed M (3 * 10) has no full tile: do not pack the heads, run the
+// batches in parallel instead.
+func.func @batch_matmul_broadcast_b_no_full_tile(%arg0: tensor<3x10x32xf32>, %arg1: tensor<32x64xf32>,
+                                                 %arg2: tensor<3x10x64xf32>) -> tensor<3x10x64xf32> {
+  %0 = tensor.empty() : tensor<3x32x64xf32>
+  %1 = linalg.broadcast ins(%arg1 : tensor<32x64xf32>)
+                        outs(%0 : tensor<3x32x64xf32>) dimensions = [0]
+  %2 = linalg.batch_matmul ins(%arg0, %1 : tensor<3x10x32xf32>, tensor<3x32x64xf32>)
+                           outs(%arg2 : tensor<3x10x64xf32>) -> tensor<3x10x64xf32>
+  return %2 : tensor<3x10x64xf32>
+}
+
+// CHECK-LABEL: batch_matmul_broadcast_b_no_full_tile
+// CHECK-SAME: %[[ARG0:.+]]: tensor<3x10x32xf32>, %[[ARG1:.+]]: tensor<32x64xf32>, %[[ARG2:.+]]: tensor<3x10x64xf32>
+// CHECK-DAG: %[[C0:.+]] = arith.constant 0 : index
+// CHECK-DAG: %[[C1:.+]] = arith.constant 1 : index
+// CHECK-DAG: %[[C3:.+]] = arith.constant 3 : index
+// CHECK-NOT: tensor.collapse_shape
+// CHECK: %{{.+}} = scf.forall (%[[B:.+]]) = (%[[C0]]) to (%[[C3]]) step (%[[C1]])
+// CHECK-SAME:  shared_outs(%[[OUT:.+]] = %[[ARG2]]) -> (tensor<3x10x64xf32>) {
+// CHECK: %[[SLICE:.+]] = tensor.extract_slice %[[ARG0]][%[[B]], 0, 0] [1, 10, 32] [1, 1, 1]
+// CHECK-SAME:  : tensor<3x10x32xf32> to tensor<10x32xf32>
+// CHECK: %[[SLICE1:.+]] = tensor.extract_slice %[[OUT]][%[[B]], 0, 0] [1, 10, 64] [1, 1, 1]
+// CHECK-SAME:  : tensor<3x10x64xf32> to tensor<10x64xf32>
+// CHECK: %{{.+}} = linalg.matmul ins(%[[SLICE]], %[[ARG1]] : tensor<10x32xf32>, tensor<32x64xf32>)
+// CHECK-SAME:  outs(%[[SLICE1]] : tensor<10x64xf32>) -> tensor<10x64xf32>
+
+// -----
+
+#map = affine_map<(d0, d1, d2, d3) -> (d1, d3)>
+#map1 = affine_map<(d0, d1, d2, d3) -> (d0, d3, d2)>
+#map2 = affine_map<(d0, d1, d2, d3) -> (d0, d1, d2)>
+
+// A is shared by all the batches: each tile of A is read by every batch.
+func.func @batch_matmul_broadcast_a(%arg0: tensor<64x32xf32>, %arg1: tensor<8x32x64xf32>,
+                                    %arg2: tensor<8x64x64xf32>) -> tensor<8x64x64xf32> {
+  %0 = linalg.generic {
+    indexing_maps = [#map, #map1, #map2],
+    iterator_types = ["parallel", "parallel", "parallel", "reduction"]}
+    ins(%arg0, %arg1 : tensor<64x32xf32>, tensor<8x32x64xf32>) outs(%arg2 : tensor<8x64x64xf32>) {
+    ^bb0(%in: f32, %in_1: f32, %out: f32):
+      %1 = arith.mulf %in, %in_1 : f32
+      %2 = arith.addf %out, %1 : f32
+      linalg.yield %2 : f32
+  } -> tensor<8x64x64xf32>
+  return %0 : tensor<8x64x64xf32>
+}
+
+// CHECK-LABEL: batch_matmul_broadcast_a
+// CHECK-SAME: %[[ARG0:.+]]: tensor<64x32xf32>, %[[ARG1:.+]]: tensor<8x32x64xf32>, %[[ARG2:.+]]: tensor<8x64x64xf32>
+// CHECK: %{{.+}} = scf.forall (%[[B:.+]], %[[I:.+]]) = ({{.+}}) to ({{.+}}) step ({{.+}})
+// CHECK-SAME:  shared_outs(%[[OUT:.+]] = %[[ARG2]]) -> (tensor<8x64x64xf32>) {
+// CHECK: %[[SLICE:.+]] = tensor.extract_slice %[[ARG0]][%[[I]], 0] [32, 32] [1, 1]
+// CHECK-SAME:  : tensor<64x32xf32> to tensor<32x32xf32>
+// CHECK: %[[SLICE1:.+]] = tensor.extract_slice %[[ARG1]][%[[B]], 0, 0] [1, 32, 64] [1, 1, 1]
+// CHECK-SAME:  : tensor<8x32x64xf32> to tensor<32x64xf32>
+// CHECK: %[[SLICE2:.+]] = tensor.extract_slice %[[OUT]][%[[B]], %[[I]], 0] [1, 32, 64] [1, 1, 1]
+// CHECK-SAME:  : tensor<8x64x64xf32> to tensor<32x64xf32>
+// CHECK: %{{.+}} = linalg.matmul ins(%[[SLICE]], %[[SLICE1]] : tensor<32x32xf32>, tensor<32x64xf32>)
+// CHECK-SAME:  outs(%[[SLICE2]] : tensor<32x64xf32>) -> tensor<32x64xf32>
@@ -0,0 +1,99 @@
+// RUN: tpp-opt %s -tile-consumer-and-fuse-producers="use-for-all=false thread-aware=true num-threads=56" -cse -split-input-file -verify-diagnostics | FileCheck %s
+
+#map = affine_map<(d0, d1) -> (d0, d1)>
+
+// 32x32 tiles give 96 work items, i.e. two waves with 16 idle threads. 16x16
+// tiles give 384 work items in 7 waves of 56.
+func.func @matmul_eletwise(%arg0: tensor<128x64xf32>, %arg1: tensor<64x768xf32>,
+    %arg2: tensor<128x768xf32>) -> tensor<128x768xf32> {
+  %c0 = arith.constant 0.0 : f32
+  // expected-remark @below {{tile sizes [16, 16]: 384 work items on 56 threads, predicted load imbalance 2.0%}}
+  %0 = linalg.matmul ins(%arg0, %arg1 : tensor<128x64xf32>, tensor<64x768xf32>)
+    outs(%arg2 : tensor<128x768xf32>) -> tensor<128x768xf32>
+  %1 = linalg.generic {indexing_maps = [#map],
+                       iterator_types = ["parallel", "parallel"]}
+    outs(%0: tensor<128x768xf32>) {
+      ^bb0(%out: f32):
+        %2 = arith.maxf %out, %c0 : f32
+        linalg.yield %2 : f32
+    } -> tensor<128x768xf32>
+  return %1 : tensor<128x768xf32>
+}
+
+// CHECK-LABEL: func.func @matmul_eletwise(
+// CHECK-DAG: %[[C0:.+]] = arith.constant 0 : index
+// CHECK-DAG: %[[C16:.+]] = arith.constant 16 : index
+// CHECK-DAG: %[[C128:.+]] = arith.constant 128 : index
+// CHECK-DAG: %[[C768:.+]] = arith.constant 768 : index
+// CHECK: scf.for %{{.+}} = %[[C0]] to %[[C128]] step %[[C16]]
+// CHECK-NEXT: scf.for %{{.+}} = %[[C0]] to %[[C768]] step %[[C16]]
+// CHECK: linalg.matmul ins(%{{.+}}, %{{.+}} : tensor<16x64xf32>, tensor<64x16xf32>)
+// CHECK-SAME:  outs(%{{.+}} : tensor<16x16xf32>)
+// CHECK: linalg.generic
+// CHECK-SAME:  outs(%{{.+}} : tensor<16x16xf32>)
+
+// -----
+
+#map0 = affine_map<(d0, d1, d2, d3, d4, d5) -> (d0, d2, d3, d5)>
+#map1 = affine_map<(d0, d1, d2, d3, d4, d5) -> (d1, d2, d5, d4)>
+#map2 = affine_map<(d0, d1, d2, d3, d4, d5) -> (d0, d1, d3, d4)>
+#map = affine_map<(d0, d1, d2, d3) -> (d0, d1, d2, d3)>
+
+// Packed ops cannot be split below one block: coarser tiles never improve the
+// balance, keep one block per work item and report the imbalance.
+func.func @blocked_matmul(%arg0: tensor<4x2x32x32xf32>, %arg1: tensor<24x2x32x32xf32>,
+                          %arg2: tensor<4x24x32x32xf32>) -> tensor<4x24x32x32xf32> {
+  // expected-remark @below {{tile sizes [1, 1]: 96 work items on 56 threads, predicted load imbalance 14.3%}}
+  %0 = linalg.generic {
+    indexing_maps = [#map0, #map1, #map2],
+    iterator_types = ["parallel", "parallel", "reduction", "parallel", "parallel", "reduction"]}
+    ins(%arg0, %arg1 : tensor<4x2x32x32xf32>, tensor<24x2x32x32xf32>)
+    outs(%arg2 : tensor<4x24x32x32xf32>) {
+    ^bb0(%arg3: f32, %arg4: f32, %arg5: f32):
+      %1 = arith.mulf %arg3, %arg4 : f32
+      %2 = arith.addf %arg5, %1 : f32
+      linalg.yield %2 : f32
+  } -> tensor<4x24x32x32xf32>
+  %c0 = arith.constant 0.0 : f32
+  %3 = linalg.generic {indexing_maps = [#map],
+                       iterator_types = ["parallel", "parallel", "parallel", "parallel"]}
+    outs(%0: tensor<4x24x32x32xf32>) {
+      ^bb0(%out: f32):
+        %4 = arith.maxf %out, %c0 : f32
+        linalg.yield %4 : f32
+  } -> tensor<4x24x32x32xf32>
+  return %3 : tensor<4x24x32x32xf32>
+}
+
+// CHECK-LABEL: func.func @blocked_matmul(
+// CHECK-DAG: %[[C0:.+]] = arith.constant 0 : index
+// CHECK-DAG: %[[C1:.+]] = arith.constant 1 : index
+// CHECK-DAG: %[[C4:.+]] = arith.constant 4 : index
+// CHECK-DAG: %[[C24:.+]] = arith.constant 24 : index
+// CHECK: scf.for %{{.+}} = %[[C0]] to %[[C4]] step %[[C1]]
+// CHECK-NEXT: scf.for %{{.+}} = %[[C0]] to %[[C24]] step %[[C1]]
+
+// -----
+
+#map = affine_map<(d0, d1) -> (d0, d1)>
+
+// Tile sizes attached to the op take precedence: no selection, no remark.
+func.func @matmul_override(%arg0: tensor<128x64xf32>, %arg1: tensor<64x768xf32>,
+    %arg2: tensor<128x768xf32>) -> tensor<128x768xf32> {
+  %c0 = arith.constant 0.0 : f32
+  %0 = linalg.matmul {tpp.tile_sizes = array<i64: 64, 128>}
+    ins(%arg0, %arg1 : tensor<128x64xf32>, tensor<64x768xf32>)
+    outs(%arg2 : tensor<128x768xf32>) -> tensor<128x768xf32>
+  %1 = linalg.generic {indexing_maps = [#map],
+                       iterator_types = ["parallel", "parallel"]}
+    outs(%0: tensor<128x768xf32>) {
+      ^bb0(%out: f32):
+        %2 = arith.maxf %out, %c0 : f32
+        linalg.yield %2 : f32
+    } -> tensor<128x768xf32>
+  return %1 : tensor<128x768xf32>
+}
+
+// CHECK-LABEL: func.func @matmul_override(
+// CHECK: linalg.matmul ins(%{{.+}}, %{{.+}} : tensor<64x64xf32>, tensor<64x128xf32>)
+// CHECK-SAME:  outs(%{{.+}} : tensor<64x128xf32>)
@@ -0,0 +1,83 @@
+// RUN: tpp-opt %s -xsmm-combine-dispatch | FileCheck %s
+// RUN: tpp-opt %s -xsmm-combine-dispatch -mlir-pass-statistics \
+// RUN:   -mlir-pass-statistics-display=list -o /dev/null 2>&1 | FileCheck %s -check-prefix=STATS
+
+// CHECK-LABEL: func.func @combine_in_parallel
+// CHECK-SAME: %[[ARG0:.+]]: memref<4x3x4xf32>, %[[ARG1:.+]]: memref<4x4x3xf32>, %[[ARG2:.+]]: memref<3x3xf32>
+func.func @combine_in_parallel(%arg0: memref<4x3x4xf32>, %arg1: memref<4x4x3xf32>,
+                               %arg2: memref<3x3xf32>) {
+  // CHECK: %[[BRGEMM:.+]] = xsmm.brgemm.dispatch [3, 3, 4, 4, 3, 3] flags = (none) data_type = f32
+  // CHECK-NEXT: %[[RELU:.+]] = xsmm.unary.dispatch relu [3, 3, 3, 3] flags = (none) data_type = f32
+  // CHECK-NEXT: scf.parallel
+  // CHECK-NOT: xsmm.brgemm.dispatch
+  // CHECK-NOT: xsmm.unary.dispatch
+  // CHECK:   xsmm.brgemm(data_type = f32, %[[BRGEMM]]
+  // CHECK:   xsmm.unary relu(data_type = f32, %[[RELU]]
+  // CHECK: scf.for
+  // CHECK:   xsmm.brgemm(data_type = f32, %[[BRGEMM]]
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c4 = arith.constant 4 : index
+  %c4_i64 = arith.constant 4 : i64
+  scf.parallel (%i) = (%c0) to (%c4) step (%c1) {
+    %0 = xsmm.brgemm.dispatch [3, 3, 4, 4, 3, 3] flags = (none) data_type = f32
+    xsmm.brgemm(data_type = f32, %0, %arg0, %arg1, %arg2, %c4_i64)
+      : (i64, memref<4x3x4xf32>, memref<4x4x3xf32>, memref<3x3xf32>, i64) -> ()
+    %1 = xsmm.unary.dispatch relu [3, 3, 3, 3] flags = (none) data_type = f32
+    xsmm.unary relu(data_type = f32, %1, %arg2, %arg2)
+      : (i64, memref<3x3xf32>, memref<3x3xf32>) -> ()
+    scf.yield
+  }
+  scf.for %j = %c0 to %c4 step %c1 {
+    %2 = xsmm.brgemm.dispatch [3, 3, 4, 4, 3, 3] flags = (none) data_type = f32
+    xsmm.brgemm(data_type = f32, %2, %arg0, %arg1, %arg2, %c4_i64)
+      : (i64, memref<4x3x4xf32>, memref<4x4x3xf32>, memref<3x3xf32>, i64) -> ()
+  }
+  return
+}
+
+// CHECK-LABEL: func.func @keep_distinct
+func.func @keep_distinct() -> (i64, i64, i64) {
+  // CHECK-NEXT: %[[A:.+]] = xsmm.gemm.dispatch [3, 3, 4, 4, 3, 3] flags = (none) data_type = f32
+  // CHECK-NEXT: %[[B:.+]] = xsmm.gemm.dispatch [3, 3, 4, 4, 3, 3] flags = (beta_0) data_type = f32
+  // CHECK-NEXT: %[[C:.+]] = xsmm.brgemm.dispatch [3, 3, 4, 4, 3, 3] flags = (none) data_type = f32
+  // CHECK-NEXT: return %[[A]], %[[B]], %[[C]]
+  %0 = xsmm.gemm.dispatch [3, 3, 4, 4, 3, 3] flags = (none) data_type = f32
+  %1 = xsmm.gemm.dispatch [3, 3, 4, 4, 3, 3] flags = (beta_0) data_type = f32
+  %2 = xsmm.brgemm.dispatch [3, 3, 4, 4, 3, 3] flags = (none) data_type = f32
+  return %0, %1, %2 : i64, i64, i64
+}
+
+// Dispatches under a conditional region are not hoisted, even when nested in
+// a loop inside it, and do not become the dispatch the others reuse.
+// CHECK-LABEL: func.func @keep_conditional
+// CHECK-SAME: %[[COND:.+]]: i1, %[[ARG0:.+]]: memref<3x3xf32>
+func.func @keep_conditional(%cond: i1, %arg0: memref<3x3xf32>) {
+  // CHECK-NOT: xsmm.unary.dispatch
+  // CHECK: scf.if %[[COND]] {
+  // CHECK-NEXT: %[[RELU:.+]] = xsmm.unary.dispatch relu [3, 3, 3, 3] flags = (none) data_type = f32
+  // CHECK-NEXT: xsmm.unary relu(data_type = f32, %[[RELU]]
+  // CHECK: scf.for
+  // CHECK-NEXT: %[[RELU1:.+]] = xsmm.unary.dispatch relu [3, 3, 3, 3] flags = (none) data_type = f32
+  // CHECK-NEXT: xsmm.unary relu(data_type = f32, %[[RELU1]]
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c4 = arith.constant 4 : index
+  scf.if %cond {
+    %0 = xsmm.unary.dispatch relu [3, 3, 3, 3] flags = (none) data_type = f32
+    xsmm.unary relu(data_type = f32, %0, %arg0, %arg0)
+      : (i64, memref<3x3xf32>, memref<3x3xf32>) -> ()
+    scf.for %i = %c0 to %c4 step %c1 {
+      %1 = xsmm.unary.dispatch relu [3, 3, 3, 3] flags = (none) data_type = f32
+      xsmm.unary relu(data_type = f32, %1, %arg0, %arg0)
+        : (i64, memref<3x3xf32>, memref<3x3xf32>) -> ()
+    }
+  }
+  return
+}
+
+// Kernels shared between functions are counted once.
+// STATS: CombineXsmmDispatch
+// STATS-DAG: (S) 1 num-combined-dispatches
+// STATS-DAG: (S) 2 num-hoisted-dispatches
+// STATS-DAG: (S) 4 num-distinct-kernels
@@ -70,7 +70,8 @@ SmallVector<int64_t> getMatMulResultShape(ShapedType lhs, ShapedType rhs) {
 MLIRGenerator::MLIRGenerator(StringRef kernelStr, unsigned miniBatch,
                              StringRef layersStr, StringRef tilesStr,
                              unsigned typeWidth, int seed, bool enableSoftmax,
-                             bool biasAcc, int vnniBlockingFactor)
+                             bool biasAcc, int vnniBlockingFactor,
+                             unsigned quantWidth)
     : builder(&context), loc(builder.getUnknownLoc()), miniBatch(miniBatch),
       seed(seed), enableSoftmax(enableSoftmax), biasAcc(biasAcc),
       vnniFactor(vnniBlockingFactor) {
@@ -116,6 +117,21 @@ MLIRGenerator::MLIRGenerator(StringRef kernelStr, unsigned miniBatch,
     return;
   }
 
+  // Pick quantized type, dequantized back to the data type
+  switch (quantWidth) {
+  case 0:
+    break;
+  case 8:
+    quantType = builder.getI8Type();
+    accType = builder.getI32Type();
+    break;
+  default:
+    assert(false && "Unsupported quantization width");
+    return;
+  }
+  assert((!quantType || tiles.empty()) &&
+         "Packed quantized types not implemented yet");
+
   // Disable VNNI packing if it is not BF16 data type
   if (!dataType.isBF16())
     vnniFactor = 0;
@@ -156,6 +172,20 @@ Value MLIRGenerator::createLayer(unsigned index, Value arg) {
 
   // Add matmul/bias/relu as it comes from tensorflow
   auto weight = createDenseTensor(builder, initType, weightType, getRand());
+
+  if (quantType) {
+    // Dequantize with per-column scale and bias, fused with the ReLU, and
+    // quantize again for the next layer
+    auto columnType = RankedTensorType::get({output}, dataType);
+    auto scale = createDenseTensor(builder, initType, columnType, getRand());
+    auto bias = createDenseTensor(builder, initType, columnType, getRand());
+    auto matmul =
+        lowerMatmul({arg, weight, /*bias=*/nullptr, /*output=*/nullptr});
+    auto relu =
+        lowerDequantize(matmul, scale, bias, /*relu=*/true, /*output=*/nullptr);
+    return lowerQuantize(relu);
+  }
+
   auto bias = createDenseTensor(builder, initType, outputType, getRand());
   auto matmul = lowerMatmul({arg, weight, bias, /*output=*/nullptr});
   auto relu = lowerRelu(matmul);
@@ -178,6 +208,21 @@ Value MLIRGenerator::createOutputLayer(Value arg, Value out) {
   auto weightType = getShape({input, output}, PACK_WEIGHT);
   auto weight = createDenseTensor(builder, initType, weightType, getRand());
 
+  if (quantType) {
+    // Dequantize the accumulator, with softmax or onto out
+    auto columnType = RankedTensorType::get({output}, dataType);
+    auto scale = createDenseTensor(builder, initType, columnType, getRand());
+    auto bias = createDenseTensor(builder, initType, columnType, getRand());
+    auto matmul =
+        lowerMatmul({arg, weight, /*bias=*/nullptr, /*output=*/nullptr});
+    if (enableSoftmax) {
+      auto dequant = lowerDequantize(matmul, scale, bias, /*relu=*/false,
+                                     /*output=*/nullptr);
+      return lowerSoftmax(dequant, out);
+    }
+    return lowerDequantize(matmul, scale, bias, /*relu=*/false, out);
+  }
+
   if (enableSoftmax) {
     // Return the softmax of the last layer
     // Allocates a temporay for the matmul, write softmax on out
@@ -261,7 +306,10 @@ void MLIRGenerator::createMatmulKernel() {
   // Ignore all hidden layers - only a single matmul operation is needed
   auto inputType = getShape({miniBatch, layers.front()}, PACK_INPUT);
   auto weightType = getShape({layers.front(), layers.back()}, PACK_WEIGHT);
-  auto outputType = getShape({miniBatch, layers.back()}, PACK_OUTPUT);
+  TensorType outputType = getShape({miniBatch, layers.back()}, PACK_OUTPUT);
+  // Quantized matmuls return the accumulator
+  if (quantType)
+    outputType = RankedTensorType::get({miniBatch, layers.back()}, accType);
   auto func = createFunction(builder, module, "entry",
                              {inputType, weightType, outputType}, {outputType});
 
@@ -282,11 +330,26 @@ void MLIRGenerator::createFcKernel() {
   auto inputType = getShape({miniBatch, layers.front()}, PACK_INPUT);
   auto weightType = getShape({layers.front(), layers.back()}, PACK_WEIGHT);
   auto outputType = getShape({miniBatch, layers.back()}, PACK_OUTPUT);
-  auto biasType = outputType;
+  TensorType biasType = outputType;
+  // Quantized biases are per column, next to the scale
+  if (quantType)
+    biasType = RankedTensorType::get({layers.back()}, dataType);
   auto func = createFunction(builder, module, "entry",
                              {inputType, weightType, biasType, outputType},
                              {outputType});
 
+  if (quantType) {
+    // Create a quantized FC kernel that is: matmul + dequantize with relu
+    auto scale = createDenseTensor(builder, initType, biasType, getRand());
+    Value data = lowerMatmul({/*input=*/func.getArgument(0),
+                              /*weight=*/func.getArgument(1),
+                              /*bias=*/nullptr, /*output=*/nullptr});
+    data = lowerDequantize(data, scale, /*bias=*/func.getArgument(2),
+                           /*relu=*/true, /*output=*/func.getArgument(3));
+    builder.create<func::ReturnOp>(loc, data);
+    return;
+  }
+
   // Create a fully connected (FC) kernel that is: matmul + bias + relu
   Value data = lowerMatmul({/*input=*/func.getArgument(0),
                             /*weight=*/func.getArgument(1),
@@ -350,9 +413,13 @@ Value MLIRGenerator::lowerMatmul(MatMulArgs args) {
     auto inputShape = args.input.getType().cast<ShapedType>();
     auto weightShape = args.weight.getType().cast<ShapedType>();
     auto dims = getMatMulResultShape(inputShape, weightShape);
-    auto zero = getConstFloat(builder, 0.0, dataType.getIntOrFloatBitWidth());
+    // Quantized matmuls accumulate in the accumulation type
+    auto outputType = quantType ? accType : dataType;
+    auto zero = quantType ? getConstInt(builder, 0, 32)
+                          : getConstFloat(builder, 0.0,
+                                          dataType.getIntOrFloatBitWidth());
     args.output =
-        builder.create<tensor::EmptyOp>(loc, dims, dataType).getResult();
+        builder.create<tensor::EmptyOp>(loc, dims, outputType).getResult();
     args.output =
         builder.create<linalg::FillOp>(loc, zero, args.output).getResult(0);
   }
@@ -369,9 +436,22 @@ Value MLIRGenerator::lowerMatmul(MatMulArgs args) {
               getIterators(MAP_MATMUL),
               [&](OpBuilder &nestedBuilder, Location nestedLoc,
                   ValueRange blockArgs) {
-                auto arg0 = blockArgs[0];
-                auto arg1 = blockArgs[1];
-                auto arg2 = blockArgs[2];
+                Value arg0 = blockArgs[0];
+                Value arg1 = blockArgs[1];
+                Value arg2 = blockArgs[2];
+                if (quantType) {
+                  // Sign-extend the quantized inputs to the accumulator
+                  arg0 = nestedBuilder.create<arith::ExtSIOp>(loc, accType,
+                                                              arg0);
+                  arg1 = nestedBuilder.create<arith::ExtSIOp>(loc, accType,
+                                                              arg1);
+                  auto mul = nestedBuilder.create<arith::MulIOp>(loc, arg0,
+                                                                 arg1);
+                  auto add = nestedBuilder.create<arith::AddIOp>(loc, arg2,
+                                                                 mul);
+                  nestedBuilder.create<linalg::YieldOp>(loc, ValueRange{add});
+                  return;
+                }
                 auto mul = nestedBuilder.create<arith::MulFOp>(loc, arg0, arg1);
                 auto add = nestedBuilder.create<arith::AddFOp>(loc, arg2, mul);
                 nestedBuilder.create<linalg::YieldOp>(loc, ValueRange{add});
@@ -474,10 +554,67 @@ Value MLIRGenerator::lowerSoftmax(Value input, Value output) {
   return softmax.getResult(0);
 }
 
+Value MLIRGenerator::lowerDequantize(Value acc, Value scale, Value bias,
+                                     bool relu, Value output) {
+  auto accTy = acc.getType().cast<ShapedType>();
+  assert(accTy.getRank() == 2 && "Packed dequantization not implemented yet");
+  auto outTy = RankedTensorType::get(accTy.getShape(), dataType);
+  if (!output)
+    output = builder.create<tensor::EmptyOp>(loc, outTy, ValueRange{});
+
+  // out = relu(sitofp(acc) * scale + bias), scale and bias are per column
+  auto map = getMap(acc, MAP_PARALLEL);
+  auto columnMap = AffineMap::get(2, 0, {affineExprs[1]}, &context);
+  auto zero = getConstFloat(builder, 0.0, dataType.getIntOrFloatBitWidth());
+  auto dequant = builder.create<linalg::GenericOp>(
+      loc, outTy, ValueRange{acc, scale, bias}, ValueRange{output},
+      ArrayRef<AffineMap>{map, columnMap, columnMap, map},
+      getIterators(MAP_PARALLEL),
+      [&](OpBuilder &nestedBuilder, Location nestedLoc, ValueRange blockArgs) {
+        auto arg0 = blockArgs[0];
+        auto arg1 = blockArgs[1];
+        auto arg2 = blockArgs[2];
+        auto conv = nestedBuilder.create<arith::SIToFPOp>(loc, dataType, arg0);
+        auto mul = nestedBuilder.create<arith::MulFOp>(loc, conv, arg1);
+        Value add = nestedBuilder.create<arith::AddFOp>(loc, mul, arg2);
+        if (relu)
+          add = nestedBuilder.create<arith::MaxFOp>(loc, add, zero);
+        nestedBuilder.create<linalg::YieldOp>(loc, ValueRange{add});
+      });
+  return dequant.getResult(0);
+}
+
+Value MLIRGenerator::lowerQuantize(Value input) {
+  auto inputTy = input.getType().cast<ShapedType>();
+  auto outTy = RankedTensorType::get(inputTy.getShape(), quantType);
+  Value output = builder.create<tensor::EmptyOp>(loc, outTy, ValueRange{});
+
+  // Saturate to the quantized range and truncate
+  auto width = quantType.getIntOrFloatBitWidth();
+  auto bitWidth = dataType.getIntOrFloatBitWidth();
+  auto lowest = getConstFloat(builder, -(1 << (width - 1)), bitWidth);
+  auto largest = getConstFloat(builder, (1 << (width - 1)) - 1, bitWidth);
+  auto map = getMap(input, MAP_PARALLEL);
+  auto quant = builder.create<linalg::GenericOp>(
+      loc, outTy, ValueRange{input}, ValueRange{output},
+      ArrayRef<AffineMap>{map, map}, getIterators(MAP_PARALLEL),
+      [&](OpBuilder &nestedBuilder, Location nestedLoc, ValueRange blockArgs) {
+        auto arg0 = blockArgs[0];
+        auto max = nestedBuilder.create<arith::MaxFOp>(loc, arg0, lowest);
+        auto min = nestedBuilder.create<arith::MinFOp>(loc, max, largest);
+        auto conv = nestedBuilder.create<arith::FPToSIOp>(loc, quantType, min);
+        nestedBuilder.create<linalg::YieldOp>(loc, ValueRange{conv});
+      });
+  return quant.getResult(0);
+}
+
 TensorType MLIRGenerator::getShape(ArrayRef<int64_t> dims, PackingType type) {
+  // Quantized inputs and weights, outputs are dequantized
+  auto elementType = (quantType && type != PACK_OUTPUT) ? quantType : dataType;
+
   // Already packed type, just return ND tensor
   if (dims.size() > 2)
-    return RankedTensorType::get(dims, dataType);
+    return RankedTensorType::get(dims, elementType);
 
   // Packed types block by tile size
   if (tiles.size()) {
@@ -491,7 +628,7 @@ TensorType MLIRGenerator::getShape(ArrayRef<int64_t> dims, PackingType type) {
       assert(x % n == 0 && "Invalid tile size for N dim");
       assert(y % c == 0 && "Invalid tile size for C dim");
       // N x C -> BN x BC x bn x bc
-      return RankedTensorType::get({x / n, y / c, n, c}, dataType);
+      return RankedTensorType::get({x / n, y / c, n, c}, elementType);
     case PACK_WEIGHT:
       // VNNI packing can be done via tpp-opt --vnni-pack
       assert(x % k == 0 && "Invalid tile size for K dim");
@@ -500,20 +637,20 @@ TensorType MLIRGenerator::getShape(ArrayRef<int64_t> dims, PackingType type) {
       // VNNI: C x K -> BK x BC x bc/vnni x bk x vnni
       if (vnniFactor != 0)
         return RankedTensorType::get(
-            {y / k, x / c, c / vnniFactor, k, vnniFactor}, dataType);
+            {y / k, x / c, c / vnniFactor, k, vnniFactor}, elementType);
 
       // C x K -> BK x BC x bc x bk
-      return RankedTensorType::get({y / k, x / c, c, k}, dataType);
+      return RankedTensorType::get({y / k, x / c, c, k}, elementType);
     case PACK_OUTPUT:
       assert(x % n == 0 && "Invalid tile size for N dim");
       assert(y % k == 0 && "Invalid tile size for K dim");
       // N x K -> BN x BK x bn x bk
-      return RankedTensorType::get({x / n, y / k, n, k}, dataType);
+      return RankedTensorType::get({x / n, y / k, n, k}, elementType);
     }
   }
 
   // Unpacked type, just return 2D tensor
-  return RankedTensorType::get(dims, dataType);
+  return RankedTensorType::get(dims, elementType);
 }
 
 AffineMap MLIRGenerator::getMap(Value tensor, MapType type) {
@@ -54,6 +54,12 @@ class MLIRGenerator {
   /// Data type (element type of all tensors)
   Type dataType;
 
+  /// Quantized data type (element type of inputs and weights, if not null)
+  Type quantType;
+
+  /// Accumulation type of the quantized matmuls
+  Type accType;
+
   /// Random seed
   int seed;
 
@@ -136,6 +142,13 @@ class MLIRGenerator {
   /// Creates a softmax in the current function
   Value lowerSoftmax(Value, Value);
 
+  /// Creates a dequantization (scale, bias and optional relu) of the
+  /// accumulator in the current function
+  Value lowerDequantize(Value, Value, Value, bool, Value);
+
+  /// Creates a quantization back to the quantized type in the current function
+  Value lowerQuantize(Value);
+
   // ============================ Main API
 
   /// Creates metadata string containing run command, flops info etc.
@@ -168,7 +181,7 @@ public:
   /// so should create new objects to not have to share / cleanup existing MLIR
   /// modules.
   MLIRGenerator(StringRef, unsigned, StringRef, StringRef, unsigned, int, bool,
-                bool, int);
+                bool, int, unsigned);
 
   ~MLIRGenerator() { module->destroy(); }
 
@@ -55,6 +55,12 @@ llvm::cl::opt<unsigned> floatWidth("float-width",
                                    llvm::cl::value_desc("32|16"),
                                    llvm::cl::init(32));
 
+// Quantization width
+llvm::cl::opt<unsigned> quantWidth(
+    "quant-width",
+    llvm::cl::desc("Bitsize of quantized integer type (disabled if zero)"),
+    llvm::cl::value_desc("0|8"), llvm::cl::init(0));
+
 // Random seed
 llvm::cl::opt<int> seed("seed", llvm::cl::desc("Random seed"),
                         llvm::cl::value_desc("int"), llvm::cl::init(0));
@@ -89,6 +95,6 @@ int main(int argc, char **argv) {
   llvm::cl::ParseCommandLineOptions(argc, argv, "MLIR Generator");
 
   MLIRGenerator gen(kernel, miniBatch, layers, tiles, floatWidth, seed,
-                    enableSoftmax, biasAcc, vnni);
+                    enableSoftmax, biasAcc, vnni, quantWidth);
   return gen.generate(filename);
 }
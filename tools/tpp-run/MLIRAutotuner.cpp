@@ -0,0 +1,228 @@
+//===- MLIRAutotuner.cpp - In-process autotuner ---------------------------===//
+//
+// Empirical search of the blocking factors and tile sizes of the matmuls and
+// convolutions of a kernel. Each candidate is applied to a copy of the module,
+// compiled with the default pipeline, JIT-ed and timed in-process.
+//
+//===----------------------------------------------------------------------===//
+
+#include "MLIRAutotuner.h"
+
+#include "TPP/BlockingFactors.h"
+#include "TPP/VNNIUtils.h"
+#include "mlir/Dialect/Linalg/IR/Linalg.h"
+#include "mlir/ExecutionEngine/ExecutionEngine.h"
+#include "mlir/IR/BuiltinTypes.h"
+#include "mlir/IR/OwningOpRef.h"
+#include "mlir/IR/TypeUtilities.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/Support/raw_ostream.h"
+
+using namespace mlir;
+
+// Block sizes tried for each blocked dimension.
+static constexpr int64_t kBlockCandidates[] = {32, 64, 128};
+
+// Outer tiles (in blocks) tried for blocked matmuls.
+static constexpr int64_t kTileCandidates[][2] = {
+    {1, 1}, {1, 2}, {2, 1}, {2, 2}};
+
+static void printEntry(llvm::raw_ostream &os, StringRef key,
+                       const tpp::TuningEntry &entry) {
+  os << "autotune: " << key << ": block-factors=[";
+  llvm::interleaveComma(entry.blockingFactors, os);
+  os << "] tile-sizes=[";
+  llvm::interleaveComma(entry.tileSizes, os);
+  os << "] time=" << entry.time << "\n";
+}
+
+MLIRAutotuner::MLIRAutotuner(ModuleOp module,
+                             const MLIRAutotunerConfig &config)
+    : module(module), config(config) {}
+
+SmallVector<linalg::LinalgOp> MLIRAutotuner::getTunableOps(ModuleOp op) {
+  SmallVector<linalg::LinalgOp> tunableOps;
+  op->walk([&](linalg::LinalgOp linalgOp) {
+    if (linalgOp.hasTensorSemantics() &&
+        succeeded(tpp::getTuningKey(linalgOp)))
+      tunableOps.push_back(linalgOp);
+  });
+  return tunableOps;
+}
+
+SmallVector<SmallVector<int64_t>>
+MLIRAutotuner::getBlockingCandidates(linalg::LinalgOp linalgOp) {
+  SmallVector<int64_t> loopRanges = linalgOp.getStaticLoopRanges();
+  Type inputType = linalgOp.getDpsInputOperand(0)->get().getType();
+  int64_t vnni = vnni::utils::getVnniBlockingFactor(inputType).value_or(1);
+  auto divides = [](int64_t block, int64_t dim) { return dim % block == 0; };
+
+  SmallVector<SmallVector<int64_t>> candidates;
+  if (isa<linalg::MatmulOp, linalg::BatchMatmulOp>(linalgOp)) {
+    if (isa<linalg::BatchMatmulOp>(linalgOp))
+      loopRanges.erase(loopRanges.begin());
+    for (int64_t i : kBlockCandidates) {
+      for (int64_t j : kBlockCandidates) {
+        for (int64_t k : kBlockCandidates) {
+          if (divides(i, loopRanges[0]) && divides(j, loopRanges[1]) &&
+              divides(k, loopRanges[2]) && divides(vnni, k))
+            candidates.push_back({i, j, k});
+        }
+      }
+    }
+    // Seed the search with the cost model selection.
+    FailureOr<SmallVector<int64_t>> model =
+        linalgx::utils::getMatmulBlockingFactors(linalgOp);
+    if (succeeded(model) && !llvm::is_contained(candidates, *model))
+      candidates.push_back(*model);
+    return candidates;
+  }
+
+  // Convolutions block the input and output channels with the same factor.
+  bool isNhwc = isa<linalg::Conv2DNhwcHwcfOp>(linalgOp);
+  int64_t dimK = isNhwc ? loopRanges[3] : loopRanges[1];
+  int64_t dimC = isNhwc ? loopRanges[6] : loopRanges[4];
+  for (int64_t block : kBlockCandidates) {
+    if (divides(block, dimK) && divides(block, dimC) && divides(vnni, block))
+      candidates.push_back({block, block});
+  }
+  return candidates;
+}
+
+SmallVector<SmallVector<int64_t>>
+MLIRAutotuner::getTileCandidates(linalg::LinalgOp linalgOp,
+                                 ArrayRef<int64_t> blockingFactors) {
+  // Only blocked matmuls expose a choice: how many blocks per parallel task.
+  // Other ops keep the default tiles of TileConsumerAndFuseProducers.
+  SmallVector<SmallVector<int64_t>> candidates;
+  if (!isa<linalg::MatmulOp>(linalgOp) || blockingFactors.size() != 3)
+    return candidates;
+  SmallVector<int64_t> loopRanges = linalgOp.getStaticLoopRanges();
+  int64_t numBlocksI = loopRanges[0] / blockingFactors[0];
+  int64_t numBlocksJ = loopRanges[1] / blockingFactors[1];
+  for (const auto &tiles : kTileCandidates) {
+    if (numBlocksI % tiles[0] == 0 && numBlocksJ % tiles[1] == 0)
+      candidates.push_back({tiles[0], tiles[1]});
+  }
+  return candidates;
+}
+
+FailureOr<double> MLIRAutotuner::measure(
+    ArrayRef<std::optional<tpp::TuningEntry>> configs) {
+  OwningOpRef<ModuleOp> candidate(module.clone());
+  for (auto [linalgOp, entry] :
+       llvm::zip(getTunableOps(*candidate), configs)) {
+    if (entry)
+      tpp::applyTuningEntry(linalgOp, *entry);
+  }
+
+  // Same wrapper as a benchmark run, returning the mean time
+  MLIRBench bench(*candidate, config.benchConfig);
+  Type timeType = FloatType::getF64(module->getContext());
+  if (failed(bench.findKernel(config.kernelName)) ||
+      failed(bench.checkKernelSignature()) || failed(bench.renameKernel()) ||
+      failed(bench.createMainWrapper(timeType)) ||
+      failed(bench.createKernelArgs()) || !bench.callKernel())
+    return failure();
+  Value acc = bench.createTimerLoop(config.numLoops);
+  if (!acc)
+    return failure();
+  Value mean = bench.getTimerMean(acc);
+  if (failed(bench.finalize(MLIRBench::PrintStage::None, mean)))
+    return failure();
+
+  ExecutionEngineOptions engineOptions;
+  engineOptions.llvmModuleBuilder = config.llvmModuleBuilder;
+  auto engine = ExecutionEngine::create(*candidate, engineOptions);
+  if (!engine) {
+    llvm::errs() << "autotune: " << llvm::toString(engine.takeError())
+                 << "\n";
+    return failure();
+  }
+  double time = 0.0;
+  if (llvm::Error error = (*engine)->invoke(bench.getMainName(),
+                                            ExecutionEngine::result(time))) {
+    llvm::errs() << "autotune: " << llvm::toString(std::move(error)) << "\n";
+    return failure();
+  }
+  return time;
+}
+
+LogicalResult MLIRAutotuner::run() {
+  std::string errorMessage;
+  FailureOr<tpp::TuningDatabase> db =
+      tpp::TuningDatabase::load(config.dbPath, &errorMessage);
+  if (failed(db))
+    return module.emitError(errorMessage);
+
+  // Group the ops by key, in order of appearance
+  SmallVector<linalg::LinalgOp> tunableOps = getTunableOps(module);
+  SmallVector<std::string> keys;
+  llvm::StringMap<SmallVector<size_t>> opsByKey;
+  for (auto [idx, linalgOp] : llvm::enumerate(tunableOps)) {
+    std::string key = *tpp::getTuningKey(linalgOp);
+    if (!opsByKey.count(key))
+      keys.push_back(key);
+    opsByKey[key].push_back(idx);
+  }
+  if (keys.empty()) {
+    llvm::errs() << "autotune: nothing to tune\n";
+    return success();
+  }
+
+  SmallVector<std::optional<tpp::TuningEntry>> best(tunableOps.size());
+  FailureOr<double> baseline = measure(best);
+  if (failed(baseline))
+    return module.emitError("autotune: cannot run the default configuration");
+  llvm::errs() << "autotune: default pipeline time=" << *baseline << "\n";
+
+  // Time `entry` for all the ops of `key`; keep it if faster
+  auto tryEntry = [&](StringRef key, tpp::TuningEntry entry,
+                      std::optional<tpp::TuningEntry> &bestEntry) {
+    SmallVector<std::optional<tpp::TuningEntry>> configs = best;
+    for (size_t idx : opsByKey[key])
+      configs[idx] = entry;
+    FailureOr<double> time = measure(configs);
+    if (failed(time))
+      return;
+    entry.time = *time;
+    if (!bestEntry || entry.time < bestEntry->time)
+      bestEntry = entry;
+  };
+
+  std::string cpu = tpp::getHostCpuName();
+  for (StringRef key : keys) {
+    linalg::LinalgOp linalgOp = tunableOps[opsByKey[key].front()];
+    std::optional<tpp::TuningEntry> bestEntry;
+    for (SmallVector<int64_t> &factors : getBlockingCandidates(linalgOp)) {
+      tpp::TuningEntry entry;
+      entry.blockingFactors = factors;
+      tryEntry(key, entry, bestEntry);
+    }
+    if (!bestEntry)
+      continue;
+    SmallVector<int64_t> factors = bestEntry->blockingFactors;
+    for (SmallVector<int64_t> &tiles : getTileCandidates(linalgOp, factors)) {
+      tpp::TuningEntry entry;
+      entry.blockingFactors = factors;
+      entry.tileSizes = tiles;
+      tryEntry(key, entry, bestEntry);
+    }
+
+    for (size_t idx : opsByKey[key])
+      best[idx] = bestEntry;
+    db->insert(cpu, key, *bestEntry);
+    printEntry(llvm::errs(), key, *bestEntry);
+  }
+
+  if (failed(db->save(config.dbPath, &errorMessage)))
+    return module.emitError(errorMessage);
+
+  // Run the winners
+  for (auto [linalgOp, entry] : llvm::zip(tunableOps, best)) {
+    if (entry)
+      tpp::applyTuningEntry(linalgOp, *entry);
+  }
+  return success();
+}
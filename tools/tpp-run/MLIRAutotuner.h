@@ -0,0 +1,95 @@
+#ifndef TPP_RUN_MLIRAUTOTUNER_H
+#define TPP_RUN_MLIRAUTOTUNER_H
+
+//===- MLIRAutotuner.h - In-process autotuner -----------------------------===//
+//
+// Empirical search of the blocking factors and tile sizes of the matmuls and
+// convolutions of a kernel. Each candidate is applied to a copy of the module,
+// compiled with the default pipeline, JIT-ed and timed in-process. Winners are
+// recorded in a tuning database, looked up by the default pipeline with
+// `-def-tuning-db`.
+//
+//===----------------------------------------------------------------------===//
+
+#include "MLIRBench.h"
+
+#include "TPP/TuningDatabase.h"
+#include "mlir/IR/BuiltinOps.h"
+#include "mlir/Support/LogicalResult.h"
+#include "llvm/ADT/STLFunctionalExtras.h"
+#include "llvm/ADT/SmallVector.h"
+
+#include <memory>
+#include <optional>
+#include <string>
+
+namespace llvm {
+class LLVMContext;
+class Module;
+} // namespace llvm
+
+namespace mlir {
+namespace linalg {
+class LinalgOp;
+} // namespace linalg
+
+// MLIRAutotuner settings.
+struct MLIRAutotunerConfig {
+  /// Settings for the benchmark wrapper of each candidate
+  MLIRBenchConfig benchConfig;
+
+  /// Kernel to tune (empty if the module has a single function)
+  std::string kernelName;
+
+  /// Number of timed iterations per candidate
+  unsigned numLoops = 10;
+
+  /// Path of the tuning database to update
+  std::string dbPath;
+
+  /// Translation of the lowered module to LLVM IR
+  llvm::function_ref<std::unique_ptr<llvm::Module>(Operation *,
+                                                   llvm::LLVMContext &)>
+      llvmModuleBuilder;
+};
+
+/// MLIRAutotuner - Tunes the packing and tiling of a kernel.
+///
+/// Ops sharing a tuning key (same op, element type and shape) share a
+/// configuration. Keys are tuned one after the other, the blocking factors
+/// first then the tile sizes, the other ops keeping their best configuration.
+class MLIRAutotuner {
+  /// Module to tune, annotated with the winners at the end
+  ModuleOp module;
+
+  /// Settings
+  MLIRAutotunerConfig config;
+
+  /// Collects the ops to tune in `op`, in a deterministic order
+  static llvm::SmallVector<linalg::LinalgOp> getTunableOps(ModuleOp op);
+
+  /// Blocking factors to try for `linalgOp`
+  static llvm::SmallVector<llvm::SmallVector<int64_t>>
+  getBlockingCandidates(linalg::LinalgOp linalgOp);
+
+  /// Tile sizes to try for `linalgOp` packed with `blockingFactors`
+  static llvm::SmallVector<llvm::SmallVector<int64_t>>
+  getTileCandidates(linalg::LinalgOp linalgOp,
+                    llvm::ArrayRef<int64_t> blockingFactors);
+
+  /// Times the kernel with `configs[i]` applied to the i-th tunable op.
+  /// Returns the mean time in seconds.
+  FailureOr<double>
+  measure(llvm::ArrayRef<std::optional<tpp::TuningEntry>> configs);
+
+public:
+  MLIRAutotuner(ModuleOp module, const MLIRAutotunerConfig &config);
+
+  /// Runs the search, updates the database and annotates the ops of the
+  /// module with the best configuration found.
+  LogicalResult run();
+};
+
+} // namespace mlir
+
+#endif
@@ -219,9 +219,9 @@ LogicalResult MLIRBench::createKernelArgs() {
   return success();
 }
 
-LogicalResult MLIRBench::createMainWrapper() {
-  // Add a `main` function (with no args/rets) to handle init/tear down
-  auto funcType = builder.getFunctionType({}, {});
+LogicalResult MLIRBench::createMainWrapper(TypeRange results) {
+  // Add a `main` function (with no args) to handle init/tear down
+  auto funcType = builder.getFunctionType({}, results);
   main = func::FuncOp::create(unkLoc, mainName, funcType);
   main.setVisibility(SymbolTable::Visibility::Public);
   auto *entryBlock = main.addEntryBlock();
@@ -305,6 +305,16 @@ Value MLIRBench::getTimerStats(Value acc) {
   return insDev;
 }
 
+Value MLIRBench::getTimerMean(Value acc) {
+  auto callMean =
+      builder.create<perf::MeanOp>(unkLoc, builder.getF64Type(), acc);
+
+  // Clean up results buffer
+  builder.create<memref::DeallocOp>(unkLoc, acc);
+
+  return callMean.getMean();
+}
+
 void MLIRBench::printVector(Value vector) {
   auto op = vector;
   auto vectorValue = vector.getType().dyn_cast<VectorType>();
@@ -380,11 +390,11 @@ LogicalResult MLIRBench::printResult(Operation *kernelCall) {
   return printShapedType(getKernelResult(kernelCall));
 }
 
-LogicalResult MLIRBench::finalize(PrintStage print) {
+LogicalResult MLIRBench::finalize(PrintStage print, ValueRange results) {
   // If we created a main at all...
-  // return void and add func to Module
+  // return and add func to Module
   if (main) {
-    builder.create<func::ReturnOp>(unkLoc);
+    builder.create<func::ReturnOp>(unkLoc, results);
   }
 
   // A set of default passes that lower any input IR to LLVM
@@ -428,6 +438,8 @@ LogicalResult MLIRBench::finalize(PrintStage print) {
   if (defParallel)
     passManager.addPass(createConvertOpenMPToLLVMPass());
   passManager.addPass(createConvertMathToLLVMPass());
+  // Math ops without an LLVM intrinsic (e.g., tanh, erf) become libm calls.
+  passManager.addPass(createConvertMathToLibmPass());
   passManager.addPass(createConvertFuncToLLVMPass());
   passManager.addPass(createGpuToLLVMConversionPass());
   passManager.addNestedPass<func::FuncOp>(createArithToLLVMConversionPass());
@@ -107,6 +107,9 @@ public:
   /// Renames the kernel to _name, so that we can create the wrapper
   LogicalResult renameKernel();
 
+  /// Name of the main wrapper (the original kernel name), after renameKernel
+  llvm::StringRef getMainName() const { return mainName; }
+
   /// Replace all dense splat tensors/memrefs with random values in the kernel
   LogicalResult replaceSplatWithRandom();
 
@@ -115,7 +118,7 @@ public:
   LogicalResult createKernelArgs();
 
   /// Create main wrapper function, sets insertion point
-  LogicalResult createMainWrapper();
+  LogicalResult createMainWrapper(TypeRange results = {});
 
   /// Creates and returns a call to the kernel.
   Operation *callKernel();
@@ -131,6 +134,9 @@ public:
   /// Get the timer average/deviation
   Value getTimerStats(Value);
 
+  /// Get the timer average only (as an f64 scalar)
+  Value getTimerMean(Value);
+
   /// Prints a float value (used for mean/dev)
   void printVector(Value);
 
@@ -150,8 +156,8 @@ public:
     Invalid,
   };
 
-  /// Terminates the function, issuing a return, lower to LLVM
-  LogicalResult finalize(PrintStage dump);
+  /// Terminates the function, issuing a return of `results`, lower to LLVM
+  LogicalResult finalize(PrintStage dump, ValueRange results = {});
 
   /// Reports error on the current module's location
   LogicalResult emitError(llvm::Twine);
@@ -7,6 +7,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include "MLIRAutotuner.h"
 #include "MLIRBench.h"
 
 #include "llvm/MC/TargetRegistry.h"
@@ -141,6 +142,24 @@ llvm::cl::opt<bool> printLLVM("print-llvm",
                               llvm::cl::desc("print LLVM IR before lowering"),
                               llvm::cl::init(false));
 
+// Autotune the packing and tiling of the kernel before running it
+llvm::cl::opt<bool>
+    autotune("autotune",
+             llvm::cl::desc("Search the blocking factors and tile sizes of "
+                            "matmuls and convolutions, record the best ones "
+                            "in --tuning-db and run with them"),
+             llvm::cl::init(false));
+
+// Tuning database updated by the autotuner
+llvm::cl::opt<std::string>
+    tuningDb("tuning-db",
+             llvm::cl::desc("Tuning database written by --autotune (use "
+                            "-def-tuning-db to compile with it)"),
+             llvm::cl::init("tpp-tuning-db.json"));
+
+std::unique_ptr<llvm::Module> lowerToLLVMIR(Operation *module,
+                                            llvm::LLVMContext &llvmContext);
+
 // Parses MLIR print stage
 MLIRBench::PrintStage parsePrintStage(StringRef stage) {
   return StringSwitch<MLIRBench::PrintStage>(stage)
@@ -166,6 +185,23 @@ static LogicalResult prepareMLIRKernel(Operation *op,
 
   // Benchmark object
   MLIRBenchConfig config(seed, tppToLoops, linalgToLoops, tensorInitType);
+
+  // Search the best configuration, the kernel then runs with it
+  if (autotune && (tppToLoops || linalgToLoops))
+    return op->emitError("Cannot autotune with -tpp-to-loops or "
+                         "-linalg-to-loops");
+  if (autotune) {
+    MLIRAutotunerConfig tunerConfig;
+    tunerConfig.benchConfig = config;
+    tunerConfig.kernelName = options.mainFuncName;
+    tunerConfig.numLoops = std::max(benchNumLoops.getValue(), 10u);
+    tunerConfig.dbPath = tuningDb;
+    tunerConfig.llvmModuleBuilder = lowerToLLVMIR;
+    MLIRAutotuner tuner(cast<ModuleOp>(op), tunerConfig);
+    if (failed(tuner.run()))
+      return failure();
+  }
+
   MLIRBench bench(op, config);
 
   // Basic checks